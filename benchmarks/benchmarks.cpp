@@ -0,0 +1,294 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+#include "cache.h"
+#include "evaluator.h"
+#include "lexer.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "resolver.h"
+#include "vm.h"
+
+// Every allocation is counted, so the bytes an object really uses can be measured, not just its sizeof
+static long long g_allocatedBytes = 0;
+static long long g_allocations = 0;
+
+void* operator new(std::size_t p_size)
+{
+	g_allocatedBytes += p_size;
+	g_allocations++;
+	void* pointer = std::malloc(p_size);
+	if (pointer == NULL) throw std::bad_alloc();
+	return pointer;
+}
+
+void operator delete(void* p_pointer) noexcept
+{
+	std::free(p_pointer);
+}
+
+void operator delete(void* p_pointer, std::size_t p_size) noexcept
+{
+	std::free(p_pointer);
+}
+
+const int c_objectCount = 100000;
+
+// Prints the heap bytes used by each object a factory makes and how long it takes to make them
+template<typename Factory>
+void benchmarkObject(const char* p_name, Factory p_factory)
+{
+	std::vector<std::shared_ptr<object::Object>> objects;
+	objects.reserve(c_objectCount);
+
+	long long allocatedBytes = g_allocatedBytes;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < c_objectCount; i++)
+	{
+		objects.push_back(p_factory());
+	}
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << std::left << std::setw(14) << p_name
+		<< std::right << std::setw(10) << (g_allocatedBytes - allocatedBytes) / c_objectCount << " bytes"
+		<< std::setw(12) << std::fixed << std::setprecision(1) << milliseconds * 1000000 / c_objectCount << " ns" << std::endl;
+}
+
+// Prints how long a program takes to run and how many allocations it makes, on the evaluator and on the virtual machine
+void benchmarkProgram(const char* p_name, std::string p_input, bool p_isOptimized = false)
+{
+	lexer::Lexer lexer = lexer::Lexer(&p_input);
+	parser::Parser parser = parser::Parser(lexer);
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+
+	resolver::Resolver resolver;
+	resolver.ResolveProgram(program);
+
+	if (p_isOptimized)
+	{
+		optimizer::Optimizer optimizer;
+		optimizer.OptimizeProgram(program);
+	}
+
+	std::cout << std::left << std::setw(24) << p_name;
+	for (int useVirtualMachine = 0; useVirtualMachine < 2; useVirtualMachine++)
+	{
+		long long allocations = g_allocations;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::shared_ptr<object::Object> result = useVirtualMachine
+			? vm::run(program, std::make_shared<object::Environment>())
+			: evaluator::evaluate(program, std::make_shared<object::Environment>());
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << std::right << std::setw(10) << std::fixed << std::setprecision(1) << milliseconds << " ms"
+			<< std::setw(10) << g_allocations - allocations << " allocations";
+	}
+	std::cout << std::endl;
+}
+
+// Generates a program of many functions. Comments and indentation can be made longer to weigh the lexer
+// towards skipping them.
+std::string generateProgram(int p_functionCount, int p_indentation, int p_commentLength)
+{
+	std::string indent(p_indentation, ' ');
+	std::string comment(p_commentLength, '=');
+
+	std::ostringstream source;
+	source << "collection<integer> values = [1, 2, 3, 4, 5];\n";
+	for (int i = 0; i < p_functionCount; i++)
+	{
+		// Identifiers cannot contain digits, so the number is spelled with letters
+		std::string name = "function";
+		for (int number = i; number > 0; number /= 26)
+		{
+			name += (char)('a' + number % 26);
+		}
+
+		source << "-> Function number " << i << " " << comment << "\n"
+			<< "integer(integer n) " << name << "\n"
+			<< "{\n"
+			<< indent << "integer total = 0;\n"
+			<< indent << "-* Sums the even values " << comment << " *-\n"
+			<< indent << "for (integer i = 0; i < values.size; i++)\n"
+			<< indent << "{\n"
+			<< indent << indent << "if (values[i] % 2 == 0 && i != n) { total += values[i] * 31 + 12345; }\n"
+			<< indent << indent << "else { float scaled = 2.5f * i; log(\"odd value\", scaled, 'c'); }\n"
+			<< indent << "}\n"
+			<< indent << "return total;\n"
+			<< "}\n";
+	}
+	return source.str();
+}
+
+// Prints the lexer's throughput on a program, taking the best of several runs
+void benchmarkLexer(const char* p_name, std::string p_input)
+{
+	double bestMilliseconds = 0;
+	for (int run = 0; run < 5; run++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		lexer::Lexer lexer = lexer::Lexer(&p_input);
+		token::Token token;
+		do
+		{
+			lexer.nextToken(&token);
+		} while (token.m_type != token::END_OF_FILE);
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (run == 0 || milliseconds < bestMilliseconds) bestMilliseconds = milliseconds;
+	}
+
+	std::cout << std::left << std::setw(24) << p_name
+		<< std::right << std::setw(10) << p_input.size() / 1024 << " KB"
+		<< std::setw(10) << std::fixed << std::setprecision(1) << bestMilliseconds << " ms"
+		<< std::setw(10) << p_input.size() / (bestMilliseconds * 1000) << " MB/s" << std::endl;
+}
+
+// Counts the tokens of a program
+long long countTokens(std::string* p_input)
+{
+	lexer::Lexer lexer = lexer::Lexer(p_input);
+	token::Token token;
+	long long tokenCount = 0;
+	do
+	{
+		lexer.nextToken(&token);
+		tokenCount++;
+	} while (token.m_type != token::END_OF_FILE);
+	return tokenCount;
+}
+
+// Prints how fast a program is lexed and parsed and how long its tree takes to free, and how many allocations parsing makes
+void benchmarkParser(const char* p_name, std::string p_input, bool p_isLazy = false, bool p_isPipelined = false, int p_threadCount = 1)
+{
+	long long tokenCount = countTokens(&p_input);
+
+	long long allocations = g_allocations;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	parser::Parser parser = parser::Parser(lexer::Lexer(&p_input), p_isPipelined);
+	parser.m_isLazy = p_isLazy;
+	parser.m_threadCount = p_threadCount;
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	allocations = g_allocations - allocations;
+
+	start = std::chrono::steady_clock::now();
+	program = NULL;
+	parser.m_arena = NULL;
+	double freeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << std::left << std::setw(24) << p_name
+		<< std::right << std::setw(10) << std::fixed << std::setprecision(1) << milliseconds << " ms"
+		<< std::setw(10) << tokenCount / (milliseconds * 1000) << " M tokens/s"
+		<< std::setw(10) << allocations << " allocations"
+		<< std::setw(10) << freeMilliseconds << " ms to free" << std::endl;
+}
+
+// Prints how fast many short lines are parsed with a new parser each, as the REPL and the web binding do
+void benchmarkParserPerLine(const char* p_name, std::string p_line, int p_lineCount)
+{
+	long long tokenCount = countTokens(&p_line) * p_lineCount;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < p_lineCount; i++)
+	{
+		parser::Parser parser = parser::Parser(lexer::Lexer(&p_line));
+		parser.ParseProgram();
+	}
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << std::left << std::setw(24) << p_name
+		<< std::right << std::setw(10) << std::fixed << std::setprecision(1) << milliseconds << " ms"
+		<< std::setw(10) << tokenCount / (milliseconds * 1000) << " M tokens/s" << std::endl;
+}
+
+// Prints how long a program takes to load from its cache, next to how long it takes to parse
+void benchmarkCache(const char* p_name, std::string p_input)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	parser::Parser parser = parser::Parser(lexer::Lexer(&p_input));
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+	double parseMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	std::string data = cache::serialize(program.get(), p_input.data(), p_input.size());
+
+	start = std::chrono::steady_clock::now();
+	std::shared_ptr<ast::Program> loaded = cache::deserialize(data.data(), data.size(), p_input.data(), p_input.size());
+	double loadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << std::left << std::setw(24) << p_name
+		<< std::right << std::setw(10) << data.size() / 1024 << " KB"
+		<< std::setw(10) << std::fixed << std::setprecision(1) << parseMilliseconds << " ms to parse"
+		<< std::setw(10) << loadMilliseconds << " ms to load" << std::endl;
+}
+
+int main()
+{
+	std::string text = "Hello, world.";
+
+	std::cout << "Heap bytes and time to create one object" << std::endl;
+	benchmarkObject("integer", []() { return std::make_shared<object::Integer>(1); });
+	benchmarkObject("float", []() { return std::make_shared<object::Float>(1.0f); });
+	benchmarkObject("character", []() { return std::make_shared<object::Character>('a'); });
+	benchmarkObject("string", [&]() { return std::make_shared<object::String>(&text); });
+	benchmarkObject("collection", []() { return std::make_shared<object::Collection>(); });
+	benchmarkObject("dictionary", []() { return std::make_shared<object::Dictionary>(); });
+
+	std::cout << std::endl << "Programs on the evaluator and on the virtual machine" << std::endl;
+	benchmarkProgram("collection size", "collection<integer> c = [1, 2, 3]; integer total = 0; for (integer i = 0; i < 200000; i++) { total += c.size; } total;");
+	benchmarkProgram("collection append", "collection<integer> c = []; for (integer i = 0; i < 200000; i++) { c.append(i); } c.size;");
+	benchmarkProgram("string length", "string s = \"Hello, world.\"; integer total = 0; for (integer i = 0; i < 200000; i++) { total += s.length; } total;");
+	benchmarkProgram("fibonacci", "integer(integer n) fibonacci { if (n < 2) { return n; } return fibonacci(n - 1) + fibonacci(n - 2); } fibonacci(24);");
+	benchmarkProgram("dictionary keys", "dictionary<integer, integer> d = {1: 2, 3: 4}; integer total = 0; for (integer i = 0; i < 50000; i++) { iterate (key : d.keys()) { total += key; } } total;");
+
+
+	std::string constants = "integer width = 64; integer height = 48; float scale = 0.5f; integer total = 0;"
+		"for (integer i = 0; i < 200000; i++) { if (i % (width * height) < width * 2 + 1) { total += width * height / 4; } if (scale * 2 < 1.5f) { total++; } } total;";
+	benchmarkProgram("constants", constants);
+	benchmarkProgram("constants, optimized", constants, true);
+
+	std::string loops = "integer(integer n, integer k) sum { integer total = 0;"
+		"for (integer i = 0; i < n; i++) { for (integer j = 0; j < k * 2; j++) { total += n * k - j; } } return total; } sum(400, 250);";
+	benchmarkProgram("loops", loops);
+	benchmarkProgram("loops, optimized", loops, true);
+
+	std::string deadCode = "integer(integer n) step { integer scratch = n * 2; integer limit = 100; boolean isDebug = false;"
+		"if (isDebug) { log(n); } return n + 1; log(limit); } integer total = 0; for (integer i = 0; i < 100000; i++) { total = step(total); } total;";
+	benchmarkProgram("dead code", deadCode);
+	benchmarkProgram("dead code, optimized", deadCode, true);
+
+	std::string subexpressions = "string word = \"racecar\"; integer total = 0; for (integer i = 0; i < 200000; i++) { integer k = i % word.length;"
+		"boolean isMirrored = word[k] == word[word.length - k - 1]; boolean isVowel = word[k] == 'a' || word[k] == 'e'; if (isMirrored && !isVowel) { total += k; } } total;";
+	benchmarkProgram("subexpressions", subexpressions);
+	benchmarkProgram("subexpressions, optimized", subexpressions, true);
+
+	std::string inlining = "integer(integer n) square { return n * n; } boolean(integer x, integer lo, integer hi) within { return x >= lo && x <= hi; }"
+		"integer total = 0; for (integer i = 0; i < 200000; i++) { integer k = i % 100; if (within(k, 10, 90)) { total += square(k); } } total;";
+	benchmarkProgram("inlining", inlining);
+	benchmarkProgram("inlining, optimized", inlining, true);
+
+	std::string program = generateProgram(20000, 4, 0);
+	std::string commentedProgram = generateProgram(20000, 16, 200);
+
+	std::cout << std::endl << "Lexer" << std::endl;
+	benchmarkLexer("program", program);
+	benchmarkLexer("commented program", commentedProgram);
+
+	std::cout << std::endl << "Parser" << std::endl;
+	benchmarkParser("program", program);
+	benchmarkParser("program, lazily", program, true);
+	benchmarkParser("program, lexer thread", program, false, true);
+	benchmarkParser("commented, synchronous", commentedProgram);
+	benchmarkParser("commented, lexer thread", commentedProgram, false, true);
+	benchmarkParser("program, 4 threads", program, false, false, 4);
+	benchmarkParserPerLine("lines", "integer total = values[2] * 3 + 1;", 100000);
+
+	std::cout << std::endl << "Cache" << std::endl;
+	benchmarkCache("program", program);
+
+	return 0;
+}
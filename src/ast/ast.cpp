@@ -5,6 +5,45 @@
 
 namespace ast
 {
+	Arena::Arena()
+		: m_bytesUsed(0)
+		, m_next(NULL)
+		, m_end(NULL)
+	{
+	}
+
+	Arena::~Arena()
+	{
+		for (int i = 0; i < m_blocks.size(); i++)
+		{
+			delete[] m_blocks[i];
+		}
+	}
+
+	void* Arena::Allocate(size_t p_size)
+	{
+		// Keeps every allocation aligned for any type
+		const size_t alignment = alignof(std::max_align_t);
+		p_size = (p_size + alignment - 1) & ~(alignment - 1);
+		m_bytesUsed += p_size;
+
+		if (m_next == NULL || (size_t)(m_end - m_next) < p_size)
+		{
+			// Anything too big for a block gets a block of its own
+			size_t blockSize = p_size > c_blockSize ? p_size : c_blockSize;
+			char* block = new char[blockSize];
+			m_blocks.push_back(block);
+			if (blockSize != c_blockSize) return block;
+
+			m_next = block;
+			m_end = block + blockSize;
+		}
+
+		void* result = m_next;
+		m_next += p_size;
+		return result;
+	}
+
 	std::string Program::TokenLiteral()
 	{
 		return "";
@@ -59,7 +98,7 @@ namespace ast
 	std::string FloatLiteral::TokenLiteral()
 	{
 		std::ostringstream output;
-		output << stof(m_token.m_literal);
+		output << m_value;
 
 		return output.str();
 	}
@@ -168,8 +207,9 @@ namespace ast
 	{
 		std::ostringstream output;
 
+		// A body that has not been parsed yet is left out
 		output << "{" << std::endl
-			<< m_body->String()
+			<< (m_body != NULL ? m_body->String() : "...\n")
 			<< "}" << std::endl;
 
 		return output.str();
@@ -335,7 +375,7 @@ namespace ast
 
 		output << ") " << m_name.String() << std::endl 
 			<< "{" << std::endl
-			<< m_body->m_body->String()
+			<< (m_body->m_body != NULL ? m_body->m_body->String() : "...\n")
 			<< "}";
 
 		return output.str();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -46,6 +47,66 @@ namespace ast
 		CONTINUE_STATEMENT_NODE,
 	};
 
+	// Members of the builtin types, such as the size of a collection
+	enum Member
+	{
+		MEMBER_UNKNOWN,
+		MEMBER_SIZE,
+		MEMBER_APPEND,
+		MEMBER_POP,
+		MEMBER_INSERT,
+		MEMBER_KEYS,
+		MEMBER_VALUES,
+		MEMBER_LENGTH,
+	};
+
+	// Memory that the nodes of one program are allocated from. Nodes are laid out one after another in the
+	// order they are parsed, so the statements of a block and their expressions sit next to each other. Nothing
+	// is freed until the arena itself is, once the last node of the program has been released.
+	class Arena
+	{
+	public:
+		Arena();
+		~Arena();
+
+		void* Allocate(size_t p_size);
+
+		size_t m_bytesUsed;
+	private:
+		const size_t c_blockSize = 64 * 1024;
+
+		std::vector<char*> m_blocks;
+		char* m_next;
+		char* m_end;
+	};
+
+	// Allocator for std::allocate_shared, so that each node and its reference count are placed in the arena.
+	// Every node keeps the arena alive, which lets functions outlive the rest of the program that declared them.
+	template<typename T>
+	class ArenaAllocator
+	{
+	public:
+		typedef T value_type;
+
+		std::shared_ptr<Arena> m_arena;
+
+		ArenaAllocator(std::shared_ptr<Arena> p_arena) : m_arena(p_arena) {}
+		template<typename U> ArenaAllocator(const ArenaAllocator<U>& p_other) : m_arena(p_other.m_arena) {}
+
+		T* allocate(size_t p_count) { return (T*)m_arena->Allocate(p_count * sizeof(T)); }
+		void deallocate(T*, size_t) {}
+
+		template<typename U> bool operator==(const ArenaAllocator<U>& p_other) const { return m_arena == p_other.m_arena; }
+		template<typename U> bool operator!=(const ArenaAllocator<U>& p_other) const { return m_arena != p_other.m_arena; }
+	};
+
+	// Allocates a node and its reference count from an arena. The node is still owned through a shared_ptr.
+	template<typename T>
+	std::shared_ptr<T> newNode(const std::shared_ptr<Arena>& p_arena)
+	{
+		return std::allocate_shared<T>(ArenaAllocator<T>(p_arena));
+	}
+
 	class Node
 	{
 	public:
@@ -69,6 +130,8 @@ namespace ast
 	class Expression : public Node 
 	{
 	public:
+		token::TokenType m_resolvedType = token::ILLEGAL; // Type found by the checker, ILLEGAL if it could not be known before running
+
 		virtual std::string TokenLiteral() = 0;
 		virtual std::string String() = 0;
 		virtual NodeType Type() = 0;
@@ -95,6 +158,12 @@ namespace ast
 	public:
 		token::Token m_token;
 		std::string m_name;
+		int m_symbol = -1; // Interned name, set by the parser
+
+		// Set by the resolver. A slot of -1 means the identifier is looked up by name instead.
+		int m_depth = -1; // How many environments out the identifier was declared
+		int m_slot = -1; // Index of the identifier in that environment's slots
+		Member m_member = MEMBER_UNKNOWN; // Member named by the right side of a member access
 
 		std::string TokenLiteral();
 		std::string String();
@@ -212,8 +281,9 @@ namespace ast
 	class FunctionLiteral : public Expression
 	{
 	public:
-		token::Token m_token;
+		token::Token m_token; // '{'
 		std::shared_ptr<ast::BlockStatement> m_body;
+		std::shared_ptr<std::string> m_source; // Source of a body skipped by a lazy parser, until it is parsed
 
 		std::string TokenLiteral();
 		std::string String();
@@ -257,6 +327,7 @@ namespace ast
 		std::shared_ptr<ast::Expression> m_leftExpression;
 		std::string m_operator;
 		std::shared_ptr<ast::Expression> m_rightExpression;
+		bool m_isTypeChecked = false; // Set by the checker when an assignment is known to keep the variable's type
 
 		std::string TokenLiteral();
 		std::string String();
@@ -271,6 +342,7 @@ namespace ast
 		token::Token m_token;
 		std::shared_ptr<ast::Expression> m_function; // Either an identifier or function literal
 		std::vector<std::shared_ptr<ast::Expression>> m_parameters;
+		bool m_isTypeChecked = false; // Set by the checker when the arguments are known to match the function's parameters
 
 		std::string TokenLiteral();
 		std::string String();
@@ -301,6 +373,7 @@ namespace ast
 		token::Token m_token;
 		Identifier m_name;
 		std::shared_ptr<Expression> m_value;
+		bool m_isTypeChecked = false; // Set by the checker when the value is known to have the declared type
 
 		std::string TokenLiteral();
 		std::string String();
@@ -316,6 +389,7 @@ namespace ast
 		token::Token m_typeToken;
 		Identifier m_name;
 		std::shared_ptr<Expression> m_value;
+		bool m_isTypeChecked = false;
 
 		std::string TokenLiteral();
 		std::string String();
@@ -332,6 +406,7 @@ namespace ast
 		token::Token m_valueTypeToken;
 		Identifier m_name;
 		std::shared_ptr<Expression> m_value;
+		bool m_isTypeChecked = false;
 
 		std::string TokenLiteral();
 		std::string String();
@@ -347,6 +422,7 @@ namespace ast
 		std::vector<std::shared_ptr<ast::DeclareVariableStatement>> m_parameters;
 		ast::Identifier m_name;
 		std::shared_ptr<ast::FunctionLiteral> m_body;
+		bool m_isTypeChecked = false; // Set by the checker when every return statement is known to return the function type
 
 		std::string TokenLiteral();
 		std::string String();
@@ -434,6 +510,11 @@ namespace ast
 		std::shared_ptr<Statement> m_updation;
 		std::shared_ptr<BlockStatement> m_consequence;
 
+		// Set by the optimizer when the initialization declares an integer counter, the condition compares it with
+		// a bound that does not change and only the updation steps it by an amount that does not change either,
+		// so that the loop can count natively.
+		bool m_isCounted = false;
+
 		std::string TokenLiteral();
 		std::string String();
 		NodeType Type() { return m_nodeType; }
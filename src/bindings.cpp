@@ -2,12 +2,16 @@
 #include <iostream>
 #include "emscripten/bind.h"
 #include "repl.h"
+#include "checker.h"
+#include "optimizer.h"
 #include "parser.h"
+#include "resolver.h"
 #include "evaluator.h"
 
 using namespace emscripten;
 
-void run(std::string p_input, int p_timeout = 0) {
+// Runs a program within a budget of milliseconds and fuel, where zero means no limit
+void run(std::string p_input, int p_timeout = 0, int p_fuel = 0) {
     lexer::Lexer lexer = lexer::Lexer(&p_input);
     parser::Parser parser = parser::Parser(lexer);
     std::shared_ptr<ast::Program> program = parser.ParseProgram();
@@ -19,7 +23,24 @@ void run(std::string p_input, int p_timeout = 0) {
     }
     if (parser.m_errors.size() > 0) return;
 
-    evaluator::g_timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(p_timeout);
+    resolver::Resolver resolver;
+    resolver.ResolveProgram(program);
+
+    checker::Checker checker;
+    if (!checker.CheckProgram(program))
+    {
+        for (int i = 0; i < checker.m_errors.size(); i++)
+        {
+            std::cout << "Type error: " << checker.m_errors[i] << std::endl;
+        }
+        return;
+    }
+
+    optimizer::Optimizer optimizer;
+    optimizer.OptimizeProgram(program);
+    evaluator::g_isOptimizing = true;
+
+    evaluator::startBudget(p_fuel, p_timeout);
     std::shared_ptr<object::Object> output = evaluator::evaluate(program, environment);
 
     // Output only if you get an error
@@ -27,6 +48,10 @@ void run(std::string p_input, int p_timeout = 0) {
     {
         std::cout << output->Inspect() << std::endl;
     }
+    if (p_fuel != 0)
+    {
+        std::cout << "Fuel used: " << evaluator::fuelUsed() << std::endl;
+    }
 }
 
 EMSCRIPTEN_BINDINGS(lotus) {
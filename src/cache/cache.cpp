@@ -0,0 +1,1064 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef _WIN32
+#define CACHE_MMAP 0
+#include <process.h>
+#define getpid _getpid
+#else
+#define CACHE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "cache.h"
+#include "object.h"
+
+namespace cache
+{
+	const char c_magic[8] = { 'L', 'O', 'T', 'U', 'S', 'A', 'S', 'T' };
+
+	// Operators the parser builds each kind of expression with
+	const std::unordered_set<std::string> c_prefixOperators = { "!", "-", "++", "--" };
+	const std::unordered_set<std::string> c_postfixOperators = { "++", "--" };
+	const std::unordered_set<std::string> c_infixOperators =
+	{
+		"+", "-", "*", "/", "%", "<", "<=", ">", ">=", "==", "!=", "&&", "||", ".",
+		"=", "+=", "-=", "*=", "/=", "%=",
+	};
+
+	unsigned long long hashBytes(const char* p_bytes, size_t p_size)
+	{
+		unsigned long long hash = 14695981039346656037ULL;
+		for (size_t i = 0; i < p_size; i++)
+		{
+			hash ^= (unsigned char)p_bytes[i];
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	bool isExpression(ast::NodeType p_type)
+	{
+		return p_type == ast::IDENTIFIER_NODE || (p_type >= ast::INTEGER_LITERAL_NODE && p_type <= ast::INDEX_EXPRESSION_NODE);
+	}
+
+	bool isStatement(ast::NodeType p_type)
+	{
+		return p_type == ast::BLOCK_STATEMENT_NODE || (p_type >= ast::DECLARE_VARIABLE_STATEMENT_NODE && p_type <= ast::CONTINUE_STATEMENT_NODE);
+	}
+
+	// Writes nodes depth first, each as its type followed by its fields. Missing nodes are written as NODE.
+	// Numbers are written as variable length integers, and strings as indexes into a table of the distinct strings
+	// written after the nodes. Identifiers are written by name, since symbols are only meaningful to the process that
+	// interned them.
+	class Writer
+	{
+	public:
+		std::string m_buffer;
+		std::vector<const std::string*> m_strings;
+
+		void writeBytes(const void* p_bytes, size_t p_size) { m_buffer.append((const char*)p_bytes, p_size); }
+		void writeInt(int p_value);
+		void writeBool(bool p_value) { m_buffer.push_back(p_value ? 1 : 0); }
+		void writeString(const std::string& p_value);
+		void writeStrings();
+		void writeToken(token::Token* p_token);
+		void writeIdentifier(ast::Identifier* p_identifier);
+		void writeNode(ast::Node* p_node);
+
+		template<typename T>
+		void writeNodes(std::vector<std::shared_ptr<T>>* p_nodes)
+		{
+			writeInt((int)p_nodes->size());
+			for (int i = 0; i < p_nodes->size(); i++)
+			{
+				writeNode((*p_nodes)[i].get());
+			}
+		}
+	private:
+		std::unordered_map<std::string, int> m_stringIndexes;
+	};
+
+	void Writer::writeInt(int p_value)
+	{
+		// Zigzag encoded so that small negative numbers stay short, then seven bits to a byte
+		unsigned int value = ((unsigned int)p_value << 1) ^ (unsigned int)(p_value >> 31);
+		while (value >= 0x80)
+		{
+			m_buffer.push_back((char)(value | 0x80));
+			value >>= 7;
+		}
+		m_buffer.push_back((char)value);
+	}
+
+	void Writer::writeString(const std::string& p_value)
+	{
+		std::unordered_map<std::string, int>::iterator it = m_stringIndexes.find(p_value);
+		if (it == m_stringIndexes.end())
+		{
+			it = m_stringIndexes.insert(std::make_pair(p_value, (int)m_strings.size())).first;
+			m_strings.push_back(&it->first);
+		}
+		writeInt(it->second);
+	}
+
+	void Writer::writeStrings()
+	{
+		writeInt((int)m_strings.size());
+		for (size_t i = 0; i < m_strings.size(); i++)
+		{
+			writeInt((int)m_strings[i]->size());
+			writeBytes(m_strings[i]->data(), m_strings[i]->size());
+		}
+	}
+
+	void Writer::writeToken(token::Token* p_token)
+	{
+		writeInt(p_token->m_type);
+		writeString(p_token->m_literal);
+		writeInt(p_token->m_location.m_offset);
+		writeInt(p_token->m_location.m_line);
+		writeInt(p_token->m_location.m_column);
+		writeInt(p_token->m_integer);
+	}
+
+	void Writer::writeIdentifier(ast::Identifier* p_identifier)
+	{
+		writeToken(&p_identifier->m_token);
+		writeString(p_identifier->m_name);
+		writeBool(p_identifier->m_symbol >= 0);
+	}
+
+	void Writer::writeNode(ast::Node* p_node)
+	{
+		if (p_node == NULL)
+		{
+			writeInt(ast::NODE);
+			return;
+		}
+
+		writeInt(p_node->Type());
+		switch (p_node->Type())
+		{
+		case ast::PROGRAM_NODE:
+			writeNodes(&((ast::Program*)p_node)->m_statements);
+			break;
+		case ast::IDENTIFIER_NODE:
+			writeIdentifier((ast::Identifier*)p_node);
+			break;
+		case ast::BLOCK_STATEMENT_NODE:
+		{
+			ast::BlockStatement* node = (ast::BlockStatement*)p_node;
+			writeToken(&node->m_token);
+			writeNodes(&node->m_statements);
+			break;
+		}
+		case ast::INTEGER_LITERAL_NODE:
+		{
+			ast::IntegerLiteral* node = (ast::IntegerLiteral*)p_node;
+			writeToken(&node->m_token);
+			writeInt(node->m_value);
+			break;
+		}
+		case ast::FLOAT_LITERAL_NODE:
+		{
+			ast::FloatLiteral* node = (ast::FloatLiteral*)p_node;
+			writeToken(&node->m_token);
+			writeBytes(&node->m_value, sizeof(node->m_value));
+			break;
+		}
+		case ast::BOOLEAN_LITERAL_NODE:
+		{
+			ast::BooleanLiteral* node = (ast::BooleanLiteral*)p_node;
+			writeToken(&node->m_token);
+			writeBool(node->m_value);
+			break;
+		}
+		case ast::CHARACTER_LITERAL_NODE:
+		{
+			ast::CharacterLiteral* node = (ast::CharacterLiteral*)p_node;
+			writeToken(&node->m_token);
+			m_buffer.push_back(node->m_value);
+			break;
+		}
+		case ast::COLLECTION_LITERAL_NODE:
+		{
+			ast::CollectionLiteral* node = (ast::CollectionLiteral*)p_node;
+			writeToken(&node->m_token);
+			writeNodes(&node->m_values);
+			break;
+		}
+		case ast::DICTIONARY_LITERAL_NODE:
+		{
+			ast::DictionaryLiteral* node = (ast::DictionaryLiteral*)p_node;
+			writeToken(&node->m_token);
+			writeInt((int)node->m_map.size());
+			for (auto it = node->m_map.begin(); it != node->m_map.end(); it++)
+			{
+				writeNode(it->first.get());
+				writeNode(it->second.get());
+			}
+			break;
+		}
+		case ast::STRING_LITERAL_NODE:
+		{
+			ast::StringLiteral* node = (ast::StringLiteral*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_stringCollection.get());
+			break;
+		}
+		case ast::FUNCTION_LITERAL_NODE:
+		{
+			ast::FunctionLiteral* node = (ast::FunctionLiteral*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_body.get());
+			break;
+		}
+		case ast::PREFIX_EXPRESSION_NODE:
+		{
+			ast::PrefixExpression* node = (ast::PrefixExpression*)p_node;
+			writeToken(&node->m_token);
+			writeString(node->m_operator);
+			writeNode(node->m_rightExpression.get());
+			break;
+		}
+		case ast::POSTFIX_EXPRESSION_NODE:
+		{
+			ast::PostfixExpression* node = (ast::PostfixExpression*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_leftExpression.get());
+			writeString(node->m_operator);
+			break;
+		}
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			ast::InfixExpression* node = (ast::InfixExpression*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_leftExpression.get());
+			writeString(node->m_operator);
+			writeNode(node->m_rightExpression.get());
+			break;
+		}
+		case ast::CALL_EXPRESSION_NODE:
+		{
+			ast::CallExpression* node = (ast::CallExpression*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_function.get());
+			writeNodes(&node->m_parameters);
+			break;
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			ast::IndexExpression* node = (ast::IndexExpression*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_collection.get());
+			writeNode(node->m_index.get());
+			break;
+		}
+		case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+		{
+			ast::DeclareVariableStatement* node = (ast::DeclareVariableStatement*)p_node;
+			writeToken(&node->m_token);
+			writeIdentifier(&node->m_name);
+			writeNode(node->m_value.get());
+			break;
+		}
+		case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+		{
+			ast::DeclareCollectionStatement* node = (ast::DeclareCollectionStatement*)p_node;
+			writeToken(&node->m_token);
+			writeToken(&node->m_typeToken);
+			writeIdentifier(&node->m_name);
+			writeNode(node->m_value.get());
+			break;
+		}
+		case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+		{
+			ast::DeclareDictionaryStatement* node = (ast::DeclareDictionaryStatement*)p_node;
+			writeToken(&node->m_token);
+			writeToken(&node->m_keyTypeToken);
+			writeToken(&node->m_valueTypeToken);
+			writeIdentifier(&node->m_name);
+			writeNode(node->m_value.get());
+			break;
+		}
+		case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+		{
+			ast::DeclareFunctionStatement* node = (ast::DeclareFunctionStatement*)p_node;
+			writeToken(&node->m_token);
+			writeNodes(&node->m_parameters);
+			writeIdentifier(&node->m_name);
+			writeNode(node->m_body.get());
+			break;
+		}
+		case ast::RETURN_STATEMENT_NODE:
+		{
+			ast::ReturnStatement* node = (ast::ReturnStatement*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_returnValue.get());
+			break;
+		}
+		case ast::EXPRESSION_STATEMENT_NODE:
+		{
+			ast::ExpressionStatement* node = (ast::ExpressionStatement*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_expression.get());
+			break;
+		}
+		case ast::IF_STATEMENT_NODE:
+		{
+			ast::IfStatement* node = (ast::IfStatement*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_condition.get());
+			writeNode(node->m_consequence.get());
+			writeNode(node->m_alternative.get());
+			break;
+		}
+		case ast::WHILE_STATEMENT_NODE:
+		{
+			ast::WhileStatement* node = (ast::WhileStatement*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_condition.get());
+			writeNode(node->m_consequence.get());
+			break;
+		}
+		case ast::DO_WHILE_STATEMENT_NODE:
+		{
+			ast::DoWhileStatement* node = (ast::DoWhileStatement*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_consequence.get());
+			writeNode(node->m_condition.get());
+			break;
+		}
+		case ast::FOR_STATEMENT_NODE:
+		{
+			ast::ForStatement* node = (ast::ForStatement*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_initialization.get());
+			writeNode(node->m_condition.get());
+			writeNode(node->m_updation.get());
+			writeNode(node->m_consequence.get());
+			break;
+		}
+		case ast::ITERATE_STATEMENT_NODE:
+		{
+			ast::IterateStatement* node = (ast::IterateStatement*)p_node;
+			writeToken(&node->m_token);
+			writeNode(node->m_var.get());
+			writeNode(node->m_collection.get());
+			writeNode(node->m_consequence.get());
+			break;
+		}
+		case ast::BREAK_STATEMENT_NODE:
+			writeToken(&((ast::BreakStatement*)p_node)->m_token);
+			break;
+		case ast::CONTINUE_STATEMENT_NODE:
+			writeToken(&((ast::ContinueStatement*)p_node)->m_token);
+			break;
+		default:
+			break;
+		}
+	}
+
+	// Reads what the writer wrote, allocating the nodes from a new arena in the order the parser would.
+	// Every read is bounds checked, every kind, type and operator is checked against those the parser produces,
+	// and anything unexpected marks the input as damaged.
+	class Reader
+	{
+	public:
+		Reader(const char* p_data, size_t p_size, const char* p_source, size_t p_sourceSize);
+
+		bool m_isDamaged;
+		std::shared_ptr<ast::Arena> m_arena;
+
+		bool readBytes(void* p_bytes, size_t p_size);
+		int readInt();
+		bool readBool();
+		const std::string& readString(int* p_index = NULL);
+		void readStrings(const char* p_data, const char* p_end);
+		void readToken(token::Token* p_token);
+		void readTypeToken(token::Token* p_token);
+		void readIdentifier(ast::Identifier* p_identifier);
+		const std::string& readOperator(const std::unordered_set<std::string>& p_operators, token::Token* p_token);
+		std::shared_ptr<ast::Node> readNode();
+
+		// Reads a node that must have the given type, or be missing
+		template<typename T>
+		std::shared_ptr<T> readNode(ast::NodeType p_type)
+		{
+			std::shared_ptr<ast::Node> node = readNode();
+			if (node == NULL) return NULL;
+			if (node->Type() != p_type) return damaged<T>();
+			return std::static_pointer_cast<T>(node);
+		}
+
+		std::shared_ptr<ast::Expression> readExpression();
+		std::shared_ptr<ast::Statement> readStatement();
+		int readCount();
+		bool isAtEnd() { return m_next == m_end; }
+
+		template<typename T>
+		std::shared_ptr<T> damaged()
+		{
+			m_isDamaged = true;
+			return NULL;
+		}
+	private:
+		const char* m_next;
+		const char* m_end;
+		int m_depth;
+
+		const char* m_source;
+		size_t m_sourceSize;
+		std::shared_ptr<std::string> m_sharedSource;  // Copy of the source shared by the skipped function bodies
+
+		std::vector<std::string> m_strings;
+		std::vector<int> m_symbols;             // Symbol of each string, interned the first time an identifier uses it
+		int symbolOf(int p_index);
+	};
+
+	Reader::Reader(const char* p_data, size_t p_size, const char* p_source, size_t p_sourceSize)
+		: m_isDamaged(false)
+		, m_arena(std::make_shared<ast::Arena>())
+		, m_next(p_data)
+		, m_end(p_data + p_size)
+		, m_depth(0)
+		, m_source(p_source)
+		, m_sourceSize(p_sourceSize)
+	{
+	}
+
+	bool Reader::readBytes(void* p_bytes, size_t p_size)
+	{
+		if (m_isDamaged || (size_t)(m_end - m_next) < p_size)
+		{
+			m_isDamaged = true;
+			memset(p_bytes, 0, p_size);
+			return false;
+		}
+		memcpy(p_bytes, m_next, p_size);
+		m_next += p_size;
+		return true;
+	}
+
+	int Reader::readInt()
+	{
+		unsigned int value = 0;
+		for (int shift = 0; shift < 35; shift += 7)
+		{
+			if (m_next == m_end)
+			{
+				m_isDamaged = true;
+				return 0;
+			}
+
+			unsigned char byte = (unsigned char)*m_next++;
+			value |= (unsigned int)(byte & 0x7f) << shift;
+			if (byte < 0x80) return (int)(value >> 1) ^ -(int)(value & 1);
+		}
+
+		m_isDamaged = true;
+		return 0;
+	}
+
+	bool Reader::readBool()
+	{
+		char value;
+		readBytes(&value, 1);
+		if (value != 0 && value != 1) m_isDamaged = true;
+		return value != 0;
+	}
+
+	int Reader::readCount()
+	{
+		// A count can never be more than the bytes left, which stops a damaged count from reserving huge vectors
+		int count = readInt();
+		if (count < 0 || count > m_end - m_next)
+		{
+			m_isDamaged = true;
+			return 0;
+		}
+		return count;
+	}
+
+	const std::string& Reader::readString(int* p_index)
+	{
+		static const std::string c_empty;
+
+		int index = readInt();
+		if (index < 0 || index >= (int)m_strings.size()) m_isDamaged = true;
+		if (m_isDamaged) return c_empty;
+
+		if (p_index != NULL) *p_index = index;
+		return m_strings[index];
+	}
+
+	void Reader::readStrings(const char* p_data, const char* p_end)
+	{
+		// The string table follows the nodes, so it is read before them and then reading goes back to the nodes
+		const char* nodes = m_next;
+		const char* nodesEnd = m_end;
+		m_next = p_data;
+		m_end = p_end;
+
+		int count = readCount();
+		m_strings.reserve(count);
+		for (int i = 0; i < count && !m_isDamaged; i++)
+		{
+			int size = readCount();
+			m_strings.push_back(std::string(m_next, size));
+			m_next += size;
+		}
+		m_symbols.assign(m_strings.size(), -1);
+		if (m_next != m_end) m_isDamaged = true;
+
+		m_next = nodes;
+		m_end = nodesEnd;
+	}
+
+	int Reader::symbolOf(int p_index)
+	{
+		if (m_symbols[p_index] < 0) m_symbols[p_index] = token::internIdentifier(&m_strings[p_index]);
+		return m_symbols[p_index];
+	}
+
+	void Reader::readToken(token::Token* p_token)
+	{
+		int type = readInt();
+		if (type < 0 || type >= token::TOKEN_TYPE_COUNT) m_isDamaged = true;
+		p_token->m_type = (token::TokenType)type;
+
+		int literal = -1;
+		p_token->m_literal = readString(&literal);
+		p_token->m_location.m_offset = readInt();
+		p_token->m_location.m_line = readInt();
+		p_token->m_location.m_column = readInt();
+		p_token->m_integer = readInt();
+
+		if (p_token->m_type == token::IDENTIFIER && !m_isDamaged)
+		{
+			p_token->m_symbol = symbolOf(literal);
+		}
+	}
+
+	void Reader::readTypeToken(token::Token* p_token)
+	{
+		// The evaluator looks the object type of a declaration up by its token
+		readToken(p_token);
+		if (object::c_nodeTypeToObjectType.count(p_token->m_type) == 0) m_isDamaged = true;
+	}
+
+	void Reader::readIdentifier(ast::Identifier* p_identifier)
+	{
+		readToken(&p_identifier->m_token);
+		if (p_identifier->m_token.m_type != token::IDENTIFIER) m_isDamaged = true;
+
+		int name = -1;
+		p_identifier->m_name = readString(&name);
+		if (readBool() && !m_isDamaged)
+		{
+			p_identifier->m_symbol = symbolOf(name);
+		}
+	}
+
+	const std::string& Reader::readOperator(const std::unordered_set<std::string>& p_operators, token::Token* p_token)
+	{
+		const std::string& value = readString();
+		if (p_operators.count(value) == 0 || value != p_token->m_literal) m_isDamaged = true;
+		return value;
+	}
+
+	std::shared_ptr<ast::Expression> Reader::readExpression()
+	{
+		std::shared_ptr<ast::Node> node = readNode();
+		if (node == NULL) return NULL;
+		if (!isExpression(node->Type())) return damaged<ast::Expression>();
+		return std::static_pointer_cast<ast::Expression>(node);
+	}
+
+	std::shared_ptr<ast::Statement> Reader::readStatement()
+	{
+		std::shared_ptr<ast::Node> node = readNode();
+		if (node == NULL) return NULL;
+		if (!isStatement(node->Type())) return damaged<ast::Statement>();
+		return std::static_pointer_cast<ast::Statement>(node);
+	}
+
+	std::shared_ptr<ast::Node> Reader::readNode()
+	{
+		int type = readInt();
+		if (m_isDamaged || type == ast::NODE) return NULL;
+
+		// Limits nesting, so that a damaged cache cannot overflow the stack
+		if (m_depth > 10000) return damaged<ast::Node>();
+		m_depth++;
+
+		std::shared_ptr<ast::Node> result;
+		switch (type)
+		{
+		case ast::PROGRAM_NODE:
+		{
+			std::shared_ptr<ast::Program> node = ast::newNode<ast::Program>(m_arena);
+			int count = readCount();
+			for (int i = 0; i < count && !m_isDamaged; i++)
+			{
+				node->m_statements.push_back(readStatement());
+			}
+			result = std::move(node);
+			break;
+		}
+		case ast::IDENTIFIER_NODE:
+		{
+			std::shared_ptr<ast::Identifier> node = ast::newNode<ast::Identifier>(m_arena);
+			readIdentifier(node.get());
+			result = std::move(node);
+			break;
+		}
+		case ast::BLOCK_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::BlockStatement> node = ast::newNode<ast::BlockStatement>(m_arena);
+			readToken(&node->m_token);
+			int count = readCount();
+			for (int i = 0; i < count && !m_isDamaged; i++)
+			{
+				node->m_statements.push_back(readStatement());
+			}
+			result = std::move(node);
+			break;
+		}
+		case ast::INTEGER_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::IntegerLiteral> node = ast::newNode<ast::IntegerLiteral>(m_arena);
+			readToken(&node->m_token);
+			node->m_value = readInt();
+			result = std::move(node);
+			break;
+		}
+		case ast::FLOAT_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::FloatLiteral> node = ast::newNode<ast::FloatLiteral>(m_arena);
+			readToken(&node->m_token);
+			readBytes(&node->m_value, sizeof(node->m_value));
+			result = std::move(node);
+			break;
+		}
+		case ast::BOOLEAN_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::BooleanLiteral> node = ast::newNode<ast::BooleanLiteral>(m_arena);
+			readToken(&node->m_token);
+			node->m_value = readBool();
+			result = std::move(node);
+			break;
+		}
+		case ast::CHARACTER_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::CharacterLiteral> node = ast::newNode<ast::CharacterLiteral>(m_arena);
+			readToken(&node->m_token);
+			readBytes(&node->m_value, 1);
+			result = std::move(node);
+			break;
+		}
+		case ast::COLLECTION_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::CollectionLiteral> node = ast::newNode<ast::CollectionLiteral>(m_arena);
+			readToken(&node->m_token);
+			int count = readCount();
+			for (int i = 0; i < count && !m_isDamaged; i++)
+			{
+				node->m_values.push_back(readExpression());
+			}
+			result = std::move(node);
+			break;
+		}
+		case ast::DICTIONARY_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::DictionaryLiteral> node = ast::newNode<ast::DictionaryLiteral>(m_arena);
+			readToken(&node->m_token);
+			int count = readCount();
+			for (int i = 0; i < count && !m_isDamaged; i++)
+			{
+				std::shared_ptr<ast::Expression> key = readExpression();
+				std::shared_ptr<ast::Expression> value = readExpression();
+				node->m_map[key] = value;
+			}
+			result = std::move(node);
+			break;
+		}
+		case ast::STRING_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::StringLiteral> node = ast::newNode<ast::StringLiteral>(m_arena);
+			readToken(&node->m_token);
+			node->m_stringCollection = readNode<ast::CollectionLiteral>(ast::COLLECTION_LITERAL_NODE);
+			result = std::move(node);
+			break;
+		}
+		case ast::FUNCTION_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::FunctionLiteral> node = ast::newNode<ast::FunctionLiteral>(m_arena);
+			readToken(&node->m_token);
+			node->m_body = readNode<ast::BlockStatement>(ast::BLOCK_STATEMENT_NODE);
+
+			// A body skipped by a lazy parser is parsed from the source when it is first needed, as it would have been,
+			// starting from its opening brace
+			if (node->m_body == NULL && !m_isDamaged)
+			{
+				int offset = node->m_token.m_location.m_offset;
+				if (offset < 0 || (size_t)offset >= m_sourceSize || m_source[offset] != '{') m_isDamaged = true;
+				if (m_sharedSource == NULL) m_sharedSource = std::make_shared<std::string>(m_source, m_sourceSize);
+				node->m_source = m_sharedSource;
+			}
+			result = std::move(node);
+			break;
+		}
+		case ast::PREFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::PrefixExpression> node = ast::newNode<ast::PrefixExpression>(m_arena);
+			readToken(&node->m_token);
+			node->m_operator = readOperator(c_prefixOperators, &node->m_token);
+			node->m_rightExpression = readExpression();
+			result = std::move(node);
+			break;
+		}
+		case ast::POSTFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::PostfixExpression> node = ast::newNode<ast::PostfixExpression>(m_arena);
+			readToken(&node->m_token);
+			node->m_leftExpression = readExpression();
+			node->m_operator = readOperator(c_postfixOperators, &node->m_token);
+			result = std::move(node);
+			break;
+		}
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::InfixExpression> node = ast::newNode<ast::InfixExpression>(m_arena);
+			readToken(&node->m_token);
+			node->m_leftExpression = readExpression();
+			node->m_operator = readOperator(c_infixOperators, &node->m_token);
+			node->m_rightExpression = readExpression();
+			result = std::move(node);
+			break;
+		}
+		case ast::CALL_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::CallExpression> node = ast::newNode<ast::CallExpression>(m_arena);
+			readToken(&node->m_token);
+			node->m_function = readExpression();
+			int count = readCount();
+			for (int i = 0; i < count && !m_isDamaged; i++)
+			{
+				node->m_parameters.push_back(readExpression());
+			}
+			result = std::move(node);
+			break;
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::IndexExpression> node = ast::newNode<ast::IndexExpression>(m_arena);
+			readToken(&node->m_token);
+			node->m_collection = readExpression();
+			node->m_index = readExpression();
+			result = std::move(node);
+			break;
+		}
+		case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareVariableStatement> node = ast::newNode<ast::DeclareVariableStatement>(m_arena);
+			readTypeToken(&node->m_token);
+			readIdentifier(&node->m_name);
+			node->m_value = readExpression();
+			result = std::move(node);
+			break;
+		}
+		case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareCollectionStatement> node = ast::newNode<ast::DeclareCollectionStatement>(m_arena);
+			readTypeToken(&node->m_token);
+			readTypeToken(&node->m_typeToken);
+			readIdentifier(&node->m_name);
+			node->m_value = readExpression();
+			result = std::move(node);
+			break;
+		}
+		case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareDictionaryStatement> node = ast::newNode<ast::DeclareDictionaryStatement>(m_arena);
+			readTypeToken(&node->m_token);
+			readTypeToken(&node->m_keyTypeToken);
+			readTypeToken(&node->m_valueTypeToken);
+			readIdentifier(&node->m_name);
+			node->m_value = readExpression();
+			result = std::move(node);
+			break;
+		}
+		case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareFunctionStatement> node = ast::newNode<ast::DeclareFunctionStatement>(m_arena);
+			readTypeToken(&node->m_token);
+			int count = readCount();
+			for (int i = 0; i < count && !m_isDamaged; i++)
+			{
+				node->m_parameters.push_back(readNode<ast::DeclareVariableStatement>(ast::DECLARE_VARIABLE_STATEMENT_NODE));
+			}
+			readIdentifier(&node->m_name);
+			node->m_body = readNode<ast::FunctionLiteral>(ast::FUNCTION_LITERAL_NODE);
+			if (node->m_body == NULL) m_isDamaged = true;
+			result = std::move(node);
+			break;
+		}
+		case ast::RETURN_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::ReturnStatement> node = ast::newNode<ast::ReturnStatement>(m_arena);
+			readToken(&node->m_token);
+			node->m_returnValue = readExpression();
+			result = std::move(node);
+			break;
+		}
+		case ast::EXPRESSION_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::ExpressionStatement> node = ast::newNode<ast::ExpressionStatement>(m_arena);
+			readToken(&node->m_token);
+			node->m_expression = readExpression();
+			result = std::move(node);
+			break;
+		}
+		case ast::IF_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::IfStatement> node = ast::newNode<ast::IfStatement>(m_arena);
+			readToken(&node->m_token);
+			node->m_condition = readExpression();
+			node->m_consequence = readNode<ast::BlockStatement>(ast::BLOCK_STATEMENT_NODE);
+			node->m_alternative = readNode<ast::IfStatement>(ast::IF_STATEMENT_NODE);
+			result = std::move(node);
+			break;
+		}
+		case ast::WHILE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::WhileStatement> node = ast::newNode<ast::WhileStatement>(m_arena);
+			readToken(&node->m_token);
+			node->m_condition = readExpression();
+			node->m_consequence = readNode<ast::BlockStatement>(ast::BLOCK_STATEMENT_NODE);
+			result = std::move(node);
+			break;
+		}
+		case ast::DO_WHILE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DoWhileStatement> node = ast::newNode<ast::DoWhileStatement>(m_arena);
+			readToken(&node->m_token);
+			node->m_consequence = readNode<ast::BlockStatement>(ast::BLOCK_STATEMENT_NODE);
+			node->m_condition = readExpression();
+			result = std::move(node);
+			break;
+		}
+		case ast::FOR_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::ForStatement> node = ast::newNode<ast::ForStatement>(m_arena);
+			readToken(&node->m_token);
+			node->m_initialization = readStatement();
+			node->m_condition = readStatement();
+			node->m_updation = readStatement();
+			node->m_consequence = readNode<ast::BlockStatement>(ast::BLOCK_STATEMENT_NODE);
+			result = std::move(node);
+			break;
+		}
+		case ast::ITERATE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::IterateStatement> node = ast::newNode<ast::IterateStatement>(m_arena);
+			readToken(&node->m_token);
+			node->m_var = readNode<ast::Identifier>(ast::IDENTIFIER_NODE);
+			node->m_collection = readExpression();
+			node->m_consequence = readNode<ast::BlockStatement>(ast::BLOCK_STATEMENT_NODE);
+			result = std::move(node);
+			break;
+		}
+		case ast::BREAK_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::BreakStatement> node = ast::newNode<ast::BreakStatement>(m_arena);
+			readToken(&node->m_token);
+			result = std::move(node);
+			break;
+		}
+		case ast::CONTINUE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::ContinueStatement> node = ast::newNode<ast::ContinueStatement>(m_arena);
+			readToken(&node->m_token);
+			result = std::move(node);
+			break;
+		}
+		default:
+			m_isDamaged = true;
+			break;
+		}
+
+		m_depth--;
+		return result;
+	}
+
+	std::string serialize(ast::Program* p_program, const char* p_source, size_t p_sourceSize)
+	{
+		unsigned long long size = p_sourceSize;
+		unsigned long long hash = hashBytes(p_source, p_sourceSize);
+
+		Writer writer;
+		writer.writeBytes(c_magic, sizeof(c_magic));
+		writer.writeBytes(&c_version, sizeof(c_version));
+		writer.writeBytes(&size, sizeof(size));
+		writer.writeBytes(&hash, sizeof(hash));
+
+		// The hash of the nodes and strings, and the offset of the string table, are filled in once they are written
+		size_t payloadHashAt = writer.m_buffer.size();
+		unsigned long long payloadHash = 0;
+		writer.writeBytes(&payloadHash, sizeof(payloadHash));
+		size_t stringsOffsetAt = writer.m_buffer.size();
+		unsigned long long stringsOffset = 0;
+		writer.writeBytes(&stringsOffset, sizeof(stringsOffset));
+		size_t nodesOffset = writer.m_buffer.size();
+
+		writer.writeNode(p_program);
+		stringsOffset = writer.m_buffer.size();
+		memcpy(&writer.m_buffer[stringsOffsetAt], &stringsOffset, sizeof(stringsOffset));
+		writer.writeStrings();
+
+		payloadHash = hashBytes(writer.m_buffer.data() + nodesOffset, writer.m_buffer.size() - nodesOffset);
+		memcpy(&writer.m_buffer[payloadHashAt], &payloadHash, sizeof(payloadHash));
+		return writer.m_buffer;
+	}
+
+	std::shared_ptr<ast::Program> deserialize(const char* p_data, size_t p_size, const char* p_source, size_t p_sourceSize)
+	{
+		Reader header(p_data, p_size, p_source, p_sourceSize);
+
+		char magic[sizeof(c_magic)];
+		unsigned int version;
+		unsigned long long size;
+		unsigned long long hash;
+		unsigned long long payloadHash;
+		unsigned long long stringsOffset;
+		header.readBytes(magic, sizeof(magic));
+		header.readBytes(&version, sizeof(version));
+		header.readBytes(&size, sizeof(size));
+		header.readBytes(&hash, sizeof(hash));
+		header.readBytes(&payloadHash, sizeof(payloadHash));
+		header.readBytes(&stringsOffset, sizeof(stringsOffset));
+
+		// The version also tells apart caches written on machines of a different byte order
+		if (header.m_isDamaged || memcmp(magic, c_magic, sizeof(c_magic)) != 0 || version != c_version) return NULL;
+		if (size != p_sourceSize || hash != hashBytes(p_source, p_sourceSize)) return NULL;
+
+		// Damage the checks below would miss, such as a changed number or name, still changes the hash
+		size_t nodesOffset = sizeof(c_magic) + sizeof(version) + sizeof(size) + sizeof(hash) + sizeof(payloadHash) + sizeof(stringsOffset);
+		if (payloadHash != hashBytes(p_data + nodesOffset, p_size - nodesOffset)) return NULL;
+		if (stringsOffset < nodesOffset || stringsOffset > p_size) return NULL;
+
+		try
+		{
+			Reader reader(p_data + nodesOffset, (size_t)stringsOffset - nodesOffset, p_source, p_sourceSize);
+			reader.readStrings(p_data + stringsOffset, p_data + p_size);
+
+			std::shared_ptr<ast::Program> program = reader.readNode<ast::Program>(ast::PROGRAM_NODE);
+			if (reader.m_isDamaged || program == NULL || !reader.isAtEnd()) return NULL;
+			return program;
+		}
+		catch (const std::exception&)
+		{
+			// A lookup that fails on what was read is damage the checks did not foresee
+			return NULL;
+		}
+	}
+
+	std::string cachePath(const char* p_fileName, const char* p_source, size_t p_sourceSize)
+	{
+		const char* directory = getenv("LOTUS_CACHE_DIR");
+		if (directory == NULL || directory[0] == '\0')
+		{
+			return std::string(p_fileName) + c_extension;
+		}
+
+		std::ostringstream path;
+		path << directory << "/" << std::hex << hashBytes(p_source, p_sourceSize) << ".lotus" << c_extension;
+		return path.str();
+	}
+
+	std::shared_ptr<ast::Program> load(const char* p_fileName, const char* p_source, size_t p_sourceSize)
+	{
+		MappedFile file(cachePath(p_fileName, p_source, p_sourceSize).c_str());
+		if (!file.IsOpen()) return NULL;
+
+		return deserialize(file.m_data, file.m_size, p_source, p_sourceSize);
+	}
+
+	void store(const char* p_fileName, ast::Program* p_program, const char* p_source, size_t p_sourceSize)
+	{
+		std::string path = cachePath(p_fileName, p_source, p_sourceSize);
+		std::string temporaryPath = path + "." + std::to_string(getpid()) + ".tmp";
+		std::string data = serialize(p_program, p_source, p_sourceSize);
+
+		// Written beside the cache and then renamed over it, so other runs never read a cache that is half written.
+		// The temporary file is named after the process, so runs storing the same cache do not write into each other's.
+		std::ofstream file(temporaryPath.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+		if (!file.is_open()) return;
+		file.write(data.data(), data.size());
+		file.close();
+		if (file.fail())
+		{
+			std::remove(temporaryPath.c_str());
+			return;
+		}
+
+		if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+		{
+			// Renaming does not replace an existing file on every platform
+			std::remove(path.c_str());
+			if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) std::remove(temporaryPath.c_str());
+		}
+	}
+
+	MappedFile::MappedFile(const char* p_fileName)
+		: m_data(NULL)
+		, m_size(0)
+		, m_isMapped(false)
+	{
+#if CACHE_MMAP
+		int descriptor = open(p_fileName, O_RDONLY);
+		if (descriptor < 0) return;
+
+		struct stat status;
+		if (fstat(descriptor, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+		{
+			void* data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (data != MAP_FAILED)
+			{
+				m_data = (const char*)data;
+				m_size = (size_t)status.st_size;
+				m_isMapped = true;
+			}
+		}
+		close(descriptor);
+		if (m_isMapped) return;
+#endif
+		// Empty files and pipes cannot be mapped, and some platforms cannot map files at all
+		std::ifstream file(p_fileName, std::ios_base::in | std::ios_base::binary);
+		if (!file.is_open()) return;
+
+		std::stringstream buffer;
+		buffer << file.rdbuf();
+		m_buffer = buffer.str();
+		m_data = m_buffer.data();
+		m_size = m_buffer.size();
+	}
+
+	MappedFile::~MappedFile()
+	{
+#if CACHE_MMAP
+		if (m_isMapped) munmap((void*)m_data, m_size);
+#endif
+	}
+}
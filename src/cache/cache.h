@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "ast.h"
+
+namespace cache
+{
+	// Version of the cache format. Changed whenever a node or token is written differently, so that
+	// caches written by other versions of the interpreter are parsed again instead of misread.
+	const unsigned int c_version = 3;
+
+	// Extension added to a source file's name for its cache, as in myScript.lotusc
+	const std::string c_extension = "c";
+
+	// FNV-1a hash of a run of bytes. Tells whether a cache still matches its source, and whether its nodes and strings
+	// are still as they were written.
+	unsigned long long hashBytes(const char* p_bytes, size_t p_size);
+
+	// Writes a parsed program, a hash of its source and a hash of what was written into a compact binary form
+	std::string serialize(ast::Program* p_program, const char* p_source, size_t p_sourceSize);
+
+	// Reads a program written by serialize. Returns NULL if it was written for a different source, by a different
+	// version or is damaged.
+	std::shared_ptr<ast::Program> deserialize(const char* p_data, size_t p_size, const char* p_source, size_t p_sourceSize);
+
+	// Where the cache of a source file is kept. Caches go next to their source file, unless LOTUS_CACHE_DIR names a
+	// directory for them, in which case they are named by the hash of the source.
+	std::string cachePath(const char* p_fileName, const char* p_source, size_t p_sourceSize);
+
+	// Loads the cached program of a source file, or returns NULL if there is no cache for this source
+	std::shared_ptr<ast::Program> load(const char* p_fileName, const char* p_source, size_t p_sourceSize);
+
+	// Caches a program that parsed without errors. Failing to write the cache is not an error.
+	void store(const char* p_fileName, ast::Program* p_program, const char* p_source, size_t p_sourceSize);
+
+	// A whole file mapped into memory, or read into a buffer where files cannot be mapped, such as pipes
+	class MappedFile
+	{
+	public:
+		MappedFile(const char* p_fileName);
+		~MappedFile();
+
+		bool IsOpen() { return m_data != NULL; }
+
+		const char* m_data;
+		size_t m_size;
+	private:
+		bool m_isMapped;
+		std::string m_buffer;
+
+		MappedFile(const MappedFile&);
+		MappedFile& operator=(const MappedFile&);
+	};
+}
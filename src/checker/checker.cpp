@@ -0,0 +1,780 @@
+#include <sstream>
+
+#include "checker.h"
+
+namespace checker
+{
+	const std::map<object::ObjectType, token::TokenType> c_objectTypeToTypeToken =
+	{
+		{object::INTEGER, token::INTEGER_TYPE},
+		{object::FLOAT, token::FLOAT_TYPE},
+		{object::BOOLEAN, token::BOOLEAN_TYPE},
+		{object::CHARACTER, token::CHARACTER_TYPE},
+		{object::COLLECTION, token::COLLECTION_TYPE},
+		{object::DICTIONARY, token::DICTIONARY_TYPE},
+		{object::STRING, token::STRING_TYPE},
+	};
+
+	Type unknownType()
+	{
+		Type type;
+		type.m_isKnown = false;
+		type.m_objectType = object::NULL_TYPE;
+		type.m_isElementKnown = false;
+		type.m_keyType = object::NULL_TYPE;
+		type.m_valueType = object::NULL_TYPE;
+		type.m_function = NULL;
+		return type;
+	}
+
+	Type knownType(object::ObjectType p_objectType)
+	{
+		Type type = unknownType();
+		type.m_isKnown = true;
+		type.m_objectType = p_objectType;
+		return type;
+	}
+
+	// Type named by a type keyword such as 'integer'
+	Type typeOfToken(token::Token* p_typeToken)
+	{
+		if (object::c_nodeTypeToObjectType.count(p_typeToken->m_type) == 0) return unknownType();
+
+		object::ObjectType objectType = object::c_nodeTypeToObjectType.at(p_typeToken->m_type);
+		if (objectType == object::RETURN) return unknownType();
+
+		return knownType(objectType);
+	}
+
+	Checker::Checker()
+	{
+	}
+
+	bool Checker::CheckProgram(std::shared_ptr<ast::Program> p_program)
+	{
+		m_errors.clear();
+		m_scopes.clear();
+		m_functions.clear();
+
+		beginScope();
+		m_scopes.back().m_isGlobal = true;
+		collectTypes(&p_program->m_statements);
+
+		for (int i = 0; i < p_program->m_statements.size(); i++)
+		{
+			checkStatement(p_program->m_statements[i]);
+		}
+
+		endScope();
+		return m_errors.empty();
+	}
+
+	// STATEMENTS
+
+	void Checker::checkStatement(std::shared_ptr<ast::Statement> p_statement)
+	{
+		switch (p_statement->Type())
+		{
+		case ast::EXPRESSION_STATEMENT_NODE:
+			checkExpression(std::static_pointer_cast<ast::ExpressionStatement>(p_statement)->m_expression);
+			break;
+		case ast::BLOCK_STATEMENT_NODE:
+			checkBlock(std::static_pointer_cast<ast::BlockStatement>(p_statement));
+			break;
+		case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+			checkDeclareVariable(std::static_pointer_cast<ast::DeclareVariableStatement>(p_statement));
+			break;
+		case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+			checkDeclareCollection(std::static_pointer_cast<ast::DeclareCollectionStatement>(p_statement));
+			break;
+		case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+			checkDeclareDictionary(std::static_pointer_cast<ast::DeclareDictionaryStatement>(p_statement));
+			break;
+		case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+			checkDeclareFunction(std::static_pointer_cast<ast::DeclareFunctionStatement>(p_statement));
+			break;
+		case ast::RETURN_STATEMENT_NODE:
+			checkReturnStatement(std::static_pointer_cast<ast::ReturnStatement>(p_statement));
+			break;
+		case ast::IF_STATEMENT_NODE:
+			checkIfStatement(std::static_pointer_cast<ast::IfStatement>(p_statement));
+			break;
+		case ast::WHILE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::WhileStatement> whileStatement = std::static_pointer_cast<ast::WhileStatement>(p_statement);
+			checkExpression(whileStatement->m_condition);
+			beginScope();
+			checkBlock(whileStatement->m_consequence);
+			endScope();
+			break;
+		}
+		case ast::DO_WHILE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DoWhileStatement> doWhileStatement = std::static_pointer_cast<ast::DoWhileStatement>(p_statement);
+			beginScope();
+			checkBlock(doWhileStatement->m_consequence);
+			endScope();
+			checkExpression(doWhileStatement->m_condition);
+			break;
+		}
+		case ast::FOR_STATEMENT_NODE:
+			checkForStatement(std::static_pointer_cast<ast::ForStatement>(p_statement));
+			break;
+		case ast::ITERATE_STATEMENT_NODE:
+			checkIterateStatement(std::static_pointer_cast<ast::IterateStatement>(p_statement));
+			break;
+		default:
+			break;
+		}
+	}
+
+	void Checker::checkBlock(std::shared_ptr<ast::BlockStatement> p_block)
+	{
+		if (p_block == NULL) return;
+
+		collectTypes(&p_block->m_statements);
+
+		for (int i = 0; i < p_block->m_statements.size(); i++)
+		{
+			checkStatement(p_block->m_statements[i]);
+		}
+	}
+
+	void Checker::checkDeclareVariable(std::shared_ptr<ast::DeclareVariableStatement> p_declareVariable)
+	{
+		Type value = p_declareVariable->m_value == NULL ? knownType(object::NULL_TYPE) : checkExpression(p_declareVariable->m_value);
+		Type declared = typeOfToken(&p_declareVariable->m_token);
+
+		if (value.m_isKnown && declared.m_isKnown)
+		{
+			if (value.m_objectType != declared.m_objectType)
+			{
+				std::ostringstream error;
+				error << "'" << p_declareVariable->m_name.m_name
+					<< "' is defined as type '" << p_declareVariable->m_token.m_literal
+					<< "', not '" << object::c_objectTypeToString.at(value.m_objectType) << "'.";
+				this->error(error.str());
+			}
+			else
+			{
+				p_declareVariable->m_isTypeChecked = true;
+			}
+		}
+
+		declare(&p_declareVariable->m_name.m_name);
+	}
+
+	void Checker::checkDeclareCollection(std::shared_ptr<ast::DeclareCollectionStatement> p_declareCollection)
+	{
+		Type value = p_declareCollection->m_value == NULL ? knownType(object::NULL_TYPE) : checkExpression(p_declareCollection->m_value);
+		Type elementType = typeOfToken(&p_declareCollection->m_typeToken);
+
+		if (value.m_isKnown && value.m_objectType != object::COLLECTION)
+		{
+			std::ostringstream error;
+			error << "'" << p_declareCollection->m_name.m_name
+				<< "' is defined as type '" << p_declareCollection->m_token.m_literal
+				<< "', not '" << object::c_objectTypeToString.at(value.m_objectType) << "'.";
+			this->error(error.str());
+		}
+		else if (value.m_isKnown && value.m_isElementKnown && elementType.m_isKnown)
+		{
+			if (value.m_valueType != object::NULL_TYPE && value.m_valueType != elementType.m_objectType)
+			{
+				std::ostringstream error;
+				error << "'" << p_declareCollection->m_name.m_name
+					<< "' is a collection of '" << p_declareCollection->m_typeToken.m_literal
+					<< "'s, but got a collection of type '" << object::c_objectTypeToString.at(value.m_valueType) << "'s.";
+				this->error(error.str());
+			}
+			else
+			{
+				p_declareCollection->m_isTypeChecked = true;
+			}
+		}
+
+		declare(&p_declareCollection->m_name.m_name);
+	}
+
+	void Checker::checkDeclareDictionary(std::shared_ptr<ast::DeclareDictionaryStatement> p_declareDictionary)
+	{
+		Type value = p_declareDictionary->m_value == NULL ? knownType(object::NULL_TYPE) : checkExpression(p_declareDictionary->m_value);
+		Type keyType = typeOfToken(&p_declareDictionary->m_keyTypeToken);
+		Type valueType = typeOfToken(&p_declareDictionary->m_valueTypeToken);
+
+		if (value.m_isKnown && value.m_objectType != object::DICTIONARY)
+		{
+			std::ostringstream error;
+			error << "'" << p_declareDictionary->m_name.m_name
+				<< "' is defined as type '" << p_declareDictionary->m_token.m_literal
+				<< "', not '" << object::c_objectTypeToString.at(value.m_objectType) << "'.";
+			this->error(error.str());
+		}
+		else if (value.m_isKnown && value.m_isElementKnown && keyType.m_isKnown && valueType.m_isKnown)
+		{
+			if (value.m_keyType != object::NULL_TYPE &&
+				(value.m_keyType != keyType.m_objectType || value.m_valueType != valueType.m_objectType))
+			{
+				std::ostringstream error;
+				error << "'" << p_declareDictionary->m_name.m_name
+					<< "' is a dictionary of <" << p_declareDictionary->m_keyTypeToken.m_literal << ", " << p_declareDictionary->m_valueTypeToken.m_literal
+					<< "> pairs, but got a dictionary of type <"
+					<< object::c_objectTypeToString.at(value.m_keyType) << ", " << object::c_objectTypeToString.at(value.m_valueType) << "> pairs.";
+				this->error(error.str());
+			}
+			else
+			{
+				p_declareDictionary->m_isTypeChecked = true;
+			}
+		}
+
+		declare(&p_declareDictionary->m_name.m_name);
+	}
+
+	void Checker::checkDeclareFunction(std::shared_ptr<ast::DeclareFunctionStatement> p_declareFunction)
+	{
+		declare(&p_declareFunction->m_name.m_name);
+
+		// A body skipped by a lazy parser is left to the checks the evaluator makes as it runs
+		if (p_declareFunction->m_body->m_body == NULL) return;
+
+		FunctionState function;
+		function.m_declaration = p_declareFunction.get();
+		function.m_isReturnChecked = typeOfToken(&p_declareFunction->m_token).m_isKnown;
+		m_functions.push_back(function);
+
+		beginScope(true);
+		for (int i = 0; i < p_declareFunction->m_parameters.size(); i++)
+		{
+			std::shared_ptr<ast::DeclareVariableStatement> parameter = p_declareFunction->m_parameters[i];
+			if (parameter == NULL) continue;
+
+			addType(&parameter->m_name.m_name, typeOfToken(&parameter->m_token));
+			declare(&parameter->m_name.m_name);
+		}
+		checkBlock(p_declareFunction->m_body->m_body);
+		endScope();
+
+		p_declareFunction->m_isTypeChecked = m_functions.back().m_isReturnChecked;
+		m_functions.pop_back();
+	}
+
+	void Checker::checkReturnStatement(std::shared_ptr<ast::ReturnStatement> p_returnStatement)
+	{
+		Type value = checkExpression(p_returnStatement->m_returnValue);
+		if (m_functions.empty()) return;
+
+		FunctionState* function = &m_functions.back();
+		Type functionType = typeOfToken(&function->m_declaration->m_token);
+
+		// Functions that return nothing are reported when they are called
+		if (!value.m_isKnown || !functionType.m_isKnown || value.m_objectType == object::NULL_TYPE)
+		{
+			function->m_isReturnChecked = false;
+			return;
+		}
+
+		if (value.m_objectType != functionType.m_objectType)
+		{
+			std::ostringstream error;
+			error << "'" << function->m_declaration->m_name.m_name << "' returns a value of type '"
+				<< object::c_objectTypeToString.at(value.m_objectType) << "' instead of type '"
+				<< object::c_objectTypeToString.at(functionType.m_objectType) << "'.";
+			this->error(error.str());
+		}
+	}
+
+	void Checker::checkIfStatement(std::shared_ptr<ast::IfStatement> p_ifStatement)
+	{
+		if (p_ifStatement->m_condition == NULL)
+		{
+			beginScope();
+			checkBlock(p_ifStatement->m_consequence);
+			endScope();
+			return;
+		}
+
+		checkExpression(p_ifStatement->m_condition);
+
+		beginScope();
+		checkBlock(p_ifStatement->m_consequence);
+		endScope();
+
+		if (p_ifStatement->m_alternative != NULL)
+		{
+			beginScope();
+			checkIfStatement(p_ifStatement->m_alternative);
+			endScope();
+		}
+	}
+
+	void Checker::checkForStatement(std::shared_ptr<ast::ForStatement> p_forStatement)
+	{
+		beginScope();
+
+		std::vector<std::shared_ptr<ast::Statement>> header;
+		if (p_forStatement->m_initialization != NULL) header.push_back(p_forStatement->m_initialization);
+		if (p_forStatement->m_condition != NULL) header.push_back(p_forStatement->m_condition);
+		if (p_forStatement->m_updation != NULL) header.push_back(p_forStatement->m_updation);
+		collectTypes(&header);
+
+		if (p_forStatement->m_initialization != NULL) checkStatement(p_forStatement->m_initialization);
+		if (p_forStatement->m_condition != NULL) checkStatement(p_forStatement->m_condition);
+		if (p_forStatement->m_updation != NULL) checkStatement(p_forStatement->m_updation);
+
+		beginScope();
+		checkBlock(p_forStatement->m_consequence);
+		endScope();
+
+		endScope();
+	}
+
+	void Checker::checkIterateStatement(std::shared_ptr<ast::IterateStatement> p_iterateStatement)
+	{
+		Type collection = checkExpression(p_iterateStatement->m_collection);
+
+		Type variable = unknownType();
+		if (collection.m_isKnown && collection.m_objectType == object::STRING)
+		{
+			variable = knownType(object::CHARACTER);
+		}
+		else if (collection.m_isKnown && collection.m_isElementKnown && collection.m_objectType == object::COLLECTION && collection.m_valueType != object::NULL_TYPE)
+		{
+			variable = knownType(collection.m_valueType);
+		}
+		else if (collection.m_isKnown && collection.m_isElementKnown && collection.m_objectType == object::DICTIONARY && collection.m_keyType != object::NULL_TYPE)
+		{
+			variable = knownType(collection.m_keyType);
+		}
+
+		beginScope();
+		addType(&p_iterateStatement->m_var->m_name, variable);
+		declare(&p_iterateStatement->m_var->m_name);
+		checkBlock(p_iterateStatement->m_consequence);
+		endScope();
+	}
+
+	// EXPRESSIONS
+
+	Type Checker::checkExpression(std::shared_ptr<ast::Expression> p_expression)
+	{
+		if (p_expression == NULL) return unknownType();
+
+		Type type = unknownType();
+		switch (p_expression->Type())
+		{
+		case ast::IDENTIFIER_NODE:
+			type = lookup(&std::static_pointer_cast<ast::Identifier>(p_expression)->m_name);
+			break;
+		case ast::INTEGER_LITERAL_NODE:
+			type = knownType(object::INTEGER);
+			break;
+		case ast::FLOAT_LITERAL_NODE:
+			type = knownType(object::FLOAT);
+			break;
+		case ast::BOOLEAN_LITERAL_NODE:
+			type = knownType(object::BOOLEAN);
+			break;
+		case ast::CHARACTER_LITERAL_NODE:
+			type = knownType(object::CHARACTER);
+			break;
+		case ast::STRING_LITERAL_NODE:
+			type = knownType(object::STRING);
+			break;
+		case ast::COLLECTION_LITERAL_NODE:
+			type = checkCollectionLiteral(std::static_pointer_cast<ast::CollectionLiteral>(p_expression));
+			break;
+		case ast::DICTIONARY_LITERAL_NODE:
+			type = checkDictionaryLiteral(std::static_pointer_cast<ast::DictionaryLiteral>(p_expression));
+			break;
+		case ast::PREFIX_EXPRESSION_NODE:
+			type = checkPrefixExpression(std::static_pointer_cast<ast::PrefixExpression>(p_expression));
+			break;
+		case ast::POSTFIX_EXPRESSION_NODE:
+		{
+			// Only ++ and -- are postfix operators, and they work on integers
+			Type operand = checkExpression(std::static_pointer_cast<ast::PostfixExpression>(p_expression)->m_leftExpression);
+			if (operand.m_isKnown && operand.m_objectType == object::INTEGER) type = knownType(object::INTEGER);
+			break;
+		}
+		case ast::INFIX_EXPRESSION_NODE:
+			type = checkInfixExpression(std::static_pointer_cast<ast::InfixExpression>(p_expression));
+			break;
+		case ast::CALL_EXPRESSION_NODE:
+			type = checkCallExpression(std::static_pointer_cast<ast::CallExpression>(p_expression));
+			break;
+		case ast::INDEX_EXPRESSION_NODE:
+			type = checkIndexExpression(std::static_pointer_cast<ast::IndexExpression>(p_expression));
+			break;
+		default:
+			break;
+		}
+
+		if (type.m_isKnown && c_objectTypeToTypeToken.count(type.m_objectType) > 0)
+		{
+			p_expression->m_resolvedType = c_objectTypeToTypeToken.at(type.m_objectType);
+		}
+
+		return type;
+	}
+
+	Type Checker::checkCollectionLiteral(std::shared_ptr<ast::CollectionLiteral> p_collectionLiteral)
+	{
+		Type type = knownType(object::COLLECTION);
+		type.m_isElementKnown = true;
+
+		// Mixed elements are left for the evaluator to report
+		for (int i = 0; i < p_collectionLiteral->m_values.size(); i++)
+		{
+			Type element = checkExpression(p_collectionLiteral->m_values[i]);
+			if (!element.m_isKnown || (i > 0 && element.m_objectType != type.m_valueType))
+			{
+				type.m_isElementKnown = false;
+			}
+			type.m_valueType = element.m_objectType;
+		}
+
+		if (!type.m_isElementKnown) type.m_valueType = object::NULL_TYPE;
+		return type;
+	}
+
+	Type Checker::checkDictionaryLiteral(std::shared_ptr<ast::DictionaryLiteral> p_dictionaryLiteral)
+	{
+		Type type = knownType(object::DICTIONARY);
+		type.m_isElementKnown = true;
+
+		bool isFirst = true;
+		for (auto it = p_dictionaryLiteral->m_map.begin(); it != p_dictionaryLiteral->m_map.end(); it++)
+		{
+			Type key = checkExpression(it->first);
+			Type value = checkExpression(it->second);
+			if (!key.m_isKnown || !value.m_isKnown ||
+				(!isFirst && (key.m_objectType != type.m_keyType || value.m_objectType != type.m_valueType)))
+			{
+				type.m_isElementKnown = false;
+			}
+			type.m_keyType = key.m_objectType;
+			type.m_valueType = value.m_objectType;
+			isFirst = false;
+		}
+
+		if (!type.m_isElementKnown)
+		{
+			type.m_keyType = object::NULL_TYPE;
+			type.m_valueType = object::NULL_TYPE;
+		}
+		return type;
+	}
+
+	Type Checker::checkPrefixExpression(std::shared_ptr<ast::PrefixExpression> p_prefixExpression)
+	{
+		Type operand = checkExpression(p_prefixExpression->m_rightExpression);
+		if (!operand.m_isKnown) return unknownType();
+
+		if (p_prefixExpression->m_operator == "++" || p_prefixExpression->m_operator == "--")
+		{
+			if (operand.m_objectType == object::INTEGER) return knownType(object::INTEGER);
+		}
+		else if (p_prefixExpression->m_operator == "!")
+		{
+			if (operand.m_objectType == object::INTEGER || operand.m_objectType == object::FLOAT || operand.m_objectType == object::BOOLEAN)
+			{
+				return knownType(object::BOOLEAN);
+			}
+		}
+		else if (p_prefixExpression->m_operator == "-")
+		{
+			if (operand.m_objectType == object::INTEGER || operand.m_objectType == object::FLOAT) return knownType(operand.m_objectType);
+		}
+
+		return unknownType();
+	}
+
+	Type Checker::checkInfixExpression(std::shared_ptr<ast::InfixExpression> p_infixExpression)
+	{
+		std::string* infixOperator = &p_infixExpression->m_operator;
+		if (*infixOperator == "=" || *infixOperator == "+=" || *infixOperator == "-=" ||
+			*infixOperator == "*=" || *infixOperator == "/=" || *infixOperator == "%=")
+		{
+			return checkAssignment(p_infixExpression);
+		}
+
+		// Member names are not variables, and member functions are checked when they run
+		if (*infixOperator == ".")
+		{
+			checkExpression(p_infixExpression->m_leftExpression);
+			return unknownType();
+		}
+
+		Type left = checkExpression(p_infixExpression->m_leftExpression);
+		Type right = checkExpression(p_infixExpression->m_rightExpression);
+		return infixType(left, infixOperator, right);
+	}
+
+	Type Checker::checkAssignment(std::shared_ptr<ast::InfixExpression> p_infixExpression)
+	{
+		Type target = checkExpression(p_infixExpression->m_leftExpression);
+		Type value = checkExpression(p_infixExpression->m_rightExpression);
+
+		// Elements of collections and dictionaries are checked by the evaluator
+		if (p_infixExpression->m_leftExpression->Type() != ast::IDENTIFIER_NODE) return unknownType();
+
+		if (p_infixExpression->m_operator != "=")
+		{
+			std::string infixOperator = p_infixExpression->m_operator.substr(0, 1);
+			value = infixType(target, &infixOperator, value);
+		}
+
+		if (!target.m_isKnown || !value.m_isKnown) return unknownType();
+
+		std::string* name = &std::static_pointer_cast<ast::Identifier>(p_infixExpression->m_leftExpression)->m_name;
+		if (target.m_objectType != value.m_objectType)
+		{
+			std::ostringstream error;
+			error << "Cannot assign '" << *name << "' of type '"
+				<< object::c_objectTypeToString.at(target.m_objectType) << "' a value of type '"
+				<< object::c_objectTypeToString.at(value.m_objectType) << "'.";
+			this->error(error.str());
+		}
+		else if (target.m_objectType == object::FUNCTION && target.m_function != value.m_function)
+		{
+			// Calls are checked against the declaration, so a function can only be replaced by one with the same signature
+			bool isSameSignature = target.m_function != NULL && value.m_function != NULL &&
+				target.m_function->m_token.m_type == value.m_function->m_token.m_type &&
+				target.m_function->m_parameters.size() == value.m_function->m_parameters.size();
+			for (int i = 0; isSameSignature && i < target.m_function->m_parameters.size(); i++)
+			{
+				isSameSignature = target.m_function->m_parameters[i] != NULL && value.m_function->m_parameters[i] != NULL &&
+					target.m_function->m_parameters[i]->m_token.m_type == value.m_function->m_parameters[i]->m_token.m_type;
+			}
+
+			if (!isSameSignature)
+			{
+				std::ostringstream error;
+				error << "Cannot assign '" << *name << "' a function with a different signature.";
+				this->error(error.str());
+			}
+			else
+			{
+				p_infixExpression->m_isTypeChecked = true;
+			}
+		}
+		else
+		{
+			p_infixExpression->m_isTypeChecked = true;
+		}
+
+		return unknownType();
+	}
+
+	Type Checker::checkCallExpression(std::shared_ptr<ast::CallExpression> p_callExpression)
+	{
+		Type function = checkExpression(p_callExpression->m_function);
+
+		std::vector<Type> arguments;
+		for (int i = 0; i < p_callExpression->m_parameters.size(); i++)
+		{
+			arguments.push_back(checkExpression(p_callExpression->m_parameters[i]));
+		}
+
+		// Builtin functions check their own arguments
+		if (!function.m_isKnown || function.m_objectType != object::FUNCTION || function.m_function == NULL) return unknownType();
+
+		ast::DeclareFunctionStatement* declaration = function.m_function;
+		if (arguments.size() != declaration->m_parameters.size())
+		{
+			std::ostringstream error;
+			error << "'" << declaration->m_name.String() << "' was supplied with "
+				<< arguments.size() << " argument(s) instead of "
+				<< declaration->m_parameters.size() << ".";
+			this->error(error.str());
+			return typeOfToken(&declaration->m_token);
+		}
+
+		bool isTypeChecked = true;
+		for (int i = 0; i < arguments.size(); i++)
+		{
+			Type parameter = declaration->m_parameters[i] == NULL ? unknownType() : typeOfToken(&declaration->m_parameters[i]->m_token);
+			if (!arguments[i].m_isKnown || !parameter.m_isKnown)
+			{
+				isTypeChecked = false;
+			}
+			else if (arguments[i].m_objectType != parameter.m_objectType)
+			{
+				std::ostringstream error;
+				error << "Parameter '" << declaration->m_parameters[i]->m_name.m_name << "' was supplied with a value of type '"
+					<< object::c_objectTypeToString.at(arguments[i].m_objectType) << "' instead of type '"
+					<< declaration->m_parameters[i]->m_token.m_literal << "' for the function call for '"
+					<< declaration->m_name.String() << "'.";
+				this->error(error.str());
+				isTypeChecked = false;
+			}
+		}
+		p_callExpression->m_isTypeChecked = isTypeChecked;
+
+		// The evaluator makes sure the function returns its type, if the checker could not
+		return typeOfToken(&declaration->m_token);
+	}
+
+	Type Checker::checkIndexExpression(std::shared_ptr<ast::IndexExpression> p_indexExpression)
+	{
+		Type collection = checkExpression(p_indexExpression->m_collection);
+		checkExpression(p_indexExpression->m_index);
+
+		if (!collection.m_isKnown) return unknownType();
+
+		if (collection.m_objectType == object::STRING) return knownType(object::CHARACTER);
+
+		if ((collection.m_objectType == object::COLLECTION || collection.m_objectType == object::DICTIONARY) &&
+			collection.m_isElementKnown && collection.m_valueType != object::NULL_TYPE)
+		{
+			return knownType(collection.m_valueType);
+		}
+
+		return unknownType();
+	}
+
+	// HELPERS
+
+	void Checker::beginScope(bool p_isFunction)
+	{
+		Scope scope;
+		scope.m_isFunction = p_isFunction;
+		scope.m_isGlobal = false;
+		m_scopes.push_back(scope);
+	}
+
+	void Checker::endScope()
+	{
+		m_scopes.pop_back();
+	}
+
+	void Checker::collectTypes(std::vector<std::shared_ptr<ast::Statement>>* p_statements)
+	{
+		for (int i = 0; i < p_statements->size(); i++)
+		{
+			std::shared_ptr<ast::Statement> statement = (*p_statements)[i];
+			switch (statement->Type())
+			{
+			case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+			{
+				std::shared_ptr<ast::DeclareVariableStatement> declaration = std::static_pointer_cast<ast::DeclareVariableStatement>(statement);
+				addType(&declaration->m_name.m_name, typeOfToken(&declaration->m_token));
+				break;
+			}
+			case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+			{
+				std::shared_ptr<ast::DeclareCollectionStatement> declaration = std::static_pointer_cast<ast::DeclareCollectionStatement>(statement);
+				Type type = knownType(object::COLLECTION);
+				Type elementType = typeOfToken(&declaration->m_typeToken);
+				type.m_isElementKnown = elementType.m_isKnown;
+				type.m_valueType = elementType.m_objectType;
+				addType(&declaration->m_name.m_name, type);
+				break;
+			}
+			case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+			{
+				std::shared_ptr<ast::DeclareDictionaryStatement> declaration = std::static_pointer_cast<ast::DeclareDictionaryStatement>(statement);
+				Type type = knownType(object::DICTIONARY);
+				Type keyType = typeOfToken(&declaration->m_keyTypeToken);
+				Type valueType = typeOfToken(&declaration->m_valueTypeToken);
+				type.m_isElementKnown = keyType.m_isKnown && valueType.m_isKnown;
+				type.m_keyType = keyType.m_objectType;
+				type.m_valueType = valueType.m_objectType;
+				addType(&declaration->m_name.m_name, type);
+				break;
+			}
+			case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+			{
+				std::shared_ptr<ast::DeclareFunctionStatement> declaration = std::static_pointer_cast<ast::DeclareFunctionStatement>(statement);
+				Type type = typeOfToken(&declaration->m_token).m_isKnown ? knownType(object::FUNCTION) : unknownType();
+				type.m_function = declaration.get();
+				addType(&declaration->m_name.m_name, type);
+				break;
+			}
+			case ast::BLOCK_STATEMENT_NODE:
+				collectTypes(&std::static_pointer_cast<ast::BlockStatement>(statement)->m_statements);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	void Checker::addType(std::string* p_name, Type p_type)
+	{
+		// A second declaration in the same scope is a redefinition, which the evaluator reports
+		std::map<std::string, Type>* types = &m_scopes.back().m_types;
+		if (types->count(*p_name) == 0)
+		{
+			(*types)[*p_name] = p_type;
+		}
+	}
+
+	void Checker::declare(std::string* p_name)
+	{
+		m_scopes.back().m_declared.insert(*p_name);
+	}
+
+	Type Checker::lookup(std::string* p_name)
+	{
+		// Follows the resolver. Inside a function, names not declared yet are looked up further out.
+		// A nested function may run after a later declaration, so its type is only certain for names
+		// already declared, or for globals which can only be declared once.
+		bool isNested = false;
+		for (int i = m_scopes.size() - 1; i >= 0; i--)
+		{
+			Scope* scope = &m_scopes[i];
+			auto it = scope->m_types.find(*p_name);
+			if (it != scope->m_types.end())
+			{
+				if (scope->m_declared.count(*p_name) > 0 || (isNested && scope->m_isGlobal)) return it->second;
+				if (isNested) return unknownType();
+			}
+
+			if (scope->m_isFunction)
+			{
+				isNested = true;
+			}
+		}
+
+		return unknownType();
+	}
+
+	Type Checker::infixType(Type p_left, std::string* p_operator, Type p_right)
+	{
+		if (!p_left.m_isKnown || !p_right.m_isKnown) return unknownType();
+
+		object::ObjectType left = p_left.m_objectType;
+		object::ObjectType right = p_right.m_objectType;
+		bool isComparison = *p_operator == "<" || *p_operator == "<=" || *p_operator == ">" || *p_operator == ">=";
+		bool isEquality = *p_operator == "==" || *p_operator == "!=";
+		bool isArithmetic = *p_operator == "+" || *p_operator == "-" || *p_operator == "*" || *p_operator == "/";
+
+		if (left == object::INTEGER && right == object::INTEGER)
+		{
+			if (isArithmetic || *p_operator == "%") return knownType(object::INTEGER);
+			if (isComparison || isEquality) return knownType(object::BOOLEAN);
+		}
+		else if ((left == object::INTEGER || left == object::FLOAT) && (right == object::INTEGER || right == object::FLOAT))
+		{
+			if (isArithmetic) return knownType(object::FLOAT);
+			if (isComparison || isEquality) return knownType(object::BOOLEAN);
+		}
+		else if (left == object::BOOLEAN && right == object::BOOLEAN)
+		{
+			if (*p_operator == "&&" || *p_operator == "||" || isEquality) return knownType(object::BOOLEAN);
+		}
+		else if (left == object::CHARACTER && right == object::CHARACTER)
+		{
+			if (isEquality) return knownType(object::BOOLEAN);
+		}
+
+		return unknownType();
+	}
+
+	void Checker::error(std::string p_errorMessage)
+	{
+		m_errors.push_back(p_errorMessage);
+	}
+}
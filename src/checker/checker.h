@@ -0,0 +1,93 @@
+#pragma once
+
+#include <map>
+#include <set>
+
+#include "ast.h"
+#include "object.h"
+
+namespace checker
+{
+	// Type of an expression as far as it can be known before running the program
+	typedef struct Type
+	{
+		bool m_isKnown;
+		object::ObjectType m_objectType;
+		bool m_isElementKnown;                          // Whether the key and value types of a collection or dictionary are known
+		object::ObjectType m_keyType;                   // NULL_TYPE for an empty literal, which takes the declared types
+		object::ObjectType m_valueType;                 // Also the element type of a collection
+		ast::DeclareFunctionStatement* m_function;      // Declaration of a function
+	} Type;
+
+	// Finds type errors before a program runs. Every declaration, assignment and call that is proven
+	// to be well typed is marked, so the evaluator can skip checking it again each time it runs.
+	class Checker
+	{
+	public:
+		Checker();
+
+		std::vector<std::string> m_errors;
+
+		// Checks a program that has been through the resolver. Returns false if a type error was found.
+		bool CheckProgram(std::shared_ptr<ast::Program> p_program);
+	private:
+		typedef struct Scope
+		{
+			std::map<std::string, Type> m_types;        // Declared type of every name declared directly in the scope
+			std::set<std::string> m_declared;           // Names whose declaration has been checked so far
+			bool m_isFunction;                          // Outermost scope of a function body
+			bool m_isGlobal;
+		} Scope;
+
+		typedef struct FunctionState
+		{
+			ast::DeclareFunctionStatement* m_declaration;
+			bool m_isReturnChecked;                     // Every return statement so far returns the function type
+		} FunctionState;
+
+		std::vector<Scope> m_scopes;
+		std::vector<FunctionState> m_functions;         // Functions being checked, innermost last
+
+		// STATEMENTS
+
+		void checkStatement(std::shared_ptr<ast::Statement> p_statement);
+		void checkBlock(std::shared_ptr<ast::BlockStatement> p_block);
+		void checkDeclareVariable(std::shared_ptr<ast::DeclareVariableStatement> p_declareVariable);
+		void checkDeclareCollection(std::shared_ptr<ast::DeclareCollectionStatement> p_declareCollection);
+		void checkDeclareDictionary(std::shared_ptr<ast::DeclareDictionaryStatement> p_declareDictionary);
+		void checkDeclareFunction(std::shared_ptr<ast::DeclareFunctionStatement> p_declareFunction);
+		void checkReturnStatement(std::shared_ptr<ast::ReturnStatement> p_returnStatement);
+		void checkIfStatement(std::shared_ptr<ast::IfStatement> p_ifStatement);
+		void checkForStatement(std::shared_ptr<ast::ForStatement> p_forStatement);
+		void checkIterateStatement(std::shared_ptr<ast::IterateStatement> p_iterateStatement);
+
+		// EXPRESSIONS
+
+		// Finds the type of an expression and records it in the node
+		Type checkExpression(std::shared_ptr<ast::Expression> p_expression);
+		Type checkCollectionLiteral(std::shared_ptr<ast::CollectionLiteral> p_collectionLiteral);
+		Type checkDictionaryLiteral(std::shared_ptr<ast::DictionaryLiteral> p_dictionaryLiteral);
+		Type checkPrefixExpression(std::shared_ptr<ast::PrefixExpression> p_prefixExpression);
+		Type checkInfixExpression(std::shared_ptr<ast::InfixExpression> p_infixExpression);
+		Type checkAssignment(std::shared_ptr<ast::InfixExpression> p_infixExpression);
+		Type checkCallExpression(std::shared_ptr<ast::CallExpression> p_callExpression);
+		Type checkIndexExpression(std::shared_ptr<ast::IndexExpression> p_indexExpression);
+
+		// HELPERS
+
+		void beginScope(bool p_isFunction = false);
+		void endScope();
+
+		// Records the declared type of every name declared directly in these statements
+		void collectTypes(std::vector<std::shared_ptr<ast::Statement>>* p_statements);
+		void addType(std::string* p_name, Type p_type);
+
+		void declare(std::string* p_name);
+		Type lookup(std::string* p_name);
+
+		// Type of the result of an infix operator, following the evaluator's rules
+		Type infixType(Type p_left, std::string* p_operator, Type p_right);
+
+		void error(std::string p_errorMessage);
+	};
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ast.h"
+#include "object.h"
+
+namespace compiler
+{
+	// Operands are named a, b and c. R[x] is register x of the current frame, K[x] is constant x,
+	// N[x] is name x, S[x] is string x and L[x] is literal x of the current prototype.
+	enum OpCode : uint8_t
+	{
+		OP_LOAD_CONSTANT,          // R[a] = K[b]
+		OP_LOAD_NULL,              // R[a] = null
+		OP_MOVE,                   // R[a] = R[b]
+
+		OP_GET_GLOBAL,             // R[a] = N[b], falling back to builtins
+		OP_GET_ASSIGNABLE_GLOBAL,  // R[a] = N[b], without falling back to builtins
+		OP_SET_GLOBAL,             // N[b] = R[a], in whichever environment N[b] was defined
+		OP_DEFINE_GLOBAL,          // N[b] = R[a], in the global environment
+		OP_CHECK_REDEFINITION,     // Errors if N[b] is already defined in the global environment
+
+		OP_CHECK_ASSIGNMENT,       // Errors if R[a] and R[b] differ in type, naming N[c] in the error
+		OP_CHECK_DECLARATION,      // Errors if R[a] is not of the type declared by declaration b
+		OP_ERROR,                  // Errors with message S[b]
+
+		OP_NEW_COLLECTION,         // R[a] = []
+		OP_COLLECTION_PUSH,        // R[a].append(R[b]), naming collection literal L[c] on a type mismatch
+		OP_NEW_DICTIONARY,         // R[a] = {}
+		OP_DICTIONARY_CHECK_KEY,   // Checks that R[b] can be used as a new key of R[a]
+		OP_DICTIONARY_INSERT,      // R[a][R[b]] = R[c], for dictionary literals
+
+		OP_ADD,                    // R[a] = R[b] + R[c]
+		OP_SUBTRACT,               // R[a] = R[b] - R[c]
+		OP_MULTIPLY,               // R[a] = R[b] * R[c]
+		OP_DIVIDE,                 // R[a] = R[b] / R[c]
+		OP_MODULO,                 // R[a] = R[b] % R[c]
+		OP_LESS,                   // R[a] = R[b] < R[c]
+		OP_LESS_EQUAL,             // R[a] = R[b] <= R[c]
+		OP_GREATER,                // R[a] = R[b] > R[c]
+		OP_GREATER_EQUAL,          // R[a] = R[b] >= R[c]
+		OP_EQUAL,                  // R[a] = R[b] == R[c]
+		OP_NOT_EQUAL,              // R[a] = R[b] != R[c]
+		OP_AND,                    // R[a] = R[b] && R[c]
+		OP_OR,                     // R[a] = R[b] || R[c]
+		OP_UNSUPPORTED_INFIX,      // Errors for the infix operator S[a] applied to R[b] and R[c]
+		OP_NOT,                    // R[a] = !R[b]
+		OP_NEGATE,                 // R[a] = -R[b]
+		OP_INCREMENT,              // R[a] = R[b] +/- 1, flags in c (see IncrementFlags)
+
+		OP_GET_INDEX,              // R[a] = R[b][R[c]]
+		OP_SET_INDEX,              // R[a][R[b]] = R[c], with the checks of an assignment
+		OP_STORE_INDEX,            // R[a][R[b]] = R[c], for already validated indices
+		OP_GET_MEMBER,             // R[a] = R[b].M[c]
+
+		OP_FUNCTION,               // R[a] = function described by prototype b
+		OP_CALL,                   // R[a] = R[b](R[b + 1], ...), described by call site c
+		OP_CALL_METHOD,            // R[a] = R[b].M(R[b + 1], ...), where call site c names the member M
+
+		OP_JUMP,                   // Jumps to instruction b
+		OP_JUMP_IF_FALSE,          // Jumps to instruction b if R[a] is not truthy
+		OP_ITERATE_PREPARE,        // R[a] = iterable form of R[b], R[a + 1] = 0
+		OP_ITERATE_NEXT,           // R[a] = next item of R[b] using counter R[b + 1], or jumps to instruction c
+		OP_RETURN,                 // Returns R[a]
+	};
+
+	enum IncrementFlags
+	{
+		INCREMENT_DECREMENT = 1,   // -- instead of ++
+		INCREMENT_POSTFIX = 2,     // x++ instead of ++x
+		INCREMENT_UNASSIGNABLE = 4 // operand is neither an identifier nor an index expression
+	};
+
+	struct Instruction
+	{
+		OpCode m_opCode;
+		int m_a;
+		int m_b;
+		int m_c;
+	};
+
+	// Information needed to call a function and to report errors about the call
+	struct CallSite
+	{
+		int m_argumentCount;
+		std::shared_ptr<ast::CallExpression> m_expression;
+		std::shared_ptr<ast::Identifier> m_methodName;  // NULL unless the call is a method call
+	};
+
+	// Information needed to check a declaration and to report errors about it
+	struct Declaration
+	{
+		std::string m_name;
+		token::Token m_token;
+		object::ObjectType m_type;
+		token::Token m_keyTypeToken;    // Collection element type or dictionary key type
+		object::ObjectType m_keyType;
+		token::Token m_valueTypeToken;  // Dictionary value type
+		object::ObjectType m_valueType;
+	};
+
+	// A compiled function or program
+	class Prototype
+	{
+	public:
+		std::shared_ptr<ast::DeclareFunctionStatement> m_declaration; // NULL for the program itself
+		object::ObjectType m_functionType = object::NULL_TYPE;
+		std::vector<object::ObjectType> m_parameterTypes;
+		int m_registerCount = 0;
+
+		std::vector<Instruction> m_instructions;
+		std::vector<object::Value> m_constants;
+		std::vector<int> m_names;                                     // Symbols of the globals used
+		std::vector<std::string> m_strings;
+		std::vector<std::shared_ptr<ast::CollectionLiteral>> m_literals;
+		std::vector<std::shared_ptr<ast::Identifier>> m_members;     // Right sides of member accesses
+		std::vector<CallSite> m_callSites;
+		std::vector<Declaration> m_declarations;
+		std::vector<std::shared_ptr<Prototype>> m_prototypes;
+	};
+}
@@ -0,0 +1,1102 @@
+#include <sstream>
+
+#include "compiler.h"
+#include "evaluator.h"
+
+namespace compiler
+{
+	const std::map<std::string, OpCode> c_infixOperatorToOpCode =
+	{
+		{"+", OP_ADD},
+		{"-", OP_SUBTRACT},
+		{"*", OP_MULTIPLY},
+		{"/", OP_DIVIDE},
+		{"%", OP_MODULO},
+		{"<", OP_LESS},
+		{"<=", OP_LESS_EQUAL},
+		{">", OP_GREATER},
+		{">=", OP_GREATER_EQUAL},
+		{"==", OP_EQUAL},
+		{"!=", OP_NOT_EQUAL},
+		{"&&", OP_AND},
+		{"||", OP_OR},
+	};
+
+	const std::map<std::string, OpCode> c_assignmentOperatorToOpCode =
+	{
+		{"+=", OP_ADD},
+		{"-=", OP_SUBTRACT},
+		{"*=", OP_MULTIPLY},
+		{"/=", OP_DIVIDE},
+		{"%=", OP_MODULO},
+	};
+
+	Compiler::Compiler()
+		: m_function(NULL)
+	{
+	}
+
+	std::shared_ptr<Prototype> Compiler::CompileProgram(std::shared_ptr<ast::Program> p_program)
+	{
+		FunctionState program;
+		program.m_prototype = std::make_shared<Prototype>();
+		program.m_prototype->m_functionType = object::NULL_TYPE;
+		program.m_enclosing = NULL;
+		program.m_nextRegister = 0;
+		m_function = &program;
+
+		// Declarations at the top level of the program are globals, not locals
+		for (int i = 0; i < p_program->m_statements.size(); i++)
+		{
+			ast::NodeType statementType = p_program->m_statements[i]->Type();
+			if (statementType == ast::DECLARE_VARIABLE_STATEMENT_NODE || statementType == ast::DECLARE_COLLECTION_STATEMENT_NODE ||
+				statementType == ast::DECLARE_DICTIONARY_STATEMENT_NODE || statementType == ast::DECLARE_FUNCTION_STATEMENT_NODE)
+			{
+				continue;
+			}
+			collectLocalNames(p_program->m_statements[i], &program.m_localNames);
+		}
+
+		// Register 0 holds the value of the last statement, which is the result of the program
+		int result = allocateRegister();
+		emit(OP_LOAD_NULL, result);
+
+		for (int i = 0; i < p_program->m_statements.size(); i++)
+		{
+			std::shared_ptr<ast::Statement> statement = p_program->m_statements[i];
+
+			if (i == p_program->m_statements.size() - 1 && statement->Type() == ast::EXPRESSION_STATEMENT_NODE)
+			{
+				compileExpression(std::static_pointer_cast<ast::ExpressionStatement>(statement)->m_expression, result);
+			}
+			else
+			{
+				compileStatement(statement);
+			}
+			freeRegisters(result + 1);
+		}
+
+		emit(OP_RETURN, result);
+		m_function = NULL;
+
+		if (m_errors.size() > 0) return NULL;
+		return program.m_prototype;
+	}
+
+	void Compiler::compileStatement(std::shared_ptr<ast::Statement> p_statement)
+	{
+		int firstFreeRegister = m_function->m_nextRegister;
+		bool declaresLocal = false;
+
+		switch (p_statement->Type())
+		{
+		case ast::EXPRESSION_STATEMENT_NODE:
+			compileExpression(std::static_pointer_cast<ast::ExpressionStatement>(p_statement)->m_expression);
+			break;
+		case ast::BLOCK_STATEMENT_NODE:
+			beginScope();
+			compileBlock(std::static_pointer_cast<ast::BlockStatement>(p_statement));
+			endScope();
+			break;
+		case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+		{
+			declaresLocal = true;
+			std::shared_ptr<ast::DeclareVariableStatement> declaration = std::static_pointer_cast<ast::DeclareVariableStatement>(p_statement);
+			compileDeclaration(declaration, &declaration->m_name, &declaration->m_token, NULL, NULL, declaration->m_value);
+			break;
+		}
+		case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+		{
+			declaresLocal = true;
+			std::shared_ptr<ast::DeclareCollectionStatement> declaration = std::static_pointer_cast<ast::DeclareCollectionStatement>(p_statement);
+			compileDeclaration(declaration, &declaration->m_name, &declaration->m_token, &declaration->m_typeToken, NULL, declaration->m_value);
+			break;
+		}
+		case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+		{
+			declaresLocal = true;
+			std::shared_ptr<ast::DeclareDictionaryStatement> declaration = std::static_pointer_cast<ast::DeclareDictionaryStatement>(p_statement);
+			compileDeclaration(declaration, &declaration->m_name, &declaration->m_token, &declaration->m_keyTypeToken, &declaration->m_valueTypeToken, declaration->m_value);
+			break;
+		}
+		case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+			declaresLocal = true;
+			compileDeclareFunction(std::static_pointer_cast<ast::DeclareFunctionStatement>(p_statement));
+			break;
+		case ast::RETURN_STATEMENT_NODE:
+			compileReturnStatement(std::static_pointer_cast<ast::ReturnStatement>(p_statement));
+			break;
+		case ast::IF_STATEMENT_NODE:
+			compileIfStatement(std::static_pointer_cast<ast::IfStatement>(p_statement));
+			break;
+		case ast::WHILE_STATEMENT_NODE:
+			compileWhileStatement(std::static_pointer_cast<ast::WhileStatement>(p_statement));
+			break;
+		case ast::DO_WHILE_STATEMENT_NODE:
+			compileDoWhileStatement(std::static_pointer_cast<ast::DoWhileStatement>(p_statement));
+			break;
+		case ast::FOR_STATEMENT_NODE:
+			compileForStatement(std::static_pointer_cast<ast::ForStatement>(p_statement));
+			break;
+		case ast::ITERATE_STATEMENT_NODE:
+			compileIterateStatement(std::static_pointer_cast<ast::IterateStatement>(p_statement));
+			break;
+		case ast::BREAK_STATEMENT_NODE:
+			compileBreakStatement();
+			break;
+		case ast::CONTINUE_STATEMENT_NODE:
+			compileContinueStatement();
+			break;
+		default:
+			unsupported("Encountered an unexpected AST node");
+		}
+
+		// Only local declarations keep the registers they allocate
+		if (!declaresLocal || m_function->m_scopes.size() == 0)
+		{
+			freeRegisters(firstFreeRegister);
+		}
+	}
+
+	void Compiler::compileBlock(std::shared_ptr<ast::BlockStatement> p_block)
+	{
+		for (int i = 0; i < p_block->m_statements.size(); i++)
+		{
+			compileStatement(p_block->m_statements[i]);
+		}
+	}
+
+	void Compiler::compileDeclaration(std::shared_ptr<ast::Statement> p_declaration, ast::Identifier* p_name, token::Token* p_token,
+		token::Token* p_keyTypeToken, token::Token* p_valueTypeToken, std::shared_ptr<ast::Expression> p_value)
+	{
+		Declaration declaration;
+		declaration.m_name = p_name->m_name;
+		declaration.m_token = *p_token;
+		declaration.m_type = object::NULL_TYPE;
+		declaration.m_keyType = object::NULL_TYPE;
+		declaration.m_valueType = object::NULL_TYPE;
+
+		if (object::c_nodeTypeToObjectType.count(p_token->m_type) == 0 ||
+			(p_keyTypeToken != NULL && object::c_nodeTypeToObjectType.count(p_keyTypeToken->m_type) == 0) ||
+			(p_valueTypeToken != NULL && object::c_nodeTypeToObjectType.count(p_valueTypeToken->m_type) == 0))
+		{
+			unsupported("Declaration of '" + p_name->m_name + "' uses an unknown type.");
+			return;
+		}
+
+		declaration.m_type = object::c_nodeTypeToObjectType.at(p_token->m_type);
+		if (p_keyTypeToken != NULL)
+		{
+			declaration.m_keyTypeToken = *p_keyTypeToken;
+			declaration.m_keyType = object::c_nodeTypeToObjectType.at(p_keyTypeToken->m_type);
+		}
+		if (p_valueTypeToken != NULL)
+		{
+			declaration.m_valueTypeToken = *p_valueTypeToken;
+			declaration.m_valueType = object::c_nodeTypeToObjectType.at(p_valueTypeToken->m_type);
+		}
+
+		m_function->m_prototype->m_declarations.push_back(declaration);
+		int declarationIndex = m_function->m_prototype->m_declarations.size() - 1;
+
+		// Global declaration
+		if (m_function->m_scopes.size() == 0)
+		{
+			int name = addName(p_name);
+			emit(OP_CHECK_REDEFINITION, 0, name);
+
+			int value = allocateRegister();
+			if (p_value == NULL) emit(OP_LOAD_NULL, value);
+			else compileExpression(p_value, value);
+
+			emit(OP_CHECK_DECLARATION, value, declarationIndex);
+			emit(OP_DEFINE_GLOBAL, value, name);
+			return;
+		}
+
+		// Local declaration
+		if (m_function->m_scopes.back().m_locals.count(p_name->m_name) > 0)
+		{
+			emitError("Redefinition of '" + p_name->m_name + "'.");
+			return;
+		}
+
+		// The name is bound after the value is compiled, so the value can still refer to outer variables of the same name
+		int local = allocateRegister();
+		if (p_value == NULL) emit(OP_LOAD_NULL, local);
+		else compileExpression(p_value, local);
+
+		emit(OP_CHECK_DECLARATION, local, declarationIndex);
+		m_function->m_scopes.back().m_locals[p_name->m_name] = local;
+	}
+
+	void Compiler::compileDeclareFunction(std::shared_ptr<ast::DeclareFunctionStatement> p_declareFunction)
+	{
+		if (object::c_nodeTypeToObjectType.count(p_declareFunction->m_token.m_type) == 0)
+		{
+			emitError("'" + p_declareFunction->m_token.m_literal + "' is not a valid function type.");
+			return;
+		}
+
+		// The name is declared before compiling the body, so that it can be used for recursion
+		int local = -1;
+		if (m_function->m_scopes.size() > 0) local = declareLocal(&p_declareFunction->m_name.m_name);
+
+		FunctionState function;
+		function.m_prototype = std::make_shared<Prototype>();
+		function.m_prototype->m_declaration = p_declareFunction;
+		function.m_prototype->m_functionType = object::c_nodeTypeToObjectType.at(p_declareFunction->m_token.m_type);
+		function.m_enclosing = m_function;
+		function.m_nextRegister = 0;
+
+		// A body skipped by a lazy parser is parsed now, and one that does not parse reports its syntax error when called
+		std::string syntaxError = evaluator::parseFunctionBody(&p_declareFunction->m_name.m_name, &p_declareFunction->m_parameters, p_declareFunction->m_body.get());
+
+		collectLocalNames(p_declareFunction->m_body->m_body, &function.m_localNames);
+
+		m_function->m_prototype->m_prototypes.push_back(function.m_prototype);
+		int prototypeIndex = m_function->m_prototype->m_prototypes.size() - 1;
+		m_function = &function;
+
+		// Parameters occupy the first registers and share the scope of the function body
+		beginScope();
+		for (int i = 0; i < p_declareFunction->m_parameters.size(); i++)
+		{
+			std::shared_ptr<ast::DeclareVariableStatement> parameter = p_declareFunction->m_parameters[i];
+			if (object::c_nodeTypeToObjectType.count(parameter->m_token.m_type) == 0)
+			{
+				unsupported("Parameter '" + parameter->m_name.m_name + "' has an unknown type.");
+				break;
+			}
+			function.m_prototype->m_parameterTypes.push_back(object::c_nodeTypeToObjectType.at(parameter->m_token.m_type));
+			function.m_localNames.insert(parameter->m_name.m_name);
+			function.m_scopes.back().m_locals[parameter->m_name.m_name] = allocateRegister();
+		}
+
+		if (!syntaxError.empty()) emitError(syntaxError);
+		else compileBlock(p_declareFunction->m_body->m_body);
+
+		// Falling off the end of a function returns null
+		int result = allocateRegister();
+		emit(OP_LOAD_NULL, result);
+		emit(OP_RETURN, result);
+		endScope();
+
+		m_function = function.m_enclosing;
+
+		if (local >= 0)
+		{
+			emit(OP_FUNCTION, local, prototypeIndex);
+		}
+		else
+		{
+			int value = allocateRegister();
+			emit(OP_FUNCTION, value, prototypeIndex);
+			emit(OP_DEFINE_GLOBAL, value, addName(&p_declareFunction->m_name));
+		}
+	}
+
+	void Compiler::compileReturnStatement(std::shared_ptr<ast::ReturnStatement> p_returnStatement)
+	{
+		// The value is copied, since the updation of enclosing loops may reassign it
+		int value = allocateRegister();
+		if (p_returnStatement->m_returnValue == NULL) emit(OP_LOAD_NULL, value);
+		else compileExpression(p_returnStatement->m_returnValue, value);
+
+		emitLoopUpdations();
+		emit(OP_RETURN, value);
+	}
+
+	void Compiler::compileIfStatement(std::shared_ptr<ast::IfStatement> p_ifStatement)
+	{
+		// Treat as else clause
+		if (p_ifStatement->m_condition == NULL)
+		{
+			beginScope();
+			compileBlock(p_ifStatement->m_consequence);
+			endScope();
+			return;
+		}
+
+		int firstFreeRegister = m_function->m_nextRegister;
+		int condition = compileExpression(p_ifStatement->m_condition);
+		int jumpToAlternative = emit(OP_JUMP_IF_FALSE, condition);
+		freeRegisters(firstFreeRegister);
+
+		beginScope();
+		compileBlock(p_ifStatement->m_consequence);
+		endScope();
+
+		if (p_ifStatement->m_alternative == NULL)
+		{
+			patchJump(jumpToAlternative);
+			return;
+		}
+
+		int jumpToEnd = emit(OP_JUMP);
+		patchJump(jumpToAlternative);
+		compileIfStatement(p_ifStatement->m_alternative);
+		patchJump(jumpToEnd);
+	}
+
+	void Compiler::compileWhileStatement(std::shared_ptr<ast::WhileStatement> p_whileStatement)
+	{
+		int firstFreeRegister = m_function->m_nextRegister;
+		int start = m_function->m_prototype->m_instructions.size();
+
+		int condition = compileExpression(p_whileStatement->m_condition);
+		int exitJump = emit(OP_JUMP_IF_FALSE, condition);
+		freeRegisters(firstFreeRegister);
+
+		Loop loop;
+		loop.m_scopeDepth = m_function->m_scopes.size();
+		m_function->m_loops.push_back(loop);
+
+		beginScope();
+		compileBlock(p_whileStatement->m_consequence);
+		endScope();
+
+		emit(OP_JUMP, 0, start);
+		patchJump(exitJump);
+
+		Loop finishedLoop = m_function->m_loops.back();
+		m_function->m_loops.pop_back();
+		for (int i = 0; i < finishedLoop.m_breakJumps.size(); i++) patchJump(finishedLoop.m_breakJumps[i]);
+		for (int i = 0; i < finishedLoop.m_continueJumps.size(); i++) m_function->m_prototype->m_instructions[finishedLoop.m_continueJumps[i]].m_b = start;
+	}
+
+	void Compiler::compileDoWhileStatement(std::shared_ptr<ast::DoWhileStatement> p_doWhileStatement)
+	{
+		int firstFreeRegister = m_function->m_nextRegister;
+		int start = m_function->m_prototype->m_instructions.size();
+
+		Loop loop;
+		loop.m_scopeDepth = m_function->m_scopes.size();
+		m_function->m_loops.push_back(loop);
+
+		beginScope();
+		compileBlock(p_doWhileStatement->m_consequence);
+		endScope();
+
+		Loop finishedLoop = m_function->m_loops.back();
+		m_function->m_loops.pop_back();
+		for (int i = 0; i < finishedLoop.m_continueJumps.size(); i++) patchJump(finishedLoop.m_continueJumps[i]);
+
+		int condition = compileExpression(p_doWhileStatement->m_condition);
+		int exitJump = emit(OP_JUMP_IF_FALSE, condition);
+		freeRegisters(firstFreeRegister);
+		emit(OP_JUMP, 0, start);
+
+		patchJump(exitJump);
+		for (int i = 0; i < finishedLoop.m_breakJumps.size(); i++) patchJump(finishedLoop.m_breakJumps[i]);
+	}
+
+	void Compiler::compileForStatement(std::shared_ptr<ast::ForStatement> p_forStatement)
+	{
+		if (p_forStatement->m_condition == NULL || p_forStatement->m_condition->Type() != ast::EXPRESSION_STATEMENT_NODE ||
+			(p_forStatement->m_updation != NULL && p_forStatement->m_updation->Type() != ast::EXPRESSION_STATEMENT_NODE))
+		{
+			unsupported("'for' loops must have an expression as their condition and updation.");
+			return;
+		}
+
+		// Scope of the initialization, condition and updation
+		beginScope();
+		if (p_forStatement->m_initialization != NULL) compileStatement(p_forStatement->m_initialization);
+
+		int firstFreeRegister = m_function->m_nextRegister;
+		int start = m_function->m_prototype->m_instructions.size();
+
+		int condition = compileExpression(std::static_pointer_cast<ast::ExpressionStatement>(p_forStatement->m_condition)->m_expression);
+		int exitJump = emit(OP_JUMP_IF_FALSE, condition);
+		freeRegisters(firstFreeRegister);
+
+		Loop loop;
+		loop.m_scopeDepth = m_function->m_scopes.size();
+		loop.m_updation = p_forStatement->m_updation;
+		m_function->m_loops.push_back(loop);
+
+		beginScope();
+		compileBlock(p_forStatement->m_consequence);
+		endScope();
+
+		Loop finishedLoop = m_function->m_loops.back();
+		m_function->m_loops.pop_back();
+
+		// The updation runs after the body no matter how the body was left
+		for (int i = 0; i < finishedLoop.m_continueJumps.size(); i++) patchJump(finishedLoop.m_continueJumps[i]);
+		if (p_forStatement->m_updation != NULL) compileStatement(p_forStatement->m_updation);
+		emit(OP_JUMP, 0, start);
+
+		if (finishedLoop.m_breakJumps.size() > 0)
+		{
+			for (int i = 0; i < finishedLoop.m_breakJumps.size(); i++) patchJump(finishedLoop.m_breakJumps[i]);
+			if (p_forStatement->m_updation != NULL) compileStatement(p_forStatement->m_updation);
+		}
+
+		patchJump(exitJump);
+		endScope();
+	}
+
+	void Compiler::compileIterateStatement(std::shared_ptr<ast::IterateStatement> p_iterateStatement)
+	{
+		int iterable = allocateRegister();
+		allocateRegister(); // counter
+
+		int collection = compileExpression(p_iterateStatement->m_collection);
+		emit(OP_ITERATE_PREPARE, iterable, collection);
+		freeRegisters(iterable + 2);
+
+		// The variable and the body share one scope
+		beginScope();
+		int variable = declareLocal(&p_iterateStatement->m_var->m_name);
+		int start = emit(OP_ITERATE_NEXT, variable, iterable);
+
+		Loop loop;
+		loop.m_scopeDepth = m_function->m_scopes.size() - 1;
+		m_function->m_loops.push_back(loop);
+
+		compileBlock(p_iterateStatement->m_consequence);
+
+		Loop finishedLoop = m_function->m_loops.back();
+		m_function->m_loops.pop_back();
+
+		emit(OP_JUMP, 0, start);
+		endScope();
+
+		m_function->m_prototype->m_instructions[start].m_c = m_function->m_prototype->m_instructions.size();
+		for (int i = 0; i < finishedLoop.m_breakJumps.size(); i++) patchJump(finishedLoop.m_breakJumps[i]);
+		for (int i = 0; i < finishedLoop.m_continueJumps.size(); i++) m_function->m_prototype->m_instructions[finishedLoop.m_continueJumps[i]].m_b = start;
+	}
+
+	void Compiler::compileBreakStatement()
+	{
+		if (m_function->m_loops.size() == 0)
+		{
+			emitError("Attempted to break outside a loop.");
+			return;
+		}
+
+		m_function->m_loops.back().m_breakJumps.push_back(emit(OP_JUMP));
+	}
+
+	void Compiler::compileContinueStatement()
+	{
+		if (m_function->m_loops.size() == 0)
+		{
+			emitError("Attempted to continue outside a loop.");
+			return;
+		}
+
+		m_function->m_loops.back().m_continueJumps.push_back(emit(OP_JUMP));
+	}
+
+	int Compiler::compileExpression(std::shared_ptr<ast::Expression> p_expression, int p_target)
+	{
+		switch (p_expression->Type())
+		{
+		case ast::IDENTIFIER_NODE:
+			return compileIdentifier(std::static_pointer_cast<ast::Identifier>(p_expression), p_target);
+		case ast::INTEGER_LITERAL_NODE:
+		{
+			int target = p_target >= 0 ? p_target : allocateRegister();
+			int value = std::static_pointer_cast<ast::IntegerLiteral>(p_expression)->m_value;
+			emit(OP_LOAD_CONSTANT, target, addConstant(object::Value(value)));
+			return target;
+		}
+		case ast::FLOAT_LITERAL_NODE:
+		{
+			int target = p_target >= 0 ? p_target : allocateRegister();
+			float value = std::static_pointer_cast<ast::FloatLiteral>(p_expression)->m_value;
+			emit(OP_LOAD_CONSTANT, target, addConstant(object::Value(value)));
+			return target;
+		}
+		case ast::BOOLEAN_LITERAL_NODE:
+		{
+			int target = p_target >= 0 ? p_target : allocateRegister();
+			bool value = std::static_pointer_cast<ast::BooleanLiteral>(p_expression)->m_value;
+			emit(OP_LOAD_CONSTANT, target, addConstant(object::Value(value)));
+			return target;
+		}
+		case ast::CHARACTER_LITERAL_NODE:
+		{
+			int target = p_target >= 0 ? p_target : allocateRegister();
+			char value = std::static_pointer_cast<ast::CharacterLiteral>(p_expression)->m_value;
+			emit(OP_LOAD_CONSTANT, target, addConstant(object::Value(value)));
+			return target;
+		}
+		case ast::STRING_LITERAL_NODE:
+		{
+			// Strings are immutable, so every evaluation can share one object
+			int target = p_target >= 0 ? p_target : allocateRegister();
+			std::shared_ptr<ast::StringLiteral> stringLiteral = std::static_pointer_cast<ast::StringLiteral>(p_expression);
+			std::string value;
+			for (int i = 0; i < stringLiteral->m_stringCollection->m_values.size(); i++)
+			{
+				value += std::static_pointer_cast<ast::CharacterLiteral>(stringLiteral->m_stringCollection->m_values[i])->m_value;
+			}
+			emit(OP_LOAD_CONSTANT, target, addConstant(object::Value(std::make_shared<object::String>(&value))));
+			return target;
+		}
+		case ast::COLLECTION_LITERAL_NODE:
+			return compileCollectionLiteral(std::static_pointer_cast<ast::CollectionLiteral>(p_expression), p_target);
+		case ast::DICTIONARY_LITERAL_NODE:
+			return compileDictionaryLiteral(std::static_pointer_cast<ast::DictionaryLiteral>(p_expression), p_target);
+		case ast::PREFIX_EXPRESSION_NODE:
+			return compilePrefixExpression(std::static_pointer_cast<ast::PrefixExpression>(p_expression), p_target);
+		case ast::POSTFIX_EXPRESSION_NODE:
+			return compilePostfixExpression(std::static_pointer_cast<ast::PostfixExpression>(p_expression), p_target);
+		case ast::INFIX_EXPRESSION_NODE:
+			return compileInfixExpression(std::static_pointer_cast<ast::InfixExpression>(p_expression), p_target);
+		case ast::CALL_EXPRESSION_NODE:
+			return compileCallExpression(std::static_pointer_cast<ast::CallExpression>(p_expression), p_target);
+		case ast::INDEX_EXPRESSION_NODE:
+			return compileIndexExpression(std::static_pointer_cast<ast::IndexExpression>(p_expression), p_target);
+		default:
+			break;
+		}
+
+		unsupported("Encountered an unexpected AST node");
+		return p_target >= 0 ? p_target : allocateRegister();
+	}
+
+	int Compiler::compileIdentifier(std::shared_ptr<ast::Identifier> p_identifier, int p_target)
+	{
+		int local = resolveLocal(&p_identifier->m_name);
+		if (local >= 0)
+		{
+			if (p_target < 0) return local;
+
+			emit(OP_MOVE, p_target, local);
+			return p_target;
+		}
+
+		int target = p_target >= 0 ? p_target : allocateRegister();
+		emit(OP_GET_GLOBAL, target, addName(p_identifier.get()));
+		return target;
+	}
+
+	int Compiler::compileCollectionLiteral(std::shared_ptr<ast::CollectionLiteral> p_collectionLiteral, int p_target)
+	{
+		int target = p_target >= 0 ? p_target : allocateRegister();
+		int firstFreeRegister = m_function->m_nextRegister;
+
+		emit(OP_NEW_COLLECTION, target);
+		if (p_collectionLiteral->m_values.size() == 0) return target;
+
+		m_function->m_prototype->m_literals.push_back(p_collectionLiteral);
+		int literal = m_function->m_prototype->m_literals.size() - 1;
+
+		for (int i = 0; i < p_collectionLiteral->m_values.size(); i++)
+		{
+			int item = compileExpression(p_collectionLiteral->m_values[i]);
+			emit(OP_COLLECTION_PUSH, target, item, literal);
+			freeRegisters(firstFreeRegister);
+		}
+
+		return target;
+	}
+
+	int Compiler::compileDictionaryLiteral(std::shared_ptr<ast::DictionaryLiteral> p_dictionaryLiteral, int p_target)
+	{
+		int target = p_target >= 0 ? p_target : allocateRegister();
+		int firstFreeRegister = m_function->m_nextRegister;
+
+		emit(OP_NEW_DICTIONARY, target);
+
+		std::map<std::shared_ptr<ast::Expression>, std::shared_ptr<ast::Expression>>::iterator it;
+		for (it = p_dictionaryLiteral->m_map.begin(); it != p_dictionaryLiteral->m_map.end(); it++)
+		{
+			int key = compileExpression(it->first, allocateRegister());
+			emit(OP_DICTIONARY_CHECK_KEY, target, key);
+
+			int value = compileExpression(it->second);
+			emit(OP_DICTIONARY_INSERT, target, key, value);
+			freeRegisters(firstFreeRegister);
+		}
+
+		return target;
+	}
+
+	int Compiler::compilePrefixExpression(std::shared_ptr<ast::PrefixExpression> p_prefixExpression, int p_target)
+	{
+		if (p_prefixExpression->m_operator == "++" || p_prefixExpression->m_operator == "--")
+		{
+			return compileIncrement(p_prefixExpression->m_rightExpression, &p_prefixExpression->m_operator, false, p_target);
+		}
+
+		int target = p_target >= 0 ? p_target : allocateRegister();
+		int firstFreeRegister = m_function->m_nextRegister;
+
+		int right = compileExpression(p_prefixExpression->m_rightExpression);
+		if (p_prefixExpression->m_operator == "!") emit(OP_NOT, target, right);
+		else if (p_prefixExpression->m_operator == "-") emit(OP_NEGATE, target, right);
+		else unsupported("Unknown prefix operator " + p_prefixExpression->m_operator + ".");
+
+		freeRegisters(firstFreeRegister);
+		return target;
+	}
+
+	int Compiler::compilePostfixExpression(std::shared_ptr<ast::PostfixExpression> p_postfixExpression, int p_target)
+	{
+		return compileIncrement(p_postfixExpression->m_leftExpression, &p_postfixExpression->m_operator, true, p_target);
+	}
+
+	int Compiler::compileIncrement(std::shared_ptr<ast::Expression> p_operand, std::string* p_operator, bool p_isPostfix, int p_target)
+	{
+		int target = p_target >= 0 ? p_target : allocateRegister();
+		int firstFreeRegister = m_function->m_nextRegister;
+
+		int flags = 0;
+		if (*p_operator == "--") flags |= INCREMENT_DECREMENT;
+		if (p_isPostfix) flags |= INCREMENT_POSTFIX;
+
+		int newValue = allocateRegister();
+
+		if (p_operand->Type() == ast::IDENTIFIER_NODE)
+		{
+			std::shared_ptr<ast::Identifier> identifier = std::static_pointer_cast<ast::Identifier>(p_operand);
+			int local = resolveLocal(&identifier->m_name);
+
+			if (local >= 0)
+			{
+				emit(OP_INCREMENT, newValue, local, flags);
+				emit(OP_MOVE, target, p_isPostfix ? local : newValue);
+				emit(OP_MOVE, local, newValue);
+			}
+			else
+			{
+				int name = addName(identifier.get());
+				int oldValue = allocateRegister();
+				emit(OP_GET_GLOBAL, oldValue, name);
+				emit(OP_INCREMENT, newValue, oldValue, flags);
+				emit(OP_SET_GLOBAL, newValue, name);
+				emit(OP_MOVE, target, p_isPostfix ? oldValue : newValue);
+			}
+		}
+		else if (p_operand->Type() == ast::INDEX_EXPRESSION_NODE)
+		{
+			std::shared_ptr<ast::IndexExpression> indexExpression = std::static_pointer_cast<ast::IndexExpression>(p_operand);
+			int collection = compileExpression(indexExpression->m_collection, allocateRegister());
+			int index = compileExpression(indexExpression->m_index, allocateRegister());
+			int oldValue = allocateRegister();
+
+			emit(OP_GET_INDEX, oldValue, collection, index);
+			emit(OP_INCREMENT, newValue, oldValue, flags);
+			emit(OP_STORE_INDEX, collection, index, newValue);
+			emit(OP_MOVE, target, p_isPostfix ? oldValue : newValue);
+		}
+		else
+		{
+			int operand = compileExpression(p_operand);
+			emit(OP_INCREMENT, newValue, operand, flags | INCREMENT_UNASSIGNABLE);
+		}
+
+		freeRegisters(firstFreeRegister);
+		return target;
+	}
+
+	int Compiler::compileInfixExpression(std::shared_ptr<ast::InfixExpression> p_infixExpression, int p_target)
+	{
+		std::string* infixOperator = &p_infixExpression->m_operator;
+		bool isAssignment = *infixOperator == "=" || c_assignmentOperatorToOpCode.count(*infixOperator) > 0;
+
+		if (isAssignment && (p_infixExpression->m_leftExpression->Type() == ast::IDENTIFIER_NODE ||
+			p_infixExpression->m_leftExpression->Type() == ast::INDEX_EXPRESSION_NODE))
+		{
+			return compileAssignment(p_infixExpression, p_target);
+		}
+
+		int target = p_target >= 0 ? p_target : allocateRegister();
+		int firstFreeRegister = m_function->m_nextRegister;
+
+		// member access
+		if (*infixOperator == ".")
+		{
+			int object = compileExpression(p_infixExpression->m_leftExpression);
+
+			if (p_infixExpression->m_rightExpression->Type() != ast::IDENTIFIER_NODE)
+			{
+				std::ostringstream error;
+				error << "Expected to see a member variable or function, got " <<
+					p_infixExpression->m_rightExpression->String() << ".";
+				emitError(error.str());
+			}
+			else
+			{
+				std::shared_ptr<ast::Identifier> name = std::static_pointer_cast<ast::Identifier>(p_infixExpression->m_rightExpression);
+				m_function->m_prototype->m_members.push_back(name);
+				emit(OP_GET_MEMBER, target, object, m_function->m_prototype->m_members.size() - 1);
+			}
+
+			freeRegisters(firstFreeRegister);
+			return target;
+		}
+
+		int left = compileExpression(p_infixExpression->m_leftExpression);
+
+		// The right operand may reassign a local read by the left operand, so that value is copied first
+		if (left < firstFreeRegister && left != target && mayAssign(p_infixExpression->m_rightExpression))
+		{
+			int copy = allocateRegister();
+			emit(OP_MOVE, copy, left);
+			left = copy;
+		}
+
+		int right = compileExpression(p_infixExpression->m_rightExpression);
+
+		if (c_infixOperatorToOpCode.count(*infixOperator) > 0)
+		{
+			emit(c_infixOperatorToOpCode.at(*infixOperator), target, left, right);
+		}
+		else
+		{
+			emit(OP_UNSUPPORTED_INFIX, addString(*infixOperator), left, right);
+		}
+
+		freeRegisters(firstFreeRegister);
+		return target;
+	}
+
+	int Compiler::compileAssignment(std::shared_ptr<ast::InfixExpression> p_infixExpression, int p_target)
+	{
+		int target = p_target >= 0 ? p_target : allocateRegister();
+		int firstFreeRegister = m_function->m_nextRegister;
+
+		std::string* assignmentOperator = &p_infixExpression->m_operator;
+
+		// identifier = newValue;
+		if (p_infixExpression->m_leftExpression->Type() == ast::IDENTIFIER_NODE)
+		{
+			std::shared_ptr<ast::Identifier> identifier = std::static_pointer_cast<ast::Identifier>(p_infixExpression->m_leftExpression);
+			int name = addName(identifier.get());
+			int local = resolveLocal(&identifier->m_name);
+
+			int savedValue = local;
+			if (local < 0)
+			{
+				savedValue = allocateRegister();
+				emit(OP_GET_ASSIGNABLE_GLOBAL, savedValue, name);
+			}
+
+			int value = compileExpression(p_infixExpression->m_rightExpression, allocateRegister());
+			if (c_assignmentOperatorToOpCode.count(*assignmentOperator) > 0)
+			{
+				emit(c_assignmentOperatorToOpCode.at(*assignmentOperator), value, savedValue, value);
+			}
+
+			emit(OP_CHECK_ASSIGNMENT, value, savedValue, name);
+			if (local >= 0) emit(OP_MOVE, local, value);
+			else emit(OP_SET_GLOBAL, value, name);
+		}
+
+		// variables[index] = newValue;
+		else
+		{
+			std::shared_ptr<ast::IndexExpression> indexExpression = std::static_pointer_cast<ast::IndexExpression>(p_infixExpression->m_leftExpression);
+
+			int collection = compileExpression(indexExpression->m_collection, allocateRegister());
+			int index = compileExpression(indexExpression->m_index, allocateRegister());
+			int value = compileExpression(p_infixExpression->m_rightExpression, allocateRegister());
+
+			if (c_assignmentOperatorToOpCode.count(*assignmentOperator) > 0)
+			{
+				int currentValue = allocateRegister();
+				emit(OP_GET_INDEX, currentValue, collection, index);
+				emit(c_assignmentOperatorToOpCode.at(*assignmentOperator), value, currentValue, value);
+			}
+
+			emit(OP_SET_INDEX, collection, index, value);
+		}
+
+		emit(OP_LOAD_NULL, target);
+		freeRegisters(firstFreeRegister);
+		return target;
+	}
+
+	int Compiler::compileCallExpression(std::shared_ptr<ast::CallExpression> p_callExpression, int p_target)
+	{
+		int target = p_target >= 0 ? p_target : allocateRegister();
+		int firstFreeRegister = m_function->m_nextRegister;
+
+		// The function and its arguments occupy consecutive registers. A method call puts the object it is
+		// called on in place of the function.
+		std::shared_ptr<ast::Identifier> methodName = evaluator::getMethodName(p_callExpression.get());
+		int function = methodName != NULL
+			? compileExpression(std::static_pointer_cast<ast::InfixExpression>(p_callExpression->m_function)->m_leftExpression, allocateRegister())
+			: compileExpression(p_callExpression->m_function, allocateRegister());
+		for (int i = 0; i < p_callExpression->m_parameters.size(); i++)
+		{
+			compileExpression(p_callExpression->m_parameters[i], allocateRegister());
+		}
+
+		CallSite callSite;
+		callSite.m_argumentCount = p_callExpression->m_parameters.size();
+		callSite.m_expression = p_callExpression;
+		callSite.m_methodName = methodName;
+		m_function->m_prototype->m_callSites.push_back(callSite);
+
+		emit(methodName != NULL ? OP_CALL_METHOD : OP_CALL, target, function, m_function->m_prototype->m_callSites.size() - 1);
+
+		freeRegisters(firstFreeRegister);
+		return target;
+	}
+
+	int Compiler::compileIndexExpression(std::shared_ptr<ast::IndexExpression> p_indexExpression, int p_target)
+	{
+		int target = p_target >= 0 ? p_target : allocateRegister();
+		int firstFreeRegister = m_function->m_nextRegister;
+
+		int collection = compileExpression(p_indexExpression->m_collection);
+		int index = compileExpression(p_indexExpression->m_index);
+		emit(OP_GET_INDEX, target, collection, index);
+
+		freeRegisters(firstFreeRegister);
+		return target;
+	}
+
+	int Compiler::emit(OpCode p_opCode, int p_a, int p_b, int p_c)
+	{
+		Instruction instruction = { p_opCode, p_a, p_b, p_c };
+		m_function->m_prototype->m_instructions.push_back(instruction);
+		return m_function->m_prototype->m_instructions.size() - 1;
+	}
+
+	void Compiler::patchJump(int p_position)
+	{
+		m_function->m_prototype->m_instructions[p_position].m_b = m_function->m_prototype->m_instructions.size();
+	}
+
+	int Compiler::addConstant(object::Value p_constant)
+	{
+		m_function->m_prototype->m_constants.push_back(p_constant);
+		return m_function->m_prototype->m_constants.size() - 1;
+	}
+
+	int Compiler::addName(ast::Identifier* p_name)
+	{
+		int symbol = p_name->m_symbol >= 0 ? p_name->m_symbol : token::internIdentifier(&p_name->m_name);
+		std::vector<int>* names = &m_function->m_prototype->m_names;
+		for (int i = 0; i < names->size(); i++)
+		{
+			if ((*names)[i] == symbol) return i;
+		}
+
+		names->push_back(symbol);
+		return names->size() - 1;
+	}
+
+	int Compiler::addString(std::string p_string)
+	{
+		m_function->m_prototype->m_strings.push_back(p_string);
+		return m_function->m_prototype->m_strings.size() - 1;
+	}
+
+	void Compiler::emitError(std::string p_errorMessage)
+	{
+		emit(OP_ERROR, 0, addString(p_errorMessage));
+	}
+
+	int Compiler::allocateRegister()
+	{
+		int allocated = m_function->m_nextRegister++;
+		if (m_function->m_nextRegister > m_function->m_prototype->m_registerCount)
+		{
+			m_function->m_prototype->m_registerCount = m_function->m_nextRegister;
+		}
+		return allocated;
+	}
+
+	void Compiler::freeRegisters(int p_firstFreeRegister)
+	{
+		m_function->m_nextRegister = p_firstFreeRegister;
+	}
+
+	void Compiler::beginScope()
+	{
+		m_function->m_scopes.push_back(Scope());
+	}
+
+	void Compiler::endScope()
+	{
+		std::map<std::string, int>* locals = &m_function->m_scopes.back().m_locals;
+
+		// Locals are allocated in order, so the lowest one marks the start of the scope's registers
+		int firstRegister = m_function->m_nextRegister;
+		for (std::map<std::string, int>::iterator it = locals->begin(); it != locals->end(); it++)
+		{
+			if (it->second < firstRegister) firstRegister = it->second;
+		}
+
+		m_function->m_scopes.pop_back();
+		freeRegisters(firstRegister);
+	}
+
+	int Compiler::declareLocal(std::string* p_name)
+	{
+		std::map<std::string, int>* locals = &m_function->m_scopes.back().m_locals;
+		if (locals->count(*p_name) > 0) return locals->at(*p_name);
+
+		int local = allocateRegister();
+		(*locals)[*p_name] = local;
+		return local;
+	}
+
+	int Compiler::resolveLocal(std::string* p_name)
+	{
+		for (int i = m_function->m_scopes.size() - 1; i >= 0; i--)
+		{
+			std::map<std::string, int>* locals = &m_function->m_scopes[i].m_locals;
+			if (locals->count(*p_name) > 0) return locals->at(*p_name);
+		}
+
+		// Functions only see their own locals and the global environment
+		for (FunctionState* enclosing = m_function->m_enclosing; enclosing != NULL; enclosing = enclosing->m_enclosing)
+		{
+			if (enclosing->m_localNames.count(*p_name) > 0)
+			{
+				unsupported("'" + *p_name + "' is a local of an enclosing scope and cannot be captured.");
+				break;
+			}
+		}
+
+		return -1;
+	}
+
+	void Compiler::emitLoopUpdations()
+	{
+		std::vector<Scope> scopes = m_function->m_scopes;
+		std::vector<Loop> loops = m_function->m_loops;
+
+		for (int i = loops.size() - 1; i >= 0; i--)
+		{
+			if (loops[i].m_updation == NULL) continue;
+
+			// The updation only sees the scopes outside of the loop body
+			m_function->m_scopes.resize(loops[i].m_scopeDepth);
+			m_function->m_loops.resize(i);
+			compileStatement(loops[i].m_updation);
+		}
+
+		m_function->m_scopes = scopes;
+		m_function->m_loops = loops;
+	}
+
+	bool Compiler::mayAssign(std::shared_ptr<ast::Expression> p_expression)
+	{
+		switch (p_expression->Type())
+		{
+		case ast::PREFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::PrefixExpression> prefixExpression = std::static_pointer_cast<ast::PrefixExpression>(p_expression);
+			return prefixExpression->m_operator == "++" || prefixExpression->m_operator == "--" || mayAssign(prefixExpression->m_rightExpression);
+		}
+		case ast::POSTFIX_EXPRESSION_NODE:
+			return true;
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::InfixExpression> infixExpression = std::static_pointer_cast<ast::InfixExpression>(p_expression);
+			return infixExpression->m_operator == "=" || c_assignmentOperatorToOpCode.count(infixExpression->m_operator) > 0 ||
+				mayAssign(infixExpression->m_leftExpression) || mayAssign(infixExpression->m_rightExpression);
+		}
+		case ast::CALL_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::CallExpression> callExpression = std::static_pointer_cast<ast::CallExpression>(p_expression);
+			for (int i = 0; i < callExpression->m_parameters.size(); i++)
+			{
+				if (mayAssign(callExpression->m_parameters[i])) return true;
+			}
+			return mayAssign(callExpression->m_function);
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::IndexExpression> indexExpression = std::static_pointer_cast<ast::IndexExpression>(p_expression);
+			return mayAssign(indexExpression->m_collection) || mayAssign(indexExpression->m_index);
+		}
+		case ast::COLLECTION_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::CollectionLiteral> collectionLiteral = std::static_pointer_cast<ast::CollectionLiteral>(p_expression);
+			for (int i = 0; i < collectionLiteral->m_values.size(); i++)
+			{
+				if (mayAssign(collectionLiteral->m_values[i])) return true;
+			}
+			return false;
+		}
+		case ast::DICTIONARY_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::DictionaryLiteral> dictionaryLiteral = std::static_pointer_cast<ast::DictionaryLiteral>(p_expression);
+			std::map<std::shared_ptr<ast::Expression>, std::shared_ptr<ast::Expression>>::iterator it;
+			for (it = dictionaryLiteral->m_map.begin(); it != dictionaryLiteral->m_map.end(); it++)
+			{
+				if (mayAssign(it->first) || mayAssign(it->second)) return true;
+			}
+			return false;
+		}
+		default:
+			return false;
+		}
+
+		return false;
+	}
+
+	void Compiler::collectLocalNames(std::shared_ptr<ast::Statement> p_statement, std::set<std::string>* p_names)
+	{
+		if (p_statement == NULL) return;
+
+		switch (p_statement->Type())
+		{
+		case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+			p_names->insert(std::static_pointer_cast<ast::DeclareVariableStatement>(p_statement)->m_name.m_name);
+			break;
+		case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+			p_names->insert(std::static_pointer_cast<ast::DeclareCollectionStatement>(p_statement)->m_name.m_name);
+			break;
+		case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+			p_names->insert(std::static_pointer_cast<ast::DeclareDictionaryStatement>(p_statement)->m_name.m_name);
+			break;
+		case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+			p_names->insert(std::static_pointer_cast<ast::DeclareFunctionStatement>(p_statement)->m_name.m_name);
+			break;
+		case ast::BLOCK_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::BlockStatement> block = std::static_pointer_cast<ast::BlockStatement>(p_statement);
+			for (int i = 0; i < block->m_statements.size(); i++) collectLocalNames(block->m_statements[i], p_names);
+			break;
+		}
+		case ast::IF_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::IfStatement> ifStatement = std::static_pointer_cast<ast::IfStatement>(p_statement);
+			collectLocalNames(ifStatement->m_consequence, p_names);
+			collectLocalNames(ifStatement->m_alternative, p_names);
+			break;
+		}
+		case ast::WHILE_STATEMENT_NODE:
+			collectLocalNames(std::static_pointer_cast<ast::WhileStatement>(p_statement)->m_consequence, p_names);
+			break;
+		case ast::DO_WHILE_STATEMENT_NODE:
+			collectLocalNames(std::static_pointer_cast<ast::DoWhileStatement>(p_statement)->m_consequence, p_names);
+			break;
+		case ast::FOR_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::ForStatement> forStatement = std::static_pointer_cast<ast::ForStatement>(p_statement);
+			collectLocalNames(forStatement->m_initialization, p_names);
+			collectLocalNames(forStatement->m_consequence, p_names);
+			break;
+		}
+		case ast::ITERATE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::IterateStatement> iterateStatement = std::static_pointer_cast<ast::IterateStatement>(p_statement);
+			p_names->insert(iterateStatement->m_var->m_name);
+			collectLocalNames(iterateStatement->m_consequence, p_names);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	void Compiler::unsupported(std::string p_reason)
+	{
+		m_errors.push_back(p_reason);
+	}
+}
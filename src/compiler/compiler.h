@@ -0,0 +1,115 @@
+#pragma once
+
+#include <map>
+#include <set>
+
+#include "ast.h"
+#include "bytecode.h"
+
+namespace compiler
+{
+	class Compiler
+	{
+	public:
+		Compiler();
+
+		// Constructs not handled by the compiler. Programs using them must be run by the evaluator.
+		std::vector<std::string> m_errors;
+
+		// Compiles a program into bytecode. Returns NULL if the program cannot be compiled.
+		std::shared_ptr<Prototype> CompileProgram(std::shared_ptr<ast::Program> p_program);
+	private:
+		typedef struct Scope
+		{
+			std::map<std::string, int> m_locals;
+		} Scope;
+
+		typedef struct Loop
+		{
+			int m_scopeDepth;                              // Number of scopes open outside of the loop body
+			std::shared_ptr<ast::Statement> m_updation;    // Run on break, continue and return for 'for' loops
+			std::vector<int> m_breakJumps;
+			std::vector<int> m_continueJumps;
+		} Loop;
+
+		typedef struct FunctionState
+		{
+			std::shared_ptr<Prototype> m_prototype;
+			FunctionState* m_enclosing;
+			std::vector<Scope> m_scopes;                   // Empty at the top level of the program
+			std::vector<Loop> m_loops;
+			std::set<std::string> m_localNames;            // Every name declared in a scope of this function
+			int m_nextRegister;
+		} FunctionState;
+
+		FunctionState* m_function;
+
+		// STATEMENTS
+
+		void compileStatement(std::shared_ptr<ast::Statement> p_statement);
+		void compileBlock(std::shared_ptr<ast::BlockStatement> p_block);
+		void compileDeclaration(std::shared_ptr<ast::Statement> p_declaration, ast::Identifier* p_name, token::Token* p_token,
+			token::Token* p_keyTypeToken, token::Token* p_valueTypeToken, std::shared_ptr<ast::Expression> p_value);
+		void compileDeclareFunction(std::shared_ptr<ast::DeclareFunctionStatement> p_declareFunction);
+		void compileReturnStatement(std::shared_ptr<ast::ReturnStatement> p_returnStatement);
+		void compileIfStatement(std::shared_ptr<ast::IfStatement> p_ifStatement);
+		void compileWhileStatement(std::shared_ptr<ast::WhileStatement> p_whileStatement);
+		void compileDoWhileStatement(std::shared_ptr<ast::DoWhileStatement> p_doWhileStatement);
+		void compileForStatement(std::shared_ptr<ast::ForStatement> p_forStatement);
+		void compileIterateStatement(std::shared_ptr<ast::IterateStatement> p_iterateStatement);
+		void compileBreakStatement();
+		void compileContinueStatement();
+
+		// EXPRESSIONS
+
+		// Compiles an expression and returns the register holding its value.
+		// The value is placed in p_target if it is given.
+		int compileExpression(std::shared_ptr<ast::Expression> p_expression, int p_target = -1);
+		int compileIdentifier(std::shared_ptr<ast::Identifier> p_identifier, int p_target);
+		int compileCollectionLiteral(std::shared_ptr<ast::CollectionLiteral> p_collectionLiteral, int p_target);
+		int compileDictionaryLiteral(std::shared_ptr<ast::DictionaryLiteral> p_dictionaryLiteral, int p_target);
+		int compilePrefixExpression(std::shared_ptr<ast::PrefixExpression> p_prefixExpression, int p_target);
+		int compilePostfixExpression(std::shared_ptr<ast::PostfixExpression> p_postfixExpression, int p_target);
+		int compileIncrement(std::shared_ptr<ast::Expression> p_operand, std::string* p_operator, bool p_isPostfix, int p_target);
+		int compileInfixExpression(std::shared_ptr<ast::InfixExpression> p_infixExpression, int p_target);
+		int compileAssignment(std::shared_ptr<ast::InfixExpression> p_infixExpression, int p_target);
+		int compileCallExpression(std::shared_ptr<ast::CallExpression> p_callExpression, int p_target);
+		int compileIndexExpression(std::shared_ptr<ast::IndexExpression> p_indexExpression, int p_target);
+
+		// HELPERS
+
+		// Emits an instruction and returns its position
+		int emit(OpCode p_opCode, int p_a = 0, int p_b = 0, int p_c = 0);
+
+		// Points the jump instruction at p_position to the next emitted instruction
+		void patchJump(int p_position);
+
+		int addConstant(object::Value p_constant);
+		int addName(ast::Identifier* p_name);
+		int addString(std::string p_string);
+		void emitError(std::string p_errorMessage);
+
+		int allocateRegister();
+		void freeRegisters(int p_firstFreeRegister);
+
+		void beginScope();
+		void endScope();
+
+		// Declares a local in the innermost scope and returns its register
+		int declareLocal(std::string* p_name);
+
+		// Returns the register of a local, or -1 for names resolved through the global environment
+		int resolveLocal(std::string* p_name);
+
+		// Emits the updation of every enclosing 'for' loop, innermost first
+		void emitLoopUpdations();
+
+		// Checks if evaluating an expression may reassign a variable
+		bool mayAssign(std::shared_ptr<ast::Expression> p_expression);
+
+		// Records every name declared in a scope of the function body
+		void collectLocalNames(std::shared_ptr<ast::Statement> p_statement, std::set<std::string>* p_names);
+
+		void unsupported(std::string p_reason);
+	};
+}
@@ -1,89 +1,105 @@
+#include <climits>
+#include <iostream>
 #include <set>
 #include <sstream>
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
 #include "builtinFunctions.h"
 #include "evaluator.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "resolver.h"
 
 namespace evaluator
 {
 	std::chrono::steady_clock::time_point g_timeout = std::chrono::steady_clock::time_point();
-
-	std::shared_ptr<object::Object> evaluate(std::shared_ptr<ast::Node> p_node, std::shared_ptr<object::Environment> p_environment)
+	long long g_fuelLimit = 0;
+	long long g_fuelUsed = 0;
+	int g_fuelChunk = c_fuelPerClockCheck;
+	int g_fuelLeft = c_fuelPerClockCheck;
+	int g_maxCallDepth = 100000;
+	Completion g_completion = COMPLETION_NORMAL;
+	int g_callDepth = 0;
+	size_t g_stackSize = nativeStackSize();
+	uintptr_t g_stackBase = 0;
+	bool g_isOptimizing = false;
+	bool g_isReportingOptimizations = false;
+
+	std::shared_ptr<object::Object> evaluate(ast::Node* p_node, const std::shared_ptr<object::Environment>& p_environment)
 	{
-		if (g_timeout != std::chrono::steady_clock::time_point() && g_timeout < std::chrono::steady_clock::now())
-		{
-			return createError("Evaluation of the program timed out.");
-		}
+		if (!useFuel()) return budgetError();
 
 		if (p_node == NULL) return object::NULL_OBJECT;
 
 		switch (p_node->Type())
 		{
-			case ast::PROGRAM_NODE:                      return evaluateProgram(std::static_pointer_cast<ast::Program>(p_node), p_environment);
-			case ast::IDENTIFIER_NODE:                   return evaluateIdentifier(std::static_pointer_cast<ast::Identifier>(p_node), p_environment);
-			case ast::BLOCK_STATEMENT_NODE:              return evaluateBlockStatement(std::static_pointer_cast<ast::BlockStatement>(p_node), p_environment);
-			case ast::INTEGER_LITERAL_NODE:              return evaluateIntegerLiteral(std::static_pointer_cast<ast::IntegerLiteral>(p_node), p_environment);
-			case ast::FLOAT_LITERAL_NODE:                return evaluateFloatLiteral(std::static_pointer_cast<ast::FloatLiteral>(p_node), p_environment);
-			case ast::BOOLEAN_LITERAL_NODE:              return evaluateBooleanLiteral(std::static_pointer_cast<ast::BooleanLiteral>(p_node), p_environment);
-			case ast::CHARACTER_LITERAL_NODE:            return evaluateCharacterLiteral(std::static_pointer_cast<ast::CharacterLiteral>(p_node), p_environment);
-			case ast::COLLECTION_LITERAL_NODE:           return evaluateCollectionLiteral(std::static_pointer_cast<ast::CollectionLiteral>(p_node), p_environment);
-			case ast::DICTIONARY_LITERAL_NODE:           return evaluateDictionaryLiteral(std::static_pointer_cast<ast::DictionaryLiteral>(p_node), p_environment);
-			case ast::STRING_LITERAL_NODE:               return evaluateStringLiteral(std::static_pointer_cast<ast::StringLiteral>(p_node), p_environment);
-			case ast::PREFIX_EXPRESSION_NODE:            return evaluatePrefixExpression(std::static_pointer_cast<ast::PrefixExpression>(p_node), p_environment);
-			case ast::POSTFIX_EXPRESSION_NODE:           return evaluatePostfixExpression(std::static_pointer_cast<ast::PostfixExpression>(p_node), p_environment);
-			case ast::INFIX_EXPRESSION_NODE:             return evaluateInfixExpression(std::static_pointer_cast<ast::InfixExpression>(p_node), p_environment);
-			case ast::CALL_EXPRESSION_NODE:              return evaluateCallExpression(std::static_pointer_cast<ast::CallExpression>(p_node), p_environment);
-			case ast::INDEX_EXPRESSION_NODE:             return evaluateIndexExpression(std::static_pointer_cast<ast::IndexExpression>(p_node), p_environment);
-			case ast::DECLARE_VARIABLE_STATEMENT_NODE:   return evaluateDeclareVariable(std::static_pointer_cast<ast::DeclareVariableStatement>(p_node), p_environment);
-			case ast::DECLARE_COLLECTION_STATEMENT_NODE: return evaluateDeclareCollection(std::static_pointer_cast<ast::DeclareCollectionStatement>(p_node), p_environment);
-			case ast::DECLARE_DICTIONARY_STATEMENT_NODE: return evaluateDeclareDictionary(std::static_pointer_cast<ast::DeclareDictionaryStatement>(p_node), p_environment);
-			case ast::DECLARE_FUNCTION_STATEMENT_NODE:   return evaluateDeclareFunction(std::static_pointer_cast<ast::DeclareFunctionStatement>(p_node), p_environment);
-			case ast::RETURN_STATEMENT_NODE:             return evaluateReturnStatement(std::static_pointer_cast<ast::ReturnStatement>(p_node), p_environment);
-			case ast::EXPRESSION_STATEMENT_NODE:         return evaluate(std::static_pointer_cast<ast::ExpressionStatement>(p_node)->m_expression, p_environment);
-			case ast::IF_STATEMENT_NODE:                 return evaluateIfStatement(std::static_pointer_cast<ast::IfStatement>(p_node), p_environment);
-			case ast::WHILE_STATEMENT_NODE:              return evaluateWhileStatement(std::static_pointer_cast<ast::WhileStatement>(p_node), p_environment);
-			case ast::DO_WHILE_STATEMENT_NODE:           return evaluateDoWhileStatement(std::static_pointer_cast<ast::DoWhileStatement>(p_node), p_environment);
-			case ast::FOR_STATEMENT_NODE:                return evaluateForStatement(std::static_pointer_cast<ast::ForStatement>(p_node), p_environment);
-			case ast::ITERATE_STATEMENT_NODE:            return evaluateIterateStatement(std::static_pointer_cast<ast::IterateStatement>(p_node), p_environment);
-			case ast::BREAK_STATEMENT_NODE:              return evaluateBreakStatement(std::static_pointer_cast<ast::BreakStatement>(p_node), p_environment);
-			case ast::CONTINUE_STATEMENT_NODE:           return evaluateContinueStatement(std::static_pointer_cast<ast::ContinueStatement>(p_node), p_environment);
+			case ast::PROGRAM_NODE:                      return evaluateProgram((ast::Program*)p_node, p_environment);
+			case ast::IDENTIFIER_NODE:                   return evaluateIdentifier((ast::Identifier*)p_node, p_environment);
+			case ast::BLOCK_STATEMENT_NODE:              return evaluateBlockStatement((ast::BlockStatement*)p_node, p_environment);
+			case ast::INTEGER_LITERAL_NODE:              return evaluateIntegerLiteral((ast::IntegerLiteral*)p_node, p_environment);
+			case ast::FLOAT_LITERAL_NODE:                return evaluateFloatLiteral((ast::FloatLiteral*)p_node, p_environment);
+			case ast::BOOLEAN_LITERAL_NODE:              return evaluateBooleanLiteral((ast::BooleanLiteral*)p_node, p_environment);
+			case ast::CHARACTER_LITERAL_NODE:            return evaluateCharacterLiteral((ast::CharacterLiteral*)p_node, p_environment);
+			case ast::COLLECTION_LITERAL_NODE:           return evaluateCollectionLiteral((ast::CollectionLiteral*)p_node, p_environment);
+			case ast::DICTIONARY_LITERAL_NODE:           return evaluateDictionaryLiteral((ast::DictionaryLiteral*)p_node, p_environment);
+			case ast::STRING_LITERAL_NODE:               return evaluateStringLiteral((ast::StringLiteral*)p_node, p_environment);
+			case ast::PREFIX_EXPRESSION_NODE:            return evaluatePrefixExpression((ast::PrefixExpression*)p_node, p_environment);
+			case ast::POSTFIX_EXPRESSION_NODE:           return evaluatePostfixExpression((ast::PostfixExpression*)p_node, p_environment);
+			case ast::INFIX_EXPRESSION_NODE:             return evaluateInfixExpression((ast::InfixExpression*)p_node, p_environment);
+			case ast::CALL_EXPRESSION_NODE:              return evaluateCallExpression((ast::CallExpression*)p_node, p_environment);
+			case ast::INDEX_EXPRESSION_NODE:             return evaluateIndexExpression((ast::IndexExpression*)p_node, p_environment);
+			case ast::DECLARE_VARIABLE_STATEMENT_NODE:   return evaluateDeclareVariable((ast::DeclareVariableStatement*)p_node, p_environment);
+			case ast::DECLARE_COLLECTION_STATEMENT_NODE: return evaluateDeclareCollection((ast::DeclareCollectionStatement*)p_node, p_environment);
+			case ast::DECLARE_DICTIONARY_STATEMENT_NODE: return evaluateDeclareDictionary((ast::DeclareDictionaryStatement*)p_node, p_environment);
+			case ast::DECLARE_FUNCTION_STATEMENT_NODE:   return evaluateDeclareFunction((ast::DeclareFunctionStatement*)p_node, p_environment);
+			case ast::RETURN_STATEMENT_NODE:             return evaluateReturnStatement((ast::ReturnStatement*)p_node, p_environment);
+			case ast::EXPRESSION_STATEMENT_NODE:         return evaluate(((ast::ExpressionStatement*)p_node)->m_expression.get(), p_environment);
+			case ast::IF_STATEMENT_NODE:                 return evaluateIfStatement((ast::IfStatement*)p_node, p_environment);
+			case ast::WHILE_STATEMENT_NODE:              return evaluateWhileStatement((ast::WhileStatement*)p_node, p_environment);
+			case ast::DO_WHILE_STATEMENT_NODE:           return evaluateDoWhileStatement((ast::DoWhileStatement*)p_node, p_environment);
+			case ast::FOR_STATEMENT_NODE:                return evaluateForStatement((ast::ForStatement*)p_node, p_environment);
+			case ast::ITERATE_STATEMENT_NODE:            return evaluateIterateStatement((ast::IterateStatement*)p_node, p_environment);
+			case ast::BREAK_STATEMENT_NODE:              return evaluateBreakStatement((ast::BreakStatement*)p_node, p_environment);
+			case ast::CONTINUE_STATEMENT_NODE:           return evaluateContinueStatement((ast::ContinueStatement*)p_node, p_environment);
 		}
 
 		return createError("Encountered an unexpected AST node");
 	}
 
-	std::shared_ptr<object::Object> evaluateProgram(std::shared_ptr<ast::Program> p_program, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateProgram(ast::Program* p_program, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		std::shared_ptr<object::Object> result = object::NULL_OBJECT;
+		g_completion = COMPLETION_NORMAL;
+		if (g_stackBase == 0) markStackBase();
 
 		for (int i = 0; i < p_program->m_statements.size(); i++)
 		{
-			result = evaluate(p_program->m_statements[i], p_environment);
-			if (result->Type() == object::ERROR) return result;
+			result = evaluate(p_program->m_statements[i].get(), p_environment);
+			if (g_completion == COMPLETION_NORMAL) continue;
 
-			if (result->Type() == object::RETURN)
-			{
-				std::shared_ptr<object::Return> returnObj = std::static_pointer_cast<object::Return>(result);
-				return returnObj->m_returnValue;
-			}
-
-			if (result->Type() == object::BREAK)
+			switch (g_completion)
 			{
+			case COMPLETION_RETURN:
+				g_completion = COMPLETION_NORMAL;
+				return result;
+			case COMPLETION_BREAK:
 				return createError("Attempted to break outside a loop.");
-			}
-
-			if (result->Type() == object::CONTINUE)
-			{
+			case COMPLETION_CONTINUE:
 				return createError("Attempted to continue outside a loop.");
+			default:
+				return result;
 			}
 		}
 
 		return result;
 	}
 
-	std::shared_ptr<object::Object> evaluateIdentifier(std::shared_ptr<ast::Identifier> p_identifier, std::shared_ptr<object::Environment> p_environment) 
+	std::shared_ptr<object::Object> evaluateIdentifier(ast::Identifier* p_identifier, const std::shared_ptr<object::Environment>& p_environment) 
 	{
-		std::shared_ptr<object::Object> result = p_environment->getIdentifier(&(p_identifier->m_name));
+		std::shared_ptr<object::Object> result = p_environment->getIdentifier(p_identifier);
 		if (result != NULL)
 		{
 			return result;
@@ -98,53 +114,32 @@ namespace evaluator
 		return createError(error.str());
 	}
 
-	std::shared_ptr<object::Object> evaluateBlockStatement(std::shared_ptr<ast::BlockStatement> p_blockStatements, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateBlockStatement(ast::BlockStatement* p_blockStatements, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		std::shared_ptr<object::Object> result = object::NULL_OBJECT;
 
 		for (int i = 0; i < p_blockStatements->m_statements.size(); i++)
 		{
-			result = evaluate(p_blockStatements->m_statements[i], p_environment);
-
-			if (result != NULL && result->Type() == object::RETURN)
-			{
-				return result;
-			}
-
-			if (result != NULL && result->Type() == object::ERROR)
-			{
-				return result;
-			}
+			result = evaluate(p_blockStatements->m_statements[i].get(), p_environment);
 
-			if (result != NULL && result->Type() == object::BREAK)
-			{
-				return result;
-			}
-
-			if (result != NULL && result->Type() == object::CONTINUE)
-			{
-				return result;
-			}
+			// Returns, breaks, continues and errors all leave the block
+			if (g_completion != COMPLETION_NORMAL) return result;
 		}
 
 		return object::NULL_OBJECT;
 	}
 
-	std::shared_ptr<object::Object> evaluateIntegerLiteral(std::shared_ptr<ast::IntegerLiteral> p_integerLiteral, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateIntegerLiteral(ast::IntegerLiteral* p_integerLiteral, const std::shared_ptr<object::Environment>& p_environment)
 	{
-		std::shared_ptr<object::Integer> object(new object::Integer);
-		object->m_value = p_integerLiteral->m_value;
-		return object;
+		return object::getInteger(p_integerLiteral->m_value);
 	}
 
-	std::shared_ptr<object::Object> evaluateFloatLiteral(std::shared_ptr<ast::FloatLiteral> p_floatLiteral, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateFloatLiteral(ast::FloatLiteral* p_floatLiteral, const std::shared_ptr<object::Environment>& p_environment)
 	{
-		std::shared_ptr<object::Float> object(new object::Float);
-		object->m_value = p_floatLiteral->m_value;
-		return object;
+		return std::make_shared<object::Float>(p_floatLiteral->m_value);
 	}
 
-	std::shared_ptr<object::Object> evaluateBooleanLiteral(std::shared_ptr<ast::BooleanLiteral> p_booleanLiteral, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateBooleanLiteral(ast::BooleanLiteral* p_booleanLiteral, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		if (p_booleanLiteral->m_value)
 		{
@@ -153,14 +148,12 @@ namespace evaluator
 		return object::FALSE_OBJECT;
 	}
 
-	std::shared_ptr<object::Object> evaluateCharacterLiteral(std::shared_ptr<ast::CharacterLiteral> p_characterLiteral, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateCharacterLiteral(ast::CharacterLiteral* p_characterLiteral, const std::shared_ptr<object::Environment>& p_environment)
 	{
-		std::shared_ptr<object::Character> object(new object::Character);
-		object->m_value = p_characterLiteral->m_value;
-		return object;
+		return object::getCharacter(p_characterLiteral->m_value);
 	}
 
-	std::shared_ptr<object::Object> evaluateCollectionLiteral(std::shared_ptr<ast::CollectionLiteral> p_collectionLiteral, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateCollectionLiteral(ast::CollectionLiteral* p_collectionLiteral, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		if (p_collectionLiteral->m_values.size() == 0)
 		{
@@ -171,7 +164,7 @@ namespace evaluator
 
 		for (int i = 0; i < p_collectionLiteral->m_values.size(); i++)
 		{
-			std::shared_ptr<object::Object> evaluatedItem = evaluate(p_collectionLiteral->m_values[i], p_environment);
+			std::shared_ptr<object::Object> evaluatedItem = evaluate(p_collectionLiteral->m_values[i].get(), p_environment);
 
 			if (evaluatedItem->Type() == object::ERROR) return evaluatedItem;
 
@@ -189,7 +182,7 @@ namespace evaluator
 		return object;
 	}
 
-	std::shared_ptr<object::Object> evaluateDictionaryLiteral(std::shared_ptr<ast::DictionaryLiteral> p_dictionaryLiteral, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateDictionaryLiteral(ast::DictionaryLiteral* p_dictionaryLiteral, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		if (p_dictionaryLiteral->m_map.size() == 0)
 		{
@@ -202,7 +195,7 @@ namespace evaluator
 		for (it = p_dictionaryLiteral->m_map.begin(); it != p_dictionaryLiteral->m_map.end(); it++)
 		{
 			// Checking the key
-			std::shared_ptr<object::Object> evaluatedKey = evaluate(it->first, p_environment);
+			std::shared_ptr<object::Object> evaluatedKey = evaluate(it->first.get(), p_environment);
 			if (evaluatedKey->Type() == object::ERROR) return evaluatedKey;
 
 			if (evaluatedKey->Type() != object::INTEGER && evaluatedKey->Type() != object::FLOAT &&
@@ -226,7 +219,7 @@ namespace evaluator
 			}
 
 			// Checking the value
-			std::shared_ptr<object::Object> evaluatedValue = evaluate(it->second, p_environment);
+			std::shared_ptr<object::Object> evaluatedValue = evaluate(it->second.get(), p_environment);
 			if (evaluatedValue->Type() == object::ERROR) return evaluatedValue;
 
 			if (object->m_valueType != object::NULL_TYPE && evaluatedValue->Type() != object->m_valueType)
@@ -243,14 +236,14 @@ namespace evaluator
 		return object;
 	}
 
-	std::shared_ptr<object::Object> evaluateStringLiteral(std::shared_ptr<ast::StringLiteral> p_stringLiteral, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateStringLiteral(ast::StringLiteral* p_stringLiteral, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		std::stringstream value;
 
 		for (int i = 0; i < p_stringLiteral->m_stringCollection->m_values.size(); i++)
 		{
 			// Take expression from string collection and cast to character literal pointer
-			std::shared_ptr<ast::CharacterLiteral> characterLiteral = std::static_pointer_cast<ast::CharacterLiteral>(p_stringLiteral->m_stringCollection->m_values[i]);
+			ast::CharacterLiteral* characterLiteral = (ast::CharacterLiteral*)p_stringLiteral->m_stringCollection->m_values[i].get();
 			value << characterLiteral->m_value;
 		}
 
@@ -259,11 +252,11 @@ namespace evaluator
 		return object;
 	}
 
-	void evaluateExpressions(std::vector<std::shared_ptr<ast::Expression>>* p_source, std::vector<std::shared_ptr<object::Object>>* p_destination, std::shared_ptr<object::Environment> p_environment)
+	void evaluateExpressions(std::vector<std::shared_ptr<ast::Expression>>* p_source, std::vector<std::shared_ptr<object::Object>>* p_destination, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		for (int i = 0; i < p_source->size(); i++)
 		{
-			std::shared_ptr<object::Object> evaluatedExpression = evaluate((*p_source)[i], p_environment);
+			std::shared_ptr<object::Object> evaluatedExpression = evaluate((*p_source)[i].get(), p_environment);
 
 			if (evaluatedExpression->Type() == object::ERROR)
 			{
@@ -275,40 +268,19 @@ namespace evaluator
 		}
 	}
 
-	std::shared_ptr<object::Object> evaluatePrefixExpression(std::shared_ptr<ast::PrefixExpression> p_prefixExpression, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluatePrefixExpression(ast::PrefixExpression* p_prefixExpression, const std::shared_ptr<object::Environment>& p_environment)
 	{
-		std::shared_ptr<object::Object> rightObject = evaluate(p_prefixExpression->m_rightExpression, p_environment);
+		if (p_prefixExpression->m_operator == "++" || p_prefixExpression->m_operator == "--")
+		{
+			return evaluateIncrement(p_prefixExpression->m_rightExpression.get(), &p_prefixExpression->m_operator, false, p_environment);
+		}
+
+		std::shared_ptr<object::Object> rightObject = evaluate(p_prefixExpression->m_rightExpression.get(), p_environment);
 		if (rightObject->Type() == object::ERROR) return rightObject;
 
 		// TODO: Change operator to an enum for performance gain
 		if (p_prefixExpression->m_operator == "!") return evaluateBangOperatorExpression(rightObject);
 		if (p_prefixExpression->m_operator == "-") return evaluateMinusPrefixOperatorExpression(rightObject);
-		if ( (p_prefixExpression->m_operator == "++" || p_prefixExpression->m_operator == "--") && rightObject->Type() == object::INTEGER)
-		{
-			std::shared_ptr<object::Integer> savedValue;
-			if (p_prefixExpression->m_rightExpression->Type() == ast::IDENTIFIER_NODE)
-			{
-				std::shared_ptr<ast::Identifier> identifier = std::static_pointer_cast<ast::Identifier>(p_prefixExpression->m_rightExpression);
-				savedValue = std::static_pointer_cast<object::Integer>(p_environment->getIdentifier(&identifier->m_name));
-			}
-			else if (p_prefixExpression->m_rightExpression->Type() == ast::INDEX_EXPRESSION_NODE)
-			{
-				std::shared_ptr<ast::IndexExpression> indexExpression = std::static_pointer_cast<ast::IndexExpression>(p_prefixExpression->m_rightExpression);
-				savedValue = std::static_pointer_cast<object::Integer>(rightObject);
-			}
-			else
-			{
-				std::ostringstream error;
-				error << object::c_objectTypeToString.at(rightObject->Type()) << " does not support prefix operator "
-					<< p_prefixExpression->m_operator << ".";
-				return createError(error.str());
-			}
-
-			std::shared_ptr<object::Integer> returnValue(savedValue);
-			if (p_prefixExpression->m_operator == "++") savedValue->m_value++;
-			else if (p_prefixExpression->m_operator == "--") savedValue->m_value--;
-			return returnValue;
-		}
 
 		std::ostringstream error;
 		error << p_prefixExpression->m_operator << object::c_objectTypeToString.at(rightObject->Type()) << "\' is not supported.";
@@ -351,14 +323,13 @@ namespace evaluator
 		case object::INTEGER:
 		{
 			std::shared_ptr<object::Integer> integer = std::static_pointer_cast<object::Integer>(p_expression);
-			std::shared_ptr<object::Integer> returnValue(new object::Integer(-integer->m_value));
+			std::shared_ptr<object::Integer> returnValue = object::getInteger(-integer->m_value);
 			return returnValue;
 		}
 		case object::FLOAT:
 		{
 			std::shared_ptr<object::Float> floating = std::static_pointer_cast<object::Float>(p_expression);
-			std::shared_ptr<object::Float> returnValue(new object::Float(-floating->m_value));
-			return returnValue;
+			return std::make_shared<object::Float>(-floating->m_value);
 		}
 		}
 
@@ -367,55 +338,73 @@ namespace evaluator
 		return createError(error.str());
 	}
 
-	std::shared_ptr<object::Object> evaluatePostfixExpression(std::shared_ptr<ast::PostfixExpression> p_postfixExpression, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluatePostfixExpression(ast::PostfixExpression* p_postfixExpression, const std::shared_ptr<object::Environment>& p_environment)
 	{
-		std::shared_ptr<object::Object> leftObject = evaluate(p_postfixExpression->m_leftExpression, p_environment);
-		if (leftObject->Type() == object::ERROR) return leftObject;
+		return evaluateIncrement(p_postfixExpression->m_leftExpression.get(), &p_postfixExpression->m_operator, true, p_environment);
+	}
 
-		std::shared_ptr<object::Integer> savedValue;
-		switch (leftObject->Type())
+	std::shared_ptr<object::Object> evaluateIncrement(ast::Expression* p_operand, std::string* p_operator, bool p_isPostfix, const std::shared_ptr<object::Environment>& p_environment)
+	{
+		std::shared_ptr<object::Object> collection;
+		std::shared_ptr<object::Object> index;
+		std::shared_ptr<object::Object> value;
+
+		// Indexed values are looked up here so that the new value can be stored back in the same slot
+		if (p_operand->Type() == ast::INDEX_EXPRESSION_NODE)
+		{
+			ast::IndexExpression* indexExpression = (ast::IndexExpression*)p_operand;
+			collection = evaluate(indexExpression->m_collection.get(), p_environment);
+
+			index = evaluate(indexExpression->m_index.get(), p_environment);
+			if (index->Type() == object::ERROR) return index;
+
+			value = applyIndex(collection, index);
+		}
+		else
+		{
+			value = evaluate(p_operand, p_environment);
+		}
+		if (value->Type() == object::ERROR) return value;
+
+		if (value->Type() != object::INTEGER)
 		{
-		case object::INTEGER:
-			if (p_postfixExpression->m_leftExpression->Type() == ast::IDENTIFIER_NODE)
-			{
-				std::shared_ptr<ast::Identifier> identifier = std::static_pointer_cast<ast::Identifier>(p_postfixExpression->m_leftExpression);
-				savedValue = std::static_pointer_cast<object::Integer>(p_environment->getIdentifier(&identifier->m_name));
-				break;
-			}
-			else if (p_postfixExpression->m_leftExpression->Type() == ast::INDEX_EXPRESSION_NODE)
-			{
-				std::shared_ptr<ast::IndexExpression> indexExpression = std::static_pointer_cast<ast::IndexExpression>(p_postfixExpression->m_leftExpression);
-				savedValue = std::static_pointer_cast<object::Integer>(leftObject);
-				break;
-			}
-			else
-			{
-				std::ostringstream error;
-				error << object::c_objectTypeToString.at(leftObject->Type()) << " does not support postfix operator "
-					<< p_postfixExpression->m_operator << ".";
-				return createError(error.str());
-			}
-		default:
 			std::ostringstream error;
-			error << object::c_objectTypeToString.at(leftObject->Type()) << p_postfixExpression->m_operator << "\' is not supported.";
+			if (p_isPostfix) error << object::c_objectTypeToString.at(value->Type()) << *p_operator << "\' is not supported.";
+			else error << *p_operator << object::c_objectTypeToString.at(value->Type()) << "\' is not supported.";
 			return createError(error.str());
 		}
 
-		std::shared_ptr<object::Integer> returnValue = std::make_shared<object::Integer>(savedValue->m_value);
-		if (p_postfixExpression->m_operator == "++")
+		if (p_operand->Type() != ast::IDENTIFIER_NODE && p_operand->Type() != ast::INDEX_EXPRESSION_NODE)
 		{
-			savedValue->m_value++;
+			std::ostringstream error;
+			error << object::c_objectTypeToString.at(value->Type()) << " does not support "
+				<< (p_isPostfix ? "postfix" : "prefix") << " operator " << *p_operator << ".";
+			return createError(error.str());
 		}
-		else if (p_postfixExpression->m_operator == "--")
+
+		int currentValue = std::static_pointer_cast<object::Integer>(value)->m_value;
+		std::shared_ptr<object::Integer> newValue = object::getInteger(*p_operator == "++" ? currentValue + 1 : currentValue - 1);
+
+		// Integers are shared between variables, so a new integer is stored instead of changing the current one
+		if (p_operand->Type() == ast::IDENTIFIER_NODE)
 		{
-			savedValue->m_value--;
+			ast::Identifier* identifier = (ast::Identifier*)p_operand;
+			p_environment->reassignIdentifier(identifier, newValue);
+		}
+		else if (collection->Type() == object::COLLECTION)
+		{
+			std::static_pointer_cast<object::Collection>(collection)->m_values[std::static_pointer_cast<object::Integer>(index)->m_value] = newValue;
+		}
+		else
+		{
+			std::static_pointer_cast<object::Dictionary>(collection)->m_map[index] = newValue;
 		}
 
-		return returnValue;
-
+		if (p_isPostfix) return value;
+		return newValue;
 	}
 
-	std::shared_ptr<object::Object> evaluateInfixExpression(std::shared_ptr<ast::InfixExpression> p_infixExpression, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateInfixExpression(ast::InfixExpression* p_infixExpression, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		// identifier = newValue;
 		if (p_infixExpression->m_leftExpression->Type() == ast::IDENTIFIER_NODE && 
@@ -423,8 +412,8 @@ namespace evaluator
 				 p_infixExpression->m_operator == "*=" || p_infixExpression->m_operator == "/=" || p_infixExpression->m_operator == "%=")
 		   )
 		{
-			std::shared_ptr<ast::Identifier> identifier = std::static_pointer_cast<ast::Identifier>(p_infixExpression->m_leftExpression);
-			std::shared_ptr<object::Object> savedValue = p_environment->getIdentifier(&identifier->m_name);
+			ast::Identifier* identifier = (ast::Identifier*)p_infixExpression->m_leftExpression.get();
+			std::shared_ptr<object::Object> savedValue = p_environment->getIdentifier(identifier);
 			if (savedValue == NULL)
 			{
 				std::ostringstream error;
@@ -432,39 +421,39 @@ namespace evaluator
 				return createError(error.str());
 			}
 
-			std::shared_ptr<object::Object> rightObject = evaluate(p_infixExpression->m_rightExpression, p_environment);
+			std::shared_ptr<object::Object> rightObject = evaluate(p_infixExpression->m_rightExpression.get(), p_environment);
 			if (rightObject->Type() == object::ERROR) return rightObject;
 
 			// Dealing with operator + assignment operators
-			std::shared_ptr<ast::InfixExpression> intermediateValue = std::make_shared<ast::InfixExpression>(*p_infixExpression);
+			ast::InfixExpression intermediateValue = *p_infixExpression;
 			if (p_infixExpression->m_operator == "+=")
 			{
-				intermediateValue->m_operator = "+";
-				rightObject = evaluateInfixExpression(intermediateValue, p_environment);
+				intermediateValue.m_operator = "+";
+				rightObject = evaluateInfixExpression(&intermediateValue, p_environment);
 			}
 			else if (p_infixExpression->m_operator == "-=")
 			{
-				intermediateValue->m_operator = "-";
-				rightObject = evaluateInfixExpression(intermediateValue, p_environment);
+				intermediateValue.m_operator = "-";
+				rightObject = evaluateInfixExpression(&intermediateValue, p_environment);
 			}
 			else if (p_infixExpression->m_operator == "*=")
 			{
-				intermediateValue->m_operator = "*";
-				rightObject = evaluateInfixExpression(intermediateValue, p_environment);
+				intermediateValue.m_operator = "*";
+				rightObject = evaluateInfixExpression(&intermediateValue, p_environment);
 			}
 			else if (p_infixExpression->m_operator == "/=")
 			{
-				intermediateValue->m_operator = "/";
-				rightObject = evaluateInfixExpression(intermediateValue, p_environment);
+				intermediateValue.m_operator = "/";
+				rightObject = evaluateInfixExpression(&intermediateValue, p_environment);
 			}
 			else if (p_infixExpression->m_operator == "%=")
 			{
-				intermediateValue->m_operator = "%";
-				rightObject = evaluateInfixExpression(intermediateValue, p_environment);
+				intermediateValue.m_operator = "%";
+				rightObject = evaluateInfixExpression(&intermediateValue, p_environment);
 			}
 			if (rightObject->Type() == object::ERROR) return rightObject;
 
-			if (savedValue->Type() != rightObject->Type())
+			if (!p_infixExpression->m_isTypeChecked && savedValue->Type() != rightObject->Type())
 			{
 				std::ostringstream error;
 				error << "Cannot assign '" << identifier->m_name << "' of type '"
@@ -473,7 +462,7 @@ namespace evaluator
 				return createError(error.str());
 			}
 
-			p_environment->reassignIdentifier(&identifier->m_name, rightObject);
+			p_environment->reassignIdentifier(identifier, rightObject);
 
 			return object::NULL_OBJECT;
 		}
@@ -484,44 +473,44 @@ namespace evaluator
 					 p_infixExpression->m_operator == "*=" || p_infixExpression->m_operator == "/=" || p_infixExpression->m_operator == "%=")
 			    )
 		{
-			std::shared_ptr<ast::IndexExpression> indexExpression = std::static_pointer_cast<ast::IndexExpression>(p_infixExpression->m_leftExpression);
+			ast::IndexExpression* indexExpression = (ast::IndexExpression*)p_infixExpression->m_leftExpression.get();
 
-			std::shared_ptr<object::Object> object = evaluate(indexExpression->m_collection, p_environment);
+			std::shared_ptr<object::Object> object = evaluate(indexExpression->m_collection.get(), p_environment);
 			if (object->Type() == object::ERROR) return object;
 
-			std::shared_ptr<object::Object> indexObject = evaluate(indexExpression->m_index, p_environment);
+			std::shared_ptr<object::Object> indexObject = evaluate(indexExpression->m_index.get(), p_environment);
 			if (indexObject->Type() == object::ERROR) return indexObject;
 
-			std::shared_ptr<object::Object> valueObject = evaluate(p_infixExpression->m_rightExpression, p_environment);
+			std::shared_ptr<object::Object> valueObject = evaluate(p_infixExpression->m_rightExpression.get(), p_environment);
 			if (valueObject->Type() == object::ERROR) return valueObject;
 
 
 			// Dealing with operator + assignment operators
-			std::shared_ptr<ast::InfixExpression> intermediateValue = std::make_shared<ast::InfixExpression>(*p_infixExpression);
+			ast::InfixExpression intermediateValue = *p_infixExpression;
 			if (p_infixExpression->m_operator == "+=")
 			{
-				intermediateValue->m_operator = "+";
-				valueObject = evaluateInfixExpression(intermediateValue, p_environment);
+				intermediateValue.m_operator = "+";
+				valueObject = evaluateInfixExpression(&intermediateValue, p_environment);
 			}
 			else if (p_infixExpression->m_operator == "-=")
 			{
-				intermediateValue->m_operator = "-";
-				valueObject = evaluateInfixExpression(intermediateValue, p_environment);
+				intermediateValue.m_operator = "-";
+				valueObject = evaluateInfixExpression(&intermediateValue, p_environment);
 			}
 			else if (p_infixExpression->m_operator == "*=")
 			{
-				intermediateValue->m_operator = "*";
-				valueObject = evaluateInfixExpression(intermediateValue, p_environment);
+				intermediateValue.m_operator = "*";
+				valueObject = evaluateInfixExpression(&intermediateValue, p_environment);
 			}
 			else if (p_infixExpression->m_operator == "/=")
 			{
-				intermediateValue->m_operator = "/";
-				valueObject = evaluateInfixExpression(intermediateValue, p_environment);
+				intermediateValue.m_operator = "/";
+				valueObject = evaluateInfixExpression(&intermediateValue, p_environment);
 			}
 			else if (p_infixExpression->m_operator == "%=")
 			{
-				intermediateValue->m_operator = "%";
-				valueObject = evaluateInfixExpression(intermediateValue, p_environment);
+				intermediateValue.m_operator = "%";
+				valueObject = evaluateInfixExpression(&intermediateValue, p_environment);
 			}
 			if (valueObject->Type() == object::ERROR) return valueObject;
 
@@ -540,7 +529,7 @@ namespace evaluator
 		// member access
 		else if (p_infixExpression->m_operator == ".")
 		{
-			std::shared_ptr<object::Object> object = evaluate(p_infixExpression->m_leftExpression, p_environment);
+			std::shared_ptr<object::Object> object = evaluate(p_infixExpression->m_leftExpression.get(), p_environment);
 			if (object->Type() == object::ERROR) return object;
 
 			if (p_infixExpression->m_rightExpression->Type() != ast::IDENTIFIER_NODE)
@@ -550,86 +539,91 @@ namespace evaluator
 					p_infixExpression->m_rightExpression->String() << ".";
 				return createError(error.str());
 			}
-			std::shared_ptr<ast::Identifier> name = std::static_pointer_cast<ast::Identifier>(p_infixExpression->m_rightExpression);
+			ast::Identifier* name = (ast::Identifier*)p_infixExpression->m_rightExpression.get();
 			
-			return object->Member(name->m_name);
+			return object->Member(name);
 		}
 
 		// General infix expressions
-		std::shared_ptr<object::Object> leftObject = evaluate(p_infixExpression->m_leftExpression, p_environment);
+		std::shared_ptr<object::Object> leftObject = evaluate(p_infixExpression->m_leftExpression.get(), p_environment);
 		if (leftObject->Type() == object::ERROR) return leftObject;
 
-		std::shared_ptr<object::Object> rightObject = evaluate(p_infixExpression->m_rightExpression, p_environment);
+		std::shared_ptr<object::Object> rightObject = evaluate(p_infixExpression->m_rightExpression.get(), p_environment);
 		if (rightObject->Type() == object::ERROR) return rightObject;
 
-		switch (leftObject->Type())
+		return applyInfixOperator(leftObject, &p_infixExpression->m_operator, rightObject);
+	}
+
+	std::shared_ptr<object::Object> applyInfixOperator(std::shared_ptr<object::Object> p_leftObject, std::string* p_infixOperator, std::shared_ptr<object::Object> p_rightObject)
+	{
+		switch (p_leftObject->Type())
 		{
 		case object::INTEGER:
 		{
-			if (rightObject->Type() == object::INTEGER)
+			if (p_rightObject->Type() == object::INTEGER)
 			{
-				return evaluateIntegerInfixExpression(std::static_pointer_cast<object::Integer>(leftObject), &p_infixExpression->m_operator, std::static_pointer_cast<object::Integer>(rightObject));
+				return evaluateIntegerInfixExpression(std::static_pointer_cast<object::Integer>(p_leftObject), p_infixOperator, std::static_pointer_cast<object::Integer>(p_rightObject));
 			}
-			if (rightObject->Type() == object::FLOAT)
+			if (p_rightObject->Type() == object::FLOAT)
 			{
-				std::shared_ptr<object::Float> castedInteger(new object::Float(std::static_pointer_cast<object::Integer>(leftObject)->m_value));
-				return evaluateFloatInfixExpression(castedInteger, &p_infixExpression->m_operator, std::static_pointer_cast<object::Float>(rightObject));
+				float castedInteger = (float)std::static_pointer_cast<object::Integer>(p_leftObject)->m_value;
+				return evaluateFloatInfixExpression(castedInteger, p_infixOperator, std::static_pointer_cast<object::Float>(p_rightObject)->m_value);
 			}
 			break;
 		}
 		case object::FLOAT:
 		{
-			if (rightObject->Type() == object::INTEGER)
+			if (p_rightObject->Type() == object::INTEGER)
 			{
-				std::shared_ptr<object::Float> castedInteger(new object::Float(std::static_pointer_cast<object::Integer>(rightObject)->m_value));
-				return evaluateFloatInfixExpression(std::static_pointer_cast<object::Float>(leftObject), &p_infixExpression->m_operator, castedInteger);
+				float castedInteger = (float)std::static_pointer_cast<object::Integer>(p_rightObject)->m_value;
+				return evaluateFloatInfixExpression(std::static_pointer_cast<object::Float>(p_leftObject)->m_value, p_infixOperator, castedInteger);
 			}
-			if (rightObject->Type() == object::FLOAT)
+			if (p_rightObject->Type() == object::FLOAT)
 			{
-				return evaluateFloatInfixExpression(std::static_pointer_cast<object::Float>(leftObject), &p_infixExpression->m_operator, std::static_pointer_cast<object::Float>(rightObject));
+				return evaluateFloatInfixExpression(std::static_pointer_cast<object::Float>(p_leftObject)->m_value, p_infixOperator, std::static_pointer_cast<object::Float>(p_rightObject)->m_value);
 			}
 			break;
 		}
 		case object::BOOLEAN:
 		{
-			if (rightObject->Type() == object::BOOLEAN)
+			if (p_rightObject->Type() == object::BOOLEAN)
 			{
-				return evaluateBooleanInfixExpression(std::static_pointer_cast<object::Boolean>(leftObject), &p_infixExpression->m_operator, std::static_pointer_cast<object::Boolean>(rightObject));
+				return evaluateBooleanInfixExpression(std::static_pointer_cast<object::Boolean>(p_leftObject), p_infixOperator, std::static_pointer_cast<object::Boolean>(p_rightObject));
 			}
 			break;
 		}
 		case object::CHARACTER:
 		{
-			if (rightObject->Type() == object::CHARACTER)
+			if (p_rightObject->Type() == object::CHARACTER)
 			{
-				return evaluateCharacterInfixExpression(std::static_pointer_cast<object::Character>(leftObject), &p_infixExpression->m_operator, std::static_pointer_cast<object::Character>(rightObject));
+				return evaluateCharacterInfixExpression(std::static_pointer_cast<object::Character>(p_leftObject), p_infixOperator, std::static_pointer_cast<object::Character>(p_rightObject));
 			}
 			break;
 		}
 		}
 
 		std::ostringstream error;
-		error << "'" << object::c_objectTypeToString.at(leftObject->Type())
-			<< ' ' << *&p_infixExpression->m_operator << ' '
-			<< object::c_objectTypeToString.at(rightObject->Type()) << "\' is not supported.";
+		error << "'" << object::c_objectTypeToString.at(p_leftObject->Type())
+			<< ' ' << *p_infixOperator << ' '
+			<< object::c_objectTypeToString.at(p_rightObject->Type()) << "\' is not supported.";
 		return createError(error.str());
 	}
 
 	std::shared_ptr<object::Object> evaluateIntegerInfixExpression(std::shared_ptr<object::Integer> p_leftObject, std::string* p_infixOperator, std::shared_ptr<object::Integer> p_rightObject)
 	{
 		// TODO: Change operator to an enum for performance gain
-		if (*p_infixOperator == "+") return std::shared_ptr<object::Integer>(new object::Integer(p_leftObject->m_value + p_rightObject->m_value));
-		if (*p_infixOperator == "-") return std::shared_ptr<object::Integer>(new object::Integer(p_leftObject->m_value - p_rightObject->m_value));
-		if (*p_infixOperator == "*") return std::shared_ptr<object::Integer>(new object::Integer(p_leftObject->m_value * p_rightObject->m_value));
+		if (*p_infixOperator == "+") return object::getInteger(p_leftObject->m_value + p_rightObject->m_value);
+		if (*p_infixOperator == "-") return object::getInteger(p_leftObject->m_value - p_rightObject->m_value);
+		if (*p_infixOperator == "*") return object::getInteger(p_leftObject->m_value * p_rightObject->m_value);
 		if (*p_infixOperator == "%") 
 		{
 			if (p_rightObject->m_value == 0) return createError("Attempted modulo by zero.");
-			return std::shared_ptr<object::Integer>(new object::Integer(p_leftObject->m_value % p_rightObject->m_value));
+			return object::getInteger(p_leftObject->m_value % p_rightObject->m_value);
 		}
 		if (*p_infixOperator == "/")
 		{
 			if (p_rightObject->m_value == 0) return createError("Attempted division by zero.");
-			return std::shared_ptr<object::Integer>(new object::Integer(p_leftObject->m_value / p_rightObject->m_value));
+			return object::getInteger(p_leftObject->m_value / p_rightObject->m_value);
 		}
 
 		if (*p_infixOperator == "<")  return object::getBoolean(p_leftObject->m_value < p_rightObject->m_value);
@@ -646,29 +640,27 @@ namespace evaluator
 		return createError(error.str());
 	}
 
-	std::shared_ptr<object::Object> evaluateFloatInfixExpression(std::shared_ptr<object::Float> p_leftObject, std::string* p_infixOperator, std::shared_ptr<object::Float> p_rightObject)
+	std::shared_ptr<object::Object> evaluateFloatInfixExpression(float p_left, std::string* p_infixOperator, float p_right)
 	{
 		// TODO: Change operator to an enum for performance gain
-		if (*p_infixOperator == "+")  return std::shared_ptr<object::Float>(new object::Float(p_leftObject->m_value + p_rightObject->m_value));
-		if (*p_infixOperator == "-")  return std::shared_ptr<object::Float>(new object::Float(p_leftObject->m_value - p_rightObject->m_value));
-		if (*p_infixOperator == "*")  return std::shared_ptr<object::Float>(new object::Float(p_leftObject->m_value * p_rightObject->m_value));
+		if (*p_infixOperator == "+")  return std::make_shared<object::Float>(p_left + p_right);
+		if (*p_infixOperator == "-")  return std::make_shared<object::Float>(p_left - p_right);
+		if (*p_infixOperator == "*")  return std::make_shared<object::Float>(p_left * p_right);
 		if (*p_infixOperator == "/")
 		{
-			if (p_rightObject->m_value == 0) return createError("Attempted division by zero.");
-			return std::shared_ptr<object::Float>(new object::Float(p_leftObject->m_value / p_rightObject->m_value));
+			if (p_right == 0) return createError("Attempted division by zero.");
+			return std::make_shared<object::Float>(p_left / p_right);
 		}
 
-		if (*p_infixOperator == "<")  return object::getBoolean(p_leftObject->m_value < p_rightObject->m_value);
-		if (*p_infixOperator == "<=") return object::getBoolean(p_leftObject->m_value <= p_rightObject->m_value);
-		if (*p_infixOperator == ">")  return object::getBoolean(p_leftObject->m_value > p_rightObject->m_value);
-		if (*p_infixOperator == ">=") return object::getBoolean(p_leftObject->m_value >= p_rightObject->m_value);
-		if (*p_infixOperator == "==") return object::getBoolean(p_leftObject->m_value == p_rightObject->m_value);
-		if (*p_infixOperator == "!=") return object::getBoolean(p_leftObject->m_value != p_rightObject->m_value);
+		if (*p_infixOperator == "<")  return object::getBoolean(p_left < p_right);
+		if (*p_infixOperator == "<=") return object::getBoolean(p_left <= p_right);
+		if (*p_infixOperator == ">")  return object::getBoolean(p_left > p_right);
+		if (*p_infixOperator == ">=") return object::getBoolean(p_left >= p_right);
+		if (*p_infixOperator == "==") return object::getBoolean(p_left == p_right);
+		if (*p_infixOperator == "!=") return object::getBoolean(p_left != p_right);
 
 		std::ostringstream error;
-		error << "'" << object::c_objectTypeToString.at(p_leftObject->Type())
-			<< ' ' << *p_infixOperator << ' '
-			<< object::c_objectTypeToString.at(p_rightObject->Type()) << "\' is not supported.";
+		error << "'float " << *p_infixOperator << " float' is not supported.";
 		return createError(error.str());
 	}
 
@@ -748,10 +740,29 @@ namespace evaluator
 	}
 
 
-	std::shared_ptr<object::Object> evaluateCallExpression(std::shared_ptr<ast::CallExpression> p_callExpression, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateCallExpression(ast::CallExpression* p_callExpression, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		// Issue with returning raw pointer rather than shared pointer
-		std::shared_ptr<object::Object> expression = evaluate(p_callExpression->m_function, p_environment);
+		std::shared_ptr<object::Object> expression;
+		object::BuiltinFunctionPointer method = NULL;
+		std::shared_ptr<ast::Identifier> methodName = getMethodName(p_callExpression);
+		if (methodName != NULL)
+		{
+			// Member functions are called on the object directly, without creating a Builtin for them
+			expression = evaluate(((ast::InfixExpression*)p_callExpression->m_function.get())->m_leftExpression.get(), p_environment);
+			if (expression->Type() == object::ERROR) return expression;
+
+			method = expression->FindMethod(object::getMember(methodName.get()));
+			if (method == NULL)
+			{
+				expression = expression->Member(methodName.get());
+			}
+		}
+		else
+		{
+			expression = evaluate(p_callExpression->m_function.get(), p_environment);
+		}
+
 		if (expression->Type() == object::ERROR)
 		{
 			return expression;
@@ -765,30 +776,38 @@ namespace evaluator
 			return evaluatedArguments[0];
 		}
 
-		if(expression->Type() == object::FUNCTION)
+		if (method != NULL)
+		{
+			// do nothing, checks handled by function itself
+		}
+		else if(expression->Type() == object::FUNCTION)
 		{ 
 			std::shared_ptr<object::Function> function = std::static_pointer_cast<object::Function>(expression);
 
-			if (p_callExpression->m_parameters.size() != function->m_parameters.size())
+			// The checker has already matched the arguments with the parameters
+			if (!p_callExpression->m_isTypeChecked)
 			{
-				std::ostringstream error;
-				error << "'" << function->m_functionName.String() << "' was supplied with "
-					<< p_callExpression->m_parameters.size() << " argument(s) instead of "
-					<< function->m_parameters.size() << ".";
-				return createError(error.str());
-			}
-
-			for (int i = 0; i < evaluatedArguments.size(); i++)
-			{
-				if (evaluatedArguments[i]->Type() != object::c_nodeTypeToObjectType.at(function->m_parameters[i]->m_token.m_type))
+				if (p_callExpression->m_parameters.size() != function->m_parameters.size())
 				{
 					std::ostringstream error;
-					error << "Parameter '" << function->m_parameters[i]->m_name.m_name << "' was supplied with a value of type '"
-						<< object::c_objectTypeToString.at(evaluatedArguments[i]->Type()) << "' instead of type '"
-						<< function->m_parameters[i]->m_token.m_literal << "' for the function call for '"
-						<< function->m_functionName.String() << "'.";
+					error << "'" << function->m_functionName.String() << "' was supplied with "
+						<< p_callExpression->m_parameters.size() << " argument(s) instead of "
+						<< function->m_parameters.size() << ".";
 					return createError(error.str());
 				}
+
+				for (int i = 0; i < evaluatedArguments.size(); i++)
+				{
+					if (evaluatedArguments[i]->Type() != object::c_nodeTypeToObjectType.at(function->m_parameters[i]->m_token.m_type))
+					{
+						std::ostringstream error;
+						error << "Parameter '" << function->m_parameters[i]->m_name.m_name << "' was supplied with a value of type '"
+							<< object::c_objectTypeToString.at(evaluatedArguments[i]->Type()) << "' instead of type '"
+							<< function->m_parameters[i]->m_token.m_literal << "' for the function call for '"
+							<< function->m_functionName.String() << "'.";
+						return createError(error.str());
+					}
+				}
 			}
 		}
 		else if (expression->Type() == object::BUILTIN_FUNCTION) 
@@ -802,10 +821,12 @@ namespace evaluator
 			return createError(error.str());
 		}
 
-		std::shared_ptr<object::Object> output = applyFunction(expression, &evaluatedArguments);
+		std::shared_ptr<object::Object> output = method != NULL
+			? method(&evaluatedArguments, expression)
+			: applyFunction(expression, &evaluatedArguments);
 		if (output->Type() == object::ERROR) return output;
-		if (output->Type() == object::BREAK) return createError("Attempted to break outside a loop.");
-		if (output->Type() == object::CONTINUE) return createError("Attempted to continue outside a loop.");
+		if (g_completion == COMPLETION_BREAK) return createError("Attempted to break outside a loop.");
+		if (g_completion == COMPLETION_CONTINUE) return createError("Attempted to continue outside a loop.");
 
 		if (expression->Type() == object::FUNCTION && output->Type() == object::NULL_TYPE)
 		{
@@ -814,7 +835,8 @@ namespace evaluator
 			return createError(error.str());
 		}
 
-		if (expression->Type() == object::FUNCTION && output->Type() != std::static_pointer_cast<object::Function>(expression)->m_functionType)
+		if (expression->Type() == object::FUNCTION && !std::static_pointer_cast<object::Function>(expression)->m_isTypeChecked &&
+			output->Type() != std::static_pointer_cast<object::Function>(expression)->m_functionType)
 		{
 			std::ostringstream error;
 			error << "'" << p_callExpression->String() << "\' produced a value of type '"
@@ -826,39 +848,44 @@ namespace evaluator
 		return output;
 	}
 
-	std::shared_ptr<object::Object> evaluateIndexExpression(std::shared_ptr<ast::IndexExpression> p_indexExpression, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateIndexExpression(ast::IndexExpression* p_indexExpression, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		// Evaluate expression and apply index to it
-		std::shared_ptr<object::Object> expression = evaluate(p_indexExpression->m_collection, p_environment);
+		std::shared_ptr<object::Object> expression = evaluate(p_indexExpression->m_collection.get(), p_environment);
 
 		// Get index
-		std::shared_ptr<object::Object> indexObject = evaluate(p_indexExpression->m_index, p_environment);
+		std::shared_ptr<object::Object> indexObject = evaluate(p_indexExpression->m_index.get(), p_environment);
 		if (indexObject->Type() == object::ERROR) return indexObject;
 
-		if (expression->Type() != object::DICTIONARY && indexObject->Type() != object::INTEGER)
+		return applyIndex(expression, indexObject);
+	}
+
+	std::shared_ptr<object::Object> applyIndex(std::shared_ptr<object::Object> p_object, std::shared_ptr<object::Object> p_indexObject)
+	{
+		if (p_object->Type() != object::DICTIONARY && p_indexObject->Type() != object::INTEGER)
 		{
 			std::ostringstream error;
-			error << "Invalid index: '" << indexObject->Inspect() << "'";
+			error << "Invalid index: '" << p_indexObject->Inspect() << "'";
 			return createError(error.str());
 		}
-		else if (expression->Type() == object::DICTIONARY &&
-			(indexObject->Type() != std::static_pointer_cast<object::Dictionary>(expression)->m_keyType))
+		else if (p_object->Type() == object::DICTIONARY &&
+			(p_indexObject->Type() != std::static_pointer_cast<object::Dictionary>(p_object)->m_keyType))
 		{
 			std::ostringstream error;
 			error << "Dictionary has keys of type: '" << 
-				object::c_objectTypeToString.at(std::static_pointer_cast<object::Dictionary>(expression)->m_keyType) <<
-				"'. Got type: '" << object::c_objectTypeToString.at(indexObject->Type()) << "'";
+				object::c_objectTypeToString.at(std::static_pointer_cast<object::Dictionary>(p_object)->m_keyType) <<
+				"'. Got type: '" << object::c_objectTypeToString.at(p_indexObject->Type()) << "'";
 			return createError(error.str());
 		}
 
 
-		switch (expression->Type())
+		switch (p_object->Type())
 		{
 		case object::ERROR:
-			return expression;
+			return p_object;
 		case object::COLLECTION:
 		{
-			std::shared_ptr<object::Integer> index = std::static_pointer_cast<object::Integer>(indexObject);
+			std::shared_ptr<object::Integer> index = std::static_pointer_cast<object::Integer>(p_indexObject);
 
 			if (index->m_value < 0)
 			{
@@ -867,12 +894,12 @@ namespace evaluator
 				return createError(error.str());
 			}
 
-			if (index->m_value >= std::static_pointer_cast<object::Collection>(expression)->m_values.size()) return createError("Index out of bounds.");
-			return std::static_pointer_cast<object::Collection>(expression)->m_values[index->m_value];
+			if (index->m_value >= std::static_pointer_cast<object::Collection>(p_object)->m_values.size()) return createError("Index out of bounds.");
+			return std::static_pointer_cast<object::Collection>(p_object)->m_values[index->m_value];
 		}
 		case object::STRING:
 		{
-			std::shared_ptr<object::Integer> index = std::static_pointer_cast<object::Integer>(indexObject);
+			std::shared_ptr<object::Integer> index = std::static_pointer_cast<object::Integer>(p_indexObject);
 
 			if (index->m_value < 0)
 			{
@@ -881,41 +908,41 @@ namespace evaluator
 				return createError(error.str());
 			}
 
-			if (index->m_value >= std::static_pointer_cast<object::String>(expression)->m_value.size()) return createError("Index out of bounds.");
-			char value = std::static_pointer_cast<object::String>(expression)->m_value[index->m_value];
-			return std::shared_ptr<object::Character>(new object::Character(value));
+			if (index->m_value >= std::static_pointer_cast<object::String>(p_object)->m_value.size()) return createError("Index out of bounds.");
+			char value = std::static_pointer_cast<object::String>(p_object)->m_value[index->m_value];
+			return object::getCharacter(value);
 		}
 		case object::DICTIONARY:
 		{
-			if (std::static_pointer_cast<object::Dictionary>(expression)->m_map.find(indexObject) == std::static_pointer_cast<object::Dictionary>(expression)->m_map.end()) return createError("Index not in dictionary.");
-			return std::static_pointer_cast<object::Dictionary>(expression)->m_map.at(indexObject);
+			if (std::static_pointer_cast<object::Dictionary>(p_object)->m_map.find(p_indexObject) == std::static_pointer_cast<object::Dictionary>(p_object)->m_map.end()) return createError("Index not in dictionary.");
+			return std::static_pointer_cast<object::Dictionary>(p_object)->m_map.at(p_indexObject);
 		}
 		}
 
 		// Error for unsupported types.
 		std::ostringstream error;
-		error << "'" << expression->Inspect() << "' is not an indexable value.";
+		error << "'" << p_object->Inspect() << "' is not an indexable value.";
 		return createError(error.str());
 	}
 
 
-	std::shared_ptr<object::Object> evaluateDeclareVariable(std::shared_ptr<ast::DeclareVariableStatement> p_declareVariable, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateDeclareVariable(ast::DeclareVariableStatement* p_declareVariable, const std::shared_ptr<object::Environment>& p_environment)
 	{
-		if (p_environment->getLocalIdentifier(&p_declareVariable->m_name.m_name) != NULL)
+		if (p_environment->getLocalIdentifier(&p_declareVariable->m_name) != NULL)
 		{
 			std::ostringstream error;
 			error << "Redefinition of '" << p_declareVariable->m_name.m_name << "'.";
 			return createError(error.str());
 		}
 
-		std::shared_ptr<object::Object> object = evaluate(p_declareVariable->m_value, p_environment);
+		std::shared_ptr<object::Object> object = evaluate(p_declareVariable->m_value.get(), p_environment);
 
 		if (object->Type() == object::ERROR)
 		{
 			return object;
 		}
 
-		if (p_declareVariable->m_token.m_literal != object::c_objectTypeToString.at(object->Type()))
+		if (!p_declareVariable->m_isTypeChecked && p_declareVariable->m_token.m_literal != object::c_objectTypeToString.at(object->Type()))
 		{
 			std::ostringstream error;
 			error << "'" << p_declareVariable->m_name.m_name
@@ -924,29 +951,29 @@ namespace evaluator
 			return createError(error.str());
 		}
 
-		p_environment->setIdentifier(&p_declareVariable->m_name.m_name, object);
+		p_environment->setIdentifier(&p_declareVariable->m_name, object);
 
 		return object::NULL_OBJECT;
 	}
 
 
-	std::shared_ptr<object::Object> evaluateDeclareCollection(std::shared_ptr<ast::DeclareCollectionStatement> p_declareCollection, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateDeclareCollection(ast::DeclareCollectionStatement* p_declareCollection, const std::shared_ptr<object::Environment>& p_environment)
 	{
-		if (p_environment->getLocalIdentifier(&p_declareCollection->m_name.m_name) != NULL)
+		if (p_environment->getLocalIdentifier(&p_declareCollection->m_name) != NULL)
 		{
 			std::ostringstream error;
 			error << "Redefinition of '" << p_declareCollection->m_name.m_name << "'.";
 			return createError(error.str());
 		}
 
-		std::shared_ptr<object::Object> object = evaluate(p_declareCollection->m_value, p_environment);
+		std::shared_ptr<object::Object> object = evaluate(p_declareCollection->m_value.get(), p_environment);
 
 		if (object->Type() == object::ERROR)
 		{
 			return object;
 		}
 
-		if (p_declareCollection->m_token.m_literal != object::c_objectTypeToString.at(object->Type()))
+		if (!p_declareCollection->m_isTypeChecked && p_declareCollection->m_token.m_literal != object::c_objectTypeToString.at(object->Type()))
 		{
 			std::ostringstream error;
 			error << "'" << p_declareCollection->m_name.m_name
@@ -957,7 +984,7 @@ namespace evaluator
 
 		std::shared_ptr<object::Collection> collection = std::static_pointer_cast<object::Collection>(object);
 
-		if (collection->m_collectionType != object::NULL_TYPE && p_declareCollection->m_typeToken.m_literal != object::c_objectTypeToString.at(collection->m_collectionType))
+		if (!p_declareCollection->m_isTypeChecked && collection->m_collectionType != object::NULL_TYPE && p_declareCollection->m_typeToken.m_literal != object::c_objectTypeToString.at(collection->m_collectionType))
 		{
 			std::ostringstream error;
 			error << "'" << p_declareCollection->m_name.m_name
@@ -971,29 +998,29 @@ namespace evaluator
 			collection->m_collectionType = object::c_nodeTypeToObjectType.at(p_declareCollection->m_typeToken.m_type);
 		}
 
-		p_environment->setIdentifier(&p_declareCollection->m_name.m_name, object);
+		p_environment->setIdentifier(&p_declareCollection->m_name, object);
 
 		return object::NULL_OBJECT;
 	}
 
 
-	std::shared_ptr<object::Object> evaluateDeclareDictionary(std::shared_ptr<ast::DeclareDictionaryStatement> p_declareDictionary, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateDeclareDictionary(ast::DeclareDictionaryStatement* p_declareDictionary, const std::shared_ptr<object::Environment>& p_environment)
 	{
-		if (p_environment->getLocalIdentifier(&p_declareDictionary->m_name.m_name) != NULL)
+		if (p_environment->getLocalIdentifier(&p_declareDictionary->m_name) != NULL)
 		{
 			std::ostringstream error;
 			error << "Redefinition of '" << p_declareDictionary->m_name.m_name << "'.";
 			return createError(error.str());
 		}
 
-		std::shared_ptr<object::Object> object = evaluate(p_declareDictionary->m_value, p_environment);
+		std::shared_ptr<object::Object> object = evaluate(p_declareDictionary->m_value.get(), p_environment);
 
 		if (object->Type() == object::ERROR)
 		{
 			return object;
 		}
 
-		if (p_declareDictionary->m_token.m_literal != object::c_objectTypeToString.at(object->Type()))
+		if (!p_declareDictionary->m_isTypeChecked && p_declareDictionary->m_token.m_literal != object::c_objectTypeToString.at(object->Type()))
 		{
 			std::ostringstream error;
 			error << "'" << p_declareDictionary->m_name.m_name
@@ -1004,7 +1031,7 @@ namespace evaluator
 
 		std::shared_ptr<object::Dictionary> dictionary = std::static_pointer_cast<object::Dictionary>(object);
 
-		if (dictionary->m_keyType != object::NULL_TYPE &&
+		if (!p_declareDictionary->m_isTypeChecked && dictionary->m_keyType != object::NULL_TYPE &&
 			(p_declareDictionary->m_keyTypeToken.m_literal != object::c_objectTypeToString.at(dictionary->m_keyType) ||
 				p_declareDictionary->m_valueTypeToken.m_literal != object::c_objectTypeToString.at(dictionary->m_valueType)))
 		{
@@ -1016,7 +1043,7 @@ namespace evaluator
 			return createError(error.str());
 		}
 
-		p_environment->setIdentifier(&p_declareDictionary->m_name.m_name, object);
+		p_environment->setIdentifier(&p_declareDictionary->m_name, object);
 
 		dictionary->m_keyType = object::c_nodeTypeToObjectType.at(p_declareDictionary->m_keyTypeToken.m_type);
 		dictionary->m_valueType = object::c_nodeTypeToObjectType.at(p_declareDictionary->m_valueTypeToken.m_type);
@@ -1024,7 +1051,7 @@ namespace evaluator
 		return object::NULL_OBJECT;
 	}
 
-	std::shared_ptr<object::Object> evaluateDeclareFunction(std::shared_ptr<ast::DeclareFunctionStatement> p_declareFunction, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateDeclareFunction(ast::DeclareFunctionStatement* p_declareFunction, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		if (object::c_nodeTypeToObjectType.count(p_declareFunction->m_token.m_type) == 0)
 		{
@@ -1037,26 +1064,28 @@ namespace evaluator
 		object::ObjectType functionType = object::c_nodeTypeToObjectType.at(p_declareFunction->m_token.m_type);
 		std::shared_ptr<object::Function> result(new object::Function(functionType, p_declareFunction, p_environment));
 
-		p_environment->setIdentifier(&p_declareFunction->m_name.m_name, result);
+		p_environment->setIdentifier(&p_declareFunction->m_name, result);
 
 		return object::NULL_OBJECT;
 	}
 
-	std::shared_ptr<object::Object> evaluateReturnStatement(std::shared_ptr<ast::ReturnStatement> p_returnStatement, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateReturnStatement(ast::ReturnStatement* p_returnStatement, const std::shared_ptr<object::Environment>& p_environment)
 	{
-		return std::shared_ptr<object::Object>(new object::Return(evaluate(p_returnStatement->m_returnValue, p_environment)));
+		std::shared_ptr<object::Object> returnValue = evaluate(p_returnStatement->m_returnValue.get(), p_environment);
+		if (g_completion == COMPLETION_NORMAL) g_completion = COMPLETION_RETURN;
+		return returnValue;
 	}
 
-	std::shared_ptr<object::Object> evaluateIfStatement(std::shared_ptr<ast::IfStatement> p_ifStatement, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateIfStatement(ast::IfStatement* p_ifStatement, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		// Treat as else caluse
 		if (p_ifStatement->m_condition == NULL)
 		{
 			std::shared_ptr<object::Environment> ifEnvironment(new object::Environment(p_environment));
-			return evaluate(p_ifStatement->m_consequence, ifEnvironment);
+			return evaluate(p_ifStatement->m_consequence.get(), ifEnvironment);
 		}
 
-		std::shared_ptr<object::Object> evaluatedCondition = evaluate(p_ifStatement->m_condition, p_environment);
+		std::shared_ptr<object::Object> evaluatedCondition = evaluate(p_ifStatement->m_condition.get(), p_environment);
 
 		if (evaluatedCondition->Type() == object::ERROR)
 		{
@@ -1075,11 +1104,11 @@ namespace evaluator
 
 		if (truthyBoolean->m_value)
 		{
-			return evaluate(p_ifStatement->m_consequence, ifEnvironment);
+			return evaluate(p_ifStatement->m_consequence.get(), ifEnvironment);
 		}
 		else if (p_ifStatement->m_alternative != NULL)
 		{
-			return evaluate(p_ifStatement->m_alternative, ifEnvironment);
+			return evaluate(p_ifStatement->m_alternative.get(), ifEnvironment);
 		}
 		else
 		{
@@ -1087,13 +1116,13 @@ namespace evaluator
 		}
 	}
 	
-	std::shared_ptr<object::Object> evaluateWhileStatement(std::shared_ptr<ast::WhileStatement> p_whileStatement, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateWhileStatement(ast::WhileStatement* p_whileStatement, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		std::shared_ptr<object::Environment> whileEnvironment(new object::Environment(p_environment));
 
 		while (true)
 		{
-			std::shared_ptr<object::Object> evaluatedCondition = evaluate(p_whileStatement->m_condition, p_environment);
+			std::shared_ptr<object::Object> evaluatedCondition = evaluate(p_whileStatement->m_condition.get(), p_environment);
 			if (evaluatedCondition->Type() == object::ERROR)
 			{
 				return evaluatedCondition;
@@ -1108,20 +1137,18 @@ namespace evaluator
 			std::shared_ptr<object::Boolean> truthyBoolean = std::static_pointer_cast<object::Boolean>(truthy);
 			if (!truthyBoolean->m_value) break;
 
-			std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_whileStatement->m_consequence, whileEnvironment);
-			if (evaluatedConsequence->Type() == object::ERROR)
-			{
-				return evaluatedConsequence;
-			}
-			else if (evaluatedConsequence->Type() == object::BREAK)
+			nextIteration(&whileEnvironment, p_environment);
+			std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_whileStatement->m_consequence.get(), whileEnvironment);
+			if (g_completion == COMPLETION_BREAK)
 			{
+				g_completion = COMPLETION_NORMAL;
 				break;
 			}
-			else if (evaluatedConsequence->Type() == object::CONTINUE)
+			else if (g_completion == COMPLETION_CONTINUE)
 			{
-				continue;
+				g_completion = COMPLETION_NORMAL;
 			}
-			else if (evaluatedConsequence->Type() == object::RETURN)
+			else if (g_completion != COMPLETION_NORMAL)
 			{
 				return evaluatedConsequence;
 			}
@@ -1130,31 +1157,28 @@ namespace evaluator
 		return object::NULL_OBJECT;
 	}
 
-	std::shared_ptr<object::Object> evaluateDoWhileStatement(std::shared_ptr<ast::DoWhileStatement> p_doWhileStatement, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateDoWhileStatement(ast::DoWhileStatement* p_doWhileStatement, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		std::shared_ptr<object::Environment> doWhileEnvironment(new object::Environment(p_environment));
 
-		std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_doWhileStatement->m_consequence, doWhileEnvironment);
-		if (evaluatedConsequence->Type() == object::ERROR)
-		{
-			return evaluatedConsequence;
-		}
-		else if (evaluatedConsequence->Type() == object::BREAK)
+		std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_doWhileStatement->m_consequence.get(), doWhileEnvironment);
+		if (g_completion == COMPLETION_BREAK)
 		{
+			g_completion = COMPLETION_NORMAL;
 			return object::NULL_OBJECT;
 		}
-		else if (evaluatedConsequence->Type() == object::CONTINUE)
+		else if (g_completion == COMPLETION_CONTINUE)
 		{
-			; // just continue
+			g_completion = COMPLETION_NORMAL;
 		}
-		else if (evaluatedConsequence->Type() == object::RETURN)
+		else if (g_completion != COMPLETION_NORMAL)
 		{
 			return evaluatedConsequence;
 		}
 
 		while (true)
 		{
-			std::shared_ptr<object::Object> evaluatedCondition = evaluate(p_doWhileStatement->m_condition, p_environment);
+			std::shared_ptr<object::Object> evaluatedCondition = evaluate(p_doWhileStatement->m_condition.get(), p_environment);
 			if (evaluatedCondition->Type() == object::ERROR)
 			{
 				return evaluatedCondition;
@@ -1169,20 +1193,18 @@ namespace evaluator
 			std::shared_ptr<object::Boolean> truthyBoolean = std::static_pointer_cast<object::Boolean>(truthy);
 			if (!truthyBoolean->m_value) break;
 
-			std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_doWhileStatement->m_consequence, doWhileEnvironment);
-			if (evaluatedConsequence->Type() == object::ERROR)
-			{
-				return evaluatedConsequence;
-			}
-			else if (evaluatedConsequence->Type() == object::BREAK)
+			nextIteration(&doWhileEnvironment, p_environment);
+			std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_doWhileStatement->m_consequence.get(), doWhileEnvironment);
+			if (g_completion == COMPLETION_BREAK)
 			{
+				g_completion = COMPLETION_NORMAL;
 				break;
 			}
-			else if (evaluatedConsequence->Type() == object::CONTINUE)
+			else if (g_completion == COMPLETION_CONTINUE)
 			{
-				continue;
+				g_completion = COMPLETION_NORMAL;
 			}
-			else if (evaluatedConsequence->Type() == object::RETURN)
+			else if (g_completion != COMPLETION_NORMAL)
 			{
 				return evaluatedConsequence;
 			}
@@ -1192,20 +1214,26 @@ namespace evaluator
 	}
 
 	// Evaluates an while statement
-	std::shared_ptr<object::Object> evaluateForStatement(std::shared_ptr<ast::ForStatement> p_forStatement, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateForStatement(ast::ForStatement* p_forStatement, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		std::shared_ptr<object::Environment> forConditionEnvironment(new object::Environment(p_environment));
 
-		std::shared_ptr<object::Object> evaluatedInitialization = evaluate(p_forStatement->m_initialization, forConditionEnvironment);
+		std::shared_ptr<object::Object> evaluatedInitialization = evaluate(p_forStatement->m_initialization.get(), forConditionEnvironment);
 		if (evaluatedInitialization->Type() == object::ERROR)
 		{
 			return evaluatedInitialization;
 		}
 
+		if (p_forStatement->m_isCounted)
+		{
+			std::shared_ptr<object::Object> counted = evaluateCountedForStatement(p_forStatement, forConditionEnvironment);
+			if (counted != NULL) return counted;
+		}
+
+		std::shared_ptr<object::Environment> forEnvironment(new object::Environment(forConditionEnvironment));
 		while (true)
 		{
-			std::shared_ptr<object::Environment> forEnvironment(new object::Environment(forConditionEnvironment));
-			std::shared_ptr<object::Object> evaluatedCondition = evaluate(p_forStatement->m_condition, forConditionEnvironment);
+			std::shared_ptr<object::Object> evaluatedCondition = evaluate(p_forStatement->m_condition.get(), forConditionEnvironment);
 			if (evaluatedCondition->Type() == object::ERROR)
 			{
 				return evaluatedCondition;
@@ -1220,39 +1248,113 @@ namespace evaluator
 			std::shared_ptr<object::Boolean> truthyBoolean = std::static_pointer_cast<object::Boolean>(truthy);
 			if (!truthyBoolean->m_value) break;
 
-			std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_forStatement->m_consequence, forEnvironment);
-			if (evaluatedConsequence->Type() == object::ERROR)
+			nextIteration(&forEnvironment, forConditionEnvironment);
+			std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_forStatement->m_consequence.get(), forEnvironment);
+			Completion completion = g_completion;
+			if (completion == COMPLETION_ERROR)
 			{
 				return evaluatedConsequence;
 			}
 
-			std::shared_ptr<object::Object> evaluatedUpdation = evaluate(p_forStatement->m_updation, forConditionEnvironment);
+			// The updation still runs after a break, continue or return
+			g_completion = COMPLETION_NORMAL;
+			std::shared_ptr<object::Object> evaluatedUpdation = evaluate(p_forStatement->m_updation.get(), forConditionEnvironment);
 			if (evaluatedUpdation->Type() == object::ERROR)
 			{
 				return evaluatedUpdation;
 			}
-			else if (evaluatedConsequence->Type() == object::BREAK)
+			else if (completion == COMPLETION_BREAK)
 			{
 				break;
 			}
-			else if (evaluatedConsequence->Type() == object::CONTINUE)
+			else if (completion == COMPLETION_RETURN)
 			{
-				continue;
+				g_completion = COMPLETION_RETURN;
+				return evaluatedConsequence;
 			}
-			else if (evaluatedConsequence->Type() == object::RETURN)
+		}
+
+		return object::NULL_OBJECT;
+	}
+
+	std::shared_ptr<object::Object> evaluateCountedForStatement(ast::ForStatement* p_forStatement, const std::shared_ptr<object::Environment>& p_environment)
+	{
+		ast::DeclareVariableStatement* counter = (ast::DeclareVariableStatement*)p_forStatement->m_initialization.get();
+		ast::InfixExpression* condition = (ast::InfixExpression*)((ast::ExpressionStatement*)p_forStatement->m_condition.get())->m_expression.get();
+
+		std::shared_ptr<object::Object> counterObject = evaluate(condition->m_leftExpression.get(), p_environment);
+		std::shared_ptr<object::Object> boundObject = evaluate(condition->m_rightExpression.get(), p_environment);
+		if (boundObject->Type() == object::ERROR) return boundObject;
+		if (counterObject->Type() != object::INTEGER || boundObject->Type() != object::INTEGER) return NULL;
+
+		// The counter steps in a wider type, so a counter about to overflow is seen leaving the range of an integer
+		long long value = std::static_pointer_cast<object::Integer>(counterObject)->m_value;
+		long long bound = std::static_pointer_cast<object::Integer>(boundObject)->m_value;
+
+		// The step is either ++, --, or an amount added or subtracted that is evaluated once
+		long long step = 1;
+		ast::Expression* updation = ((ast::ExpressionStatement*)p_forStatement->m_updation.get())->m_expression.get();
+		if (updation->Type() == ast::POSTFIX_EXPRESSION_NODE)
+		{
+			step = ((ast::PostfixExpression*)updation)->m_operator == "++" ? 1 : -1;
+		}
+		else if (updation->Type() == ast::PREFIX_EXPRESSION_NODE)
+		{
+			step = ((ast::PrefixExpression*)updation)->m_operator == "++" ? 1 : -1;
+		}
+		else
+		{
+			ast::InfixExpression* infixExpression = (ast::InfixExpression*)updation;
+			std::shared_ptr<object::Object> amountObject = evaluate(infixExpression->m_rightExpression.get(), p_environment);
+			if (amountObject->Type() == object::ERROR) return amountObject;
+			if (amountObject->Type() != object::INTEGER) return NULL;
+
+			long long amount = std::static_pointer_cast<object::Integer>(amountObject)->m_value;
+			step = infixExpression->m_operator == "+=" ? amount : -amount;
+		}
+
+		// The comparison is decoded once instead of on every iteration
+		int comparison = condition->m_operator == "<" ? 0 : condition->m_operator == "<=" ? 1 : condition->m_operator == ">" ? 2 : 3;
+
+		std::shared_ptr<object::Environment> forEnvironment(new object::Environment(p_environment));
+		while (comparison == 0 ? value < bound : comparison == 1 ? value <= bound : comparison == 2 ? value > bound : value >= bound)
+		{
+			// One unit of fuel stands in for the condition and updation of the iteration
+			if (!useFuel()) return budgetError();
+
+			nextIteration(&forEnvironment, p_environment);
+			std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_forStatement->m_consequence.get(), forEnvironment);
+			Completion completion = g_completion;
+			if (completion == COMPLETION_ERROR)
 			{
 				return evaluatedConsequence;
 			}
+
+			// The counter still steps after a break, continue or return, as the updation would.
+			// A step that leaves the range of an integer ends the loop, with the counter left at its last value.
+			g_completion = COMPLETION_NORMAL;
+			value += step;
+			bool isInRange = value >= INT_MIN && value <= INT_MAX;
+			if (isInRange) p_environment->setIdentifier(&counter->m_name, object::getInteger((int)value));
+			if (completion == COMPLETION_RETURN)
+			{
+				g_completion = COMPLETION_RETURN;
+				return evaluatedConsequence;
+			}
+			else if (completion == COMPLETION_BREAK || !isInRange)
+			{
+				break;
+			}
 		}
 
 		return object::NULL_OBJECT;
 	}
 
-	std::shared_ptr<object::Object> evaluateIterateStatement(std::shared_ptr<ast::IterateStatement> p_iterateStatement, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateIterateStatement(ast::IterateStatement* p_iterateStatement, const std::shared_ptr<object::Environment>& p_environment)
 	{
 		std::shared_ptr<object::Environment> iterateEnvironment(new object::Environment(p_environment));
 
-		std::shared_ptr<object::Object> evaluatedIterator = evaluate(p_iterateStatement->m_collection, p_environment);
+		std::shared_ptr<object::Object> evaluatedIterator = evaluate(p_iterateStatement->m_collection.get(), p_environment);
 		if (evaluatedIterator->Type() == object::ERROR)
 		{
 			return evaluatedIterator;
@@ -1264,13 +1366,13 @@ namespace evaluator
 
 			for (std::shared_ptr<object::Object> value : collection->m_values)
 			{
-				iterateEnvironment->setIdentifier(&p_iterateStatement->m_var->m_name, value);
+				nextIteration(&iterateEnvironment, p_environment);
+				iterateEnvironment->setIdentifier(p_iterateStatement->m_var.get(), value);
 
-				std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_iterateStatement->m_consequence, iterateEnvironment);
-				if (evaluatedConsequence->Type() == object::ERROR) return evaluatedConsequence;
-				else if (evaluatedConsequence->Type() == object::BREAK) break;
-				else if (evaluatedConsequence->Type() == object::CONTINUE) continue;
-				else if (evaluatedConsequence->Type() == object::RETURN) return evaluatedConsequence;
+				std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_iterateStatement->m_consequence.get(), iterateEnvironment);
+				if (g_completion == COMPLETION_BREAK) { g_completion = COMPLETION_NORMAL; break; }
+				else if (g_completion == COMPLETION_CONTINUE) g_completion = COMPLETION_NORMAL;
+				else if (g_completion != COMPLETION_NORMAL) return evaluatedConsequence;
 			}
 		}
 		else if (evaluatedIterator->Type() == object::DICTIONARY)
@@ -1279,13 +1381,13 @@ namespace evaluator
 
 			for (auto const& keyValuePair : dictionary->m_map)
 			{
-				iterateEnvironment->setIdentifier(&p_iterateStatement->m_var->m_name, keyValuePair.first);
+				nextIteration(&iterateEnvironment, p_environment);
+				iterateEnvironment->setIdentifier(p_iterateStatement->m_var.get(), keyValuePair.first);
 
-				std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_iterateStatement->m_consequence, iterateEnvironment);
-				if (evaluatedConsequence->Type() == object::ERROR) return evaluatedConsequence;
-				else if (evaluatedConsequence->Type() == object::BREAK) break;
-				else if (evaluatedConsequence->Type() == object::CONTINUE) continue;
-				else if (evaluatedConsequence->Type() == object::RETURN) return evaluatedConsequence;
+				std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_iterateStatement->m_consequence.get(), iterateEnvironment);
+				if (g_completion == COMPLETION_BREAK) { g_completion = COMPLETION_NORMAL; break; }
+				else if (g_completion == COMPLETION_CONTINUE) g_completion = COMPLETION_NORMAL;
+				else if (g_completion != COMPLETION_NORMAL) return evaluatedConsequence;
 			}
 		}
 		else if (evaluatedIterator->Type() == object::STRING)
@@ -1294,14 +1396,14 @@ namespace evaluator
 
 			for (char chr : string->m_value)
 			{
-				std::shared_ptr<object::Character> character = std::make_shared<object::Character>(chr);
-				iterateEnvironment->setIdentifier(&p_iterateStatement->m_var->m_name, character);
-
-				std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_iterateStatement->m_consequence, iterateEnvironment);
-				if (evaluatedConsequence->Type() == object::ERROR) return evaluatedConsequence;
-				else if (evaluatedConsequence->Type() == object::BREAK) break;
-				else if (evaluatedConsequence->Type() == object::CONTINUE) continue;
-				else if (evaluatedConsequence->Type() == object::RETURN) return evaluatedConsequence;
+				std::shared_ptr<object::Character> character = object::getCharacter(chr);
+				nextIteration(&iterateEnvironment, p_environment);
+				iterateEnvironment->setIdentifier(p_iterateStatement->m_var.get(), character);
+
+				std::shared_ptr<object::Object> evaluatedConsequence = evaluate(p_iterateStatement->m_consequence.get(), iterateEnvironment);
+				if (g_completion == COMPLETION_BREAK) { g_completion = COMPLETION_NORMAL; break; }
+				else if (g_completion == COMPLETION_CONTINUE) g_completion = COMPLETION_NORMAL;
+				else if (g_completion != COMPLETION_NORMAL) return evaluatedConsequence;
 			}
 		}
 		else
@@ -1315,14 +1417,33 @@ namespace evaluator
 		return object::NULL_OBJECT;
 	}
 
-	std::shared_ptr<object::Object> evaluateBreakStatement(std::shared_ptr<ast::BreakStatement> p_breakStatement, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<object::Object> evaluateBreakStatement(ast::BreakStatement* p_breakStatement, const std::shared_ptr<object::Environment>& p_environment)
+	{
+		g_completion = COMPLETION_BREAK;
+		return object::NULL_OBJECT;
+	}
+
+	std::shared_ptr<object::Object> evaluateContinueStatement(ast::ContinueStatement* p_continueStatement, const std::shared_ptr<object::Environment>& p_environment)
 	{
-		return object::BREAK_OBJECT;
+		g_completion = COMPLETION_CONTINUE;
+		return object::NULL_OBJECT;
 	}
 
-	std::shared_ptr<object::Object> evaluateContinueStatement(std::shared_ptr<ast::ContinueStatement> p_continueStatement, std::shared_ptr<object::Environment> p_environment)
+	std::shared_ptr<ast::Identifier> getMethodName(ast::CallExpression* p_callExpression)
 	{
-		return object::CONTINUE_OBJECT;
+		if (p_callExpression->m_function->Type() != ast::INFIX_EXPRESSION_NODE) return NULL;
+
+		ast::InfixExpression* access = (ast::InfixExpression*)p_callExpression->m_function.get();
+		if (access->m_operator != "." || access->m_rightExpression->Type() != ast::IDENTIFIER_NODE) return NULL;
+
+		return std::static_pointer_cast<ast::Identifier>(access->m_rightExpression);
+	}
+
+	void nextIteration(std::shared_ptr<object::Environment>* p_environment, const std::shared_ptr<object::Environment>& p_outer)
+	{
+		// A function declared by the last iteration keeps its environment alive, and must still see its variables
+		if (p_environment->use_count() > 1) p_environment->reset(new object::Environment(p_outer));
+		else (*p_environment)->clear();
 	}
 
 	std::shared_ptr<object::Object> applyFunction(std::shared_ptr<object::Object> p_function, std::vector<std::shared_ptr<object::Object>>* p_arguments)
@@ -1332,13 +1453,39 @@ namespace evaluator
 		case object::BUILTIN_FUNCTION:
 		{
 			std::shared_ptr<object::Builtin> builtin = std::static_pointer_cast<object::Builtin>(p_function);
-			return unwrapReturnValue(builtin->m_function(p_arguments, builtin->m_object));
+			return builtin->m_function(p_arguments, builtin->m_object);
 		}
 		case object::FUNCTION:
 		{
-			std::shared_ptr<object::Environment> extendedEnvironment = extendFunctionEnvironment(std::static_pointer_cast<object::Function>(p_function), p_arguments);
-			std::shared_ptr<object::Object> evaluated = evaluate(std::static_pointer_cast<object::Function>(p_function)->m_body, extendedEnvironment);
-			return unwrapReturnValue(evaluated);
+			if (g_callDepth >= g_maxCallDepth)
+			{
+				std::ostringstream error;
+				error << "Exceeded the maximum call depth of " << g_maxCallDepth << ".";
+				return createError(error.str());
+			}
+			if (!hasStackForCall())
+			{
+				std::ostringstream error;
+				error << "Exceeded the call depth of " << g_callDepth << " that the native stack can hold.";
+				return createError(error.str());
+			}
+
+			std::shared_ptr<object::Function> function = std::static_pointer_cast<object::Function>(p_function);
+			if (function->m_body == NULL)
+			{
+				std::string syntaxError = parseFunctionBody(&function->m_functionName.m_name, &function->m_parameters, function->m_literal.get());
+				if (!syntaxError.empty()) return createError(syntaxError);
+				function->m_body = function->m_literal->m_body;
+			}
+
+			std::shared_ptr<object::Environment> extendedEnvironment = extendFunctionEnvironment(function, p_arguments);
+			g_callDepth++;
+			std::shared_ptr<object::Object> evaluated = evaluate(function->m_body.get(), extendedEnvironment);
+			g_callDepth--;
+
+			// A break or continue reaching the function is left for the caller to report
+			if (g_completion == COMPLETION_RETURN) g_completion = COMPLETION_NORMAL;
+			return evaluated;
 		}
 		}
 
@@ -1348,27 +1495,78 @@ namespace evaluator
 		return createError(error.str());
 	}
 
-	std::shared_ptr<object::Environment> extendFunctionEnvironment(std::shared_ptr<object::Function> p_function, std::vector<std::shared_ptr<object::Object>>* p_arguments)
+	size_t nativeStackSize()
 	{
-		std::shared_ptr<object::Environment> newEnvironment(new object::Environment(p_function->m_environment));
+#ifdef _WIN32
+		// What the linker reserves for the main thread unless told otherwise
+		return 1024 * 1024;
+#else
+		rlimit limit;
+		if (getrlimit(RLIMIT_STACK, &limit) != 0) return 8 * 1024 * 1024;
+
+		// An unlimited stack still has to stop somewhere before it runs into the rest of memory
+		if (limit.rlim_cur == RLIM_INFINITY) return 1024 * 1024 * 1024;
+		return limit.rlim_cur;
+#endif
+	}
 
-		for (int i = 0; i < p_arguments->size(); i++)
+	void markStackBase()
+	{
+		char marker;
+		g_stackBase = (uintptr_t)&marker;
+	}
+
+	bool hasStackForCall()
+	{
+		char marker;
+		uintptr_t position = (uintptr_t)&marker;
+		size_t used = g_stackBase > position ? g_stackBase - position : position - g_stackBase;
+		return used + c_stackReserve <= g_stackSize;
+	}
+
+	std::string parseFunctionBody(std::string* p_name, std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters, ast::FunctionLiteral* p_function)
+	{
+		if (p_function->m_body != NULL) return "";
+
+		// Lexing starts again from the opening brace of the body
+		parser::Parser parser = parser::Parser(lexer::Lexer(p_function->m_source.get(), p_function->m_token.m_location));
+		std::shared_ptr<ast::BlockStatement> body = parser.ParseFunctionBody();
+		if (parser.m_errors.size() > 0)
 		{
-			newEnvironment->setIdentifier(&p_function->m_parameters[i]->m_name.m_name, (*p_arguments)[i]);
+			std::ostringstream error;
+			error << "Syntax error in function '" << *p_name << "' on line " << p_function->m_token.m_location.m_line << ". " << parser.m_errors[0];
+			return error.str();
 		}
 
-		return newEnvironment;
+		resolver::Resolver resolver;
+		resolver.ResolveFunctionBody(p_parameters, body);
+
+		if (g_isOptimizing)
+		{
+			optimizer::Optimizer optimizer;
+			optimizer.OptimizeFunctionBody(p_parameters, body);
+
+			for (int i = 0; g_isReportingOptimizations && i < optimizer.m_report.size(); i++)
+			{
+				std::cout << "Optimizer, function '" << *p_name << "': " << optimizer.m_report[i] << std::endl;
+			}
+		}
+
+		p_function->m_body = body;
+		p_function->m_source = NULL;
+		return "";
 	}
 
-	std::shared_ptr<object::Object> unwrapReturnValue(std::shared_ptr<object::Object> p_object)
+	std::shared_ptr<object::Environment> extendFunctionEnvironment(std::shared_ptr<object::Function> p_function, std::vector<std::shared_ptr<object::Object>>* p_arguments)
 	{
-		if (p_object->Type() == object::RETURN)
+		std::shared_ptr<object::Environment> newEnvironment(new object::Environment(p_function->m_environment));
+
+		for (int i = 0; i < p_arguments->size(); i++)
 		{
-			std::shared_ptr<object::Return> returnObject = std::static_pointer_cast<object::Return>(p_object);
-			return returnObject->m_returnValue;
+			newEnvironment->setIdentifier(&p_function->m_parameters[i]->m_name, (*p_arguments)[i]);
 		}
 
-		return p_object;
+		return newEnvironment;
 	}
 
 	std::shared_ptr<object::Object> isTruthy(std::shared_ptr<object::Object> p_object)
@@ -1403,8 +1601,55 @@ namespace evaluator
 	}
 
 
+	void startBudget(long long p_fuelLimit, int p_timeoutMilliseconds)
+	{
+		markStackBase();
+		g_fuelLimit = p_fuelLimit;
+		g_fuelUsed = 0;
+		g_fuelChunk = p_fuelLimit != 0 && p_fuelLimit < c_fuelPerClockCheck ? (int)p_fuelLimit : c_fuelPerClockCheck;
+		g_fuelLeft = g_fuelChunk;
+		g_timeout = p_timeoutMilliseconds != 0
+			? std::chrono::steady_clock::now() + std::chrono::milliseconds(p_timeoutMilliseconds)
+			: std::chrono::steady_clock::time_point();
+	}
+
+	long long fuelUsed()
+	{
+		return g_fuelUsed + g_fuelChunk - g_fuelLeft;
+	}
+
+	bool refuel()
+	{
+		g_fuelUsed += g_fuelChunk;
+
+		bool isOutOfTime = g_timeout != std::chrono::steady_clock::time_point() && g_timeout < std::chrono::steady_clock::now();
+		long long fuelLeft = g_fuelLimit != 0 ? g_fuelLimit - g_fuelUsed : c_fuelPerClockCheck;
+		if (isOutOfTime || fuelLeft <= 0)
+		{
+			// Stays empty, so every later use fails as well
+			g_fuelChunk = 0;
+			g_fuelLeft = 0;
+			return false;
+		}
+
+		// The unit being used is the first of the new chunk
+		g_fuelChunk = fuelLeft < c_fuelPerClockCheck ? (int)fuelLeft : c_fuelPerClockCheck;
+		g_fuelLeft = g_fuelChunk - 1;
+		return true;
+	}
+
+	std::shared_ptr<object::Error> budgetError()
+	{
+		if (g_fuelLimit != 0 && g_fuelUsed >= g_fuelLimit)
+		{
+			return createError("Evaluation of the program ran out of fuel.");
+		}
+		return createError("Evaluation of the program timed out.");
+	}
+
 	std::shared_ptr<object::Error> createError(std::string errorMessage)
 	{
+		g_completion = COMPLETION_ERROR;
 		return std::shared_ptr<object::Error>(new object::Error(errorMessage));
 	}
 
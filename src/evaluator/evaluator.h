@@ -1,51 +1,121 @@
 #pragma once
 #include <chrono>
+#include <cstdint>
 
 #include "ast.h"
 #include "object.h"
 
 namespace evaluator
 {
-	extern std::chrono::steady_clock::time_point g_timeout;
+	// Budget of a run. Each node evaluated and each loop iteration of the virtual machine uses one unit of fuel,
+	// and the clock is only read against g_timeout once every c_fuelPerClockCheck units. A counted for loop uses one
+	// unit for the condition and updation of each iteration instead of a unit for each of their nodes.
+	const int c_fuelPerClockCheck = 1024;
 
-	// Evaluates a node
-	std::shared_ptr<object::Object> evaluate(std::shared_ptr<ast::Node> p_node, std::shared_ptr<object::Environment> p_environment);
+	extern std::chrono::steady_clock::time_point g_timeout;
+	extern long long g_fuelLimit;                  // Zero for no limit
+	extern long long g_fuelUsed;                   // Fuel used before the current chunk
+	extern int g_fuelChunk;                        // Size of the current chunk
+	extern int g_fuelLeft;                         // Fuel left in the current chunk
+
+	// Deepest a chain of calls can go. The evaluator recurses on the native stack, so calls also stop once fewer than
+	// c_stackReserve bytes are left of the g_stackSize bytes above g_stackBase. The reserve is kept back for the frames
+	// of one more call and for the rest of the program.
+	const size_t c_stackReserve = 256 * 1024;
+	extern int g_maxCallDepth;
+	extern int g_callDepth;
+	extern size_t g_stackSize;
+	extern uintptr_t g_stackBase;                  // Zero until a run has started
+
+	// Size of the native stack of the process
+	size_t nativeStackSize();
+
+	// Records where on the native stack a run starts. startBudget does this, and otherwise the first program evaluated.
+	void markStackBase();
+
+	// Whether the native stack can hold another call
+	bool hasStackForCall();
+
+	// How the statement just evaluated completed. Returns, breaks, continues and errors set it so that blocks,
+	// loops and functions can tell how to carry on without inspecting the object that was produced.
+	enum Completion
+	{
+		COMPLETION_NORMAL,
+		COMPLETION_RETURN,
+		COMPLETION_BREAK,
+		COMPLETION_CONTINUE,
+		COMPLETION_ERROR,
+	};
+
+	extern Completion g_completion;
+
+	// Whether function bodies parsed lazily are optimized once they are resolved, like the rest of their program
+	extern bool g_isOptimizing;
+
+	// Whether what the optimizer removes from those bodies is printed
+	extern bool g_isReportingOptimizations;
+
+	// Starts the budget of a new run. Zero means no limit.
+	void startBudget(long long p_fuelLimit, int p_timeoutMilliseconds);
+
+	// Fuel used since the budget was started
+	long long fuelUsed();
+
+	// Starts the next chunk of fuel, checking the limit and the clock
+	bool refuel();
+
+	// Uses one unit of fuel. Returns false once the run has used up its fuel or its time.
+	inline bool useFuel()
+	{
+		return --g_fuelLeft >= 0 || refuel();
+	}
+
+	// Error for a run that is out of fuel or time
+	std::shared_ptr<object::Error> budgetError();
+
+	// Evaluates a node. Nodes are passed as plain pointers, since the program that owns them outlives the evaluation.
+	std::shared_ptr<object::Object> evaluate(ast::Node* p_node, const std::shared_ptr<object::Environment>& p_environment);
+
+	inline std::shared_ptr<object::Object> evaluate(const std::shared_ptr<ast::Node>& p_node, const std::shared_ptr<object::Environment>& p_environment)
+	{
+		return evaluate(p_node.get(), p_environment);
+	}
 
 	// Evaluates a program
-	std::shared_ptr<object::Object> evaluateProgram(std::shared_ptr<ast::Program> p_program, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateProgram(ast::Program* p_program, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates an identifier
-	std::shared_ptr<object::Object> evaluateIdentifier(std::shared_ptr<ast::Identifier> p_identifier, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateIdentifier(ast::Identifier* p_identifier, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates a block statement
-	std::shared_ptr<object::Object> evaluateBlockStatement(std::shared_ptr<ast::BlockStatement> p_blockStatements, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateBlockStatement(ast::BlockStatement* p_blockStatements, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates an integer literal
-	std::shared_ptr<object::Object> evaluateIntegerLiteral(std::shared_ptr<ast::IntegerLiteral> p_integerLiteral, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateIntegerLiteral(ast::IntegerLiteral* p_integerLiteral, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates an float literal
-	std::shared_ptr<object::Object> evaluateFloatLiteral(std::shared_ptr<ast::FloatLiteral> p_floatLiteral, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateFloatLiteral(ast::FloatLiteral* p_floatLiteral, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates an boolean literal
-	std::shared_ptr<object::Object> evaluateBooleanLiteral(std::shared_ptr<ast::BooleanLiteral> p_booleanLiteral, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateBooleanLiteral(ast::BooleanLiteral* p_booleanLiteral, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates an character literal
-	std::shared_ptr<object::Object> evaluateCharacterLiteral(std::shared_ptr<ast::CharacterLiteral> p_characterLiteral, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateCharacterLiteral(ast::CharacterLiteral* p_characterLiteral, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates a collection literal node
-	std::shared_ptr<object::Object> evaluateCollectionLiteral(std::shared_ptr<ast::CollectionLiteral> p_collectionLiteral, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateCollectionLiteral(ast::CollectionLiteral* p_collectionLiteral, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates a dictionary literal node
-	std::shared_ptr<object::Object> evaluateDictionaryLiteral(std::shared_ptr<ast::DictionaryLiteral> p_dictionaryLiteral, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateDictionaryLiteral(ast::DictionaryLiteral* p_dictionaryLiteral, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates a string literal node
-	std::shared_ptr<object::Object> evaluateStringLiteral(std::shared_ptr<ast::StringLiteral> p_stringLiteral, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateStringLiteral(ast::StringLiteral* p_stringLiteral, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates a list of expressions
-	void evaluateExpressions(std::vector<std::shared_ptr<ast::Expression>>* p_source, std::vector<std::shared_ptr<object::Object>>* p_destination, std::shared_ptr<object::Environment> p_environment);
+	void evaluateExpressions(std::vector<std::shared_ptr<ast::Expression>>* p_source, std::vector<std::shared_ptr<object::Object>>* p_destination, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates a prefix expression
-	std::shared_ptr<object::Object> evaluatePrefixExpression(std::shared_ptr<ast::PrefixExpression> p_prefixOperator, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluatePrefixExpression(ast::PrefixExpression* p_prefixOperator, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Applies bang operator
 	std::shared_ptr<object::Object> evaluateBangOperatorExpression(std::shared_ptr<object::Object> p_expression);
@@ -54,10 +124,16 @@ namespace evaluator
 	std::shared_ptr<object::Object> evaluateMinusPrefixOperatorExpression(std::shared_ptr<object::Object> p_expression);
 
 	// Evaluates a postfix expression
-	std::shared_ptr<object::Object> evaluatePostfixExpression(std::shared_ptr<ast::PostfixExpression> p_postfixOperator, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluatePostfixExpression(ast::PostfixExpression* p_postfixOperator, const std::shared_ptr<object::Environment>& p_environment);
 	
+	// Applies ++ or -- to an identifier or an indexed value
+	std::shared_ptr<object::Object> evaluateIncrement(ast::Expression* p_operand, std::string* p_operator, bool p_isPostfix, const std::shared_ptr<object::Environment>& p_environment);
+
 	// Evaluates an infix expression
-	std::shared_ptr<object::Object> evaluateInfixExpression(std::shared_ptr<ast::InfixExpression> p_infixExpression, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateInfixExpression(ast::InfixExpression* p_infixExpression, const std::shared_ptr<object::Environment>& p_environment);
+
+	// Applies an infix operator to two evaluated operands
+	std::shared_ptr<object::Object> applyInfixOperator(std::shared_ptr<object::Object> p_leftObject, std::string* p_infixOperator, std::shared_ptr<object::Object> p_rightObject);
 
 	// Evaluates an integer infix expression
 	std::shared_ptr<object::Object> evaluateIntegerInfixExpression(std::shared_ptr<object::Integer> p_leftObject, std::string* p_infixOperator, std::shared_ptr<object::Integer> p_rightObject);
@@ -68,8 +144,8 @@ namespace evaluator
 	// Evaluates a character infix expression
 	std::shared_ptr<object::Object> evaluateCharacterInfixExpression(std::shared_ptr<object::Character> p_leftObject, std::string* p_infixOperator, std::shared_ptr<object::Character> p_rightObject);
 	
-	// Evaluates an integer infix expression
-	std::shared_ptr<object::Object> evaluateFloatInfixExpression(std::shared_ptr<object::Float> p_leftObject, std::string* p_infixOperator, std::shared_ptr<object::Float> p_rightObject);
+	// Evaluates a float infix expression. An integer operand is converted to a float by the caller.
+	std::shared_ptr<object::Object> evaluateFloatInfixExpression(float p_left, std::string* p_infixOperator, float p_right);
 
 	// Reassigns value in a collection
 	std::shared_ptr<object::Object> collectionValueReassignment(std::shared_ptr<object::Collection> p_collection, std::shared_ptr<object::Object> p_indexObject, std::shared_ptr<object::Object> p_valueObject);
@@ -78,56 +154,70 @@ namespace evaluator
 	std::shared_ptr<object::Object> dictionaryValueReassignment(std::shared_ptr<object::Dictionary> p_dictionary, std::shared_ptr<object::Object> p_keyObject, std::shared_ptr<object::Object> p_valueObject);
 
 	// Evaluates a function call
-	std::shared_ptr<object::Object> evaluateCallExpression(std::shared_ptr<ast::CallExpression> p_callExpression, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateCallExpression(ast::CallExpression* p_callExpression, const std::shared_ptr<object::Environment>& p_environment);
+
+	// Gets the member name of a method call such as myCollection.append(x), or NULL for other calls
+	std::shared_ptr<ast::Identifier> getMethodName(ast::CallExpression* p_callExpression);
 
 	// Evaluates an indexing on collections, strings, or dictionaries
-	std::shared_ptr<object::Object> evaluateIndexExpression(std::shared_ptr<ast::IndexExpression> p_indexExpression, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateIndexExpression(ast::IndexExpression* p_indexExpression, const std::shared_ptr<object::Environment>& p_environment);
+
+	// Applies an index to an evaluated collection, string, or dictionary
+	std::shared_ptr<object::Object> applyIndex(std::shared_ptr<object::Object> p_object, std::shared_ptr<object::Object> p_indexObject);
 
 	// Evaluates a variable declaration
-	std::shared_ptr<object::Object> evaluateDeclareVariable(std::shared_ptr<ast::DeclareVariableStatement> p_declareVariable, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateDeclareVariable(ast::DeclareVariableStatement* p_declareVariable, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates a collection declaration
-	std::shared_ptr<object::Object> evaluateDeclareCollection(std::shared_ptr<ast::DeclareCollectionStatement> p_declareCollection, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateDeclareCollection(ast::DeclareCollectionStatement* p_declareCollection, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates a dictionary declaration
-	std::shared_ptr<object::Object> evaluateDeclareDictionary(std::shared_ptr<ast::DeclareDictionaryStatement> p_declareDictionary, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateDeclareDictionary(ast::DeclareDictionaryStatement* p_declareDictionary, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates a function declaration
-	std::shared_ptr<object::Object> evaluateDeclareFunction(std::shared_ptr<ast::DeclareFunctionStatement> p_declareFunction, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateDeclareFunction(ast::DeclareFunctionStatement* p_declareFunction, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates a return statement
-	std::shared_ptr<object::Object> evaluateReturnStatement(std::shared_ptr<ast::ReturnStatement> p_returnStatement, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateReturnStatement(ast::ReturnStatement* p_returnStatement, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates an if statement
-	std::shared_ptr<object::Object> evaluateIfStatement(std::shared_ptr<ast::IfStatement> p_ifStatement, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateIfStatement(ast::IfStatement* p_ifStatement, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates an while statement
-	std::shared_ptr<object::Object> evaluateWhileStatement(std::shared_ptr<ast::WhileStatement> p_whileStatement, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateWhileStatement(ast::WhileStatement* p_whileStatement, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates an while statement
-	std::shared_ptr<object::Object> evaluateDoWhileStatement(std::shared_ptr<ast::DoWhileStatement> p_doWhileStatement, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateDoWhileStatement(ast::DoWhileStatement* p_doWhileStatement, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates an while statement
-	std::shared_ptr<object::Object> evaluateForStatement(std::shared_ptr<ast::ForStatement> p_forStatement, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateForStatement(ast::ForStatement* p_forStatement, const std::shared_ptr<object::Environment>& p_environment);
+
+	// Runs a for loop the optimizer found to be counted, once its initialization has run, keeping its counter as a native
+	// integer instead of evaluating the condition and updation. Returns NULL if the counter or bound is not an integer.
+	std::shared_ptr<object::Object> evaluateCountedForStatement(ast::ForStatement* p_forStatement, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates an iterate statement
-	std::shared_ptr<object::Object> evaluateIterateStatement(std::shared_ptr<ast::IterateStatement> p_iterateStatement, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateIterateStatement(ast::IterateStatement* p_iterateStatement, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates break statements
-	std::shared_ptr<object::Object> evaluateBreakStatement(std::shared_ptr<ast::BreakStatement> p_breakStatement, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateBreakStatement(ast::BreakStatement* p_breakStatement, const std::shared_ptr<object::Environment>& p_environment);
 
 	// Evaluates continue statements
-	std::shared_ptr<object::Object> evaluateContinueStatement(std::shared_ptr<ast::ContinueStatement> p_continueStatement, std::shared_ptr<object::Environment> p_environment);
+	std::shared_ptr<object::Object> evaluateContinueStatement(ast::ContinueStatement* p_continueStatement, const std::shared_ptr<object::Environment>& p_environment);
+
+	// Empties the environment of a loop for its next iteration, or gives the iteration a new one if the last captured it
+	void nextIteration(std::shared_ptr<object::Environment>* p_environment, const std::shared_ptr<object::Environment>& p_outer);
 
 	// Applies a function call to a function
 	std::shared_ptr<object::Object> applyFunction(std::shared_ptr<object::Object> p_function, std::vector<std::shared_ptr<object::Object>>* p_arguments);
 
+	// Parses and resolves the body of a function the first time it is needed, when a lazy parser skipped it.
+	// Returns the first syntax error of the body, or an empty string if it parsed.
+	std::string parseFunctionBody(std::string* p_name, std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters, ast::FunctionLiteral* p_function);
+
 	// Helper function to extend a function's environment
 	std::shared_ptr<object::Environment> extendFunctionEnvironment(std::shared_ptr<object::Function> p_function, std::vector<std::shared_ptr<object::Object>>* p_arguments);
 
-	// Unwraps return value
-	std::shared_ptr<object::Object> unwrapReturnValue(std::shared_ptr<object::Object> p_object);
-
 	// Checks value of a truthy object
 	std::shared_ptr<object::Object> isTruthy(std::shared_ptr<object::Object> p_object);
 
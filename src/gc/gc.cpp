@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <unordered_map>
+
+#include "gc.h"
+#include "object.h"
+
+namespace gc
+{
+	Statistics g_statistics;
+
+	object::Environment* g_environments = NULL;
+	long g_threshold = c_minimumThreshold;
+
+	class Tracer
+	{
+	public:
+		void collect();
+	private:
+		typedef struct Node
+		{
+			bool m_isEnvironment;
+			long m_useCount;                                            // -1 when nothing in the heap owns the node
+			long m_references;                                          // Owners that are themselves in the heap
+			bool m_isMarked;
+			const std::shared_ptr<object::Environment>* m_owner;        // Any owner of an environment
+		} Node;
+
+		std::unordered_map<const void*, Node> m_nodes;
+		std::vector<const void*> m_pending;
+		bool m_isMarking = false;
+
+		void trace(const void* p_node, Node* p_value);
+		void reference(const std::shared_ptr<object::Environment>& p_environment);
+		void reference(const std::shared_ptr<object::Object>& p_object);
+		void visit(const void* p_node, Node* p_value);
+		void drain();
+	};
+
+	void Tracer::collect()
+	{
+		// Counts how many owners of each node are in the heap. Reading use_count through references
+		// leaves the counts untouched.
+		m_nodes.reserve(2 * g_statistics.m_liveEnvironments);
+		for (object::Environment* environment = g_environments; environment != NULL; environment = environment->m_nextEnvironment)
+		{
+			Node node = { true, -1, 0, false, NULL };
+			m_nodes[environment] = node;
+			m_pending.push_back(environment);
+		}
+		drain();
+
+		// A node with an owner outside the heap is a root: an active frame, a global environment or a value
+		// held by the evaluator or virtual machine.
+		m_isMarking = true;
+		for (auto it = m_nodes.begin(); it != m_nodes.end(); it++)
+		{
+			if (it->second.m_useCount < 0 || it->second.m_useCount > it->second.m_references)
+			{
+				it->second.m_isMarked = true;
+				m_pending.push_back(it->first);
+			}
+		}
+		drain();
+
+		// Keeps every garbage environment alive until all of them are emptied, since emptying one can free another
+		std::vector<std::shared_ptr<object::Environment>> garbage;
+		for (auto it = m_nodes.begin(); it != m_nodes.end(); it++)
+		{
+			if (it->second.m_isEnvironment && !it->second.m_isMarked)
+			{
+				garbage.push_back(*it->second.m_owner);
+			}
+		}
+		m_nodes.clear();
+
+		for (int i = 0; i < garbage.size(); i++)
+		{
+			garbage[i]->clear();
+			garbage[i]->m_slots.clear();
+			garbage[i]->m_outer = NULL;
+		}
+		g_statistics.m_environmentsFreed += garbage.size();
+	}
+
+	void Tracer::trace(const void* p_node, Node* p_value)
+	{
+		if (p_value->m_isEnvironment)
+		{
+			object::Environment* environment = (object::Environment*)p_node;
+			reference(environment->m_outer);
+			for (auto it = environment->m_store.begin(); it != environment->m_store.end(); it++)
+			{
+				reference(it->second);
+			}
+			for (int i = 0; i < environment->m_slots.size(); i++)
+			{
+				reference(environment->m_slots[i]);
+			}
+			return;
+		}
+
+		object::Object* object = (object::Object*)p_node;
+		switch (object->Type())
+		{
+		case object::FUNCTION:
+			reference(((object::Function*)object)->m_environment);
+			break;
+		case object::COLLECTION:
+		{
+			std::vector<std::shared_ptr<object::Object>>* values = &((object::Collection*)object)->m_values;
+			for (int i = 0; i < values->size(); i++)
+			{
+				reference(values->at(i));
+			}
+			break;
+		}
+		case object::DICTIONARY:
+		{
+			object::Dictionary* dictionary = (object::Dictionary*)object;
+			for (auto it = dictionary->m_map.begin(); it != dictionary->m_map.end(); it++)
+			{
+				reference(it->first);
+				reference(it->second);
+			}
+			break;
+		}
+		case object::BUILTIN_FUNCTION:
+			reference(((object::Builtin*)object)->m_object);
+			break;
+		default:
+			break;
+		}
+	}
+
+	void Tracer::reference(const std::shared_ptr<object::Environment>& p_environment)
+	{
+		if (p_environment == NULL) return;
+
+		Node* node = &m_nodes[p_environment.get()];
+		if (!m_isMarking)
+		{
+			node->m_useCount = p_environment.use_count();
+			node->m_references++;
+			node->m_owner = &p_environment;
+			return;
+		}
+		visit(p_environment.get(), node);
+	}
+
+	void Tracer::reference(const std::shared_ptr<object::Object>& p_object)
+	{
+		if (p_object == NULL) return;
+
+		// Only objects that hold references can be part of a cycle
+		switch (p_object->Type())
+		{
+		case object::FUNCTION:
+		case object::COLLECTION:
+		case object::DICTIONARY:
+		case object::BUILTIN_FUNCTION:
+			break;
+		default:
+			return;
+		}
+
+		auto it = m_nodes.find(p_object.get());
+		if (!m_isMarking)
+		{
+			if (it == m_nodes.end())
+			{
+				Node node = { false, p_object.use_count(), 0, false, NULL };
+				it = m_nodes.insert(std::make_pair(p_object.get(), node)).first;
+				m_pending.push_back(p_object.get());
+			}
+			it->second.m_references++;
+			return;
+		}
+		visit(p_object.get(), &it->second);
+	}
+
+	void Tracer::visit(const void* p_node, Node* p_value)
+	{
+		if (p_value->m_isMarked) return;
+
+		p_value->m_isMarked = true;
+		m_pending.push_back(p_node);
+	}
+
+	void Tracer::drain()
+	{
+		while (m_pending.size() > 0)
+		{
+			const void* node = m_pending.back();
+			m_pending.pop_back();
+			trace(node, &m_nodes.at(node));
+		}
+	}
+
+	void addEnvironment(object::Environment* p_environment)
+	{
+		collectIfNeeded();
+
+		p_environment->m_previousEnvironment = NULL;
+		p_environment->m_nextEnvironment = g_environments;
+		if (g_environments != NULL)
+		{
+			g_environments->m_previousEnvironment = p_environment;
+		}
+		g_environments = p_environment;
+		g_statistics.m_liveEnvironments++;
+		g_statistics.m_maxLiveEnvironments = std::max(g_statistics.m_maxLiveEnvironments, g_statistics.m_liveEnvironments);
+	}
+
+	void removeEnvironment(object::Environment* p_environment)
+	{
+		if (p_environment->m_previousEnvironment != NULL)
+		{
+			p_environment->m_previousEnvironment->m_nextEnvironment = p_environment->m_nextEnvironment;
+		}
+		else
+		{
+			g_environments = p_environment->m_nextEnvironment;
+		}
+		if (p_environment->m_nextEnvironment != NULL)
+		{
+			p_environment->m_nextEnvironment->m_previousEnvironment = p_environment->m_previousEnvironment;
+		}
+		g_statistics.m_liveEnvironments--;
+	}
+
+	void collect()
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		Tracer tracer;
+		tracer.collect();
+
+		double pause = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		g_statistics.m_collections++;
+		g_statistics.m_lastPause = pause;
+		g_statistics.m_totalPause += pause;
+		if (pause > g_statistics.m_maxPause)
+		{
+			g_statistics.m_maxPause = pause;
+		}
+
+		g_threshold = std::max(c_minimumThreshold, 2 * g_statistics.m_liveEnvironments);
+	}
+
+	void collectIfNeeded()
+	{
+		if (g_statistics.m_liveEnvironments >= g_threshold)
+		{
+			collect();
+		}
+	}
+
+	void printStatistics()
+	{
+		std::cout << "Live objects: " << g_statistics.m_liveObjects << std::endl;
+		std::cout << "Live environments: " << g_statistics.m_liveEnvironments << " (at most " << g_statistics.m_maxLiveEnvironments << ")" << std::endl;
+		std::cout << "Collections: " << g_statistics.m_collections << std::endl;
+		std::cout << "Environments freed: " << g_statistics.m_environmentsFreed << std::endl;
+		std::cout << "Pause (ms): last " << g_statistics.m_lastPause << ", max " << g_statistics.m_maxPause << ", total " << g_statistics.m_totalPause << std::endl;
+	}
+}
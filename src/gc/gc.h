@@ -0,0 +1,60 @@
+#pragma once
+
+namespace object
+{
+	class Environment;
+}
+
+// A cycle collector layered on the reference counts that own every object and environment, rather than a tracing
+// collector that owns them itself.
+//
+// Reference counting is kept because every evaluator and virtual machine function passes objects as shared_ptrs, and
+// the evaluator keeps them in locals on the native stack. A tracing collector would need every one of those locals
+// registered as a root, which means changing every signature in both. Reference counts already free acyclic garbage
+// as soon as it is dropped, so the collector only has to find the cycles they leave behind. The cost is that the
+// atomic count updates on every copy of an object stay.
+//
+// What the collector does not do:
+// - It only finds cycles that pass through an environment, since environments are the only part of the heap it keeps
+//   a list of. Objects that only reference each other are never reclaimed.
+// - It treats anything with an owner outside the heap as alive, so a cycle that a value held by C++ code still
+//   reaches is kept until that value is dropped.
+// - It is not incremental. Each collection stops the program while it traces every live environment, and the pauses
+//   are recorded in the statistics below.
+namespace gc
+{
+	// Collections do not run while there are fewer live environments than this
+	const long c_minimumThreshold = 1024;
+
+	// Heap size and collection pause statistics
+	typedef struct Statistics
+	{
+		long m_liveObjects;
+		long m_liveEnvironments;
+		long m_maxLiveEnvironments;
+		long m_collections;
+		long m_environmentsFreed;                   // Environments freed by the collector rather than by their reference count
+		double m_lastPause;                         // Milliseconds
+		double m_totalPause;
+		double m_maxPause;
+	} Statistics;
+
+	extern Statistics g_statistics;
+
+	// Walks the references held by objects and environments during a collection
+	class Tracer;
+
+	// Every environment adds itself when it is created and removes itself when it is destroyed
+	void addEnvironment(object::Environment* p_environment);
+	void removeEnvironment(object::Environment* p_environment);
+
+	// Objects and environments are still owned by reference counts, which free everything except cycles,
+	// such as a function stored in the environment it was declared in. A collection finds every environment
+	// that can no longer be reached from outside the heap and empties it, which breaks its cycles.
+	void collect();
+
+	// Collects once the number of live environments has doubled since the last collection
+	void collectIfNeeded();
+
+	void printStatistics();
+}
@@ -1,16 +1,58 @@
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include <ctype.h>
 
 #include "lexer.h"
 #include <iostream>
 
+// Every x86-64 processor has SSE2. Other targets, such as WebAssembly, scan one character at a time.
+#if defined(__SSE2__) || defined(_M_X64)
+#define LEXER_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
 namespace lexer 
 {
+	const token::Location Lexer::c_start = { 0, 1, 1 };
+
 	Lexer::Lexer(std::string* p_input)
+		: m_input(p_input->data()),
+		m_length((int)p_input->size()),
+		m_currentChar('\0'),
+		m_currentPosition(-1),
+		m_nextPosition(0),
+		m_line(1),
+		m_lineStart(0)
+	{
+		readChar();
+	}
+
+	Lexer::Lexer(std::string* p_input, token::Location p_start)
+		: m_input(p_input->data()),
+		m_length((int)p_input->size()),
+		m_currentChar('\0'),
+		m_currentPosition(-1),
+		m_nextPosition(p_start.m_offset),
+		m_line(p_start.m_line),
+		m_lineStart(p_start.m_offset - p_start.m_column + 1)
+	{
+		readChar();
+	}
+
+	Lexer::Lexer(const char* p_input, int p_length, token::Location p_start)
 		: m_input(p_input),
+		m_length(p_length),
 		m_currentChar('\0'),
 		m_currentPosition(-1),
-		m_nextPosition(0)
+		m_nextPosition(p_start.m_offset),
+		m_line(p_start.m_line),
+		m_lineStart(p_start.m_offset - p_start.m_column + 1)
 	{
 		readChar();
 	}
@@ -18,7 +60,12 @@ namespace lexer
 	token::Token Lexer::nextToken()
 	{
 		token::Token token;
+		nextToken(&token);
+		return token;
+	}
 
+	void Lexer::nextToken(token::Token* p_token)
+	{
 		// Remove whitespace and comments so we don't tokenize them
 
 		eatWhiteSpace();
@@ -39,276 +86,351 @@ namespace lexer
 			eatWhiteSpace();
 		}
 
+		int start = m_currentPosition;
+		p_token->m_location.m_offset = start;
+		p_token->m_location.m_line = m_line;
+		p_token->m_location.m_column = start - m_lineStart + 1;
+
 		// Generate token based on current (and possibly next) char
 		switch(m_currentChar)
 		{
 		case '=':
 			if (peekChar() == '=')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::EQ, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::EQ, start);
 			}
 			else
 			{
-				token = token::Token(token::ASSIGN, std::string{ m_currentChar });
+				makeToken(p_token, token::ASSIGN, start);
 			}
 			break;
 		case '+':
 			if (peekChar() == '=')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::PLUS_ASSIGN, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::PLUS_ASSIGN, start);
 			}
 			else if (peekChar() == '+')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::INCREMENT, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::INCREMENT, start);
 			}
 			else
 			{
-				token = token::Token(token::PLUS, std::string{ m_currentChar });
+				makeToken(p_token, token::PLUS, start);
 			}
 			break;
 		case '-':
 			if (peekChar() == '=')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::MINUS_ASSIGN, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::MINUS_ASSIGN, start);
 			}
 			else if (peekChar() == '-')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::DECREMENT, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::DECREMENT, start);
 			}
 			else
 			{
-				token = token::Token(token::MINUS, std::string{ m_currentChar });
+				makeToken(p_token, token::MINUS, start);
 			}
 			break;
 		case '*':
 			if (peekChar() == '=')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::ASTERIK_ASSIGN, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::ASTERIK_ASSIGN, start);
 			}
 			else
 			{
-				token = token::Token(token::ASTERIK, std::string{ m_currentChar });
+				makeToken(p_token, token::ASTERIK, start);
 			}
 			break;
 		case '/':
 			if (peekChar() == '=')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::SLASH_ASSIGN, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::SLASH_ASSIGN, start);
 			}
 			else
 			{
-				token = token::Token(token::SLASH, std::string{ m_currentChar });
+				makeToken(p_token, token::SLASH, start);
 			}
 			break;
 		case '%':
 			if (peekChar() == '=')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::PERCENT_ASSIGN, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::PERCENT_ASSIGN, start);
 			}
 			else
 			{
-				token = token::Token(token::PERCENT, std::string{ m_currentChar });
+				makeToken(p_token, token::PERCENT, start);
 			}
 			break;
 		case '!':
 			if (peekChar() == '=')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::NEQ, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::NEQ, start);
 			}
 			else
 			{
-				token = token::Token(token::BANG, std::string{ m_currentChar });
+				makeToken(p_token, token::BANG, start);
 			}
 			break;
 		case '&':
 			if (peekChar() == '&')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::AND, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::AND, start);
 			}
 			else
 			{
-				token = token::Token(token::AMPERSAND, std::string{ m_currentChar });
+				makeToken(p_token, token::AMPERSAND, start);
 			}
 			break;
 		case '|':
 			if (peekChar() == '|')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::OR, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::OR, start);
 			}
 			else
 			{
-				token = token::Token(token::PIPE, std::string{ m_currentChar });
+				makeToken(p_token, token::PIPE, start);
 			}
 			break;
 		case ',':
-			token = token::Token(token::COMMA, std::string{ m_currentChar });
+			makeToken(p_token, token::COMMA, start);
 			break;
 		case ':':
-			token = token::Token(token::COLON, std::string{ m_currentChar });
+			makeToken(p_token, token::COLON, start);
 			break;
 		case ';':
-			token = token::Token(token::SEMICOLON, std::string{ m_currentChar });
+			makeToken(p_token, token::SEMICOLON, start);
 			break;
 		case '.':
-			token = token::Token(token::DOT, std::string{ m_currentChar });
+			makeToken(p_token, token::DOT, start);
 			break;
 		case '(':
-			token = token::Token(token::LPARENTHESIS, std::string{ m_currentChar });
+			makeToken(p_token, token::LPARENTHESIS, start);
 			break;
 		case ')':
-			token = token::Token(token::RPARENTHESIS, std::string{ m_currentChar });
+			makeToken(p_token, token::RPARENTHESIS, start);
 			break;
 		case '{':
-			token = token::Token(token::LBRACE, std::string{ m_currentChar });
+			makeToken(p_token, token::LBRACE, start);
 			break;
 		case '}':
-			token = token::Token(token::RBRACE, std::string{ m_currentChar });
+			makeToken(p_token, token::RBRACE, start);
 			break;
 		case '[':
-			token = token::Token(token::LBRACKET, std::string{ m_currentChar });
+			makeToken(p_token, token::LBRACKET, start);
 			break;
 		case ']':
-			token = token::Token(token::RBRACKET, std::string{ m_currentChar });
+			makeToken(p_token, token::RBRACKET, start);
 			break;
 		case '<':
 			if (peekChar() == '=')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::LEQ, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::LEQ, start);
 			}
 			else
 			{
-				token = token::Token(token::LCHEVRON, std::string{ m_currentChar });
+				makeToken(p_token, token::LCHEVRON, start);
 			}
 			break;
 		case '>':
 			if (peekChar() == '=')
 			{
-				char prevChar = m_currentChar;
 				readChar();
-				token = token::Token(token::GEQ, std::string{ prevChar } + std::string{ m_currentChar });
+				makeToken(p_token, token::GEQ, start);
 			}
 			else
 			{
-				token = token::Token(token::RCHEVRON, std::string{ m_currentChar });
+				makeToken(p_token, token::RCHEVRON, start);
 			}
 			break;
 		case '\'':
-		{
-			std::string charLiteral;
-			readCharacter(&charLiteral);
-			token = token::Token(token::CHARACTER_LITERAL, charLiteral);
+			p_token->m_type = token::CHARACTER_LITERAL;
+			readCharacter(&p_token->m_literal);
 			break;
-		}
 		case '"':
-		{
-			std::string stringLiteral;
-			readString(&stringLiteral);
-			token = token::Token(token::STRING_LITERAL, stringLiteral);
+			p_token->m_type = token::STRING_LITERAL;
+			readString(&p_token->m_literal);
 			break;
-		}
 		case '\0':
-			token = token::Token(token::END_OF_FILE, "");
+			p_token->m_type = token::END_OF_FILE;
+			p_token->m_literal.clear();
 			break;
 		default:
 		{
 			// Generate a number or identifier
 			if (isDigit(m_currentChar))
 			{
-				token = readNumber();
+				readNumber(p_token);
 			}
 			else if (validIdentifierChar(m_currentChar))
 			{
-				std::string identifierLiteral;
-				readIdentifier(&identifierLiteral);
-
-				if (token::c_keywordToTokenType.count(identifierLiteral) > 0)
+				readIdentifier(&p_token->m_literal);
+				p_token->m_type = token::lookupIdentifier(&p_token->m_literal);
+				if (p_token->m_type == token::IDENTIFIER)
 				{
-					token = token::Token(token::c_keywordToTokenType.at(identifierLiteral), identifierLiteral);
-				}
-				else
-				{
-					token = token::Token(token::IDENTIFIER, identifierLiteral);
+					p_token->m_symbol = token::internIdentifier(&p_token->m_literal);
 				}
 			}
 			else
 			{
-				token = token::Token(token::ILLEGAL, "ILLEGAL");
+				p_token->m_type = token::ILLEGAL;
+				p_token->m_literal = "ILLEGAL";
 			}
 			break;
 		}
 		}
 
 		readChar();
-		return token;
+	}
+
+	void Lexer::makeToken(token::Token* p_token, token::TokenType p_tokenType, int p_start)
+	{
+		p_token->m_type = p_tokenType;
+		p_token->m_literal.assign(m_input + p_start, m_currentPosition + 1 - p_start);
 	}
 
 	void Lexer::readChar() 
 	{
-		if (m_nextPosition >= m_input->length())
+		if (m_nextPosition >= m_length)
 		{
 			m_currentChar = '\0';
 		}
 		else
 		{
-			m_currentChar = (*m_input)[m_nextPosition];
+			m_currentChar = m_input[m_nextPosition];
 		}
 
 		m_currentPosition = m_nextPosition;
 		m_nextPosition++;
+
+		if (m_currentChar == '\n')
+		{
+			m_line++;
+			m_lineStart = m_nextPosition;
+		}
+	}
+
+	void Lexer::advanceTo(int p_position)
+	{
+		const char* input = m_input;
+		int length = m_length;
+
+		// Counts the lines passed over, as reading one character at a time would have
+		int end = p_position < length ? p_position + 1 : length;
+		const char* newline = m_nextPosition < end ? (const char*)memchr(input + m_nextPosition, '\n', end - m_nextPosition) : NULL;
+		while (newline != NULL)
+		{
+			m_line++;
+			m_lineStart = newline - input + 1;
+			newline = (const char*)memchr(newline + 1, '\n', input + end - newline - 1);
+		}
+
+		m_currentPosition = p_position;
+		m_nextPosition = p_position + 1;
+		m_currentChar = p_position < length ? input[p_position] : '\0';
 	}
 
 	void Lexer::eatWhiteSpace() 
 	{
-		while (m_currentChar == ' ' || m_currentChar == '\t' || m_currentChar == '\n' || m_currentChar == '\r')
-		{ 
-			readChar();
+		if (isWhiteSpace(m_currentChar))
+		{
+			advanceTo(skipWhiteSpace(m_currentPosition + 1));
 		}
 	}
 
 	void Lexer::eatSingleComment()
 	{
-		while (m_currentChar != '\n' && m_currentChar != '\0')
+		// Skips past the end of the line
+		const char* input = m_input;
+		int length = m_length;
+		const char* newline = (const char*)memchr(input + m_currentPosition, '\n', length - m_currentPosition);
+		advanceTo(newline != NULL ? newline - input + 1 : length + 1);
+	}
+
+	void Lexer::eatMultiComment()
+	{
+		// Skips past the first "*-", which can be the "*" of the opening "-*"
+		const char* input = m_input;
+		int length = m_length;
+		const char* star = (const char*)memchr(input + m_currentPosition, '*', length - m_currentPosition);
+		while (star != NULL && (star + 1 == input + length || star[1] != '-'))
 		{
-			readChar();
+			star = (const char*)memchr(star + 1, '*', input + length - star - 1);
 		}
-		readChar();
+		advanceTo(star != NULL ? star - input + 2 : length + 2);
 	}
 
-	void Lexer::eatMultiComment()
+	int Lexer::skipWhiteSpace(int p_position)
 	{
-		while (!(m_currentChar == '*' && peekChar() == '-') && m_currentChar != '\0')
+		const char* input = m_input;
+		int length = m_length;
+
+#ifdef LEXER_SSE2
+		// Most runs are a single space or a line break and an indent, so the first character is checked alone
+		if (p_position < length && !isWhiteSpace(input[p_position])) return p_position;
+
+		while (p_position + 16 <= length)
 		{
-			readChar();
+			__m128i chunk = _mm_loadu_si128((const __m128i*)(input + p_position));
+			__m128i whiteSpace = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+
+			unsigned int mask = ~_mm_movemask_epi8(whiteSpace) & 0xFFFF;
+			if (mask != 0) return p_position + firstSetBit(mask);
+			p_position += 16;
 		}
-		readChar();
-		readChar();
+#endif
+
+		while (p_position < length && isWhiteSpace(input[p_position]))
+		{
+			p_position++;
+		}
+		return p_position;
+	}
+
+	int Lexer::skipIdentifier(int p_position)
+	{
+		const char* input = m_input;
+		int length = m_length;
+
+#ifdef LEXER_SSE2
+		while (p_position + 16 <= length)
+		{
+			// Setting the 0x20 bit turns upper case letters into lower case ones, and no other character into a letter.
+			// Bytes above 127 compare as negative, so they are never letters.
+			__m128i chunk = _mm_loadu_si128((const __m128i*)(input + p_position));
+			__m128i lowerCase = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+			__m128i identifier = _mm_or_si128(
+				_mm_and_si128(_mm_cmpgt_epi8(lowerCase, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lowerCase, _mm_set1_epi8('z' + 1))),
+				_mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')));
+
+			unsigned int mask = ~_mm_movemask_epi8(identifier) & 0xFFFF;
+			if (mask != 0) return p_position + firstSetBit(mask);
+			p_position += 16;
+		}
+#endif
+
+		while (p_position < length && validIdentifierChar(input[p_position]))
+		{
+			p_position++;
+		}
+		return p_position;
 	}
 
-	token::Token Lexer::readNumber() 
+	void Lexer::readNumber(token::Token* p_token)
 	{
 		int startPosition = m_currentPosition;
 		bool seenDecimal = false;
@@ -338,8 +460,9 @@ namespace lexer
 						readChar();
 					}
 
-					std::string numberLiteral = m_input->substr(startPosition, m_nextPosition - startPosition);
-					return token::Token(token::ILLEGAL_NUMERIC, numberLiteral);
+					p_token->m_type = token::ILLEGAL_NUMERIC;
+					p_token->m_literal.assign(m_input + startPosition, m_nextPosition - startPosition);
+					return;
 				}
 				else
 				{
@@ -359,26 +482,39 @@ namespace lexer
 
 				if (invalidValue) // We've seen an 'f' already, found unexpected digits, '.', or 'f'.
 				{
-					std::string numberLiteral = m_input->substr(startPosition, m_nextPosition - startPosition);
-					return token::Token(token::ILLEGAL_NUMERIC, numberLiteral);
+					p_token->m_type = token::ILLEGAL_NUMERIC;
+					p_token->m_literal.assign(m_input + startPosition, m_nextPosition - startPosition);
+					return;
 				}
 			}
 		}
 
+		// Values are decoded here, so the parser does not read the digits again
 		if (!seenDecimal && !seenF) // No decimal, no 'f'
 		{
-			std::string numberLiteral = m_input->substr(startPosition, m_nextPosition - startPosition);
-			return token::Token(token::INTEGER_LITERAL, numberLiteral);
+			p_token->m_literal.assign(m_input + startPosition, m_nextPosition - startPosition);
+
+			long long value = 0;
+			for (int i = 0; i < p_token->m_literal.size() && value <= INT_MAX; i++)
+			{
+				value = value * 10 + (p_token->m_literal[i] - '0');
+			}
+			p_token->m_type = value <= INT_MAX ? token::INTEGER_LITERAL : token::ILLEGAL_NUMERIC;
+			p_token->m_integer = (int)value;
+			return;
 		}
 		else if(seenF && (!seenDecimal || (seenDecimal && seenSecondDigit))) // Seen 'f' and seen decimal digits or see 'f' with no dot
 		{
-			std::string numberLiteral = m_input->substr(startPosition, m_nextPosition - startPosition - 1); // Ensure 'f' is not included
-			return token::Token(token::FLOAT_LITERAL, numberLiteral);
+			p_token->m_type = token::FLOAT_LITERAL;
+			p_token->m_literal.assign(m_input + startPosition, m_nextPosition - startPosition - 1); // Ensure 'f' is not included
+			p_token->m_float = strtof(p_token->m_literal.c_str(), NULL);
+			return;
 		} 
 		else
 		{
-			std::string numberLiteral = m_input->substr(startPosition, m_nextPosition - startPosition);
-			return token::Token(token::ILLEGAL_NUMERIC, numberLiteral);
+			p_token->m_type = token::ILLEGAL_NUMERIC;
+			p_token->m_literal.assign(m_input + startPosition, m_nextPosition - startPosition);
+			return;
 		}
 		
 	}
@@ -386,52 +522,52 @@ namespace lexer
 	void Lexer::readIdentifier(std::string* p_output) 
 	{
 		int startPosition = m_currentPosition;
-		while (validIdentifierChar(peekChar()))
-		{
-			readChar();
-		}
+		advanceTo(skipIdentifier(m_nextPosition) - 1);
 
-		*p_output = m_input->substr(startPosition, m_nextPosition - startPosition);
+		p_output->assign(m_input + startPosition, m_nextPosition - startPosition);
 	}
 
 	void Lexer::readString(std::string* p_output) 
 	{
 		int startPosition = m_currentPosition+1;
-		readChar();
-		while (m_currentChar != '"' && m_currentChar != '\0')
-		{
-			readChar();
-		}
+		advanceTo(find('"', startPosition));
 
-		if (m_currentChar == '"')
-		{
-			*p_output = m_input->substr(startPosition, m_currentPosition - startPosition);
-		}
-		else if (m_currentChar == '\0')
-		{
-			// TODO: Handle errors
-			*p_output = m_input->substr(startPosition, m_currentPosition - startPosition);
-		}
+		// TODO: Handle errors for a string missing its closing quote
+		p_output->assign(m_input + startPosition, std::min(m_currentPosition, m_length) - startPosition);
 	}
 
 	void Lexer::readCharacter(std::string* p_output)
 	{
 		int startPosition = m_currentPosition + 1;
-		readChar();
-		while (m_currentChar != '\'' && m_currentChar != '\0')
-		{
-			readChar();
-		}
+		advanceTo(find('\'', startPosition));
 
-		if (m_currentChar == '\'')
-		{
-			*p_output = m_input->substr(startPosition, m_currentPosition - startPosition);
-		}
-		else if (m_currentChar == '\0')
-		{
-			// TODO: Handle errors
-			*p_output = m_input->substr(startPosition, m_currentPosition - startPosition);
-		}
+		// TODO: Handle errors for a character missing its closing quote
+		p_output->assign(m_input + startPosition, std::min(m_currentPosition, m_length) - startPosition);
+	}
+
+	int Lexer::find(char p_character, int p_position)
+	{
+		int length = m_length;
+		if (p_position >= length) return length;
+
+		const char* found = (const char*)memchr(m_input + p_position, p_character, length - p_position);
+		return found != NULL ? found - m_input : length;
+	}
+
+	int Lexer::firstSetBit(unsigned int p_mask)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, p_mask);
+		return index;
+#else
+		return __builtin_ctz(p_mask);
+#endif
+	}
+
+	bool Lexer::isWhiteSpace(char p_character)
+	{
+		return p_character == ' ' || p_character == '\t' || p_character == '\n' || p_character == '\r';
 	}
 
 	bool Lexer::isLetter(char p_character)
@@ -451,11 +587,76 @@ namespace lexer
 
 	char Lexer::peekChar()
 	{
-		if (m_nextPosition >= m_input->length())
+		if (m_nextPosition >= m_length)
 		{
 			return '\0';
 		}
 
-		return (*m_input)[m_nextPosition];
+		return m_input[m_nextPosition];
+	}
+
+	LexerThread::LexerThread(Lexer p_lexer)
+		: m_lexer(p_lexer),
+		m_ring(c_capacity),
+		m_head(0),
+		m_knownTail(0),
+		m_isEnded(false),
+		m_tail(0),
+		m_knownHead(0),
+		m_isStopping(false)
+	{
+		m_thread = std::thread(&LexerThread::run, this);
+	}
+
+	LexerThread::~LexerThread()
+	{
+		m_isStopping.store(true, std::memory_order_relaxed);
+		m_thread.join();
+	}
+
+	void LexerThread::nextToken(token::Token* p_token)
+	{
+		// The lexer thread is done once it has written the end of the file, and the lexer keeps returning it
+		if (m_isEnded)
+		{
+			m_lexer.nextToken(p_token);
+			return;
+		}
+
+		size_t head = m_head.load(std::memory_order_relaxed);
+		while (head == m_knownTail)
+		{
+			m_knownTail = m_tail.load(std::memory_order_acquire);
+			if (head == m_knownTail) std::this_thread::yield();
+		}
+
+		// Swapped, so the lexer reuses the storage of the old token's literal
+		std::swap(*p_token, m_ring[head & (c_capacity - 1)]);
+		m_isEnded = p_token->m_type == token::END_OF_FILE;
+		m_head.store(head + 1, std::memory_order_release);
+	}
+
+	void LexerThread::run()
+	{
+		size_t tail = 0;
+		while (true)
+		{
+			while (tail - m_knownHead == c_capacity)
+			{
+				m_knownHead = m_head.load(std::memory_order_acquire);
+				if (tail - m_knownHead < c_capacity) break;
+
+				// The parser stopped before the end of the file
+				if (m_isStopping.load(std::memory_order_relaxed)) return;
+				std::this_thread::yield();
+			}
+
+			token::Token* token = &m_ring[tail & (c_capacity - 1)];
+			m_lexer.nextToken(token);
+			bool isEnd = token->m_type == token::END_OF_FILE;
+			m_tail.store(++tail, std::memory_order_release);
+
+			if (isEnd) return;
+		}
 	}
-}
\ No newline at end of file
+}
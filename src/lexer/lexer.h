@@ -1,5 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "token.h"
 
 namespace lexer 
@@ -9,20 +13,42 @@ namespace lexer
 	public:
 		Lexer(std::string* p_input);
 
+		// Starts lexing the input from a token found by an earlier lexer, so locations carry on from it
+		Lexer(std::string* p_input, token::Location p_start);
+
+		// Lexes characters that are not kept in a string, such as a file mapped into memory. They are not copied,
+		// so they must outlive the lexer.
+		Lexer(const char* p_input, int p_length, token::Location p_start = c_start);
+
 		// Returns the token we are currently on.
 		// Increments position to next token.
 		token::Token nextToken();
 
+		// Same as above, but reuses the token given, so its literal does not need a new allocation
+		void nextToken(token::Token* p_token);
+
+		const char* Input() { return m_input; }
+		int Length() { return m_length; }
+
+		// Location of the first character of an input
+		static const token::Location c_start;
+
 	private:
-		std::string* m_input;
+		const char* m_input;
+		int m_length;
 		char m_currentChar;
 		int m_currentPosition;
 		int m_nextPosition;
+		int m_line;
+		int m_lineStart;        // Position of the first character of the current line
 
 		// Reads the character in the 'nextPosition' and saves it to 'currentChar'.
 		// Increments 'nextPosition'
 		void readChar();
 
+		// Moves to the position given, as if reading one character at a time
+		void advanceTo(int p_position);
+
 		// Skips through whitespace characters, like tabs, spaces, and newlines.
 		void eatWhiteSpace();
 
@@ -32,8 +58,11 @@ namespace lexer
 		// Skips through a multi-lined comment
 		void eatMultiComment();
 
-		// Reads numeric value and returns Token.
-		token::Token readNumber();
+		// Reads numeric value into the token given, decoding its value.
+		void readNumber(token::Token* p_token);
+
+		// Sets a token spelled by the input from the start given up to and including the current character.
+		void makeToken(token::Token* p_token, token::TokenType p_tokenType, int p_start);
 
 		// Reads an identifier and saves it into the address provided.
 		void readIdentifier(std::string* p_output);
@@ -44,6 +73,17 @@ namespace lexer
 		// Reads a character literal and saves it into the address provided.
 		void readCharacter(std::string* p_output);
 
+		// Return the position of the first character from the position given that is not whitespace or
+		// not part of an identifier. These check 16 characters at a time where SSE2 is available.
+		int skipWhiteSpace(int p_position);
+		int skipIdentifier(int p_position);
+
+		// Returns the position of the next occurrence of a character, or the length of the input
+		int find(char p_character, int p_position);
+
+		int firstSetBit(unsigned int p_mask);
+
+		bool isWhiteSpace(char p_character);
 		bool isLetter(char p_character);
 		bool isDigit(char p_character);
 
@@ -54,4 +94,37 @@ namespace lexer
 		char peekChar();
 
 	};
+
+	// Runs a lexer on a thread of its own, so that lexing overlaps with parsing. Tokens are handed to one consumer
+	// through a bounded ring, which neither side locks.
+	class LexerThread
+	{
+	public:
+		LexerThread(Lexer p_lexer);
+		~LexerThread();
+
+		// Same as Lexer::nextToken, waiting for the lexer thread when it has fallen behind
+		void nextToken(token::Token* p_token);
+	private:
+		static const size_t c_capacity = 1024;      // A power of two
+
+		Lexer m_lexer;
+		std::vector<token::Token> m_ring;
+
+		// Each side writes only its own index, and keeps the last index of the other side it saw,
+		// so that the two only share a cache line when one has caught up with the other
+		alignas(64) std::atomic<size_t> m_head;     // Next token the parser takes
+		size_t m_knownTail;
+		bool m_isEnded;                             // The parser has taken the end of the file
+		alignas(64) std::atomic<size_t> m_tail;     // Next token the lexer writes
+		size_t m_knownHead;
+		alignas(64) std::atomic<bool> m_isStopping;
+
+		std::thread m_thread;
+
+		void run();
+
+		LexerThread(const LexerThread&);
+		LexerThread& operator=(const LexerThread&);
+	};
 }
@@ -1,16 +1,102 @@
+#include <cstdlib>
 #include <iostream>
+#include <string>
 
+#include "gc.h"
+#include "optimizer.h"
 #include "repl.h"
+#include "vm.h"
 
 int main(int argc, const char* argv[])
 {
+	// --vm runs programs on the bytecode virtual machine instead of the tree-walking evaluator
+	// --gc-stats prints heap and collection pause statistics once the program has finished
+	// --fuel=N and --timeout=MS limit each run, and the fuel used is printed when it is limited
+	// --max-depth=N limits how deep calls can go, and the evaluator also stops where the native stack runs out
+	// --no-cache parses a file again instead of loading or writing its cached program
+	// --lazy-parse leaves the bodies of top level functions until they are first called, reporting their errors only then
+	// --lexer-thread lexes a file on another thread while it is parsed
+	// --parallel-parse parses the top level statements of a large file on a thread for each core
+	// --no-optimize runs a file as it was parsed, without running the optimizer over it
+	// --opt-report prints each statement the optimizer removed, such as code after a return, and each call it inlined
+	// --inline-budget=N sets how many expression nodes a function can return for its calls to be inlined, 0 for none
+	bool useVirtualMachine = false;
+	bool useCache = true;
+	bool isLazy = false;
+	bool isPipelined = false;
+	bool isParallel = false;
+	bool isOptimized = true;
+	bool isReporting = false;
+	bool printGcStatistics = false;
+	long long fuel = 0;
+	int timeout = -1;
+	while (argc > 1 && std::string(argv[1]).compare(0, 2, "--") == 0)
+	{
+		std::string flag = argv[1];
+		if (flag == "--vm")
+		{
+			useVirtualMachine = true;
+		}
+		else if (flag == "--gc-stats")
+		{
+			printGcStatistics = true;
+		}
+		else if (flag == "--no-cache")
+		{
+			useCache = false;
+		}
+		else if (flag == "--lazy-parse")
+		{
+			isLazy = true;
+		}
+		else if (flag == "--lexer-thread")
+		{
+			isPipelined = true;
+		}
+		else if (flag == "--parallel-parse")
+		{
+			isParallel = true;
+		}
+		else if (flag == "--no-optimize")
+		{
+			isOptimized = false;
+		}
+		else if (flag == "--opt-report")
+		{
+			isReporting = true;
+		}
+		else if (flag.compare(0, 7, "--fuel=") == 0)
+		{
+			fuel = std::atoll(flag.c_str() + 7);
+		}
+		else if (flag.compare(0, 10, "--timeout=") == 0)
+		{
+			timeout = std::atoi(flag.c_str() + 10);
+		}
+		else if (flag.compare(0, 12, "--max-depth=") == 0)
+		{
+			vm::setMaxCallDepth(std::atoi(flag.c_str() + 12));
+		}
+		else if (flag.compare(0, 16, "--inline-budget=") == 0)
+		{
+			optimizer::g_inlineBudget = std::atoi(flag.c_str() + 16);
+		}
+		else
+		{
+			std::cout << "Unknown option '" << flag << "'.";
+			return -1;
+		}
+		argc--;
+		argv++;
+	}
+
 	if (argc == 1)
 	{
-		repl::Start();
+		repl::Start(useVirtualMachine, fuel, timeout < 0 ? 1000 : timeout);
 	}
 	else if (argc == 2)
 	{
-		repl::Run(argv[1]);
+		repl::Run(argv[1], useVirtualMachine, fuel, timeout < 0 ? 0 : timeout, useCache, isLazy, isPipelined, isParallel, isOptimized, isReporting);
 	}
 	else
 	{
@@ -18,5 +104,12 @@ int main(int argc, const char* argv[])
 		return -1;
 	}
 
+	if (printGcStatistics)
+	{
+		// Reclaims the cycles left behind by the program before reporting
+		gc::collect();
+		gc::printStatistics();
+	}
+
 	return 0;
-}
\ No newline at end of file
+}
@@ -12,70 +12,216 @@ namespace object
 	std::shared_ptr<Null> NULL_OBJECT = std::make_shared<object::Null>();
 	std::shared_ptr<Boolean> TRUE_OBJECT = std::make_shared<object::Boolean>(true);
 	std::shared_ptr<Boolean> FALSE_OBJECT = std::make_shared<object::Boolean>(false);
-	std::shared_ptr<Break> BREAK_OBJECT = std::make_shared<object::Break>();
-	std::shared_ptr<Continue> CONTINUE_OBJECT = std::make_shared<object::Continue>();
 
-	std::shared_ptr<Object> Object::Member(std::string p_memberName)
+	Object::Object()
 	{
-		auto it = m_members.find(p_memberName);
-		if (it != m_members.end())
+		gc::g_statistics.m_liveObjects++;
+	}
+	Object::~Object()
+	{
+		gc::g_statistics.m_liveObjects--;
+	}
+
+	ast::Member getMember(ast::Identifier* p_name)
+	{
+		// Member names are found by the resolver, but programs that skipped it are looked up here
+		if (p_name->m_member == ast::MEMBER_UNKNOWN && c_nameToMember.count(p_name->m_name) > 0)
+		{
+			return c_nameToMember.at(p_name->m_name);
+		}
+		return p_name->m_member;
+	}
+
+	std::shared_ptr<Object> Object::Member(ast::Identifier* p_memberName)
+	{
+		std::shared_ptr<Object> result = FindMember(getMember(p_memberName));
+		if (result != NULL)
 		{
-			return m_members.at(p_memberName)();
+			return result;
 		}
 
 		std::ostringstream error;
-		error << p_memberName << " is not a member variable or function for an object of type " << c_objectTypeToString.at(Type()) << ".";
+		error << p_memberName->m_name << " is not a member variable or function for an object of type " << c_objectTypeToString.at(Type()) << ".";
 		return evaluator::createError(error.str());
 	}
 
+	std::shared_ptr<Object> Object::FindMember(ast::Member p_member)
+	{
+		int size = FindSize(p_member);
+		if (size >= 0)
+		{
+			return getInteger(size);
+		}
+
+		BuiltinFunctionPointer method = FindMethod(p_member);
+		if (method != NULL)
+		{
+			return std::make_shared<object::Builtin>(method, shared_from_this());
+		}
+		return NULL;
+	}
+
+	BuiltinFunctionPointer Object::FindMethod(ast::Member p_member)
+	{
+		return NULL;
+	}
+
+	int Object::FindSize(ast::Member p_member)
+	{
+		return -1;
+	}
+
 	Environment::Environment()
-		: m_outer(NULL) {}
+		: m_outer(NULL)
+	{
+		gc::addEnvironment(this);
+	}
 	Environment::Environment(std::shared_ptr<Environment> p_outer)
-		: m_outer(p_outer) {}
+		: m_outer(p_outer)
+	{
+		gc::addEnvironment(this);
+	}
+	Environment::~Environment()
+	{
+		gc::removeEnvironment(this);
+	}
 
-	std::shared_ptr<Object> Environment::getIdentifier(std::string* p_identifier)
+	// Nodes built by hand rather than by the parser have no symbol yet
+	static int symbolOf(ast::Identifier* p_identifier)
 	{
-		if (m_store.count(*p_identifier) > 0)
+		return p_identifier->m_symbol >= 0 ? p_identifier->m_symbol : token::internIdentifier(&p_identifier->m_name);
+	}
+
+	std::shared_ptr<Object> Environment::getIdentifier(int p_symbol)
+	{
+		for (Environment* environment = this; environment != NULL; environment = environment->m_outer.get())
 		{
-			return m_store.at(*p_identifier);
+			auto it = environment->m_store.find(p_symbol);
+			if (it != environment->m_store.end())
+			{
+				return it->second;
+			}
 		}
 
-		if (m_outer != NULL)
+		return NULL;
+	}
+
+	std::shared_ptr<Object> Environment::getLocalIdentifier(int p_symbol)
+	{
+		auto it = m_store.find(p_symbol);
+		if (it != m_store.end())
 		{
-			return m_outer->getIdentifier(p_identifier);
+			return it->second;
 		}
 
 		return NULL;
 	}
 
-	std::shared_ptr<Object> Environment::getLocalIdentifier(std::string* p_identifier)
+	void Environment::setIdentifier(int p_symbol, std::shared_ptr<Object> p_value)
+	{
+		m_store[p_symbol] = p_value;
+	}
+
+	void Environment::reassignIdentifier(int p_symbol, std::shared_ptr<Object> p_value)
 	{
-		if (m_store.count(*p_identifier) > 0)
+		for (Environment* environment = this; environment != NULL; environment = environment->m_outer.get())
 		{
-			return m_store.at(*p_identifier);
+			auto it = environment->m_store.find(p_symbol);
+			if (it != environment->m_store.end())
+			{
+				it->second = p_value;
+				return;
+			}
 		}
+	}
 
-		return NULL;
+	std::shared_ptr<Object> Environment::getIdentifier(std::string* p_identifier)
+	{
+		return getIdentifier(token::internIdentifier(p_identifier));
 	}
 
 	void Environment::setIdentifier(std::string* p_identifier, std::shared_ptr<Object> p_value)
 	{
-		m_store[*p_identifier] = p_value;
+		setIdentifier(token::internIdentifier(p_identifier), p_value);
 	}
 
-	void Environment::reassignIdentifier(std::string* p_identifier, std::shared_ptr<Object> p_value)
+	std::shared_ptr<Object> Environment::getIdentifier(ast::Identifier* p_identifier)
 	{
-		if (m_store.count(*p_identifier) > 0)
+		if (p_identifier->m_slot < 0)
 		{
-			m_store[*p_identifier] = p_value;
+			return getIdentifier(symbolOf(p_identifier));
 		}
-		else
+
+		Environment* environment = outer(p_identifier->m_depth);
+		if (environment != NULL && p_identifier->m_slot < environment->m_slots.size() && environment->m_slots[p_identifier->m_slot] != NULL)
 		{
-			if(m_outer != NULL)
-			{
-				m_outer->reassignIdentifier(p_identifier, p_value);
-			}
+			return environment->m_slots[p_identifier->m_slot];
 		}
+
+		// A function body can refer to a variable that is declared after the function. Until the declaration runs, look it up further out by name.
+		return getIdentifier(symbolOf(p_identifier));
+	}
+
+	std::shared_ptr<Object> Environment::getLocalIdentifier(ast::Identifier* p_identifier)
+	{
+		if (p_identifier->m_slot < 0)
+		{
+			return getLocalIdentifier(symbolOf(p_identifier));
+		}
+
+		if (p_identifier->m_slot < m_slots.size())
+		{
+			return m_slots[p_identifier->m_slot];
+		}
+
+		return NULL;
+	}
+
+	void Environment::setIdentifier(ast::Identifier* p_identifier, std::shared_ptr<Object> p_value)
+	{
+		if (p_identifier->m_slot < 0)
+		{
+			setIdentifier(symbolOf(p_identifier), p_value);
+			return;
+		}
+
+		if (p_identifier->m_slot >= m_slots.size())
+		{
+			m_slots.resize(p_identifier->m_slot + 1);
+		}
+		m_slots[p_identifier->m_slot] = p_value;
+	}
+
+	void Environment::reassignIdentifier(ast::Identifier* p_identifier, std::shared_ptr<Object> p_value)
+	{
+		Environment* environment = p_identifier->m_slot < 0 ? NULL : outer(p_identifier->m_depth);
+		if (environment != NULL && p_identifier->m_slot < environment->m_slots.size() && environment->m_slots[p_identifier->m_slot] != NULL)
+		{
+			environment->m_slots[p_identifier->m_slot] = p_value;
+			return;
+		}
+
+		reassignIdentifier(symbolOf(p_identifier), p_value);
+	}
+
+	void Environment::clear()
+	{
+		m_store.clear();
+		for (int i = 0; i < m_slots.size(); i++)
+		{
+			m_slots[i] = NULL;
+		}
+	}
+
+	Environment* Environment::outer(int p_depth)
+	{
+		Environment* environment = this;
+		for (int i = 0; i < p_depth && environment != NULL; i++)
+		{
+			environment = environment->m_outer.get();
+		}
+
+		return environment;
 	}
 
 	Integer::Integer()
@@ -174,39 +320,27 @@ namespace object
 	Collection::Collection()
 		: m_collectionType(NULL_TYPE)
 	{
-		m_members = {
-			{"size", [&]() {
-				return std::make_shared<object::Integer>(m_values.size());
-			}},
-			{"append", [&]() {
-				return std::make_shared<object::Builtin>(&evaluator::collectionAppend, shared_from_this());
-			}},
-			{"pop", [&]() {
-				return std::make_shared<object::Builtin>(&evaluator::collectionPop, shared_from_this());
-			}},
-			{"insert", [&]() {
-				return std::make_shared<object::Builtin>(&evaluator::collectionInsert, shared_from_this());
-			}},
-		};
 	}
 
 	Collection::Collection(ObjectType p_collectionType, std::vector<std::shared_ptr<Object>> p_value)
 		: m_collectionType(p_collectionType), m_values(p_value)
 	{
-		m_members = {
-			{"size", [&]() {
-				return std::make_shared<object::Integer>(m_values.size());
-			}},
-			{"append", [&]() {
-				return std::make_shared<object::Builtin>(&evaluator::collectionAppend, shared_from_this());
-			}},
-			{"pop", [&]() {
-				return std::make_shared<object::Builtin>(&evaluator::collectionPop, shared_from_this());
-			}},
-			{"insert", [&]() {
-				return std::make_shared<object::Builtin>(&evaluator::collectionInsert, shared_from_this());
-			}},
-		};
+	}
+
+	BuiltinFunctionPointer Collection::FindMethod(ast::Member p_member)
+	{
+		switch (p_member)
+		{
+		case ast::MEMBER_APPEND: return &evaluator::collectionAppend;
+		case ast::MEMBER_POP:    return &evaluator::collectionPop;
+		case ast::MEMBER_INSERT: return &evaluator::collectionInsert;
+		default:                 return NULL;
+		}
+	}
+
+	int Collection::FindSize(ast::Member p_member)
+	{
+		return p_member == ast::MEMBER_SIZE ? m_values.size() : -1;
 	}
 
 	ObjectType Collection::Type()
@@ -274,40 +408,32 @@ namespace object
 	Dictionary::Dictionary()
 		: m_keyType(NULL_TYPE), m_valueType(NULL_TYPE)
 	{
-		m_members = {
-			{"size", [&]() {
-				return std::make_shared<object::Integer>(m_map.size());
-			}},
-			{"keys", [&]() {
-				return std::make_shared<object::Builtin>(&evaluator::dictionaryKeys, shared_from_this());
-			}},
-			{"values", [&]() {
-				return std::make_shared<object::Builtin>(&evaluator::dictionaryValues, shared_from_this());
-			}},
-		};
 	}
 
 	Dictionary::Dictionary(ObjectType p_keyType, ObjectType p_valueType, std::vector<std::shared_ptr<Object>> p_keys, std::vector<std::shared_ptr<Object>> p_values)
 		: m_keyType(p_keyType), m_valueType(p_valueType)
 	{
-		m_members = {
-			{"size", [&]() {
-				return std::make_shared<object::Integer>(m_map.size());
-			}},
-			{"keys", [&]() {
-				return std::make_shared<object::Builtin>(&evaluator::dictionaryKeys, shared_from_this());
-			}},
-			{"values", [&]() {
-				return std::make_shared<object::Builtin>(&evaluator::dictionaryValues, shared_from_this());
-			}},
-		};
-
 		for (int i = 0; i < p_keys.size(); i++)
 		{
 			m_map.emplace(p_keys.at(i), p_values.at(i));
 		}
 	}
 
+	BuiltinFunctionPointer Dictionary::FindMethod(ast::Member p_member)
+	{
+		switch (p_member)
+		{
+		case ast::MEMBER_KEYS:   return &evaluator::dictionaryKeys;
+		case ast::MEMBER_VALUES: return &evaluator::dictionaryValues;
+		default:                 return NULL;
+		}
+	}
+
+	int Dictionary::FindSize(ast::Member p_member)
+	{
+		return p_member == ast::MEMBER_SIZE ? m_map.size() : -1;
+	}
+
 	ObjectType Dictionary::Type()
 	{
 		return DICTIONARY;
@@ -335,21 +461,16 @@ namespace object
 	String::String()
 		: m_value("")
 	{
-		m_members = {
-			{"length", [&]() {
-				return std::make_shared<object::Integer>(m_value.length());
-			}},
-		};
 	}
 
 	String::String(std::string *p_value)
 		: m_value(*p_value)
 	{
-		m_members = {
-			{"length", [&]() {
-				return std::make_shared<object::Integer>(m_value.length());
-			}},
-		};
+	}
+
+	int String::FindSize(ast::Member p_member)
+	{
+		return p_member == ast::MEMBER_LENGTH ? m_value.length() : -1;
 	}
 
 	ObjectType String::Type()
@@ -374,26 +495,13 @@ namespace object
 		return "null";
 	}
 
-	Return::Return(std::shared_ptr<Object> p_returnValue)
-		: m_returnValue(p_returnValue)
-	{
-	}
-
-	ObjectType Return::Type()
-	{
-		return RETURN;
-	}
-
-	std::string Return::Inspect()
-	{
-		return m_returnValue->Inspect();
-	}
-
-	Function::Function(ObjectType p_functionType, std::shared_ptr<ast::DeclareFunctionStatement> p_functionDeclaration, std::shared_ptr<Environment> p_environment)
+	Function::Function(ObjectType p_functionType, ast::DeclareFunctionStatement* p_functionDeclaration, std::shared_ptr<Environment> p_environment)
 		: m_functionType(p_functionType)
 		, m_functionName(p_functionDeclaration->m_name)
 		, m_body(p_functionDeclaration->m_body->m_body)
+		, m_literal(p_functionDeclaration->m_body)
 		, m_environment(p_environment)
+		, m_isTypeChecked(p_functionDeclaration->m_isTypeChecked)
 	{
 		m_parameters = p_functionDeclaration->m_parameters;
 	}
@@ -415,7 +523,7 @@ namespace object
 			if (i != m_parameters.size() - 1) output << ", ";
 		}
 
-		output << ")" << std::endl << "{" << std::endl << m_body->String() << std::endl << "}";
+		output << ")" << std::endl << "{" << std::endl << (m_body != NULL ? m_body->String() : "...") << std::endl << "}";
 
 		return output.str();
 	}
@@ -437,7 +545,7 @@ namespace object
 		return output.str();
 	}
 
-	Builtin::Builtin(Builtin::BuiltinFunctionPointer p_fn, std::shared_ptr<Object> p_object)
+	Builtin::Builtin(BuiltinFunctionPointer p_fn, std::shared_ptr<Object> p_object)
 		: m_function(p_fn)
 		, m_object(p_object)
 	{
@@ -463,29 +571,95 @@ namespace object
 		}
 		return FALSE_OBJECT;
 	}
+
+	std::vector<std::shared_ptr<Integer>> makeSmallIntegers()
+	{
+		std::vector<std::shared_ptr<Integer>> integers;
+		for (int i = c_smallIntegerMin; i <= c_smallIntegerMax; i++) integers.push_back(std::make_shared<Integer>(i));
+		return integers;
+	}
+
+	std::vector<std::shared_ptr<Character>> makeCharacters()
+	{
+		std::vector<std::shared_ptr<Character>> characters;
+		for (int i = 0; i < 256; i++) characters.push_back(std::make_shared<Character>((char)i));
+		return characters;
+	}
+
+	const std::vector<std::shared_ptr<Integer>> SMALL_INTEGER_OBJECTS = makeSmallIntegers();
+	const std::vector<std::shared_ptr<Character>> CHARACTER_OBJECTS = makeCharacters();
+
+	std::shared_ptr<Integer> getInteger(int p_value)
+	{
+		if (p_value < c_smallIntegerMin || p_value > c_smallIntegerMax) return std::make_shared<Integer>(p_value);
+		return SMALL_INTEGER_OBJECTS[p_value - c_smallIntegerMin];
+	}
+
+	std::shared_ptr<Character> getCharacter(char p_value)
+	{
+		return CHARACTER_OBJECTS[(unsigned char)p_value];
+	}
 	
-	Break::Break() {};
+	Value::Value()
+		: m_type(NULL_TYPE), m_integer(0)
+	{
+	}
+
+	Value::Value(std::shared_ptr<Object> p_object)
+		: m_type(p_object->Type()), m_integer(0)
+	{
+		switch (m_type)
+		{
+		case INTEGER:
+			m_integer = std::static_pointer_cast<Integer>(p_object)->m_value;
+			break;
+		case FLOAT:
+			m_float = std::static_pointer_cast<Float>(p_object)->m_value;
+			break;
+		case BOOLEAN:
+			m_boolean = std::static_pointer_cast<Boolean>(p_object)->m_value;
+			break;
+		case CHARACTER:
+			m_character = std::static_pointer_cast<Character>(p_object)->m_value;
+			break;
+		default:
+			m_object = p_object;
+			break;
+		}
+	}
 
-	ObjectType Break::Type()
+	Value::Value(int p_value)
+		: m_type(INTEGER), m_integer(p_value)
 	{
-		return BREAK;
 	}
 
-	std::string Break::Inspect()
+	Value::Value(float p_value)
+		: m_type(FLOAT), m_float(p_value)
 	{
-		return "break";
 	}
 
-	Continue::Continue() {};
+	Value::Value(bool p_value)
+		: m_type(BOOLEAN), m_boolean(p_value)
+	{
+	}
 
-	ObjectType Continue::Type()
+	Value::Value(char p_value)
+		: m_type(CHARACTER), m_character(p_value)
 	{
-		return CONTINUE;
 	}
 
-	std::string Continue::Inspect()
+	std::shared_ptr<Object> Value::Box() const
 	{
-		return "continue";
+		switch (m_type)
+		{
+		case INTEGER:   return getInteger(m_integer);
+		case FLOAT:     return std::make_shared<Float>(m_float);
+		case BOOLEAN:   return getBoolean(m_boolean);
+		case CHARACTER: return getCharacter(m_character);
+		}
+
+		if (m_object == NULL) return NULL_OBJECT;
+		return m_object;
 	}
 
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <functional>
+#include <unordered_map>
 
 #include "ast.h"
+#include "gc.h"
 
 namespace object
 {
@@ -20,8 +22,6 @@ namespace object
 		FUNCTION,
 		ERROR,
 		BUILTIN_FUNCTION,
-		BREAK,
-		CONTINUE,
 	};
 
 	const std::map<ObjectType, std::string> c_objectTypeToString =
@@ -38,8 +38,6 @@ namespace object
 		{FUNCTION, "FUNCTION"},
 		{ERROR, "ERROR"},
 		{BUILTIN_FUNCTION, "BUILTIN_FUNCTION"},
-		{BREAK, "break"},
-		{CONTINUE, "continue"},
 	};
 
 	const std::map<token::TokenType, ObjectType> c_nodeTypeToObjectType =
@@ -52,19 +50,47 @@ namespace object
 		{token::DICTIONARY_TYPE, DICTIONARY},
 		{token::STRING_TYPE, STRING},
 		{token::RETURN, RETURN},
-		{token::BREAK, BREAK},
-		{token::CONTINUE, CONTINUE},
 	};
 
+	const std::map<std::string, ast::Member> c_nameToMember =
+	{
+		{"size", ast::MEMBER_SIZE},
+		{"append", ast::MEMBER_APPEND},
+		{"pop", ast::MEMBER_POP},
+		{"insert", ast::MEMBER_INSERT},
+		{"keys", ast::MEMBER_KEYS},
+		{"values", ast::MEMBER_VALUES},
+		{"length", ast::MEMBER_LENGTH},
+	};
+
+	class Object;
+
+	// Member functions such as collection append, which are passed the object they are called on
+	typedef std::shared_ptr<Object> (*BuiltinFunctionPointer) (std::vector<std::shared_ptr<Object>>*, std::shared_ptr<Object>);
+
+	// Gets the member named by the right side of a member access, looking it up by name if the resolver has not
+	ast::Member getMember(ast::Identifier* p_name);
+
 	class Object : public std::enable_shared_from_this<Object>
 	{
-	protected:
-		std::map<std::string, std::function<std::shared_ptr<Object>()>> m_members;
 	public:
+		Object();
+		virtual ~Object();
+
 		virtual ObjectType Type() = 0;
 		virtual std::string Inspect() = 0;
 
-		std::shared_ptr<Object> Member(std::string p_memberName);
+		// Gets the member named by the right side of a member access, or an error if there is none
+		std::shared_ptr<Object> Member(ast::Identifier* p_memberName);
+
+		// Gets a member of the object's type, or NULL if the type does not have it
+		std::shared_ptr<Object> FindMember(ast::Member p_member);
+
+		// Gets a member function of the object's type, or NULL. Method calls use it to skip creating a Builtin.
+		virtual BuiltinFunctionPointer FindMethod(ast::Member p_member);
+
+		// Gets a size such as the length of a string, or -1 if the type does not have that member
+		virtual int FindSize(ast::Member p_member);
 	};
 
 	class Environment
@@ -72,21 +98,50 @@ namespace object
 	public:
 		Environment();
 		Environment(std::shared_ptr<Environment> p_outer);
+		Environment(const Environment&) = delete;
+		~Environment();
+
+		// Identifiers are given by the symbols the lexer interned them as.
 
 		// Gets value of identifier, looking through outer layers as welll.
-		std::shared_ptr<Object> getIdentifier(std::string* p_identifier);
+		std::shared_ptr<Object> getIdentifier(int p_symbol);
 
 		// Gets value of identifier only in the current level of environment.
-		std::shared_ptr<Object> getLocalIdentifier(std::string* p_identifier);
+		std::shared_ptr<Object> getLocalIdentifier(int p_symbol);
 
 		// Assigns value to identifier in this level of environment.
-		void setIdentifier(std::string* p_identifier, std::shared_ptr<Object> p_value);
+		void setIdentifier(int p_symbol, std::shared_ptr<Object> p_value);
 
 		// Checks outer level for identifier for assignment.
-		void reassignIdentifier(std::string* p_identifier, std::shared_ptr<Object> p_value);
+		void reassignIdentifier(int p_symbol, std::shared_ptr<Object> p_value);
+
+		// Same as above, but by name.
+		std::shared_ptr<Object> getIdentifier(std::string* p_identifier);
+		void setIdentifier(std::string* p_identifier, std::shared_ptr<Object> p_value);
+
+		// Same as above, but uses the slot given by the resolver when there is one.
+		std::shared_ptr<Object> getIdentifier(ast::Identifier* p_identifier);
+		std::shared_ptr<Object> getLocalIdentifier(ast::Identifier* p_identifier);
+		void setIdentifier(ast::Identifier* p_identifier, std::shared_ptr<Object> p_value);
+		void reassignIdentifier(ast::Identifier* p_identifier, std::shared_ptr<Object> p_value);
+
+		// Removes every identifier so that a loop can reuse the environment for its next iteration.
+		void clear();
 	private:
-		std::map<std::string, std::shared_ptr<Object>> m_store;
+		// Walks out p_depth levels of environment.
+		Environment* outer(int p_depth);
+
+		friend class gc::Tracer;
+		friend void gc::addEnvironment(Environment* p_environment);
+		friend void gc::removeEnvironment(Environment* p_environment);
+
+		std::unordered_map<int, std::shared_ptr<Object>> m_store;
+		std::vector<std::shared_ptr<Object>> m_slots;
 		std::shared_ptr<Environment> m_outer;
+
+		// Links in the collector's list of live environments
+		Environment* m_previousEnvironment;
+		Environment* m_nextEnvironment;
 	};
 
 	class Integer : public Object
@@ -140,6 +195,8 @@ namespace object
 		Collection(ObjectType p_collection_type, std::vector<std::shared_ptr<Object>> p_value);
 		ObjectType Type();
 		std::string Inspect();
+		BuiltinFunctionPointer FindMethod(ast::Member p_member);
+		int FindSize(ast::Member p_member);
 
 		ObjectType m_collectionType;
 		std::vector<std::shared_ptr<Object>> m_values;
@@ -156,6 +213,8 @@ namespace object
 		Dictionary(ObjectType p_keyType, ObjectType p_valueType, std::vector<std::shared_ptr<Object>> p_keys, std::vector<std::shared_ptr<Object>> p_values);
 		ObjectType Type();
 		std::string Inspect();
+		BuiltinFunctionPointer FindMethod(ast::Member p_member);
+		int FindSize(ast::Member p_member);
 
 		ObjectType m_keyType;
 		ObjectType m_valueType;
@@ -169,6 +228,7 @@ namespace object
 		String(std::string* p_value);
 		ObjectType Type();
 		std::string Inspect();
+		int FindSize(ast::Member p_member);
 
 		std::string m_value;
 	};
@@ -181,28 +241,20 @@ namespace object
 		std::string Inspect();
 	};
 
-	class Return : public Object
-	{
-	public:
-		Return(std::shared_ptr<Object> p_returnValue);
-		ObjectType Type();
-		std::string Inspect();
-		
-		std::shared_ptr<Object> m_returnValue;
-	};
-
 	class Function : public Object
 	{
 	public:
-		Function(ObjectType p_functionType, std::shared_ptr<ast::DeclareFunctionStatement> p_functionDeclaration, std::shared_ptr<Environment> p_environment);
+		Function(ObjectType p_functionType, ast::DeclareFunctionStatement* p_functionDeclaration, std::shared_ptr<Environment> p_environment);
 		ObjectType Type();
 		std::string Inspect();
 
 		ObjectType m_functionType;
 		ast::Identifier m_functionName;
 		std::vector<std::shared_ptr<ast::DeclareVariableStatement>> m_parameters;
-		std::shared_ptr<ast::BlockStatement> m_body;
+		std::shared_ptr<ast::BlockStatement> m_body;  // NULL until the first call when a lazy parser skipped it
+		std::shared_ptr<ast::FunctionLiteral> m_literal;
 		std::shared_ptr<Environment> m_environment;
+		bool m_isTypeChecked; // Return values are known to have the function type
 	};
 
 	class Error : public Object
@@ -218,8 +270,6 @@ namespace object
 	class Builtin : public Object
 	{
 	public:
-		typedef std::shared_ptr<Object> (*BuiltinFunctionPointer) (std::vector<std::shared_ptr<Object>>*, std::shared_ptr<object::Object>);
-
 		Builtin(BuiltinFunctionPointer p_fn, std::shared_ptr<Object> p_object = 0);
 		ObjectType Type();
 		std::string Inspect();
@@ -228,27 +278,42 @@ namespace object
 		std::shared_ptr<Object> m_object; // Refers to "parent" object. myCollection.append() for example.
 	};
 
-	class Break : public Object
+	// A value that holds integers, floats, booleans and characters inline instead of allocating an object for them.
+	// Every other type is held through its object.
+	class Value
 	{
 	public:
-		Break();
-		ObjectType Type();
-		std::string Inspect();
-	};
-
-	class Continue : public Object
-	{
-	public:
-		Continue();
-		ObjectType Type();
-		std::string Inspect();
+		Value();
+		Value(std::shared_ptr<Object> p_object);
+		explicit Value(int p_value);
+		explicit Value(float p_value);
+		explicit Value(bool p_value);
+		explicit Value(char p_value);
+
+		// Returns the value as an object, allocating one for inline values
+		std::shared_ptr<Object> Box() const;
+
+		ObjectType m_type;
+		union
+		{
+			int m_integer;
+			float m_float;
+			bool m_boolean;
+			char m_character;
+		};
+		std::shared_ptr<Object> m_object;
 	};
 
 	extern std::shared_ptr<Null> NULL_OBJECT;
 	extern std::shared_ptr<Boolean> TRUE_OBJECT;
 	extern std::shared_ptr<Boolean> FALSE_OBJECT;
-	extern std::shared_ptr<Break> BREAK_OBJECT;
-	extern std::shared_ptr<Continue> CONTINUE_OBJECT;
 
 	std::shared_ptr<Boolean> getBoolean(bool condition);
+
+	// Integers from c_smallIntegerMin to c_smallIntegerMax, and every character, are shared instead of allocated for
+	// each result. Integers and characters are never changed once created, so sharing them is not observable.
+	const int c_smallIntegerMin = -128;
+	const int c_smallIntegerMax = 1024;
+	std::shared_ptr<Integer> getInteger(int p_value);
+	std::shared_ptr<Character> getCharacter(char p_value);
 }
\ No newline at end of file
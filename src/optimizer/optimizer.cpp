@@ -0,0 +1,2230 @@
+#include <algorithm>
+#include <climits>
+#include <sstream>
+
+#include "lexer.h"
+#include "optimizer.h"
+
+namespace optimizer
+{
+	int g_inlineBudget = 16;
+
+	Optimizer::Optimizer()
+		: m_arena(std::make_shared<ast::Arena>())
+		, m_invariantCount(0)
+		, m_valueCount(0)
+		, m_isLazilyScanned(false)
+	{
+	}
+
+	void Optimizer::OptimizeProgram(std::shared_ptr<ast::Program> p_program)
+	{
+		m_scopes.clear();
+		m_effects = Effects();
+		m_removableStatements.clear();
+		m_keptVariables.clear();
+		m_keptNames.clear();
+		m_functions.clear();
+		m_skippedFunctions.clear();
+		m_lazilyAssignedNames.clear();
+		m_isLazilyScanned = false;
+
+		for (int i = 0; i < p_program->m_statements.size(); i++)
+		{
+			std::shared_ptr<ast::Statement> statement = p_program->m_statements[i];
+			collectEffects(statement, &m_effects);
+
+			if (statement->Type() == ast::DECLARE_FUNCTION_STATEMENT_NODE && std::static_pointer_cast<ast::DeclareFunctionStatement>(statement)->m_body->m_body == NULL)
+			{
+				m_skippedFunctions.push_back(std::static_pointer_cast<ast::DeclareFunctionStatement>(statement));
+			}
+		}
+
+		beginScope();
+		m_scopes.back().m_isGlobal = true;
+		collectNames(&p_program->m_statements);
+		optimizeStatements(&p_program->m_statements);
+		endScope();
+
+		// Reads are only known once folding has replaced the ones it could
+		Effects used;
+		for (int i = 0; i < p_program->m_statements.size(); i++)
+		{
+			collectEffects(p_program->m_statements[i], &used);
+		}
+		removeDeadStores(&p_program->m_statements, &used, true);
+	}
+
+	void Optimizer::OptimizeFunctionBody(std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters, std::shared_ptr<ast::BlockStatement> p_body)
+	{
+		m_scopes.clear();
+		m_effects = Effects();
+		m_removableStatements.clear();
+		m_keptVariables.clear();
+		m_keptNames.clear();
+		m_functions.clear();
+		m_skippedFunctions.clear();
+
+		collectEffects(p_body, &m_effects);
+		optimizeFunctionBody(p_parameters, p_body);
+
+		Effects used;
+		collectEffects(p_body, &used);
+		removeDeadStores(&p_body->m_statements, &used);
+	}
+
+	// EFFECTS
+
+	void Optimizer::collectEffects(std::shared_ptr<ast::Statement> p_statement, Effects* p_effects)
+	{
+		if (p_statement == NULL) return;
+
+		switch (p_statement->Type())
+		{
+		case ast::EXPRESSION_STATEMENT_NODE:
+		{
+			// A statement that only assigns a variable does not read it, even when it increments it
+			std::shared_ptr<ast::Expression> expression = std::static_pointer_cast<ast::ExpressionStatement>(p_statement)->m_expression;
+			std::shared_ptr<ast::Expression> target;
+			std::shared_ptr<ast::Expression> value;
+			if (expression->Type() == ast::INFIX_EXPRESSION_NODE && isAssignment(&std::static_pointer_cast<ast::InfixExpression>(expression)->m_operator))
+			{
+				target = std::static_pointer_cast<ast::InfixExpression>(expression)->m_leftExpression;
+				value = std::static_pointer_cast<ast::InfixExpression>(expression)->m_rightExpression;
+			}
+			else if (expression->Type() == ast::PREFIX_EXPRESSION_NODE && (std::static_pointer_cast<ast::PrefixExpression>(expression)->m_operator == "++" || std::static_pointer_cast<ast::PrefixExpression>(expression)->m_operator == "--"))
+			{
+				target = std::static_pointer_cast<ast::PrefixExpression>(expression)->m_rightExpression;
+			}
+			else if (expression->Type() == ast::POSTFIX_EXPRESSION_NODE)
+			{
+				target = std::static_pointer_cast<ast::PostfixExpression>(expression)->m_leftExpression;
+			}
+
+			if (target != NULL && target->Type() == ast::IDENTIFIER_NODE)
+			{
+				p_effects->m_assignedNames.insert(std::static_pointer_cast<ast::Identifier>(target)->m_name);
+				collectEffects(value, p_effects);
+			}
+			else collectEffects(expression, p_effects);
+			break;
+		}
+		case ast::BLOCK_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::BlockStatement> block = std::static_pointer_cast<ast::BlockStatement>(p_statement);
+			for (int i = 0; i < block->m_statements.size(); i++)
+			{
+				collectEffects(block->m_statements[i], p_effects);
+			}
+			break;
+		}
+		case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareVariableStatement> declaration = std::static_pointer_cast<ast::DeclareVariableStatement>(p_statement);
+			p_effects->m_declaredNames.insert(declaration->m_name.m_name);
+			collectEffects(declaration->m_value, p_effects);
+			break;
+		}
+		case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareCollectionStatement> declaration = std::static_pointer_cast<ast::DeclareCollectionStatement>(p_statement);
+			p_effects->m_declaredNames.insert(declaration->m_name.m_name);
+			collectEffects(declaration->m_value, p_effects);
+			break;
+		}
+		case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareDictionaryStatement> declaration = std::static_pointer_cast<ast::DeclareDictionaryStatement>(p_statement);
+			p_effects->m_declaredNames.insert(declaration->m_name.m_name);
+			collectEffects(declaration->m_value, p_effects);
+			break;
+		}
+		case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareFunctionStatement> declaration = std::static_pointer_cast<ast::DeclareFunctionStatement>(p_statement);
+			p_effects->m_declaredNames.insert(declaration->m_name.m_name);
+			for (int i = 0; i < declaration->m_parameters.size(); i++)
+			{
+				p_effects->m_declaredNames.insert(declaration->m_parameters[i]->m_name.m_name);
+			}
+			if (declaration->m_body->m_body == NULL) p_effects->m_hasSkippedBodies = true;
+			collectEffects(declaration->m_body->m_body, p_effects);
+			break;
+		}
+		case ast::RETURN_STATEMENT_NODE:
+			collectEffects(std::static_pointer_cast<ast::ReturnStatement>(p_statement)->m_returnValue, p_effects);
+			break;
+		case ast::IF_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::IfStatement> ifStatement = std::static_pointer_cast<ast::IfStatement>(p_statement);
+			collectEffects(ifStatement->m_condition, p_effects);
+			collectEffects(ifStatement->m_consequence, p_effects);
+			collectEffects(ifStatement->m_alternative, p_effects);
+			break;
+		}
+		case ast::WHILE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::WhileStatement> whileStatement = std::static_pointer_cast<ast::WhileStatement>(p_statement);
+			collectEffects(whileStatement->m_condition, p_effects);
+			collectEffects(whileStatement->m_consequence, p_effects);
+			break;
+		}
+		case ast::DO_WHILE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DoWhileStatement> doWhileStatement = std::static_pointer_cast<ast::DoWhileStatement>(p_statement);
+			collectEffects(doWhileStatement->m_consequence, p_effects);
+			collectEffects(doWhileStatement->m_condition, p_effects);
+			break;
+		}
+		case ast::FOR_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::ForStatement> forStatement = std::static_pointer_cast<ast::ForStatement>(p_statement);
+			collectEffects(forStatement->m_initialization, p_effects);
+			collectEffects(forStatement->m_condition, p_effects);
+			collectEffects(forStatement->m_updation, p_effects);
+			collectEffects(forStatement->m_consequence, p_effects);
+			break;
+		}
+		case ast::ITERATE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::IterateStatement> iterateStatement = std::static_pointer_cast<ast::IterateStatement>(p_statement);
+			p_effects->m_declaredNames.insert(iterateStatement->m_var->m_name);
+			collectEffects(iterateStatement->m_collection, p_effects);
+			collectEffects(iterateStatement->m_consequence, p_effects);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	void Optimizer::collectEffects(std::shared_ptr<ast::Expression> p_expression, Effects* p_effects)
+	{
+		if (p_expression == NULL) return;
+
+		switch (p_expression->Type())
+		{
+		case ast::IDENTIFIER_NODE:
+			p_effects->m_readNames.insert(std::static_pointer_cast<ast::Identifier>(p_expression)->m_name);
+			break;
+		case ast::COLLECTION_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::CollectionLiteral> collectionLiteral = std::static_pointer_cast<ast::CollectionLiteral>(p_expression);
+			for (int i = 0; i < collectionLiteral->m_values.size(); i++)
+			{
+				collectEffects(collectionLiteral->m_values[i], p_effects);
+			}
+			break;
+		}
+		case ast::DICTIONARY_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::DictionaryLiteral> dictionaryLiteral = std::static_pointer_cast<ast::DictionaryLiteral>(p_expression);
+			for (auto it = dictionaryLiteral->m_map.begin(); it != dictionaryLiteral->m_map.end(); it++)
+			{
+				collectEffects(it->first, p_effects);
+				collectEffects(it->second, p_effects);
+			}
+			break;
+		}
+		case ast::PREFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::PrefixExpression> prefixExpression = std::static_pointer_cast<ast::PrefixExpression>(p_expression);
+			if (prefixExpression->m_operator == "++" || prefixExpression->m_operator == "--")
+			{
+				if (prefixExpression->m_rightExpression->Type() == ast::IDENTIFIER_NODE)
+				{
+					p_effects->m_assignedNames.insert(std::static_pointer_cast<ast::Identifier>(prefixExpression->m_rightExpression)->m_name);
+				}
+				else p_effects->m_hasMutations = true;
+			}
+			collectEffects(prefixExpression->m_rightExpression, p_effects);
+			break;
+		}
+		case ast::POSTFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::PostfixExpression> postfixExpression = std::static_pointer_cast<ast::PostfixExpression>(p_expression);
+			if (postfixExpression->m_leftExpression->Type() == ast::IDENTIFIER_NODE)
+			{
+				p_effects->m_assignedNames.insert(std::static_pointer_cast<ast::Identifier>(postfixExpression->m_leftExpression)->m_name);
+			}
+			else p_effects->m_hasMutations = true;
+			collectEffects(postfixExpression->m_leftExpression, p_effects);
+			break;
+		}
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::InfixExpression> infixExpression = std::static_pointer_cast<ast::InfixExpression>(p_expression);
+			if (isAssignment(&infixExpression->m_operator))
+			{
+				if (infixExpression->m_leftExpression->Type() == ast::IDENTIFIER_NODE)
+				{
+					p_effects->m_assignedNames.insert(std::static_pointer_cast<ast::Identifier>(infixExpression->m_leftExpression)->m_name);
+				}
+				else p_effects->m_hasMutations = true;
+			}
+			collectEffects(infixExpression->m_leftExpression, p_effects);
+
+			// The right side of a member access names the member
+			if (infixExpression->m_operator != ".") collectEffects(infixExpression->m_rightExpression, p_effects);
+			break;
+		}
+		case ast::CALL_EXPRESSION_NODE:
+		{
+			// Members that are called either change their collection or only read it
+			std::shared_ptr<ast::CallExpression> callExpression = std::static_pointer_cast<ast::CallExpression>(p_expression);
+			std::shared_ptr<ast::Expression> function = callExpression->m_function;
+			if (function->Type() == ast::INFIX_EXPRESSION_NODE && std::static_pointer_cast<ast::InfixExpression>(function)->m_operator == ".")
+			{
+				std::shared_ptr<ast::Expression> member = std::static_pointer_cast<ast::InfixExpression>(function)->m_rightExpression;
+				if (member->Type() != ast::IDENTIFIER_NODE) p_effects->m_hasMutations = true;
+				else
+				{
+					std::string* name = &std::static_pointer_cast<ast::Identifier>(member)->m_name;
+					if (*name != "keys" && *name != "values") p_effects->m_hasMutations = true;
+				}
+			}
+			else p_effects->m_hasCalls = true;
+
+			collectEffects(function, p_effects);
+			for (int i = 0; i < callExpression->m_parameters.size(); i++)
+			{
+				collectEffects(callExpression->m_parameters[i], p_effects);
+			}
+			break;
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::IndexExpression> indexExpression = std::static_pointer_cast<ast::IndexExpression>(p_expression);
+			collectEffects(indexExpression->m_collection, p_effects);
+			collectEffects(indexExpression->m_index, p_effects);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	// STATEMENTS
+
+	void Optimizer::optimizeStatements(std::vector<std::shared_ptr<ast::Statement>>* p_statements)
+	{
+		BasicBlock block;
+		block.m_order = 0;
+
+		for (int i = 0; i < p_statements->size(); i++)
+		{
+			std::shared_ptr<ast::Statement> statement = (*p_statements)[i];
+			optimizeStatement(statement);
+			recordAssignment(statement, true);
+
+			if (pruneBranches(statement))
+			{
+				p_statements->erase(p_statements->begin() + i);
+				i--;
+				continue;
+			}
+
+			if (!numberStatement(statement, &block)) block.m_available.clear();
+
+			// Nothing after a return, break or continue in the same list runs
+			ast::NodeType type = statement->Type();
+			if ((type == ast::RETURN_STATEMENT_NODE || type == ast::BREAK_STATEMENT_NODE || type == ast::CONTINUE_STATEMENT_NODE) && i + 1 < p_statements->size())
+			{
+				std::ostringstream report;
+				int line = type == ast::RETURN_STATEMENT_NODE ? std::static_pointer_cast<ast::ReturnStatement>(statement)->m_token.m_location.m_line
+					: type == ast::BREAK_STATEMENT_NODE ? std::static_pointer_cast<ast::BreakStatement>(statement)->m_token.m_location.m_line
+					: std::static_pointer_cast<ast::ContinueStatement>(statement)->m_token.m_location.m_line;
+				int count = p_statements->size() - i - 1;
+				report << "Line " << line << ": removed " << count << (count == 1 ? " statement that never runs" : " statements that never run") << " after '"
+					<< (type == ast::RETURN_STATEMENT_NODE ? "return" : type == ast::BREAK_STATEMENT_NODE ? "break" : "continue") << "'.";
+				m_report.push_back(report.str());
+				p_statements->erase(p_statements->begin() + i + 1, p_statements->end());
+				break;
+			}
+
+			if (type != ast::WHILE_STATEMENT_NODE && type != ast::DO_WHILE_STATEMENT_NODE && type != ast::FOR_STATEMENT_NODE) continue;
+
+			// Invariants are declared in the environment the loop runs in, just before it
+			std::vector<std::shared_ptr<ast::Statement>> hoisted;
+			hoistInvariants(statement, &hoisted);
+			p_statements->insert(p_statements->begin() + i, hoisted.begin(), hoisted.end());
+			i += hoisted.size();
+		}
+
+		reuseValues(p_statements, &block);
+	}
+
+	void Optimizer::optimizeStatement(std::shared_ptr<ast::Statement> p_statement)
+	{
+		switch (p_statement->Type())
+		{
+		case ast::EXPRESSION_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::ExpressionStatement> expressionStatement = std::static_pointer_cast<ast::ExpressionStatement>(p_statement);
+			expressionStatement->m_expression = optimizeExpression(expressionStatement->m_expression);
+			break;
+		}
+		case ast::BLOCK_STATEMENT_NODE:
+			optimizeBlock(std::static_pointer_cast<ast::BlockStatement>(p_statement));
+			break;
+		case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+			optimizeDeclareVariable(std::static_pointer_cast<ast::DeclareVariableStatement>(p_statement));
+			break;
+		case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareCollectionStatement> declaration = std::static_pointer_cast<ast::DeclareCollectionStatement>(p_statement);
+			declaration->m_value = optimizeExpression(declaration->m_value);
+			declare(&declaration->m_name.m_name, NULL, token::COLLECTION_TYPE);
+			countSlot(&declaration->m_name);
+			break;
+		}
+		case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareDictionaryStatement> declaration = std::static_pointer_cast<ast::DeclareDictionaryStatement>(p_statement);
+			declaration->m_value = optimizeExpression(declaration->m_value);
+			declare(&declaration->m_name.m_name, NULL, token::DICTIONARY_TYPE);
+			countSlot(&declaration->m_name);
+			break;
+		}
+		case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+			optimizeDeclareFunction(std::static_pointer_cast<ast::DeclareFunctionStatement>(p_statement));
+			break;
+		case ast::RETURN_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::ReturnStatement> returnStatement = std::static_pointer_cast<ast::ReturnStatement>(p_statement);
+			returnStatement->m_returnValue = optimizeExpression(returnStatement->m_returnValue);
+			break;
+		}
+		case ast::IF_STATEMENT_NODE:
+			optimizeIfStatement(std::static_pointer_cast<ast::IfStatement>(p_statement));
+			break;
+		case ast::WHILE_STATEMENT_NODE:
+		{
+			// The condition is evaluated outside of the loop's environment
+			std::shared_ptr<ast::WhileStatement> whileStatement = std::static_pointer_cast<ast::WhileStatement>(p_statement);
+			whileStatement->m_condition = optimizeExpression(whileStatement->m_condition);
+			beginScope();
+			optimizeBlock(whileStatement->m_consequence);
+			endScope();
+			break;
+		}
+		case ast::DO_WHILE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DoWhileStatement> doWhileStatement = std::static_pointer_cast<ast::DoWhileStatement>(p_statement);
+			beginScope();
+			optimizeBlock(doWhileStatement->m_consequence);
+			endScope();
+			doWhileStatement->m_condition = optimizeExpression(doWhileStatement->m_condition);
+			break;
+		}
+		case ast::FOR_STATEMENT_NODE:
+			optimizeForStatement(std::static_pointer_cast<ast::ForStatement>(p_statement));
+			break;
+		case ast::ITERATE_STATEMENT_NODE:
+			optimizeIterateStatement(std::static_pointer_cast<ast::IterateStatement>(p_statement));
+			break;
+		default:
+			break;
+		}
+	}
+
+	void Optimizer::optimizeBlock(std::shared_ptr<ast::BlockStatement> p_block)
+	{
+		if (p_block == NULL) return;
+
+		collectNames(&p_block->m_statements);
+		optimizeStatements(&p_block->m_statements);
+	}
+
+	void Optimizer::optimizeDeclareVariable(std::shared_ptr<ast::DeclareVariableStatement> p_declareVariable)
+	{
+		std::shared_ptr<ast::Expression> value = optimizeExpression(p_declareVariable->m_value);
+		p_declareVariable->m_value = value;
+
+		// A literal of another type than the declared one fails when it runs, and is left to fail
+		bool isLiteral = false;
+		if (value != NULL)
+		{
+			switch (p_declareVariable->m_token.m_type)
+			{
+			case token::INTEGER_TYPE:   isLiteral = value->Type() == ast::INTEGER_LITERAL_NODE; break;
+			case token::FLOAT_TYPE:     isLiteral = value->Type() == ast::FLOAT_LITERAL_NODE; break;
+			case token::BOOLEAN_TYPE:   isLiteral = value->Type() == ast::BOOLEAN_LITERAL_NODE; break;
+			case token::CHARACTER_TYPE: isLiteral = value->Type() == ast::CHARACTER_LITERAL_NODE; break;
+			case token::STRING_TYPE:    isLiteral = value->Type() == ast::STRING_LITERAL_NODE; break;
+			default: break;
+			}
+		}
+
+		// A global could be assigned by the body of a function that has not been parsed yet
+		bool isConstant = isLiteral && m_effects.m_assignedNames.count(p_declareVariable->m_name.m_name) == 0
+			&& !(m_scopes.back().m_isGlobal && m_effects.m_hasSkippedBodies);
+
+		// The value is checked before the name is declared, since it cannot see the variable it declares
+		bool isRemovable = isRemovableValue(value, p_declareVariable->m_token.m_type);
+
+		// A declaration that runs has checked the type of its value
+		declare(&p_declareVariable->m_name.m_name, isConstant ? value : NULL, p_declareVariable->m_token.m_type);
+		countSlot(&p_declareVariable->m_name);
+
+		// A global can be read by a body left for the lazy parser, and a name declared twice fails when it runs
+		Scope* scope = &m_scopes.back();
+		if (isRemovable && scope->m_redeclaredNames.count(p_declareVariable->m_name.m_name) == 0 && !(scope->m_isGlobal && m_effects.m_hasSkippedBodies))
+		{
+			m_removableStatements[p_declareVariable] = scope->m_declared[p_declareVariable->m_name.m_name];
+		}
+	}
+
+	void Optimizer::optimizeDeclareFunction(std::shared_ptr<ast::DeclareFunctionStatement> p_declareFunction)
+	{
+		declare(&p_declareFunction->m_name.m_name, NULL);
+		countSlot(&p_declareFunction->m_name);
+
+		Scope* scope = &m_scopes.back();
+		if (scope->m_redeclaredNames.count(p_declareFunction->m_name.m_name) == 0 && !(scope->m_isGlobal && m_effects.m_hasSkippedBodies))
+		{
+			m_removableStatements[p_declareFunction] = scope->m_declared[p_declareFunction->m_name.m_name];
+		}
+
+		// Calls are only inlined once the body has been optimized, so a function cannot be inlined into itself
+		Variable* variable = scope->m_declared[p_declareFunction->m_name.m_name];
+		bool isGlobal = scope->m_isGlobal;
+		if (p_declareFunction->m_body->m_body != NULL)
+		{
+			optimizeFunctionBody(&p_declareFunction->m_parameters, p_declareFunction->m_body->m_body);
+		}
+		if (isGlobal) m_functions[variable] = p_declareFunction;
+	}
+
+	void Optimizer::optimizeFunctionBody(std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters, std::shared_ptr<ast::BlockStatement> p_body)
+	{
+		beginScope(true);
+		for (int i = 0; i < p_parameters->size(); i++)
+		{
+			std::string* parameter = &(*p_parameters)[i]->m_name.m_name;
+			addName(parameter);
+			declare(parameter, NULL, (*p_parameters)[i]->m_token.m_type);
+			countSlot(&(*p_parameters)[i]->m_name);
+		}
+		optimizeBlock(p_body);
+		endScope();
+	}
+
+	void Optimizer::optimizeIfStatement(std::shared_ptr<ast::IfStatement> p_ifStatement)
+	{
+		// An else clause creates its environment inside the one of the 'if' it belongs to
+		if (p_ifStatement->m_condition != NULL)
+		{
+			p_ifStatement->m_condition = optimizeExpression(p_ifStatement->m_condition);
+		}
+
+		beginScope();
+		optimizeBlock(p_ifStatement->m_consequence);
+		endScope();
+
+		if (p_ifStatement->m_condition != NULL && p_ifStatement->m_alternative != NULL)
+		{
+			beginScope();
+			optimizeIfStatement(p_ifStatement->m_alternative);
+			endScope();
+		}
+	}
+
+	void Optimizer::optimizeForStatement(std::shared_ptr<ast::ForStatement> p_forStatement)
+	{
+		// One environment holds the initialization, and the body gets another one inside of it
+		beginScope();
+
+		std::vector<std::shared_ptr<ast::Statement>> header;
+		if (p_forStatement->m_initialization != NULL) header.push_back(p_forStatement->m_initialization);
+		if (p_forStatement->m_condition != NULL) header.push_back(p_forStatement->m_condition);
+		if (p_forStatement->m_updation != NULL) header.push_back(p_forStatement->m_updation);
+		collectNames(&header);
+
+		// What the header assigns stays assigned, since the header cannot lose a statement
+		for (int i = 0; i < header.size(); i++)
+		{
+			optimizeStatement(header[i]);
+			recordAssignment(header[i], false);
+		}
+
+		beginScope();
+		optimizeBlock(p_forStatement->m_consequence);
+		endScope();
+
+		endScope();
+	}
+
+	void Optimizer::optimizeIterateStatement(std::shared_ptr<ast::IterateStatement> p_iterateStatement)
+	{
+		p_iterateStatement->m_collection = optimizeExpression(p_iterateStatement->m_collection);
+
+		// The loop variable shares its environment with the body
+		beginScope();
+		addName(&p_iterateStatement->m_var->m_name);
+		declare(&p_iterateStatement->m_var->m_name, NULL);
+		countSlot(p_iterateStatement->m_var.get());
+		optimizeBlock(p_iterateStatement->m_consequence);
+		endScope();
+	}
+
+	// EXPRESSIONS
+
+	std::shared_ptr<ast::Expression> Optimizer::optimizeExpression(std::shared_ptr<ast::Expression> p_expression)
+	{
+		if (p_expression == NULL) return NULL;
+
+		switch (p_expression->Type())
+		{
+		case ast::IDENTIFIER_NODE:
+			return optimizeIdentifier(std::static_pointer_cast<ast::Identifier>(p_expression));
+		case ast::COLLECTION_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::CollectionLiteral> collectionLiteral = std::static_pointer_cast<ast::CollectionLiteral>(p_expression);
+			for (int i = 0; i < collectionLiteral->m_values.size(); i++)
+			{
+				collectionLiteral->m_values[i] = optimizeExpression(collectionLiteral->m_values[i]);
+			}
+			return p_expression;
+		}
+		case ast::DICTIONARY_LITERAL_NODE:
+		{
+			// Keys are left as they are, since the map is ordered by them
+			std::shared_ptr<ast::DictionaryLiteral> dictionaryLiteral = std::static_pointer_cast<ast::DictionaryLiteral>(p_expression);
+			for (auto it = dictionaryLiteral->m_map.begin(); it != dictionaryLiteral->m_map.end(); it++)
+			{
+				it->second = optimizeExpression(it->second);
+			}
+			return p_expression;
+		}
+		case ast::PREFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::PrefixExpression> prefixExpression = std::static_pointer_cast<ast::PrefixExpression>(p_expression);
+			if (prefixExpression->m_operator == "++" || prefixExpression->m_operator == "--")
+			{
+				// What is incremented stays a variable or an index
+				if (prefixExpression->m_rightExpression->Type() == ast::INDEX_EXPRESSION_NODE) optimizeExpression(prefixExpression->m_rightExpression);
+				return p_expression;
+			}
+
+			prefixExpression->m_rightExpression = optimizeExpression(prefixExpression->m_rightExpression);
+			std::shared_ptr<ast::Expression> folded = foldPrefixExpression(prefixExpression);
+			return folded != NULL ? folded : p_expression;
+		}
+		case ast::POSTFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::PostfixExpression> postfixExpression = std::static_pointer_cast<ast::PostfixExpression>(p_expression);
+			if (postfixExpression->m_leftExpression->Type() == ast::INDEX_EXPRESSION_NODE) optimizeExpression(postfixExpression->m_leftExpression);
+			return p_expression;
+		}
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::InfixExpression> infixExpression = std::static_pointer_cast<ast::InfixExpression>(p_expression);
+			if (isAssignment(&infixExpression->m_operator))
+			{
+				if (infixExpression->m_leftExpression->Type() == ast::INDEX_EXPRESSION_NODE) optimizeExpression(infixExpression->m_leftExpression);
+				infixExpression->m_rightExpression = optimizeExpression(infixExpression->m_rightExpression);
+				return p_expression;
+			}
+
+			// Member names are not variables
+			if (infixExpression->m_operator == ".")
+			{
+				infixExpression->m_leftExpression = optimizeExpression(infixExpression->m_leftExpression);
+				return foldMemberAccess(infixExpression);
+			}
+
+			infixExpression->m_leftExpression = optimizeExpression(infixExpression->m_leftExpression);
+			infixExpression->m_rightExpression = optimizeExpression(infixExpression->m_rightExpression);
+			std::shared_ptr<ast::Expression> folded = foldInfixExpression(infixExpression);
+			return folded != NULL ? folded : p_expression;
+		}
+		case ast::CALL_EXPRESSION_NODE:
+		{
+			// A function named by an identifier is looked up as a function, not a value
+			std::shared_ptr<ast::CallExpression> callExpression = std::static_pointer_cast<ast::CallExpression>(p_expression);
+			if (callExpression->m_function->Type() != ast::IDENTIFIER_NODE)
+			{
+				callExpression->m_function = optimizeExpression(callExpression->m_function);
+			}
+			for (int i = 0; i < callExpression->m_parameters.size(); i++)
+			{
+				callExpression->m_parameters[i] = optimizeExpression(callExpression->m_parameters[i]);
+			}
+			std::shared_ptr<ast::Expression> inlined = inlineCall(callExpression);
+			return inlined != NULL ? inlined : p_expression;
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::IndexExpression> indexExpression = std::static_pointer_cast<ast::IndexExpression>(p_expression);
+			indexExpression->m_collection = optimizeExpression(indexExpression->m_collection);
+			indexExpression->m_index = optimizeExpression(indexExpression->m_index);
+			return p_expression;
+		}
+		default:
+			return p_expression;
+		}
+	}
+
+	std::shared_ptr<ast::Expression> Optimizer::optimizeIdentifier(std::shared_ptr<ast::Identifier> p_identifier)
+	{
+		// Strings are only known for their length, since a string literal makes a new string each time
+		Variable* variable = lookup(&p_identifier->m_name);
+		if (variable == NULL || variable->m_value == NULL || variable->m_value->Type() == ast::STRING_LITERAL_NODE) return p_identifier;
+
+		return variable->m_value;
+	}
+
+	std::shared_ptr<ast::Expression> Optimizer::foldPrefixExpression(std::shared_ptr<ast::PrefixExpression> p_prefixExpression)
+	{
+		ast::Expression* right = p_prefixExpression->m_rightExpression.get();
+		token::Token* token = &p_prefixExpression->m_token;
+
+		if (p_prefixExpression->m_operator == "-")
+		{
+			if (right->Type() == ast::INTEGER_LITERAL_NODE) return newInteger(token, -(long long)((ast::IntegerLiteral*)right)->m_value);
+			if (right->Type() == ast::FLOAT_LITERAL_NODE) return newFloat(token, -((ast::FloatLiteral*)right)->m_value);
+		}
+		else if (p_prefixExpression->m_operator == "!")
+		{
+			if (right->Type() == ast::INTEGER_LITERAL_NODE) return newBoolean(token, !((ast::IntegerLiteral*)right)->m_value);
+			if (right->Type() == ast::FLOAT_LITERAL_NODE) return newBoolean(token, !((ast::FloatLiteral*)right)->m_value);
+			if (right->Type() == ast::BOOLEAN_LITERAL_NODE) return newBoolean(token, !((ast::BooleanLiteral*)right)->m_value);
+		}
+
+		return p_prefixExpression;
+	}
+
+	std::shared_ptr<ast::Expression> Optimizer::foldInfixExpression(std::shared_ptr<ast::InfixExpression> p_infixExpression)
+	{
+		ast::Expression* left = p_infixExpression->m_leftExpression.get();
+		ast::Expression* right = p_infixExpression->m_rightExpression.get();
+		std::string* op = &p_infixExpression->m_operator;
+		token::Token* token = &p_infixExpression->m_token;
+
+		if (left->Type() == ast::INTEGER_LITERAL_NODE && right->Type() == ast::INTEGER_LITERAL_NODE)
+		{
+			// Results that do not fit an integer and divisions by zero are left for the evaluator
+			long long leftValue = ((ast::IntegerLiteral*)left)->m_value;
+			long long rightValue = ((ast::IntegerLiteral*)right)->m_value;
+			bool isDividable = rightValue != 0 && !(leftValue == INT_MIN && rightValue == -1);
+
+			if (*op == "+") return newInteger(token, leftValue + rightValue);
+			if (*op == "-") return newInteger(token, leftValue - rightValue);
+			if (*op == "*") return newInteger(token, leftValue * rightValue);
+			if (*op == "/" && isDividable) return newInteger(token, leftValue / rightValue);
+			if (*op == "%" && isDividable) return newInteger(token, leftValue % rightValue);
+			if (*op == "<")  return newBoolean(token, leftValue < rightValue);
+			if (*op == "<=") return newBoolean(token, leftValue <= rightValue);
+			if (*op == ">")  return newBoolean(token, leftValue > rightValue);
+			if (*op == ">=") return newBoolean(token, leftValue >= rightValue);
+			if (*op == "==") return newBoolean(token, leftValue == rightValue);
+			if (*op == "!=") return newBoolean(token, leftValue != rightValue);
+		}
+		else if ((left->Type() == ast::INTEGER_LITERAL_NODE || left->Type() == ast::FLOAT_LITERAL_NODE)
+			&& (right->Type() == ast::INTEGER_LITERAL_NODE || right->Type() == ast::FLOAT_LITERAL_NODE))
+		{
+			// An integer with a float is turned into a float first, as the evaluator does
+			float leftValue = left->Type() == ast::INTEGER_LITERAL_NODE ? (float)((ast::IntegerLiteral*)left)->m_value : ((ast::FloatLiteral*)left)->m_value;
+			float rightValue = right->Type() == ast::INTEGER_LITERAL_NODE ? (float)((ast::IntegerLiteral*)right)->m_value : ((ast::FloatLiteral*)right)->m_value;
+
+			if (*op == "+") return newFloat(token, leftValue + rightValue);
+			if (*op == "-") return newFloat(token, leftValue - rightValue);
+			if (*op == "*") return newFloat(token, leftValue * rightValue);
+			if (*op == "/" && rightValue != 0) return newFloat(token, leftValue / rightValue);
+			if (*op == "<")  return newBoolean(token, leftValue < rightValue);
+			if (*op == "<=") return newBoolean(token, leftValue <= rightValue);
+			if (*op == ">")  return newBoolean(token, leftValue > rightValue);
+			if (*op == ">=") return newBoolean(token, leftValue >= rightValue);
+			if (*op == "==") return newBoolean(token, leftValue == rightValue);
+			if (*op == "!=") return newBoolean(token, leftValue != rightValue);
+		}
+		else if (left->Type() == ast::BOOLEAN_LITERAL_NODE && right->Type() == ast::BOOLEAN_LITERAL_NODE)
+		{
+			bool leftValue = ((ast::BooleanLiteral*)left)->m_value;
+			bool rightValue = ((ast::BooleanLiteral*)right)->m_value;
+
+			if (*op == "&&") return newBoolean(token, leftValue && rightValue);
+			if (*op == "||") return newBoolean(token, leftValue || rightValue);
+			if (*op == "==") return newBoolean(token, leftValue == rightValue);
+			if (*op == "!=") return newBoolean(token, leftValue != rightValue);
+		}
+		else if (left->Type() == ast::CHARACTER_LITERAL_NODE && right->Type() == ast::CHARACTER_LITERAL_NODE)
+		{
+			char leftValue = ((ast::CharacterLiteral*)left)->m_value;
+			char rightValue = ((ast::CharacterLiteral*)right)->m_value;
+
+			if (*op == "==") return newBoolean(token, leftValue == rightValue);
+			if (*op == "!=") return newBoolean(token, leftValue != rightValue);
+		}
+
+		return p_infixExpression;
+	}
+
+	std::shared_ptr<ast::Expression> Optimizer::foldMemberAccess(std::shared_ptr<ast::InfixExpression> p_infixExpression)
+	{
+		if (p_infixExpression->m_rightExpression->Type() != ast::IDENTIFIER_NODE) return p_infixExpression;
+
+		ast::Identifier* member = (ast::Identifier*)p_infixExpression->m_rightExpression.get();
+		if (member->m_member != ast::MEMBER_LENGTH && member->m_name != "length") return p_infixExpression;
+
+		// The length of a string literal, or of a variable that always holds one
+		std::shared_ptr<ast::Expression> string = p_infixExpression->m_leftExpression;
+		if (string->Type() == ast::IDENTIFIER_NODE)
+		{
+			Variable* variable = lookup(&std::static_pointer_cast<ast::Identifier>(string)->m_name);
+			if (variable == NULL || variable->m_value == NULL) return p_infixExpression;
+			string = variable->m_value;
+		}
+		if (string->Type() != ast::STRING_LITERAL_NODE) return p_infixExpression;
+
+		return newInteger(&p_infixExpression->m_token, std::static_pointer_cast<ast::StringLiteral>(string)->m_stringCollection->m_values.size());
+	}
+
+	// LOOPS
+
+	void Optimizer::hoistInvariants(std::shared_ptr<ast::Statement> p_loop, std::vector<std::shared_ptr<ast::Statement>>* p_hoisted)
+	{
+		Effects loop;
+		collectEffects(p_loop, &loop);
+
+		switch (p_loop->Type())
+		{
+		case ast::WHILE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::WhileStatement> whileStatement = std::static_pointer_cast<ast::WhileStatement>(p_loop);
+			whileStatement->m_condition = hoistExpression(whileStatement->m_condition, &loop, 0, p_hoisted);
+			hoistStatement(whileStatement->m_consequence, &loop, 1, p_hoisted);
+			break;
+		}
+		case ast::DO_WHILE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DoWhileStatement> doWhileStatement = std::static_pointer_cast<ast::DoWhileStatement>(p_loop);
+			hoistStatement(doWhileStatement->m_consequence, &loop, 1, p_hoisted);
+			doWhileStatement->m_condition = hoistExpression(doWhileStatement->m_condition, &loop, 0, p_hoisted);
+			break;
+		}
+		case ast::FOR_STATEMENT_NODE:
+		{
+			// The initialization only runs once already
+			std::shared_ptr<ast::ForStatement> forStatement = std::static_pointer_cast<ast::ForStatement>(p_loop);
+			hoistStatement(forStatement->m_condition, &loop, 1, p_hoisted);
+			hoistStatement(forStatement->m_updation, &loop, 1, p_hoisted);
+			hoistStatement(forStatement->m_consequence, &loop, 2, p_hoisted);
+			markCountedLoop(forStatement, &loop);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	void Optimizer::hoistStatement(std::shared_ptr<ast::Statement> p_statement, Effects* p_loop, int p_depth, std::vector<std::shared_ptr<ast::Statement>>* p_hoisted)
+	{
+		if (p_statement == NULL) return;
+
+		// Bodies of functions declared in the loop run when they are called, and are left alone
+		switch (p_statement->Type())
+		{
+		case ast::EXPRESSION_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::ExpressionStatement> expressionStatement = std::static_pointer_cast<ast::ExpressionStatement>(p_statement);
+			expressionStatement->m_expression = hoistExpression(expressionStatement->m_expression, p_loop, p_depth, p_hoisted);
+			break;
+		}
+		case ast::BLOCK_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::BlockStatement> block = std::static_pointer_cast<ast::BlockStatement>(p_statement);
+			for (int i = 0; i < block->m_statements.size(); i++)
+			{
+				// An invariant of an inner loop that does not change in this one either moves out with it
+				std::shared_ptr<ast::Statement> statement = block->m_statements[i];
+				if (statement->Type() == ast::DECLARE_VARIABLE_STATEMENT_NODE)
+				{
+					std::shared_ptr<ast::DeclareVariableStatement> declaration = std::static_pointer_cast<ast::DeclareVariableStatement>(statement);
+					if (declaration->m_name.m_name.compare(0, 10, "$invariant") == 0 && invariantType(declaration->m_value.get(), p_loop) != token::ILLEGAL)
+					{
+						moveOut(declaration->m_value.get(), p_depth);
+						p_hoisted->push_back(declaration);
+						declare(&declaration->m_name.m_name, NULL, declaration->m_token.m_type);
+						block->m_statements.erase(block->m_statements.begin() + i);
+						i--;
+						continue;
+					}
+				}
+
+				hoistStatement(statement, p_loop, p_depth, p_hoisted);
+			}
+			break;
+		}
+		case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareVariableStatement> declaration = std::static_pointer_cast<ast::DeclareVariableStatement>(p_statement);
+			declaration->m_value = hoistExpression(declaration->m_value, p_loop, p_depth, p_hoisted);
+			break;
+		}
+		case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareCollectionStatement> declaration = std::static_pointer_cast<ast::DeclareCollectionStatement>(p_statement);
+			declaration->m_value = hoistExpression(declaration->m_value, p_loop, p_depth, p_hoisted);
+			break;
+		}
+		case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareDictionaryStatement> declaration = std::static_pointer_cast<ast::DeclareDictionaryStatement>(p_statement);
+			declaration->m_value = hoistExpression(declaration->m_value, p_loop, p_depth, p_hoisted);
+			break;
+		}
+		case ast::RETURN_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::ReturnStatement> returnStatement = std::static_pointer_cast<ast::ReturnStatement>(p_statement);
+			returnStatement->m_returnValue = hoistExpression(returnStatement->m_returnValue, p_loop, p_depth, p_hoisted);
+			break;
+		}
+		case ast::IF_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::IfStatement> ifStatement = std::static_pointer_cast<ast::IfStatement>(p_statement);
+			ifStatement->m_condition = hoistExpression(ifStatement->m_condition, p_loop, p_depth, p_hoisted);
+			hoistStatement(ifStatement->m_consequence, p_loop, p_depth + 1, p_hoisted);
+			hoistStatement(ifStatement->m_alternative, p_loop, p_depth + 1, p_hoisted);
+			break;
+		}
+		case ast::WHILE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::WhileStatement> whileStatement = std::static_pointer_cast<ast::WhileStatement>(p_statement);
+			whileStatement->m_condition = hoistExpression(whileStatement->m_condition, p_loop, p_depth, p_hoisted);
+			hoistStatement(whileStatement->m_consequence, p_loop, p_depth + 1, p_hoisted);
+			break;
+		}
+		case ast::DO_WHILE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DoWhileStatement> doWhileStatement = std::static_pointer_cast<ast::DoWhileStatement>(p_statement);
+			hoistStatement(doWhileStatement->m_consequence, p_loop, p_depth + 1, p_hoisted);
+			doWhileStatement->m_condition = hoistExpression(doWhileStatement->m_condition, p_loop, p_depth, p_hoisted);
+			break;
+		}
+		case ast::FOR_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::ForStatement> forStatement = std::static_pointer_cast<ast::ForStatement>(p_statement);
+			hoistStatement(forStatement->m_initialization, p_loop, p_depth + 1, p_hoisted);
+			hoistStatement(forStatement->m_condition, p_loop, p_depth + 1, p_hoisted);
+			hoistStatement(forStatement->m_updation, p_loop, p_depth + 1, p_hoisted);
+			hoistStatement(forStatement->m_consequence, p_loop, p_depth + 2, p_hoisted);
+			break;
+		}
+		case ast::ITERATE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::IterateStatement> iterateStatement = std::static_pointer_cast<ast::IterateStatement>(p_statement);
+			iterateStatement->m_collection = hoistExpression(iterateStatement->m_collection, p_loop, p_depth, p_hoisted);
+			hoistStatement(iterateStatement->m_consequence, p_loop, p_depth + 1, p_hoisted);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	std::shared_ptr<ast::Expression> Optimizer::hoistExpression(std::shared_ptr<ast::Expression> p_expression, Effects* p_loop, int p_depth, std::vector<std::shared_ptr<ast::Statement>>* p_hoisted)
+	{
+		if (p_expression == NULL) return NULL;
+
+		// Only operations are worth computing once, since literals and variables are already as cheap as it gets
+		token::Token* token = NULL;
+		if (p_expression->Type() == ast::PREFIX_EXPRESSION_NODE)
+		{
+			std::shared_ptr<ast::PrefixExpression> prefixExpression = std::static_pointer_cast<ast::PrefixExpression>(p_expression);
+			if (prefixExpression->m_operator == "-" || prefixExpression->m_operator == "!") token = &prefixExpression->m_token;
+		}
+		else if (p_expression->Type() == ast::INFIX_EXPRESSION_NODE)
+		{
+			std::shared_ptr<ast::InfixExpression> infixExpression = std::static_pointer_cast<ast::InfixExpression>(p_expression);
+			if (!isAssignment(&infixExpression->m_operator)) token = &infixExpression->m_token;
+		}
+
+		token::TokenType type = token != NULL ? invariantType(p_expression.get(), p_loop) : token::ILLEGAL;
+		if (type != token::ILLEGAL)
+		{
+			m_invariantCount++;
+
+			// The name cannot be written in a program, so it never clashes with one, and marks the invariants of a loop
+			std::shared_ptr<ast::DeclareVariableStatement> declaration = ast::newNode<ast::DeclareVariableStatement>(m_arena);
+			declaration->m_token = *token;
+			declaration->m_token.m_type = type;
+			declaration->m_token.m_literal = type == token::INTEGER_TYPE ? "integer" : type == token::FLOAT_TYPE ? "float" : type == token::BOOLEAN_TYPE ? "boolean" : "character";
+			declaration->m_name.m_token = *token;
+			declaration->m_name.m_token.m_type = token::IDENTIFIER;
+			declaration->m_name.m_name = "$invariant" + std::to_string(m_invariantCount);
+			declaration->m_name.m_token.m_literal = declaration->m_name.m_name;
+			declaration->m_name.m_symbol = token::internIdentifier(&declaration->m_name.m_name);
+			moveOut(p_expression.get(), p_depth);
+			declaration->m_value = p_expression;
+			declaration->m_isTypeChecked = true;
+			p_hoisted->push_back(declaration);
+			declare(&declaration->m_name.m_name, NULL, type);
+
+			std::shared_ptr<ast::Identifier> identifier = ast::newNode<ast::Identifier>(m_arena);
+			*identifier = declaration->m_name;
+			identifier->m_resolvedType = type;
+			return identifier;
+		}
+
+		switch (p_expression->Type())
+		{
+		case ast::COLLECTION_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::CollectionLiteral> collectionLiteral = std::static_pointer_cast<ast::CollectionLiteral>(p_expression);
+			for (int i = 0; i < collectionLiteral->m_values.size(); i++)
+			{
+				collectionLiteral->m_values[i] = hoistExpression(collectionLiteral->m_values[i], p_loop, p_depth, p_hoisted);
+			}
+			break;
+		}
+		case ast::DICTIONARY_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::DictionaryLiteral> dictionaryLiteral = std::static_pointer_cast<ast::DictionaryLiteral>(p_expression);
+			for (auto it = dictionaryLiteral->m_map.begin(); it != dictionaryLiteral->m_map.end(); it++)
+			{
+				it->second = hoistExpression(it->second, p_loop, p_depth, p_hoisted);
+			}
+			break;
+		}
+		case ast::PREFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::PrefixExpression> prefixExpression = std::static_pointer_cast<ast::PrefixExpression>(p_expression);
+			if (prefixExpression->m_operator != "++" && prefixExpression->m_operator != "--")
+			{
+				prefixExpression->m_rightExpression = hoistExpression(prefixExpression->m_rightExpression, p_loop, p_depth, p_hoisted);
+			}
+			else if (prefixExpression->m_rightExpression->Type() == ast::INDEX_EXPRESSION_NODE)
+			{
+				hoistExpression(prefixExpression->m_rightExpression, p_loop, p_depth, p_hoisted);
+			}
+			break;
+		}
+		case ast::POSTFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::PostfixExpression> postfixExpression = std::static_pointer_cast<ast::PostfixExpression>(p_expression);
+			if (postfixExpression->m_leftExpression->Type() == ast::INDEX_EXPRESSION_NODE)
+			{
+				hoistExpression(postfixExpression->m_leftExpression, p_loop, p_depth, p_hoisted);
+			}
+			break;
+		}
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::InfixExpression> infixExpression = std::static_pointer_cast<ast::InfixExpression>(p_expression);
+			if (isAssignment(&infixExpression->m_operator))
+			{
+				if (infixExpression->m_leftExpression->Type() == ast::INDEX_EXPRESSION_NODE) hoistExpression(infixExpression->m_leftExpression, p_loop, p_depth, p_hoisted);
+			}
+			else
+			{
+				infixExpression->m_leftExpression = hoistExpression(infixExpression->m_leftExpression, p_loop, p_depth, p_hoisted);
+			}
+
+			if (infixExpression->m_operator != ".")
+			{
+				infixExpression->m_rightExpression = hoistExpression(infixExpression->m_rightExpression, p_loop, p_depth, p_hoisted);
+			}
+			break;
+		}
+		case ast::CALL_EXPRESSION_NODE:
+		{
+			// A member that is called stays a member access
+			std::shared_ptr<ast::CallExpression> callExpression = std::static_pointer_cast<ast::CallExpression>(p_expression);
+			if (callExpression->m_function->Type() == ast::INFIX_EXPRESSION_NODE)
+			{
+				std::shared_ptr<ast::InfixExpression> access = std::static_pointer_cast<ast::InfixExpression>(callExpression->m_function);
+				access->m_leftExpression = hoistExpression(access->m_leftExpression, p_loop, p_depth, p_hoisted);
+			}
+			for (int i = 0; i < callExpression->m_parameters.size(); i++)
+			{
+				callExpression->m_parameters[i] = hoistExpression(callExpression->m_parameters[i], p_loop, p_depth, p_hoisted);
+			}
+			break;
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::IndexExpression> indexExpression = std::static_pointer_cast<ast::IndexExpression>(p_expression);
+			indexExpression->m_collection = hoistExpression(indexExpression->m_collection, p_loop, p_depth, p_hoisted);
+			indexExpression->m_index = hoistExpression(indexExpression->m_index, p_loop, p_depth, p_hoisted);
+			break;
+		}
+		default:
+			break;
+		}
+
+		return p_expression;
+	}
+
+	void Optimizer::moveOut(ast::Expression* p_expression, int p_depth)
+	{
+		// Only what an invariant can be made of needs to be handled
+		switch (p_expression->Type())
+		{
+		case ast::IDENTIFIER_NODE:
+		{
+			ast::Identifier* identifier = (ast::Identifier*)p_expression;
+			if (identifier->m_slot >= 0) identifier->m_depth -= p_depth;
+			break;
+		}
+		case ast::PREFIX_EXPRESSION_NODE:
+			moveOut(((ast::PrefixExpression*)p_expression)->m_rightExpression.get(), p_depth);
+			break;
+		case ast::INFIX_EXPRESSION_NODE:
+			moveOut(((ast::InfixExpression*)p_expression)->m_leftExpression.get(), p_depth);
+			moveOut(((ast::InfixExpression*)p_expression)->m_rightExpression.get(), p_depth);
+			break;
+		default:
+			break;
+		}
+	}
+
+	token::TokenType Optimizer::invariantType(ast::Expression* p_expression, Effects* p_loop)
+	{
+		switch (p_expression->Type())
+		{
+		case ast::INTEGER_LITERAL_NODE:   return token::INTEGER_TYPE;
+		case ast::FLOAT_LITERAL_NODE:     return token::FLOAT_TYPE;
+		case ast::BOOLEAN_LITERAL_NODE:   return token::BOOLEAN_TYPE;
+		case ast::CHARACTER_LITERAL_NODE: return token::CHARACTER_TYPE;
+		case ast::IDENTIFIER_NODE:
+		{
+			// A variable of the loop, or one the loop assigns, changes between iterations
+			std::string* name = &((ast::Identifier*)p_expression)->m_name;
+			if (p_loop->m_assignedNames.count(*name) > 0 || p_loop->m_declaredNames.count(*name) > 0) return token::ILLEGAL;
+
+			Variable* variable = lookup(name);
+			if (variable == NULL) return token::ILLEGAL;
+
+			// A function called by the loop may assign any variable it can see
+			if (p_loop->m_hasCalls && (m_effects.m_assignedNames.count(*name) > 0 || (variable->m_isGlobal && m_effects.m_hasSkippedBodies))) return token::ILLEGAL;
+			return variable->m_type;
+		}
+		case ast::PREFIX_EXPRESSION_NODE:
+		{
+			ast::PrefixExpression* prefixExpression = (ast::PrefixExpression*)p_expression;
+			token::TokenType right = invariantType(prefixExpression->m_rightExpression.get(), p_loop);
+			bool isNumber = right == token::INTEGER_TYPE || right == token::FLOAT_TYPE;
+
+			if (prefixExpression->m_operator == "-" && isNumber) return right;
+			if (prefixExpression->m_operator == "!" && (isNumber || right == token::BOOLEAN_TYPE)) return token::BOOLEAN_TYPE;
+			return token::ILLEGAL;
+		}
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			ast::InfixExpression* infixExpression = (ast::InfixExpression*)p_expression;
+			std::string* op = &infixExpression->m_operator;
+			token::TokenType left = invariantType(infixExpression->m_leftExpression.get(), p_loop);
+
+			// The length of a string never changes, but the size of a collection does if anything could change it
+			if (*op == ".")
+			{
+				if (infixExpression->m_rightExpression->Type() != ast::IDENTIFIER_NODE) return token::ILLEGAL;
+				ast::Identifier* member = (ast::Identifier*)infixExpression->m_rightExpression.get();
+
+				bool isLength = member->m_member == ast::MEMBER_LENGTH || member->m_name == "length";
+				bool isSize = member->m_member == ast::MEMBER_SIZE || member->m_name == "size";
+				if (left == token::STRING_TYPE && isLength) return token::INTEGER_TYPE;
+				if ((left == token::COLLECTION_TYPE || left == token::DICTIONARY_TYPE) && isSize && !p_loop->m_hasMutations && !p_loop->m_hasCalls) return token::INTEGER_TYPE;
+				return token::ILLEGAL;
+			}
+
+			token::TokenType right = invariantType(infixExpression->m_rightExpression.get(), p_loop);
+			if (left == token::ILLEGAL || right == token::ILLEGAL) return token::ILLEGAL;
+
+			bool isComparison = *op == "<" || *op == "<=" || *op == ">" || *op == ">=" || *op == "==" || *op == "!=";
+			bool isEquality = *op == "==" || *op == "!=";
+			if ((left == token::INTEGER_TYPE || left == token::FLOAT_TYPE) && (right == token::INTEGER_TYPE || right == token::FLOAT_TYPE))
+			{
+				token::TokenType result = left == token::INTEGER_TYPE && right == token::INTEGER_TYPE ? token::INTEGER_TYPE : token::FLOAT_TYPE;
+				if (*op == "+" || *op == "-" || *op == "*") return result;
+				if (isComparison) return token::BOOLEAN_TYPE;
+
+				// Dividing fails for a divisor of zero, so only literal divisors that cannot fail are allowed
+				ast::Expression* divisor = infixExpression->m_rightExpression.get();
+				bool isSafeDivisor = (divisor->Type() == ast::INTEGER_LITERAL_NODE && ((ast::IntegerLiteral*)divisor)->m_value != 0 && ((ast::IntegerLiteral*)divisor)->m_value != -1)
+					|| (divisor->Type() == ast::FLOAT_LITERAL_NODE && ((ast::FloatLiteral*)divisor)->m_value != 0);
+				if (*op == "/" && isSafeDivisor) return result;
+				if (*op == "%" && isSafeDivisor && result == token::INTEGER_TYPE) return result;
+				return token::ILLEGAL;
+			}
+			if (left == token::BOOLEAN_TYPE && right == token::BOOLEAN_TYPE && (*op == "&&" || *op == "||" || isEquality)) return token::BOOLEAN_TYPE;
+			if (left == token::CHARACTER_TYPE && right == token::CHARACTER_TYPE && isEquality) return token::BOOLEAN_TYPE;
+			return token::ILLEGAL;
+		}
+		default:
+			return token::ILLEGAL;
+		}
+	}
+
+	void Optimizer::markCountedLoop(std::shared_ptr<ast::ForStatement> p_forStatement, Effects* p_loop)
+	{
+		// for (integer counter = start; counter < bound; counter += step), with any comparison, ++ or --
+		if (p_forStatement->m_initialization == NULL || p_forStatement->m_condition == NULL || p_forStatement->m_updation == NULL) return;
+		if (p_forStatement->m_initialization->Type() != ast::DECLARE_VARIABLE_STATEMENT_NODE) return;
+
+		std::shared_ptr<ast::DeclareVariableStatement> counter = std::static_pointer_cast<ast::DeclareVariableStatement>(p_forStatement->m_initialization);
+		std::string* name = &counter->m_name.m_name;
+		if (counter->m_token.m_type != token::INTEGER_TYPE) return;
+
+		if (p_forStatement->m_condition->Type() != ast::EXPRESSION_STATEMENT_NODE) return;
+		std::shared_ptr<ast::Expression> condition = std::static_pointer_cast<ast::ExpressionStatement>(p_forStatement->m_condition)->m_expression;
+		if (condition->Type() != ast::INFIX_EXPRESSION_NODE) return;
+
+		std::shared_ptr<ast::InfixExpression> comparison = std::static_pointer_cast<ast::InfixExpression>(condition);
+		std::string* op = &comparison->m_operator;
+		if (*op != "<" && *op != "<=" && *op != ">" && *op != ">=") return;
+		if (comparison->m_leftExpression->Type() != ast::IDENTIFIER_NODE || std::static_pointer_cast<ast::Identifier>(comparison->m_leftExpression)->m_name != *name) return;
+		if (invariantType(comparison->m_rightExpression.get(), p_loop) != token::INTEGER_TYPE) return;
+
+		if (p_forStatement->m_updation->Type() != ast::EXPRESSION_STATEMENT_NODE) return;
+		std::shared_ptr<ast::Expression> updation = std::static_pointer_cast<ast::ExpressionStatement>(p_forStatement->m_updation)->m_expression;
+
+		std::shared_ptr<ast::Expression> stepped;
+		if (updation->Type() == ast::POSTFIX_EXPRESSION_NODE)
+		{
+			stepped = std::static_pointer_cast<ast::PostfixExpression>(updation)->m_leftExpression;
+		}
+		else if (updation->Type() == ast::PREFIX_EXPRESSION_NODE)
+		{
+			std::shared_ptr<ast::PrefixExpression> prefixExpression = std::static_pointer_cast<ast::PrefixExpression>(updation);
+			if (prefixExpression->m_operator == "++" || prefixExpression->m_operator == "--") stepped = prefixExpression->m_rightExpression;
+		}
+		else if (updation->Type() == ast::INFIX_EXPRESSION_NODE)
+		{
+			std::shared_ptr<ast::InfixExpression> infixExpression = std::static_pointer_cast<ast::InfixExpression>(updation);
+			bool isStep = infixExpression->m_operator == "+=" || infixExpression->m_operator == "-=";
+			if (isStep && invariantType(infixExpression->m_rightExpression.get(), p_loop) == token::INTEGER_TYPE) stepped = infixExpression->m_leftExpression;
+		}
+		if (stepped == NULL || stepped->Type() != ast::IDENTIFIER_NODE || std::static_pointer_cast<ast::Identifier>(stepped)->m_name != *name) return;
+
+		// Only the updation may change the counter
+		Effects body;
+		collectEffects(p_forStatement->m_consequence, &body);
+		if (body.m_assignedNames.count(*name) > 0) return;
+
+		p_forStatement->m_isCounted = true;
+	}
+
+	// DEAD CODE
+
+	bool Optimizer::pruneBranches(std::shared_ptr<ast::Statement> p_statement)
+	{
+		std::ostringstream report;
+		if (p_statement->Type() == ast::WHILE_STATEMENT_NODE)
+		{
+			std::shared_ptr<ast::WhileStatement> whileStatement = std::static_pointer_cast<ast::WhileStatement>(p_statement);
+			if (whileStatement->m_condition->Type() != ast::BOOLEAN_LITERAL_NODE || std::static_pointer_cast<ast::BooleanLiteral>(whileStatement->m_condition)->m_value) return false;
+
+			report << "Line " << whileStatement->m_token.m_location.m_line << ": removed 'while' whose condition is always false.";
+			m_report.push_back(report.str());
+			return true;
+		}
+		if (p_statement->Type() != ast::IF_STATEMENT_NODE) return false;
+
+		// Branches are emptied rather than moved, so that every environment the evaluator creates stays where it was
+		std::shared_ptr<ast::IfStatement> ifStatement = std::static_pointer_cast<ast::IfStatement>(p_statement);
+		if (ifStatement->m_condition->Type() != ast::BOOLEAN_LITERAL_NODE) return false;
+
+		int line = ifStatement->m_token.m_location.m_line;
+		if (std::static_pointer_cast<ast::BooleanLiteral>(ifStatement->m_condition)->m_value)
+		{
+			if (ifStatement->m_alternative == NULL) return false;
+
+			ifStatement->m_alternative = NULL;
+			report << "Line " << line << ": removed 'else' of 'if' whose condition is always true.";
+			m_report.push_back(report.str());
+			return false;
+		}
+
+		if (ifStatement->m_alternative == NULL)
+		{
+			report << "Line " << line << ": removed 'if' whose condition is always false.";
+			m_report.push_back(report.str());
+			return true;
+		}
+
+		if (!ifStatement->m_consequence->m_statements.empty())
+		{
+			ifStatement->m_consequence->m_statements.clear();
+			report << "Line " << line << ": removed branch of 'if' whose condition is always false.";
+			m_report.push_back(report.str());
+		}
+		return false;
+	}
+
+	void Optimizer::recordAssignment(std::shared_ptr<ast::Statement> p_statement, bool p_isRemovable)
+	{
+		if (p_statement->Type() != ast::EXPRESSION_STATEMENT_NODE) return;
+		std::shared_ptr<ast::Expression> expression = std::static_pointer_cast<ast::ExpressionStatement>(p_statement)->m_expression;
+
+		std::string op;
+		std::shared_ptr<ast::Expression> target;
+		std::shared_ptr<ast::Expression> value;
+		switch (expression->Type())
+		{
+		case ast::INFIX_EXPRESSION_NODE:
+			op = std::static_pointer_cast<ast::InfixExpression>(expression)->m_operator;
+			target = std::static_pointer_cast<ast::InfixExpression>(expression)->m_leftExpression;
+			value = std::static_pointer_cast<ast::InfixExpression>(expression)->m_rightExpression;
+			if (!isAssignment(&op)) return;
+			break;
+		case ast::PREFIX_EXPRESSION_NODE:
+			op = std::static_pointer_cast<ast::PrefixExpression>(expression)->m_operator;
+			target = std::static_pointer_cast<ast::PrefixExpression>(expression)->m_rightExpression;
+			if (op != "++" && op != "--") return;
+			break;
+		case ast::POSTFIX_EXPRESSION_NODE:
+			op = std::static_pointer_cast<ast::PostfixExpression>(expression)->m_operator;
+			target = std::static_pointer_cast<ast::PostfixExpression>(expression)->m_leftExpression;
+			break;
+		default:
+			return;
+		}
+		if (target->Type() != ast::IDENTIFIER_NODE) return;
+
+		std::string* name = &std::static_pointer_cast<ast::Identifier>(target)->m_name;
+		Variable* variable = lookup(name);
+		if (variable == NULL)
+		{
+			m_keptNames.insert(*name);
+			return;
+		}
+
+		// Integers can be incremented, or have integers added, subtracted or multiplied, without failing
+		bool isRemovable = false;
+		if (op == "=") isRemovable = isRemovableValue(value, variable->m_type);
+		else if (op == "++" || op == "--") isRemovable = variable->m_type == token::INTEGER_TYPE;
+		else if (op == "+=" || op == "-=" || op == "*=") isRemovable = variable->m_type == token::INTEGER_TYPE && isRemovableValue(value, token::INTEGER_TYPE);
+
+		if (p_isRemovable && isRemovable) m_removableStatements[p_statement] = variable;
+		else m_keptVariables.insert(variable);
+	}
+
+	bool Optimizer::isRemovableValue(std::shared_ptr<ast::Expression> p_value, token::TokenType p_type)
+	{
+		if (p_value == NULL || p_type == token::ILLEGAL) return false;
+		if (p_type == token::STRING_TYPE) return p_value->Type() == ast::STRING_LITERAL_NODE;
+
+		// Outside of a loop, an invariant is any expression that cannot fail
+		Effects nothing;
+		return invariantType(p_value.get(), &nothing) == p_type;
+	}
+
+	void Optimizer::removeDeadStores(std::vector<std::shared_ptr<ast::Statement>>* p_statements, Effects* p_used, bool p_isProgram)
+	{
+		for (int i = 0; i < p_statements->size(); i++)
+		{
+			std::shared_ptr<ast::Statement> statement = (*p_statements)[i];
+			auto it = m_removableStatements.find(statement);
+			bool isLast = p_isProgram && i == p_statements->size() - 1;
+			if (it == m_removableStatements.end() || isLast || m_keptVariables.count(it->second) > 0
+				|| m_keptNames.count(it->second->m_name) > 0 || p_used->m_readNames.count(it->second->m_name) > 0)
+			{
+				removeDeadStores(statement, p_used);
+				continue;
+			}
+
+			std::ostringstream report;
+			switch (statement->Type())
+			{
+			case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+				report << "Line " << std::static_pointer_cast<ast::DeclareVariableStatement>(statement)->m_token.m_location.m_line << ": removed variable '" << it->second->m_name << "' that is never read.";
+				break;
+			case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+				report << "Line " << std::static_pointer_cast<ast::DeclareFunctionStatement>(statement)->m_token.m_location.m_line << ": removed function '" << it->second->m_name << "' that is never called.";
+				break;
+			default:
+				report << "Line " << std::static_pointer_cast<ast::ExpressionStatement>(statement)->m_token.m_location.m_line << ": removed assignment to '" << it->second->m_name << "', which is never read.";
+				break;
+			}
+			m_report.push_back(report.str());
+			p_statements->erase(p_statements->begin() + i);
+			i--;
+		}
+	}
+
+	void Optimizer::removeDeadStores(std::shared_ptr<ast::Statement> p_statement, Effects* p_used)
+	{
+		if (p_statement == NULL) return;
+
+		switch (p_statement->Type())
+		{
+		case ast::BLOCK_STATEMENT_NODE:
+			removeDeadStores(&std::static_pointer_cast<ast::BlockStatement>(p_statement)->m_statements, p_used);
+			break;
+		case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+			removeDeadStores(std::static_pointer_cast<ast::DeclareFunctionStatement>(p_statement)->m_body->m_body, p_used);
+			break;
+		case ast::IF_STATEMENT_NODE:
+			removeDeadStores(std::static_pointer_cast<ast::IfStatement>(p_statement)->m_consequence, p_used);
+			removeDeadStores(std::static_pointer_cast<ast::IfStatement>(p_statement)->m_alternative, p_used);
+			break;
+		case ast::WHILE_STATEMENT_NODE:
+			removeDeadStores(std::static_pointer_cast<ast::WhileStatement>(p_statement)->m_consequence, p_used);
+			break;
+		case ast::DO_WHILE_STATEMENT_NODE:
+			removeDeadStores(std::static_pointer_cast<ast::DoWhileStatement>(p_statement)->m_consequence, p_used);
+			break;
+		case ast::FOR_STATEMENT_NODE:
+			removeDeadStores(std::static_pointer_cast<ast::ForStatement>(p_statement)->m_consequence, p_used);
+			break;
+		case ast::ITERATE_STATEMENT_NODE:
+			removeDeadStores(std::static_pointer_cast<ast::IterateStatement>(p_statement)->m_consequence, p_used);
+			break;
+		default:
+			break;
+		}
+	}
+
+	// COMMON SUBEXPRESSIONS
+
+	bool Optimizer::numberStatement(std::shared_ptr<ast::Statement> p_statement, BasicBlock* p_block)
+	{
+		p_block->m_statement = p_statement;
+		p_block->m_isSafe = true;
+
+		// Bodies of branches and loops are blocks of their own, numbered when their list is optimized
+		switch (p_statement->Type())
+		{
+		case ast::EXPRESSION_STATEMENT_NODE:
+			numberExpression(&std::static_pointer_cast<ast::ExpressionStatement>(p_statement)->m_expression, p_block);
+			return true;
+		case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+		case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+		case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::Expression>* value;
+			std::string* name;
+			if (p_statement->Type() == ast::DECLARE_VARIABLE_STATEMENT_NODE)
+			{
+				value = &std::static_pointer_cast<ast::DeclareVariableStatement>(p_statement)->m_value;
+				name = &std::static_pointer_cast<ast::DeclareVariableStatement>(p_statement)->m_name.m_name;
+			}
+			else if (p_statement->Type() == ast::DECLARE_COLLECTION_STATEMENT_NODE)
+			{
+				value = &std::static_pointer_cast<ast::DeclareCollectionStatement>(p_statement)->m_value;
+				name = &std::static_pointer_cast<ast::DeclareCollectionStatement>(p_statement)->m_name.m_name;
+			}
+			else
+			{
+				value = &std::static_pointer_cast<ast::DeclareDictionaryStatement>(p_statement)->m_value;
+				name = &std::static_pointer_cast<ast::DeclareDictionaryStatement>(p_statement)->m_name.m_name;
+			}
+
+			// The name is already declared here, so a value that reads the variable it hides cannot be looked up.
+			// A name declared twice fails before its value is evaluated.
+			Effects effects;
+			collectEffects(*value, &effects);
+			if (effects.m_readNames.count(*name) == 0)
+			{
+				p_block->m_isSafe = m_scopes.back().m_redeclaredNames.count(*name) == 0;
+				numberExpression(value, p_block);
+			}
+			else if (effects.m_hasCalls) p_block->m_available.clear();
+			else if (effects.m_hasMutations) forget(NULL, p_block);
+			forget(name, p_block);
+
+			// A variable declared with a value of its own type holds it until it is assigned
+			if (p_statement->Type() != ast::DECLARE_VARIABLE_STATEMENT_NODE || *value == NULL) return true;
+			std::shared_ptr<ast::DeclareVariableStatement> declaration = std::static_pointer_cast<ast::DeclareVariableStatement>(p_statement);
+			auto it = p_block->m_available.find((*value)->String());
+			if (it != p_block->m_available.end() && it->second->m_uses.size() == 1 && it->second->m_uses[0] == value && it->second->m_type == declaration->m_token.m_type)
+			{
+				it->second->m_holder = &declaration->m_name;
+				it->second->m_names.insert(*name);
+			}
+			return true;
+		}
+		case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+			forget(&std::static_pointer_cast<ast::DeclareFunctionStatement>(p_statement)->m_name.m_name, p_block);
+			return true;
+		case ast::RETURN_STATEMENT_NODE:
+			numberExpression(&std::static_pointer_cast<ast::ReturnStatement>(p_statement)->m_returnValue, p_block);
+			return false;
+		case ast::IF_STATEMENT_NODE:
+			numberExpression(&std::static_pointer_cast<ast::IfStatement>(p_statement)->m_condition, p_block);
+			return false;
+		default:
+			return false;
+		}
+	}
+
+	void Optimizer::numberExpression(std::shared_ptr<ast::Expression>* p_expression, BasicBlock* p_block)
+	{
+		std::shared_ptr<ast::Expression> expression = *p_expression;
+		if (expression == NULL) return;
+
+		// A value that is still known is read instead, along with everything in it
+		Value* value = NULL;
+		std::string key;
+		if (isValue(expression.get()))
+		{
+			key = expression->String();
+			auto it = p_block->m_available.find(key);
+			if (it != p_block->m_available.end())
+			{
+				it->second->m_uses.push_back(p_expression);
+				return;
+			}
+
+			p_block->m_values.push_back(Value());
+			value = &p_block->m_values.back();
+			value->m_uses.push_back(p_expression);
+			value->m_statement = p_block->m_statement;
+			value->m_holder = NULL;
+			value->m_readsContents = false;
+			value->m_isMovable = p_block->m_isSafe;
+			value->m_type = valueType(expression.get());
+			collectValue(expression.get(), value);
+		}
+
+		// Operands are evaluated in the order the evaluator evaluates them
+		switch (expression->Type())
+		{
+		case ast::COLLECTION_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::CollectionLiteral> collectionLiteral = std::static_pointer_cast<ast::CollectionLiteral>(expression);
+			for (int i = 0; i < collectionLiteral->m_values.size(); i++)
+			{
+				numberExpression(&collectionLiteral->m_values[i], p_block);
+			}
+			break;
+		}
+		case ast::DICTIONARY_LITERAL_NODE:
+		{
+			// Pairs are left alone, and only what they may change is forgotten
+			Effects effects;
+			collectEffects(expression, &effects);
+			if (effects.m_hasCalls) p_block->m_available.clear();
+			else if (effects.m_hasMutations) forget(NULL, p_block);
+			for (auto it = effects.m_assignedNames.begin(); it != effects.m_assignedNames.end(); it++)
+			{
+				std::string name = *it;
+				forget(&name, p_block);
+			}
+			break;
+		}
+		case ast::PREFIX_EXPRESSION_NODE:
+		case ast::POSTFIX_EXPRESSION_NODE:
+		{
+			bool isPrefix = expression->Type() == ast::PREFIX_EXPRESSION_NODE;
+			std::string* op = isPrefix ? &std::static_pointer_cast<ast::PrefixExpression>(expression)->m_operator : &std::static_pointer_cast<ast::PostfixExpression>(expression)->m_operator;
+			std::shared_ptr<ast::Expression>* operand = isPrefix ? &std::static_pointer_cast<ast::PrefixExpression>(expression)->m_rightExpression : &std::static_pointer_cast<ast::PostfixExpression>(expression)->m_leftExpression;
+			if (*op != "++" && *op != "--")
+			{
+				numberExpression(operand, p_block);
+				break;
+			}
+
+			// What is incremented stays a variable or an index
+			if ((*operand)->Type() == ast::IDENTIFIER_NODE)
+			{
+				forget(&std::static_pointer_cast<ast::Identifier>(*operand)->m_name, p_block);
+			}
+			else
+			{
+				if ((*operand)->Type() == ast::INDEX_EXPRESSION_NODE)
+				{
+					numberExpression(&std::static_pointer_cast<ast::IndexExpression>(*operand)->m_collection, p_block);
+					numberExpression(&std::static_pointer_cast<ast::IndexExpression>(*operand)->m_index, p_block);
+				}
+				forget(NULL, p_block);
+			}
+			break;
+		}
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::InfixExpression> infixExpression = std::static_pointer_cast<ast::InfixExpression>(expression);
+			std::shared_ptr<ast::Expression> left = infixExpression->m_leftExpression;
+			if (isAssignment(&infixExpression->m_operator))
+			{
+				// A variable is looked up before the value it is assigned, and an index after its collection and index
+				if (left->Type() == ast::IDENTIFIER_NODE)
+				{
+					if (lookup(&std::static_pointer_cast<ast::Identifier>(left)->m_name) == NULL) p_block->m_isSafe = false;
+					numberExpression(&infixExpression->m_rightExpression, p_block);
+					forget(&std::static_pointer_cast<ast::Identifier>(left)->m_name, p_block);
+				}
+				else
+				{
+					if (left->Type() == ast::INDEX_EXPRESSION_NODE)
+					{
+						numberExpression(&std::static_pointer_cast<ast::IndexExpression>(left)->m_collection, p_block);
+						numberExpression(&std::static_pointer_cast<ast::IndexExpression>(left)->m_index, p_block);
+					}
+					numberExpression(&infixExpression->m_rightExpression, p_block);
+					forget(NULL, p_block);
+				}
+				break;
+			}
+
+			numberExpression(&infixExpression->m_leftExpression, p_block);
+			if (infixExpression->m_operator != ".") numberExpression(&infixExpression->m_rightExpression, p_block);
+			break;
+		}
+		case ast::CALL_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::CallExpression> callExpression = std::static_pointer_cast<ast::CallExpression>(expression);
+			std::shared_ptr<ast::Expression> function = callExpression->m_function;
+			bool isMember = function->Type() == ast::INFIX_EXPRESSION_NODE && std::static_pointer_cast<ast::InfixExpression>(function)->m_operator == ".";
+
+			// A member that is not found fails before the arguments are evaluated
+			std::string name;
+			if (isMember)
+			{
+				std::shared_ptr<ast::InfixExpression> access = std::static_pointer_cast<ast::InfixExpression>(function);
+				numberExpression(&access->m_leftExpression, p_block);
+				p_block->m_isSafe = false;
+				if (access->m_rightExpression->Type() == ast::IDENTIFIER_NODE) name = std::static_pointer_cast<ast::Identifier>(access->m_rightExpression)->m_name;
+			}
+			else if (function->Type() == ast::IDENTIFIER_NODE)
+			{
+				name = std::static_pointer_cast<ast::Identifier>(function)->m_name;
+				if (name != "log" && lookup(&name) == NULL) p_block->m_isSafe = false;
+			}
+			else
+			{
+				numberExpression(&callExpression->m_function, p_block);
+			}
+
+			for (int i = 0; i < callExpression->m_parameters.size(); i++)
+			{
+				numberExpression(&callExpression->m_parameters[i], p_block);
+			}
+
+			// The builtin 'log' only prints, a function may assign anything it can see, and members other than
+			// 'keys' and 'values' change their collection or dictionary
+			if (isMember)
+			{
+				if (name != "keys" && name != "values")
+				{
+					std::shared_ptr<ast::Expression> object = std::static_pointer_cast<ast::InfixExpression>(function)->m_leftExpression;
+					if (object->Type() == ast::IDENTIFIER_NODE) forget(&std::static_pointer_cast<ast::Identifier>(object)->m_name, p_block);
+					forget(NULL, p_block);
+				}
+			}
+			else if (name != "log" || lookup(&name) != NULL) p_block->m_available.clear();
+			break;
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::IndexExpression> indexExpression = std::static_pointer_cast<ast::IndexExpression>(expression);
+			numberExpression(&indexExpression->m_collection, p_block);
+			numberExpression(&indexExpression->m_index, p_block);
+			break;
+		}
+		default:
+			break;
+		}
+
+		if (value != NULL)
+		{
+			value->m_order = p_block->m_order++;
+			p_block->m_available[key] = value;
+		}
+
+		// Outside of a loop, an invariant is any expression that cannot fail
+		Effects nothing;
+		if (invariantType(expression.get(), &nothing) == token::ILLEGAL) p_block->m_isSafe = false;
+	}
+
+	void Optimizer::forget(std::string* p_name, BasicBlock* p_block)
+	{
+		for (auto it = p_block->m_available.begin(); it != p_block->m_available.end();)
+		{
+			bool isChanged = p_name != NULL ? it->second->m_names.count(*p_name) > 0 : it->second->m_readsContents;
+			if (isChanged) it = p_block->m_available.erase(it);
+			else it++;
+		}
+	}
+
+	void Optimizer::reuseValues(std::vector<std::shared_ptr<ast::Statement>>* p_statements, BasicBlock* p_block)
+	{
+		// Values in a value are numbered first, so they are declared first
+		std::vector<Value*> values;
+		for (int i = 0; i < p_block->m_values.size(); i++)
+		{
+			Value* value = &p_block->m_values[i];
+			bool isDeclarable = value->m_type == token::INTEGER_TYPE || value->m_type == token::FLOAT_TYPE || value->m_type == token::BOOLEAN_TYPE
+				|| value->m_type == token::CHARACTER_TYPE || value->m_type == token::STRING_TYPE;
+			if (value->m_uses.size() > 1 && (value->m_holder != NULL || (value->m_isMovable && isDeclarable))) values.push_back(value);
+		}
+		std::sort(values.begin(), values.end(), [](Value* p_left, Value* p_right) { return p_left->m_order < p_right->m_order; });
+
+		Scope* scope = &m_scopes.back();
+		for (int i = 0; i < values.size(); i++)
+		{
+			Value* value = values[i];
+			if (value->m_holder != NULL)
+			{
+				for (int j = 1; j < value->m_uses.size(); j++)
+				{
+					std::shared_ptr<ast::Identifier> identifier = ast::newNode<ast::Identifier>(m_arena);
+					*identifier = *value->m_holder;
+					identifier->m_resolvedType = value->m_type;
+					*value->m_uses[j] = identifier;
+				}
+				continue;
+			}
+
+			std::shared_ptr<ast::Expression> expression = *value->m_uses[0];
+			token::TokenType type = value->m_type;
+			token::Token* token = expression->Type() == ast::PREFIX_EXPRESSION_NODE ? &std::static_pointer_cast<ast::PrefixExpression>(expression)->m_token
+				: expression->Type() == ast::INFIX_EXPRESSION_NODE ? &std::static_pointer_cast<ast::InfixExpression>(expression)->m_token
+				: &std::static_pointer_cast<ast::IndexExpression>(expression)->m_token;
+			m_valueCount++;
+
+			// Like an invariant, the name cannot clash with one of the program. Outside of the global scope it gets a
+			// slot after the ones of the names the resolver found.
+			std::shared_ptr<ast::DeclareVariableStatement> declaration = ast::newNode<ast::DeclareVariableStatement>(m_arena);
+			declaration->m_token = *token;
+			declaration->m_token.m_type = type;
+			declaration->m_token.m_literal = type == token::INTEGER_TYPE ? "integer" : type == token::FLOAT_TYPE ? "float" : type == token::BOOLEAN_TYPE ? "boolean"
+				: type == token::CHARACTER_TYPE ? "character" : "string";
+			declaration->m_name.m_token = *token;
+			declaration->m_name.m_token.m_type = token::IDENTIFIER;
+			declaration->m_name.m_name = "$value" + std::to_string(m_valueCount);
+			declaration->m_name.m_token.m_literal = declaration->m_name.m_name;
+			declaration->m_name.m_symbol = token::internIdentifier(&declaration->m_name.m_name);
+			if (!scope->m_isGlobal)
+			{
+				declaration->m_name.m_depth = 0;
+				declaration->m_name.m_slot = scope->m_slotCount++;
+			}
+			declaration->m_value = expression;
+			declaration->m_isTypeChecked = true;
+
+			auto it = std::find(p_statements->begin(), p_statements->end(), value->m_statement);
+			p_statements->insert(it, declaration);
+
+			for (int j = 0; j < value->m_uses.size(); j++)
+			{
+				std::shared_ptr<ast::Identifier> identifier = ast::newNode<ast::Identifier>(m_arena);
+				*identifier = declaration->m_name;
+				identifier->m_resolvedType = type;
+				*value->m_uses[j] = identifier;
+			}
+		}
+	}
+
+	bool Optimizer::isValue(ast::Expression* p_expression)
+	{
+		switch (p_expression->Type())
+		{
+		case ast::PREFIX_EXPRESSION_NODE:
+		{
+			ast::PrefixExpression* prefixExpression = (ast::PrefixExpression*)p_expression;
+			return (prefixExpression->m_operator == "-" || prefixExpression->m_operator == "!") && isOperand(prefixExpression->m_rightExpression.get());
+		}
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			ast::InfixExpression* infixExpression = (ast::InfixExpression*)p_expression;
+			std::string* op = &infixExpression->m_operator;
+			if (*op == ".")
+			{
+				if (infixExpression->m_rightExpression->Type() != ast::IDENTIFIER_NODE) return false;
+				ast::Identifier* member = (ast::Identifier*)infixExpression->m_rightExpression.get();
+				bool isLength = member->m_member == ast::MEMBER_LENGTH || member->m_name == "length";
+				bool isSize = member->m_member == ast::MEMBER_SIZE || member->m_name == "size";
+				return (isLength || isSize) && isOperand(infixExpression->m_leftExpression.get());
+			}
+
+			bool isOperator = *op == "+" || *op == "-" || *op == "*" || *op == "/" || *op == "%" || *op == "<" || *op == "<=" || *op == ">" || *op == ">="
+				|| *op == "==" || *op == "!=" || *op == "&&" || *op == "||";
+			return isOperator && isOperand(infixExpression->m_leftExpression.get()) && isOperand(infixExpression->m_rightExpression.get());
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			ast::IndexExpression* indexExpression = (ast::IndexExpression*)p_expression;
+			return isOperand(indexExpression->m_collection.get()) && isOperand(indexExpression->m_index.get());
+		}
+		default:
+			return false;
+		}
+	}
+
+	bool Optimizer::isOperand(ast::Expression* p_expression)
+	{
+		// Floats are written rounded, so two different ones could look the same
+		switch (p_expression->Type())
+		{
+		case ast::IDENTIFIER_NODE:
+		case ast::INTEGER_LITERAL_NODE:
+		case ast::BOOLEAN_LITERAL_NODE:
+		case ast::CHARACTER_LITERAL_NODE:
+		case ast::STRING_LITERAL_NODE:
+			return true;
+		default:
+			return isValue(p_expression);
+		}
+	}
+
+	void Optimizer::collectValue(ast::Expression* p_expression, Value* p_value)
+	{
+		switch (p_expression->Type())
+		{
+		case ast::IDENTIFIER_NODE:
+			p_value->m_names.insert(((ast::Identifier*)p_expression)->m_name);
+			break;
+		case ast::PREFIX_EXPRESSION_NODE:
+			collectValue(((ast::PrefixExpression*)p_expression)->m_rightExpression.get(), p_value);
+			break;
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			// Only the length of a string never changes
+			ast::InfixExpression* infixExpression = (ast::InfixExpression*)p_expression;
+			collectValue(infixExpression->m_leftExpression.get(), p_value);
+			if (infixExpression->m_operator != ".") collectValue(infixExpression->m_rightExpression.get(), p_value);
+			else if (infixExpression->m_leftExpression->m_resolvedType != token::STRING_TYPE) p_value->m_readsContents = true;
+			break;
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+			collectValue(((ast::IndexExpression*)p_expression)->m_collection.get(), p_value);
+			collectValue(((ast::IndexExpression*)p_expression)->m_index.get(), p_value);
+			p_value->m_readsContents = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	token::TokenType Optimizer::valueType(ast::Expression* p_expression)
+	{
+		// The checker knows the type of most expressions, but not of those in a body the lazy parser left for later
+		if (p_expression->m_resolvedType != token::ILLEGAL) return p_expression->m_resolvedType;
+
+		switch (p_expression->Type())
+		{
+		case ast::INTEGER_LITERAL_NODE:   return token::INTEGER_TYPE;
+		case ast::BOOLEAN_LITERAL_NODE:   return token::BOOLEAN_TYPE;
+		case ast::CHARACTER_LITERAL_NODE: return token::CHARACTER_TYPE;
+		case ast::STRING_LITERAL_NODE:    return token::STRING_TYPE;
+		case ast::IDENTIFIER_NODE:
+		{
+			Variable* variable = lookup(&((ast::Identifier*)p_expression)->m_name);
+			return variable != NULL ? variable->m_type : token::ILLEGAL;
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			// Elements of collections and dictionaries can be of any type
+			ast::IndexExpression* indexExpression = (ast::IndexExpression*)p_expression;
+			if (valueType(indexExpression->m_collection.get()) == token::STRING_TYPE && valueType(indexExpression->m_index.get()) == token::INTEGER_TYPE) return token::CHARACTER_TYPE;
+			return token::ILLEGAL;
+		}
+		case ast::PREFIX_EXPRESSION_NODE:
+		{
+			ast::PrefixExpression* prefixExpression = (ast::PrefixExpression*)p_expression;
+			token::TokenType right = valueType(prefixExpression->m_rightExpression.get());
+			bool isNumber = right == token::INTEGER_TYPE || right == token::FLOAT_TYPE;
+
+			if (prefixExpression->m_operator == "-" && isNumber) return right;
+			if (prefixExpression->m_operator == "!" && (isNumber || right == token::BOOLEAN_TYPE)) return token::BOOLEAN_TYPE;
+			return token::ILLEGAL;
+		}
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			ast::InfixExpression* infixExpression = (ast::InfixExpression*)p_expression;
+			std::string* op = &infixExpression->m_operator;
+			token::TokenType left = valueType(infixExpression->m_leftExpression.get());
+
+			if (*op == ".")
+			{
+				ast::Identifier* member = (ast::Identifier*)infixExpression->m_rightExpression.get();
+				bool isLength = member->m_member == ast::MEMBER_LENGTH || member->m_name == "length";
+				bool isSize = member->m_member == ast::MEMBER_SIZE || member->m_name == "size";
+				if (left == token::STRING_TYPE && isLength) return token::INTEGER_TYPE;
+				if ((left == token::COLLECTION_TYPE || left == token::DICTIONARY_TYPE) && isSize) return token::INTEGER_TYPE;
+				return token::ILLEGAL;
+			}
+
+			token::TokenType right = valueType(infixExpression->m_rightExpression.get());
+			bool isComparison = *op == "<" || *op == "<=" || *op == ">" || *op == ">=" || *op == "==" || *op == "!=";
+			bool isEquality = *op == "==" || *op == "!=";
+			if ((left == token::INTEGER_TYPE || left == token::FLOAT_TYPE) && (right == token::INTEGER_TYPE || right == token::FLOAT_TYPE))
+			{
+				token::TokenType result = left == token::INTEGER_TYPE && right == token::INTEGER_TYPE ? token::INTEGER_TYPE : token::FLOAT_TYPE;
+				if (*op == "+" || *op == "-" || *op == "*" || *op == "/") return result;
+				if (*op == "%" && result == token::INTEGER_TYPE) return result;
+				if (isComparison) return token::BOOLEAN_TYPE;
+				return token::ILLEGAL;
+			}
+			if (left == token::BOOLEAN_TYPE && right == token::BOOLEAN_TYPE && (*op == "&&" || *op == "||" || isEquality)) return token::BOOLEAN_TYPE;
+			if (left == token::CHARACTER_TYPE && right == token::CHARACTER_TYPE && isEquality) return token::BOOLEAN_TYPE;
+			return token::ILLEGAL;
+		}
+		default:
+			return token::ILLEGAL;
+		}
+	}
+
+	// INLINING
+
+	std::shared_ptr<ast::Expression> Optimizer::inlineCall(std::shared_ptr<ast::CallExpression> p_callExpression)
+	{
+		if (g_inlineBudget <= 0 || p_callExpression->m_function->Type() != ast::IDENTIFIER_NODE) return NULL;
+
+		// A function declared twice, or assigned anywhere, may not be the one declared when it is called
+		std::string* name = &std::static_pointer_cast<ast::Identifier>(p_callExpression->m_function)->m_name;
+		Variable* variable = lookup(name);
+		auto found = m_functions.find(variable);
+		if (variable == NULL || found == m_functions.end() || m_inlining.count(variable) > 0) return NULL;
+		if (m_scopes.front().m_redeclaredNames.count(*name) > 0 || m_effects.m_assignedNames.count(*name) > 0 || isAssignedLazily(name)) return NULL;
+
+		std::shared_ptr<ast::DeclareFunctionStatement> function = found->second;
+		std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* parameters = &function->m_parameters;
+		if (parameters->size() != p_callExpression->m_parameters.size()) return NULL;
+
+		// A body the lazy parser skipped is parsed now, and a syntax error in it is left for the call to report
+		if (function->m_body->m_body == NULL && (m_parseBody == NULL || !m_parseBody(function.get()))) return NULL;
+
+		std::vector<std::shared_ptr<ast::Statement>>* body = &function->m_body->m_body->m_statements;
+		if (body->size() != 1 || (*body)[0]->Type() != ast::RETURN_STATEMENT_NODE) return NULL;
+		std::shared_ptr<ast::Expression> value = std::static_pointer_cast<ast::ReturnStatement>((*body)[0])->m_returnValue;
+
+		int size = 0;
+		if (value == NULL || !isInlinable(value.get(), &size) || size > g_inlineBudget) return NULL;
+
+		// Other names the value reads are globals, which must not be hidden by a local where the call is
+		Effects effects;
+		collectEffects(value, &effects);
+		for (auto it = effects.m_readNames.begin(); it != effects.m_readNames.end(); it++)
+		{
+			bool isParameter = false;
+			for (int i = 0; i < parameters->size(); i++)
+			{
+				if ((*parameters)[i]->m_name.m_name == *it) isParameter = true;
+			}
+			if (isParameter) continue;
+
+			for (int i = 1; i < m_scopes.size(); i++)
+			{
+				if (m_scopes[i].m_names.count(*it) > 0) return NULL;
+			}
+		}
+
+		// Arguments are evaluated before the body and checked against the types of the parameters. Once inlined, each
+		// one is evaluated where its parameter is read, so it must not be able to fail and must be cheap to repeat.
+		for (int i = 0; i < parameters->size(); i++)
+		{
+			std::shared_ptr<ast::Expression> argument = p_callExpression->m_parameters[i];
+			bool isLiteral = argument->Type() == ast::INTEGER_LITERAL_NODE || argument->Type() == ast::FLOAT_LITERAL_NODE || argument->Type() == ast::BOOLEAN_LITERAL_NODE
+				|| argument->Type() == ast::CHARACTER_LITERAL_NODE || argument->Type() == ast::STRING_LITERAL_NODE;
+
+			Effects nothing;
+			if (!isLiteral && invariantType(argument.get(), &nothing) == token::ILLEGAL) return NULL;
+			if (!isLiteral && argument->Type() != ast::IDENTIFIER_NODE && countReads(value.get(), &(*parameters)[i]->m_name.m_name) > 1) return NULL;
+			if (valueType(argument.get()) != (*parameters)[i]->m_token.m_type) return NULL;
+		}
+
+		m_inlining.insert(variable);
+		std::shared_ptr<ast::Expression> inlined = copyExpression(value, parameters, &p_callExpression->m_parameters);
+
+		// The call checks the type of the value returned
+		if (valueType(inlined.get()) != function->m_token.m_type)
+		{
+			m_inlining.erase(variable);
+			return NULL;
+		}
+
+		std::ostringstream report;
+		report << "Line " << p_callExpression->m_token.m_location.m_line << ": inlined the call to '" << *name << "'.";
+		m_report.push_back(report.str());
+
+		inlined = optimizeExpression(inlined);
+		m_inlining.erase(variable);
+		return inlined;
+	}
+
+	bool Optimizer::isInlinable(ast::Expression* p_expression, int* p_size)
+	{
+		(*p_size)++;
+
+		// Calls are left out, since an error from one names the call as it is written
+		switch (p_expression->Type())
+		{
+		case ast::INTEGER_LITERAL_NODE:
+		case ast::FLOAT_LITERAL_NODE:
+		case ast::BOOLEAN_LITERAL_NODE:
+		case ast::CHARACTER_LITERAL_NODE:
+		case ast::STRING_LITERAL_NODE:
+		case ast::IDENTIFIER_NODE:
+			return true;
+		case ast::PREFIX_EXPRESSION_NODE:
+		{
+			ast::PrefixExpression* prefixExpression = (ast::PrefixExpression*)p_expression;
+			return prefixExpression->m_operator != "++" && prefixExpression->m_operator != "--" && isInlinable(prefixExpression->m_rightExpression.get(), p_size);
+		}
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			ast::InfixExpression* infixExpression = (ast::InfixExpression*)p_expression;
+			if (isAssignment(&infixExpression->m_operator) || !isInlinable(infixExpression->m_leftExpression.get(), p_size)) return false;
+			if (infixExpression->m_operator == ".") return infixExpression->m_rightExpression->Type() == ast::IDENTIFIER_NODE;
+			return isInlinable(infixExpression->m_rightExpression.get(), p_size);
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			ast::IndexExpression* indexExpression = (ast::IndexExpression*)p_expression;
+			return isInlinable(indexExpression->m_collection.get(), p_size) && isInlinable(indexExpression->m_index.get(), p_size);
+		}
+		default:
+			return false;
+		}
+	}
+
+	int Optimizer::countReads(ast::Expression* p_expression, std::string* p_name)
+	{
+		// Only what an inlinable value can be made of needs to be handled
+		switch (p_expression->Type())
+		{
+		case ast::IDENTIFIER_NODE:
+			return ((ast::Identifier*)p_expression)->m_name == *p_name ? 1 : 0;
+		case ast::PREFIX_EXPRESSION_NODE:
+			return countReads(((ast::PrefixExpression*)p_expression)->m_rightExpression.get(), p_name);
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			ast::InfixExpression* infixExpression = (ast::InfixExpression*)p_expression;
+			int count = countReads(infixExpression->m_leftExpression.get(), p_name);
+			return infixExpression->m_operator == "." ? count : count + countReads(infixExpression->m_rightExpression.get(), p_name);
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			ast::IndexExpression* indexExpression = (ast::IndexExpression*)p_expression;
+			return countReads(indexExpression->m_collection.get(), p_name) + countReads(indexExpression->m_index.get(), p_name);
+		}
+		default:
+			return 0;
+		}
+	}
+
+	std::shared_ptr<ast::Expression> Optimizer::copyExpression(std::shared_ptr<ast::Expression> p_expression, std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters, std::vector<std::shared_ptr<ast::Expression>>* p_arguments)
+	{
+		// Literals are never changed where they are, so they can be shared
+		switch (p_expression->Type())
+		{
+		case ast::IDENTIFIER_NODE:
+		{
+			std::shared_ptr<ast::Identifier> identifier = std::static_pointer_cast<ast::Identifier>(p_expression);
+			for (int i = 0; p_parameters != NULL && i < p_parameters->size(); i++)
+			{
+				if ((*p_parameters)[i]->m_name.m_name == identifier->m_name) return copyExpression((*p_arguments)[i], NULL, NULL);
+			}
+			std::shared_ptr<ast::Identifier> copy = ast::newNode<ast::Identifier>(m_arena);
+			*copy = *identifier;
+			return copy;
+		}
+		case ast::PREFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::PrefixExpression> copy = ast::newNode<ast::PrefixExpression>(m_arena);
+			*copy = *std::static_pointer_cast<ast::PrefixExpression>(p_expression);
+			copy->m_rightExpression = copyExpression(copy->m_rightExpression, p_parameters, p_arguments);
+			return copy;
+		}
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			// The right side of a member access names the member, even when a parameter has the same name
+			std::shared_ptr<ast::InfixExpression> copy = ast::newNode<ast::InfixExpression>(m_arena);
+			*copy = *std::static_pointer_cast<ast::InfixExpression>(p_expression);
+			copy->m_leftExpression = copyExpression(copy->m_leftExpression, p_parameters, p_arguments);
+			copy->m_rightExpression = copy->m_operator == "." ? copyExpression(copy->m_rightExpression, NULL, NULL) : copyExpression(copy->m_rightExpression, p_parameters, p_arguments);
+			return copy;
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::IndexExpression> copy = ast::newNode<ast::IndexExpression>(m_arena);
+			*copy = *std::static_pointer_cast<ast::IndexExpression>(p_expression);
+			copy->m_collection = copyExpression(copy->m_collection, p_parameters, p_arguments);
+			copy->m_index = copyExpression(copy->m_index, p_parameters, p_arguments);
+			return copy;
+		}
+		default:
+			return p_expression;
+		}
+	}
+
+	bool Optimizer::isAssignedLazily(std::string* p_name)
+	{
+		if (!m_isLazilyScanned)
+		{
+			m_isLazilyScanned = true;
+			for (int i = 0; i < m_skippedFunctions.size(); i++)
+			{
+				// A body parsed since the program's effects were collected has its own
+				ast::FunctionLiteral* function = m_skippedFunctions[i]->m_body.get();
+				if (function->m_body != NULL)
+				{
+					Effects effects;
+					collectEffects(function->m_body, &effects);
+					m_lazilyAssignedNames.insert(effects.m_assignedNames.begin(), effects.m_assignedNames.end());
+					continue;
+				}
+
+				// Tokens are enough to find the names a body assigns, from its opening brace to the one that closes it
+				lexer::Lexer lexer = lexer::Lexer(function->m_source.get(), function->m_token.m_location);
+				token::Token previous;
+				token::Token current;
+				previous.m_type = token::ILLEGAL;
+				lexer.nextToken(&current);
+				int depth = 0;
+				do
+				{
+					if (current.m_type == token::LBRACE) depth++;
+					else if (current.m_type == token::RBRACE) depth--;
+
+					bool isAssignment = current.m_type == token::ASSIGN || current.m_type == token::PLUS_ASSIGN || current.m_type == token::MINUS_ASSIGN
+						|| current.m_type == token::ASTERIK_ASSIGN || current.m_type == token::SLASH_ASSIGN || current.m_type == token::PERCENT_ASSIGN
+						|| current.m_type == token::INCREMENT || current.m_type == token::DECREMENT;
+					if (isAssignment && previous.m_type == token::IDENTIFIER) m_lazilyAssignedNames.insert(previous.m_literal);
+					if ((previous.m_type == token::INCREMENT || previous.m_type == token::DECREMENT) && current.m_type == token::IDENTIFIER) m_lazilyAssignedNames.insert(current.m_literal);
+
+					previous = current;
+					lexer.nextToken(&current);
+				} while (depth > 0 && current.m_type != token::END_OF_FILE);
+			}
+		}
+		return m_lazilyAssignedNames.count(*p_name) > 0;
+	}
+
+	// HELPERS
+
+	void Optimizer::beginScope(bool p_isFunction)
+	{
+		Scope scope;
+		scope.m_isFunction = p_isFunction;
+		scope.m_isGlobal = false;
+		scope.m_slotCount = 0;
+		m_scopes.push_back(scope);
+	}
+
+	void Optimizer::endScope()
+	{
+		m_scopes.pop_back();
+	}
+
+	void Optimizer::collectNames(std::vector<std::shared_ptr<ast::Statement>>* p_statements)
+	{
+		for (int i = 0; i < p_statements->size(); i++)
+		{
+			std::shared_ptr<ast::Statement> statement = (*p_statements)[i];
+			switch (statement->Type())
+			{
+			case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+				addName(&std::static_pointer_cast<ast::DeclareVariableStatement>(statement)->m_name.m_name);
+				break;
+			case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+				addName(&std::static_pointer_cast<ast::DeclareCollectionStatement>(statement)->m_name.m_name);
+				break;
+			case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+				addName(&std::static_pointer_cast<ast::DeclareDictionaryStatement>(statement)->m_name.m_name);
+				break;
+			case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+				addName(&std::static_pointer_cast<ast::DeclareFunctionStatement>(statement)->m_name.m_name);
+				break;
+			case ast::BLOCK_STATEMENT_NODE:
+				collectNames(&std::static_pointer_cast<ast::BlockStatement>(statement)->m_statements);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	void Optimizer::addName(std::string* p_name)
+	{
+		Scope* scope = &m_scopes.back();
+		if (!scope->m_names.insert(*p_name).second)
+		{
+			scope->m_redeclaredNames.insert(*p_name);
+		}
+	}
+
+	void Optimizer::declare(std::string* p_name, std::shared_ptr<ast::Expression> p_value, token::TokenType p_type)
+	{
+		Scope* scope = &m_scopes.back();
+
+		// A name declared twice in the same environment fails when it runs
+		bool isRedeclared = scope->m_redeclaredNames.count(*p_name) > 0;
+
+		Variable variable;
+		variable.m_value = isRedeclared ? NULL : p_value;
+		variable.m_type = isRedeclared ? token::ILLEGAL : p_type;
+		variable.m_name = *p_name;
+		variable.m_isGlobal = scope->m_isGlobal;
+		m_variables.push_back(variable);
+		scope->m_declared[*p_name] = &m_variables.back();
+	}
+
+	void Optimizer::countSlot(ast::Identifier* p_name)
+	{
+		Scope* scope = &m_scopes.back();
+		if (p_name->m_slot >= scope->m_slotCount) scope->m_slotCount = p_name->m_slot + 1;
+	}
+
+	Optimizer::Variable* Optimizer::lookup(std::string* p_name)
+	{
+		// Within a function only names declared so far are visible, like in the evaluator. From inside a nested
+		// function, a name of the enclosing scopes is only known if it was declared before the nested function,
+		// since the call may come after a declaration further on.
+		bool isNested = false;
+		for (int i = m_scopes.size() - 1; i >= 0; i--)
+		{
+			Scope* scope = &m_scopes[i];
+			auto it = scope->m_declared.find(*p_name);
+			if (it != scope->m_declared.end())
+			{
+				return it->second;
+			}
+			if (isNested && scope->m_names.count(*p_name) > 0)
+			{
+				return NULL;
+			}
+
+			if (scope->m_isFunction)
+			{
+				isNested = true;
+			}
+		}
+		return NULL;
+	}
+
+	bool Optimizer::isAssignment(std::string* p_operator)
+	{
+		return *p_operator == "=" || *p_operator == "+=" || *p_operator == "-=" || *p_operator == "*=" || *p_operator == "/=" || *p_operator == "%=";
+	}
+
+	std::shared_ptr<ast::Expression> Optimizer::newInteger(token::Token* p_token, long long p_value)
+	{
+		if (p_value < INT_MIN || p_value > INT_MAX) return NULL;
+
+		std::shared_ptr<ast::IntegerLiteral> literal = ast::newNode<ast::IntegerLiteral>(m_arena);
+		literal->m_token = *p_token;
+		literal->m_token.m_type = token::INTEGER_LITERAL;
+		literal->m_token.m_literal = std::to_string(p_value);
+		literal->m_value = (int)p_value;
+		literal->m_resolvedType = token::INTEGER_TYPE;
+		return literal;
+	}
+
+	std::shared_ptr<ast::Expression> Optimizer::newFloat(token::Token* p_token, float p_value)
+	{
+		std::shared_ptr<ast::FloatLiteral> literal = ast::newNode<ast::FloatLiteral>(m_arena);
+		literal->m_token = *p_token;
+		literal->m_token.m_type = token::FLOAT_LITERAL;
+		literal->m_value = p_value;
+		literal->m_resolvedType = token::FLOAT_TYPE;
+		literal->m_token.m_literal = literal->TokenLiteral();
+		return literal;
+	}
+
+	std::shared_ptr<ast::Expression> Optimizer::newBoolean(token::Token* p_token, bool p_value)
+	{
+		std::shared_ptr<ast::BooleanLiteral> literal = ast::newNode<ast::BooleanLiteral>(m_arena);
+		literal->m_token = *p_token;
+		literal->m_token.m_type = p_value ? token::TRUE_LITERAL : token::FALSE_LITERAL;
+		literal->m_token.m_literal = p_value ? "true" : "false";
+		literal->m_value = p_value;
+		literal->m_resolvedType = token::BOOLEAN_TYPE;
+		return literal;
+	}
+}
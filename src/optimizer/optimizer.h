@@ -0,0 +1,233 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <set>
+
+#include "ast.h"
+
+namespace optimizer
+{
+	// Most expression nodes the returned value of a function can have for its calls to be replaced by it. 0 turns inlining off.
+	extern int g_inlineBudget;
+
+	// Rewrites a resolved program so that it does less work each time it runs. Operators applied to literals are
+	// folded into a literal, and variables that are never assigned after their declaration are replaced by their value.
+	// An expression that would fail is left as it is, so that it fails with the same error when it runs.
+	// Expressions of a loop that cannot fail and give the same value on every iteration are computed once before it,
+	// and 'for' loops that count an integer to a fixed bound are marked for the evaluator to count natively.
+	// Statements that can never run are removed, along with variables that are never read.
+	// An expression repeated in statements that run one after another is computed once, if nothing between changes it.
+	// A call to a small function that only returns a value is replaced by that value, when its arguments are known to
+	// have the types of its parameters.
+	class Optimizer
+	{
+	public:
+		Optimizer();
+
+		std::vector<std::string> m_report;                 // Each statement that was removed, and why
+
+		// Parses the body of a function that the lazy parser skipped, so that its calls can be inlined. Returns whether it could.
+		std::function<bool(ast::DeclareFunctionStatement*)> m_parseBody;
+
+		void OptimizeProgram(std::shared_ptr<ast::Program> p_program);
+
+		// Optimizes the body of a function declared at the top level of a program, once a lazy parser has parsed it
+		void OptimizeFunctionBody(std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters, std::shared_ptr<ast::BlockStatement> p_body);
+	private:
+		// A name declared in a scope
+		typedef struct Variable
+		{
+			std::shared_ptr<ast::Expression> m_value;  // Literal the variable holds for as long as it exists, or NULL
+			token::TokenType m_type;                   // Type of every value it can hold, or ILLEGAL if not known
+			std::string m_name;
+			bool m_isGlobal;
+		} Variable;
+
+		// What running part of a program may do
+		typedef struct Effects
+		{
+			std::set<std::string> m_assignedNames;     // Names assigned or incremented
+			std::set<std::string> m_declaredNames;     // Names declared, including parameters and iterated variables
+			std::set<std::string> m_readNames;         // Names read, other than by a statement that only assigns them
+			bool m_hasCalls = false;                   // Calls a function, which may assign what it can see
+			bool m_hasMutations = false;               // Appends, pops, inserts or assigns an index
+			bool m_hasSkippedBodies = false;           // Declares a function whose body a lazy parser left for later
+		} Effects;
+
+		// Mirrors one object::Environment created by the evaluator
+		typedef struct Scope
+		{
+			std::map<std::string, Variable*> m_declared;   // Names whose declaration has been optimized so far
+			std::set<std::string> m_names;                 // Every name declared directly in the scope
+			std::set<std::string> m_redeclaredNames;       // Names declared more than once, which fails when it runs
+			bool m_isFunction;                             // Outermost scope of a function body
+			bool m_isGlobal;
+			int m_slotCount;                               // Slots the resolver gave the names declared so far
+		} Scope;
+
+		// An expression that reads variables and computes a value from them without doing anything else
+		typedef struct Value
+		{
+			std::vector<std::shared_ptr<ast::Expression>*> m_uses;   // Where it is written, starting with its first use
+			std::shared_ptr<ast::Statement> m_statement;             // Statement of its first use
+			std::set<std::string> m_names;                           // Variables it reads, and the one that holds it
+			ast::Identifier* m_holder;                               // Variable declared with it as its whole value, or NULL
+			bool m_readsContents;                                    // Reads an element or the size of a collection or dictionary
+			bool m_isMovable;                                        // Nothing before its first use in its statement can fail or do anything else
+			int m_order;                                             // Position among the values of its block, after the values in it
+			token::TokenType m_type;
+		} Value;
+
+		// Statements that run one after another, with no loop or branch between them
+		typedef struct BasicBlock
+		{
+			std::deque<Value> m_values;
+			std::map<std::string, Value*> m_available;    // Values that are still known, by how they are written
+			std::shared_ptr<ast::Statement> m_statement;  // Statement being numbered
+			bool m_isSafe;                                // Nothing the statement evaluated so far can fail or do anything else
+			int m_order;
+		} BasicBlock;
+
+		std::shared_ptr<ast::Arena> m_arena;               // Arena of the literals made by folding
+		std::vector<Scope> m_scopes;
+		std::deque<Variable> m_variables;
+		Effects m_effects;                                 // Effects of everything that is optimized
+		int m_invariantCount;                              // Number of loop invariants computed before their loop
+		int m_valueCount;                                  // Number of repeated values computed once
+
+		// Declarations and assignments that can go if the variable they declare or assign is never read
+		std::map<std::shared_ptr<ast::Statement>, Variable*> m_removableStatements;
+		std::set<Variable*> m_keptVariables;               // Variables assigned by a statement that cannot be removed
+		std::set<std::string> m_keptNames;                 // Names assigned where the variable they name cannot be known
+
+		std::map<Variable*, std::shared_ptr<ast::DeclareFunctionStatement>> m_functions;   // Functions declared at the top level
+		std::set<Variable*> m_inlining;                    // Functions whose calls are being replaced, which are not replaced again inside
+		std::vector<std::shared_ptr<ast::DeclareFunctionStatement>> m_skippedFunctions;    // Functions whose bodies the lazy parser skipped
+		std::set<std::string> m_lazilyAssignedNames;       // Names assigned in those bodies, once they have been scanned
+		bool m_isLazilyScanned;
+
+		// EFFECTS
+
+		static void collectEffects(std::shared_ptr<ast::Statement> p_statement, Effects* p_effects);
+		static void collectEffects(std::shared_ptr<ast::Expression> p_expression, Effects* p_effects);
+
+		// STATEMENTS
+
+		// Optimizes a list of statements, adding the invariants of its loops before them
+		void optimizeStatements(std::vector<std::shared_ptr<ast::Statement>>* p_statements);
+		void optimizeStatement(std::shared_ptr<ast::Statement> p_statement);
+		void optimizeBlock(std::shared_ptr<ast::BlockStatement> p_block);
+		void optimizeDeclareVariable(std::shared_ptr<ast::DeclareVariableStatement> p_declareVariable);
+		void optimizeDeclareFunction(std::shared_ptr<ast::DeclareFunctionStatement> p_declareFunction);
+		void optimizeFunctionBody(std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters, std::shared_ptr<ast::BlockStatement> p_body);
+		void optimizeIfStatement(std::shared_ptr<ast::IfStatement> p_ifStatement);
+		void optimizeForStatement(std::shared_ptr<ast::ForStatement> p_forStatement);
+		void optimizeIterateStatement(std::shared_ptr<ast::IterateStatement> p_iterateStatement);
+
+		// EXPRESSIONS
+
+		// Optimizes an expression and returns what replaces it, which is the expression itself if nothing does
+		std::shared_ptr<ast::Expression> optimizeExpression(std::shared_ptr<ast::Expression> p_expression);
+		std::shared_ptr<ast::Expression> optimizeIdentifier(std::shared_ptr<ast::Identifier> p_identifier);
+		std::shared_ptr<ast::Expression> foldPrefixExpression(std::shared_ptr<ast::PrefixExpression> p_prefixExpression);
+		std::shared_ptr<ast::Expression> foldInfixExpression(std::shared_ptr<ast::InfixExpression> p_infixExpression);
+		std::shared_ptr<ast::Expression> foldMemberAccess(std::shared_ptr<ast::InfixExpression> p_infixExpression);
+
+		// LOOPS
+
+		// Replaces the invariants of a loop that has been optimized by variables, declared by p_hoisted before it
+		void hoistInvariants(std::shared_ptr<ast::Statement> p_loop, std::vector<std::shared_ptr<ast::Statement>>* p_hoisted);
+		// p_depth is the number of environments the evaluator creates between the statement and the loop itself
+		void hoistStatement(std::shared_ptr<ast::Statement> p_statement, Effects* p_loop, int p_depth, std::vector<std::shared_ptr<ast::Statement>>* p_hoisted);
+		std::shared_ptr<ast::Expression> hoistExpression(std::shared_ptr<ast::Expression> p_expression, Effects* p_loop, int p_depth, std::vector<std::shared_ptr<ast::Statement>>* p_hoisted);
+
+		// Points the resolved identifiers of an invariant at the same variables from p_depth environments further out
+		static void moveOut(ast::Expression* p_expression, int p_depth);
+
+		// Type of an expression that cannot fail and has the same value on every iteration of a loop, or ILLEGAL
+		token::TokenType invariantType(ast::Expression* p_expression, Effects* p_loop);
+
+		void markCountedLoop(std::shared_ptr<ast::ForStatement> p_forStatement, Effects* p_loop);
+
+		// DEAD CODE
+
+		// Removes the branches of an 'if' or 'while' whose condition is a literal that never runs them, and returns
+		// whether nothing of the statement is left to run
+		bool pruneBranches(std::shared_ptr<ast::Statement> p_statement);
+
+		// Records an assignment that makes up a whole statement, which can be removed if p_isRemovable and its value cannot fail
+		void recordAssignment(std::shared_ptr<ast::Statement> p_statement, bool p_isRemovable);
+
+		// Whether a value cannot fail, does nothing else and has the declared type
+		bool isRemovableValue(std::shared_ptr<ast::Expression> p_value, token::TokenType p_type);
+
+		// Removes the recorded declarations and assignments of variables that no statement in p_used reads. The last
+		// statement of a program gives its result, and is kept if p_isProgram.
+		void removeDeadStores(std::vector<std::shared_ptr<ast::Statement>>* p_statements, Effects* p_used, bool p_isProgram = false);
+		void removeDeadStores(std::shared_ptr<ast::Statement> p_statement, Effects* p_used);
+
+		// COMMON SUBEXPRESSIONS
+
+		// Numbers the values a statement computes, and returns whether the block goes on after it
+		bool numberStatement(std::shared_ptr<ast::Statement> p_statement, BasicBlock* p_block);
+		void numberExpression(std::shared_ptr<ast::Expression>* p_expression, BasicBlock* p_block);
+
+		// Forgets the values that read a name, or the contents of collections and dictionaries if p_name is NULL
+		static void forget(std::string* p_name, BasicBlock* p_block);
+
+		// Declares each value used more than once just before the statement of its first use, and reads it from there
+		void reuseValues(std::vector<std::shared_ptr<ast::Statement>>* p_statements, BasicBlock* p_block);
+
+		// Whether an expression is worth numbering: an operator, index or member access applied to variables,
+		// literals and other values
+		static bool isValue(ast::Expression* p_expression);
+		static bool isOperand(ast::Expression* p_expression);
+		static void collectValue(ast::Expression* p_expression, Value* p_value);
+
+		// Type of a value, or ILLEGAL if it cannot be known before it runs
+		token::TokenType valueType(ast::Expression* p_expression);
+
+		// INLINING
+
+		// Returns the optimized value that replaces a call, or NULL if it cannot be replaced
+		std::shared_ptr<ast::Expression> inlineCall(std::shared_ptr<ast::CallExpression> p_callExpression);
+
+		// Whether an expression is made only of what a returned value can be inlined with, counting its nodes in p_size
+		static bool isInlinable(ast::Expression* p_expression, int* p_size);
+		static int countReads(ast::Expression* p_expression, std::string* p_name);
+
+		// Copies an expression, with each parameter replaced by a copy of its argument
+		std::shared_ptr<ast::Expression> copyExpression(std::shared_ptr<ast::Expression> p_expression, std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters, std::vector<std::shared_ptr<ast::Expression>>* p_arguments);
+
+		// Whether a name can be assigned by a body the lazy parser skipped, which are scanned for their assignments the first time
+		bool isAssignedLazily(std::string* p_name);
+
+		// HELPERS
+
+		void beginScope(bool p_isFunction = false);
+		void endScope();
+
+		// Records every name declared directly in these statements in the innermost scope
+		void collectNames(std::vector<std::shared_ptr<ast::Statement>>* p_statements);
+		void addName(std::string* p_name);
+
+		// Records the slot of a declared name in the innermost scope
+		void countSlot(ast::Identifier* p_name);
+
+		// Declares a name in the innermost scope, with the literal it always holds or NULL
+		void declare(std::string* p_name, std::shared_ptr<ast::Expression> p_value, token::TokenType p_type = token::ILLEGAL);
+
+		// Finds the variable an identifier names where it is evaluated, or NULL if it cannot be known
+		Variable* lookup(std::string* p_name);
+
+		// Whether an infix operator assigns to its left side
+		static bool isAssignment(std::string* p_operator);
+
+		// Makes the literal a folded expression is replaced by. newInteger returns NULL for a value that does not fit.
+		std::shared_ptr<ast::Expression> newInteger(token::Token* p_token, long long p_value);
+		std::shared_ptr<ast::Expression> newFloat(token::Token* p_token, float p_value);
+		std::shared_ptr<ast::Expression> newBoolean(token::Token* p_token, bool p_value);
+	};
+}
@@ -1,81 +1,251 @@
+#include <atomic>
+#include <climits>
 #include <sstream>
+#include <thread>
 
 #include "parser.h"
 
 
 namespace parser
 {
-	Parser::Parser(lexer::Lexer p_lexer)
+	Parser::Parser(lexer::Lexer p_lexer, bool p_isPipelined)
 		: m_lexer(p_lexer)
+		, m_parseRules(parseRules())
 	{
+		if (p_isPipelined) m_lexerThread = std::make_shared<lexer::LexerThread>(p_lexer);
+
 		nextToken();
 		nextToken();
+	}
+
+	const Parser::ParseRule* Parser::parseRules()
+	{
+		static const std::vector<ParseRule> rules = buildParseRules();
+		return rules.data();
+	}
 
-		registerPrefixFunction(token::IDENTIFIER, &Parser::parseIdentifier);
-		registerPrefixFunction(token::INTEGER_LITERAL, &Parser::parseIntegerLiteral);
-		registerPrefixFunction(token::FLOAT_LITERAL, &Parser::parseFloatLiteral);
-		registerPrefixFunction(token::TRUE_LITERAL, &Parser::parseBooleanLiteral);
-		registerPrefixFunction(token::FALSE_LITERAL, &Parser::parseBooleanLiteral);
-		registerPrefixFunction(token::CHARACTER_LITERAL, &Parser::parseCharacterLiteral);
-		registerPrefixFunction(token::STRING_LITERAL, &Parser::parseStringLiteral);
-		registerPrefixFunction(token::LBRACKET, &Parser::parseCollectionLiteral);
-		registerPrefixFunction(token::LBRACE, &Parser::parseDictionaryLiteral);
-		registerPrefixFunction(token::BANG, &Parser::parsePrefixExpression);
-		registerPrefixFunction(token::MINUS, &Parser::parsePrefixExpression);
-		registerPrefixFunction(token::LPARENTHESIS, &Parser::parseGroupedExpression);
-		registerPrefixFunction(token::INCREMENT, &Parser::parsePrefixExpression);
-		registerPrefixFunction(token::DECREMENT, &Parser::parsePrefixExpression);
-
-		registerPostfixFunction(token::INCREMENT, &Parser::parsePostfixExpression);
-		registerPostfixFunction(token::DECREMENT, &Parser::parsePostfixExpression);
-
-		registerInfixFunction(token::PLUS, &Parser::parseInfixExpression);
-		registerInfixFunction(token::MINUS, &Parser::parseInfixExpression);
-		registerInfixFunction(token::ASTERIK, &Parser::parseInfixExpression);
-		registerInfixFunction(token::SLASH, &Parser::parseInfixExpression);
-		registerInfixFunction(token::PERCENT, &Parser::parseInfixExpression);
-		registerInfixFunction(token::RCHEVRON, &Parser::parseInfixExpression);
-		registerInfixFunction(token::GEQ, &Parser::parseInfixExpression);
-		registerInfixFunction(token::LCHEVRON, &Parser::parseInfixExpression);
-		registerInfixFunction(token::LEQ, &Parser::parseInfixExpression);
-		registerInfixFunction(token::EQ, &Parser::parseInfixExpression);
-		registerInfixFunction(token::NEQ, &Parser::parseInfixExpression);
-		registerInfixFunction(token::AND, &Parser::parseInfixExpression);
-		registerInfixFunction(token::OR, &Parser::parseInfixExpression);
-		registerInfixFunction(token::ASSIGN, &Parser::parseInfixExpression);
-		registerInfixFunction(token::PLUS_ASSIGN, &Parser::parseInfixExpression);
-		registerInfixFunction(token::MINUS_ASSIGN, &Parser::parseInfixExpression);
-		registerInfixFunction(token::ASTERIK_ASSIGN, &Parser::parseInfixExpression);
-		registerInfixFunction(token::SLASH_ASSIGN, &Parser::parseInfixExpression);
-		registerInfixFunction(token::PERCENT_ASSIGN, &Parser::parseInfixExpression);
-		registerInfixFunction(token::LPARENTHESIS, &Parser::parseCallExpression);
-		registerInfixFunction(token::LBRACKET, &Parser::parseIndexExpression);
-		registerInfixFunction(token::DOT, &Parser::parseInfixExpression);
+	std::vector<Parser::ParseRule> Parser::buildParseRules()
+	{
+		ParseRule none = { NULL, NULL, NULL, LOWEST };
+		std::vector<ParseRule> rules(token::TOKEN_TYPE_COUNT, none);
+
+		rules[token::IDENTIFIER].m_prefix = &Parser::parseIdentifier;
+		rules[token::INTEGER_LITERAL].m_prefix = &Parser::parseIntegerLiteral;
+		rules[token::FLOAT_LITERAL].m_prefix = &Parser::parseFloatLiteral;
+		rules[token::TRUE_LITERAL].m_prefix = &Parser::parseBooleanLiteral;
+		rules[token::FALSE_LITERAL].m_prefix = &Parser::parseBooleanLiteral;
+		rules[token::CHARACTER_LITERAL].m_prefix = &Parser::parseCharacterLiteral;
+		rules[token::STRING_LITERAL].m_prefix = &Parser::parseStringLiteral;
+		rules[token::LBRACKET].m_prefix = &Parser::parseCollectionLiteral;
+		rules[token::LBRACE].m_prefix = &Parser::parseDictionaryLiteral;
+		rules[token::BANG].m_prefix = &Parser::parsePrefixExpression;
+		rules[token::MINUS].m_prefix = &Parser::parsePrefixExpression;
+		rules[token::LPARENTHESIS].m_prefix = &Parser::parseGroupedExpression;
+		rules[token::INCREMENT].m_prefix = &Parser::parsePrefixExpression;
+		rules[token::DECREMENT].m_prefix = &Parser::parsePrefixExpression;
+
+		rules[token::INCREMENT].m_postfix = &Parser::parsePostfixExpression;
+		rules[token::DECREMENT].m_postfix = &Parser::parsePostfixExpression;
+
+		rules[token::PLUS].m_infix = &Parser::parseInfixExpression;
+		rules[token::MINUS].m_infix = &Parser::parseInfixExpression;
+		rules[token::ASTERIK].m_infix = &Parser::parseInfixExpression;
+		rules[token::SLASH].m_infix = &Parser::parseInfixExpression;
+		rules[token::PERCENT].m_infix = &Parser::parseInfixExpression;
+		rules[token::RCHEVRON].m_infix = &Parser::parseInfixExpression;
+		rules[token::GEQ].m_infix = &Parser::parseInfixExpression;
+		rules[token::LCHEVRON].m_infix = &Parser::parseInfixExpression;
+		rules[token::LEQ].m_infix = &Parser::parseInfixExpression;
+		rules[token::EQ].m_infix = &Parser::parseInfixExpression;
+		rules[token::NEQ].m_infix = &Parser::parseInfixExpression;
+		rules[token::AND].m_infix = &Parser::parseInfixExpression;
+		rules[token::OR].m_infix = &Parser::parseInfixExpression;
+		rules[token::ASSIGN].m_infix = &Parser::parseInfixExpression;
+		rules[token::PLUS_ASSIGN].m_infix = &Parser::parseInfixExpression;
+		rules[token::MINUS_ASSIGN].m_infix = &Parser::parseInfixExpression;
+		rules[token::ASTERIK_ASSIGN].m_infix = &Parser::parseInfixExpression;
+		rules[token::SLASH_ASSIGN].m_infix = &Parser::parseInfixExpression;
+		rules[token::PERCENT_ASSIGN].m_infix = &Parser::parseInfixExpression;
+		rules[token::LPARENTHESIS].m_infix = &Parser::parseCallExpression;
+		rules[token::LBRACKET].m_infix = &Parser::parseIndexExpression;
+		rules[token::DOT].m_infix = &Parser::parseInfixExpression;
+
+		rules[token::ASSIGN].m_precedence = ASSIGNMENT;
+		rules[token::PLUS_ASSIGN].m_precedence = ASSIGNMENT;
+		rules[token::MINUS_ASSIGN].m_precedence = ASSIGNMENT;
+		rules[token::ASTERIK_ASSIGN].m_precedence = ASSIGNMENT;
+		rules[token::SLASH_ASSIGN].m_precedence = ASSIGNMENT;
+		rules[token::PERCENT_ASSIGN].m_precedence = ASSIGNMENT;
+		rules[token::OR].m_precedence = LOGICAL_OR;
+		rules[token::AND].m_precedence = LOGICAL_AND;
+		rules[token::EQ].m_precedence = EQUALS;
+		rules[token::NEQ].m_precedence = EQUALS;
+		rules[token::LEQ].m_precedence = LESSGREATER;
+		rules[token::LCHEVRON].m_precedence = LESSGREATER;
+		rules[token::GEQ].m_precedence = LESSGREATER;
+		rules[token::RCHEVRON].m_precedence = LESSGREATER;
+		rules[token::PLUS].m_precedence = SUM;
+		rules[token::MINUS].m_precedence = SUM;
+		rules[token::ASTERIK].m_precedence = PRODUCT;
+		rules[token::SLASH].m_precedence = PRODUCT;
+		rules[token::PERCENT].m_precedence = PRODUCT;
+		rules[token::LPARENTHESIS].m_precedence = CALL;
+		rules[token::INCREMENT].m_precedence = CALL;
+		rules[token::DECREMENT].m_precedence = CALL;
+		rules[token::LBRACKET].m_precedence = INDEX;
+		rules[token::DOT].m_precedence = MEMBER_ACCESS;
+
+		return rules;
 	}
 
 	std::shared_ptr<ast::Program> Parser::ParseProgram()
 	{
-		std::shared_ptr<ast::Program> program(new ast::Program);
-		
-		while (m_currentToken.m_type != token::END_OF_FILE)
+		m_arena = std::make_shared<ast::Arena>();
+		std::shared_ptr<ast::Program> program;
+
+		if (m_threadCount > 1)
+		{
+			program = parseChunks();
+			if (program != NULL) return program;
+		}
+
+		program = newNode<ast::Program>();
+		parseStatements(program.get(), INT_MAX);
+
+		return program;
+	}
+
+	void Parser::parseStatements(ast::Program* p_program, int p_end)
+	{
+		while (m_currentToken.m_type != token::END_OF_FILE && m_currentToken.m_location.m_offset < p_end)
 		{
 			std::shared_ptr<ast::Statement> statement = parseStatement();
 
 			if (statement != NULL)
 			{
-				program->m_statements.push_back(statement);
+				p_program->m_statements.push_back(statement);
 			}
 
 			nextToken();
 		}
+	}
+
+	std::shared_ptr<ast::Program> Parser::parseChunks()
+	{
+		// A few chunks per thread, so that a thread that finishes early takes another
+		int chunkSize = (m_lexer.Length() - m_currentToken.m_location.m_offset) / (m_threadCount * 4);
+		if (chunkSize < c_minimumChunkSize) chunkSize = c_minimumChunkSize;
+
+		std::vector<token::Location> starts = findChunks(chunkSize);
+		if (starts.size() < 2) return NULL;
+
+		// Skipped bodies of every chunk share one copy of the source
+		if (m_isLazy && m_source == NULL) m_source = std::make_shared<std::string>(m_lexer.Input(), m_lexer.Length());
+
+		std::vector<std::shared_ptr<ast::Program>> chunks(starts.size());
+		std::atomic<bool> hasErrors(false);
+		std::atomic<size_t> nextChunk(0);
+
+		auto parseChunk = [&]()
+		{
+			for (size_t i = nextChunk++; i < starts.size() && !hasErrors; i = nextChunk++)
+			{
+				Parser parser(lexer::Lexer(m_lexer.Input(), m_lexer.Length(), starts[i]));
+				parser.m_isLazy = m_isLazy;
+				parser.m_source = m_source;
+				parser.m_arena = std::make_shared<ast::Arena>();
+
+				chunks[i] = parser.newNode<ast::Program>();
+				parser.parseStatements(chunks[i].get(), i + 1 < starts.size() ? starts[i + 1].m_offset : INT_MAX);
+				if (!parser.m_errors.empty()) hasErrors = true;
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (size_t i = 1; i < (size_t)m_threadCount && i < starts.size(); i++)
+		{
+			threads.push_back(std::thread(parseChunk));
+		}
+		parseChunk();
+		for (size_t i = 0; i < threads.size(); i++)
+		{
+			threads[i].join();
+		}
+
+		// Recovering from an error can run past the end of a chunk, so a program with errors is parsed in order to
+		// report them as they always are
+		if (hasErrors) return NULL;
+
+		std::shared_ptr<ast::Program> program = newNode<ast::Program>();
+		for (size_t i = 0; i < chunks.size(); i++)
+		{
+			program->m_statements.insert(program->m_statements.end(), chunks[i]->m_statements.begin(), chunks[i]->m_statements.end());
+		}
 
 		return program;
 	}
 
+	std::vector<token::Location> Parser::findChunks(int p_chunkSize)
+	{
+		std::vector<token::Location> starts;
+		starts.push_back(m_currentToken.m_location);
+
+		lexer::Lexer lexer(m_lexer.Input(), m_lexer.Length(), m_currentToken.m_location);
+		token::Token token;
+		token::TokenType previous = token::ILLEGAL;
+		int depth = 0;
+
+		for (lexer.nextToken(&token); token.m_type != token::END_OF_FILE; lexer.nextToken(&token))
+		{
+			// A statement at the top level starts after a semicolon or a closing brace, unless the brace closes a
+			// dictionary used in an expression or is followed by the else of an if or the while of a do
+			bool isStart = depth == 0 && token.m_location.m_offset - starts.back().m_offset >= p_chunkSize
+				&& (previous == token::SEMICOLON || (previous == token::RBRACE && (token.m_type == token::IDENTIFIER
+				|| (token.m_type >= token::INTEGER_TYPE && token.m_type <= token::STRING_TYPE)
+				|| token.m_type == token::IF || token.m_type == token::FOR || token.m_type == token::ITERATE
+				|| token.m_type == token::RETURN)));
+			if (isStart) starts.push_back(token.m_location);
+
+			switch (token.m_type)
+			{
+			case token::LPARENTHESIS:
+			case token::LBRACKET:
+			case token::LBRACE:
+				depth++;
+				break;
+			case token::RPARENTHESIS:
+			case token::RBRACKET:
+			case token::RBRACE:
+				depth--;
+				break;
+			default:
+				break;
+			}
+			previous = token.m_type;
+		}
+
+		return starts;
+	}
+
+	std::shared_ptr<ast::BlockStatement> Parser::ParseFunctionBody()
+	{
+		m_arena = std::make_shared<ast::Arena>();
+		std::shared_ptr<ast::BlockStatement> body = parseBlockStatement();
+
+		if (!expectCurrent(token::RBRACE))
+		{
+			return NULL;
+		}
+
+		return body;
+	}
+
 	void Parser::nextToken()
 	{
-		m_currentToken = m_peekToken;
-		m_peekToken = m_lexer.nextToken();
+		// The old current token is reused for the next one, so its literal keeps its storage
+		std::swap(m_currentToken, m_peekToken);
+		if (m_lexerThread != NULL) m_lexerThread->nextToken(&m_peekToken);
+		else m_lexer.nextToken(&m_peekToken);
 	}
 
 	bool Parser::expectCurrent(token::TokenType p_tokenType)
@@ -113,24 +283,12 @@ namespace parser
 
 	Parser::Precedence Parser::peekPrecedence()
 	{
-		// Check if precedence table has token, and if it does, return precedence of it.
-		if (c_precedenceOfTokenType.count(m_peekToken.m_type) >= 1)
-		{
-			return c_precedenceOfTokenType.at(m_peekToken.m_type);
-		}
-
-		return LOWEST;
+		return m_parseRules[m_peekToken.m_type].m_precedence;
 	}
 
 	Parser::Precedence Parser::currentPrecedence()
 	{
-		// Check if precedence table has token, and if it does, return precedence of it.
-		if (c_precedenceOfTokenType.count(m_currentToken.m_type) >= 1)
-		{
-			return c_precedenceOfTokenType.at(m_currentToken.m_type);
-		}
-
-		return LOWEST;
+		return m_parseRules[m_currentToken.m_type].m_precedence;
 	}
 
 	void Parser::expectedPeekError(token::TokenType p_expectedToken)
@@ -237,7 +395,7 @@ namespace parser
 
 	std::shared_ptr<ast::DeclareVariableStatement> Parser::parseVariableDeclaration()
 	{
-		std::shared_ptr<ast::DeclareVariableStatement> statement(new ast::DeclareVariableStatement);
+		std::shared_ptr<ast::DeclareVariableStatement> statement = newNode<ast::DeclareVariableStatement>();
 		statement->m_token = m_currentToken;
 
 		if (!expectPeek(token::IDENTIFIER))
@@ -247,6 +405,7 @@ namespace parser
 
 		statement->m_name.m_token = m_currentToken;
 		statement->m_name.m_name = m_currentToken.m_literal;
+		statement->m_name.m_symbol = m_currentToken.m_symbol;
 
 		// Declaration without assignment
 		if (peekTokenIs(token::SEMICOLON))
@@ -268,7 +427,7 @@ namespace parser
 
 	std::shared_ptr<ast::DeclareCollectionStatement> Parser::parseCollectionDeclaration()
 	{
-		std::shared_ptr<ast::DeclareCollectionStatement> statement(new ast::DeclareCollectionStatement);
+		std::shared_ptr<ast::DeclareCollectionStatement> statement = newNode<ast::DeclareCollectionStatement>();
 		statement->m_token = m_currentToken;
 
 		if (!expectPeek(token::LCHEVRON))
@@ -291,6 +450,7 @@ namespace parser
 
 		statement->m_name.m_token = m_currentToken;
 		statement->m_name.m_name = m_currentToken.m_literal;
+		statement->m_name.m_symbol = m_currentToken.m_symbol;
 
 		// Declaration without assignment
 		if (peekTokenIs(token::SEMICOLON))
@@ -312,7 +472,7 @@ namespace parser
 
 	std::shared_ptr<ast::DeclareDictionaryStatement> Parser::parseDictionaryDeclaration()
 	{
-		std::shared_ptr<ast::DeclareDictionaryStatement> statement(new ast::DeclareDictionaryStatement);
+		std::shared_ptr<ast::DeclareDictionaryStatement> statement = newNode<ast::DeclareDictionaryStatement>();
 		statement->m_token = m_currentToken;
 
 		if (!expectPeek(token::LCHEVRON))
@@ -343,6 +503,7 @@ namespace parser
 
 		statement->m_name.m_token = m_currentToken;
 		statement->m_name.m_name = m_currentToken.m_literal;
+		statement->m_name.m_symbol = m_currentToken.m_symbol;
 
 		// Declaration without assignment
 		if (peekTokenIs(token::SEMICOLON))
@@ -364,7 +525,7 @@ namespace parser
 
 	std::shared_ptr<ast::DeclareFunctionStatement> Parser::parseFunctionDeclaration()
 	{
-		std::shared_ptr<ast::DeclareFunctionStatement> statement(new ast::DeclareFunctionStatement);
+		std::shared_ptr<ast::DeclareFunctionStatement> statement = newNode<ast::DeclareFunctionStatement>();
 		statement->m_token = m_currentToken;
 
 		if (!expectPeek(token::LPARENTHESIS))
@@ -391,9 +552,19 @@ namespace parser
 			return NULL;
 		}
 
-		statement->m_body = std::shared_ptr<ast::FunctionLiteral>(new ast::FunctionLiteral);
+		statement->m_body = newNode<ast::FunctionLiteral>();
 		statement->m_body->m_token = m_currentToken;
-		statement->m_body->m_body = parseBlockStatement();
+		if (m_isLazy && m_blockDepth == 0)
+		{
+			// The body is parsed again from its opening brace when it is first needed
+			if (m_source == NULL) m_source = std::make_shared<std::string>(m_lexer.Input(), m_lexer.Length());
+			statement->m_body->m_source = m_source;
+			skipBlock();
+		}
+		else
+		{
+			statement->m_body->m_body = parseBlockStatement();
+		}
 
 		if (!expectCurrent(token::RBRACE))
 		{
@@ -405,7 +576,7 @@ namespace parser
 
 	std::shared_ptr<ast::ReturnStatement> Parser::parseReturnStatement()
 	{
-		std::shared_ptr<ast::ReturnStatement> statement(new ast::ReturnStatement);
+		std::shared_ptr<ast::ReturnStatement> statement = newNode<ast::ReturnStatement>();
 		statement->m_token = m_currentToken;
 
 		nextToken();
@@ -422,7 +593,7 @@ namespace parser
 
 	std::shared_ptr<ast::ExpressionStatement> Parser::parseExpressionStatement()
 	{
-		std::shared_ptr<ast::ExpressionStatement> statement(new ast::ExpressionStatement);
+		std::shared_ptr<ast::ExpressionStatement> statement = newNode<ast::ExpressionStatement>();
 		statement->m_token = m_currentToken;
 		statement->m_expression = parseExpression(LOWEST);
 
@@ -431,9 +602,10 @@ namespace parser
 
 	std::shared_ptr<ast::BlockStatement> Parser::parseBlockStatement()
 	{
-		std::shared_ptr<ast::BlockStatement> statement(new ast::BlockStatement);
+		std::shared_ptr<ast::BlockStatement> statement = newNode<ast::BlockStatement>();
 		statement->m_token = m_currentToken;
 
+		m_blockDepth++;
 		nextToken();
 
 		while (!currentTokenIs(token::RBRACE) && !currentTokenIs(token::END_OF_FILE))
@@ -445,13 +617,14 @@ namespace parser
 			}
 			nextToken();
 		}
+		m_blockDepth--;
 
 		return statement;
 	}
 
 	std::shared_ptr<ast::IfStatement> Parser::parseIfStatement()
 	{
-		std::shared_ptr<ast::IfStatement> statement(new ast::IfStatement);
+		std::shared_ptr<ast::IfStatement> statement = newNode<ast::IfStatement>();
 		statement->m_token = m_currentToken;
 		
 		if (!expectPeek(token::LPARENTHESIS))
@@ -500,7 +673,7 @@ namespace parser
 			return parseIfStatement();
 		}
 
-		std::shared_ptr<ast::IfStatement> statement(new ast::IfStatement);
+		std::shared_ptr<ast::IfStatement> statement = newNode<ast::IfStatement>();
 		statement->m_token = m_currentToken;
 
 		if (!expectPeek(token::LBRACE))
@@ -522,7 +695,7 @@ namespace parser
 
 	std::shared_ptr<ast::WhileStatement> Parser::parseWhileStatement()
 	{
-		std::shared_ptr<ast::WhileStatement> statement(new ast::WhileStatement);
+		std::shared_ptr<ast::WhileStatement> statement = newNode<ast::WhileStatement>();
 		statement->m_token = m_currentToken;
 
 		if (!expectPeek(token::LPARENTHESIS))
@@ -555,7 +728,7 @@ namespace parser
 
 	std::shared_ptr<ast::DoWhileStatement> Parser::parseDoWhileStatement()
 	{
-		std::shared_ptr<ast::DoWhileStatement> statement(new ast::DoWhileStatement);
+		std::shared_ptr<ast::DoWhileStatement> statement = newNode<ast::DoWhileStatement>();
 		statement->m_token = m_currentToken;
 
 		if (!expectPeek(token::LBRACE))
@@ -598,7 +771,7 @@ namespace parser
 
 	std::shared_ptr<ast::ForStatement> Parser::parseForStatement()
 	{
-		std::shared_ptr<ast::ForStatement> statement(new ast::ForStatement);
+		std::shared_ptr<ast::ForStatement> statement = newNode<ast::ForStatement>();
 		statement->m_token = m_currentToken;
 
 		if (!expectPeek(token::LPARENTHESIS))
@@ -644,7 +817,7 @@ namespace parser
 
 	std::shared_ptr<ast::IterateStatement> Parser::parseIterateStatement()
 	{
-		std::shared_ptr<ast::IterateStatement> statement(new ast::IterateStatement);
+		std::shared_ptr<ast::IterateStatement> statement = newNode<ast::IterateStatement>();
 		statement->m_token = m_currentToken;
 
 		if (!expectPeek(token::LPARENTHESIS))
@@ -685,7 +858,7 @@ namespace parser
 
 	std::shared_ptr<ast::BreakStatement> Parser::parseBreakStatement()
 	{
-		std::shared_ptr<ast::BreakStatement> statement(new ast::BreakStatement);
+		std::shared_ptr<ast::BreakStatement> statement = newNode<ast::BreakStatement>();
 		statement->m_token = m_currentToken;
 
 		if (!expectPeek(token::SEMICOLON))
@@ -698,7 +871,7 @@ namespace parser
 
 	std::shared_ptr<ast::ContinueStatement> Parser::parseContinueStatement()
 	{
-		std::shared_ptr<ast::ContinueStatement> statement(new ast::ContinueStatement);
+		std::shared_ptr<ast::ContinueStatement> statement = newNode<ast::ContinueStatement>();
 		statement->m_token = m_currentToken;
 
 		if (!expectPeek(token::SEMICOLON))
@@ -711,12 +884,8 @@ namespace parser
 
 	std::shared_ptr<ast::Expression> Parser::parseExpression(Precedence p_precedence)
 	{
-		PrefixParseFunction prefix;
-		if (m_prefixParseFunctions.count(m_currentToken.m_type) >= 1)
-		{
-			prefix = m_prefixParseFunctions.at(m_currentToken.m_type);
-		}
-		else
+		PrefixParseFunction prefix = m_parseRules[m_currentToken.m_type].m_prefix;
+		if (prefix == NULL)
 		{
 			noPrefixParseFunction(m_currentToken.m_type);
 			return NULL;
@@ -727,7 +896,7 @@ namespace parser
 
 		while (!peekTokenIs(token::SEMICOLON) && p_precedence < peekPrecedence())
 		{
-			InfixParseFunction infix = m_infixParseFunctions[m_peekToken.m_type];
+			InfixParseFunction infix = m_parseRules[m_peekToken.m_type].m_infix;
 			
 			if (infix != NULL)
 			{
@@ -737,7 +906,7 @@ namespace parser
 				continue;
 			}
 
-			PostfixParseFunction postfix = m_postfixParseFunctions[m_peekToken.m_type];
+			PostfixParseFunction postfix = m_parseRules[m_peekToken.m_type].m_postfix;
 			if (postfix != NULL)
 			{
 				nextToken();
@@ -754,7 +923,7 @@ namespace parser
 
 	std::shared_ptr<ast::Expression> Parser::parsePrefixExpression()
 	{
-		std::shared_ptr<ast::PrefixExpression> expression(new ast::PrefixExpression);
+		std::shared_ptr<ast::PrefixExpression> expression = newNode<ast::PrefixExpression>();
 
 		expression->m_token = m_currentToken;
 		expression->m_operator = m_currentToken.m_literal;
@@ -768,7 +937,7 @@ namespace parser
 
 	std::shared_ptr<ast::Expression> Parser::parsePostfixExpression(std::shared_ptr<ast::Expression> p_leftExpression)
 	{
-		std::shared_ptr<ast::PostfixExpression> expression(new ast::PostfixExpression);
+		std::shared_ptr<ast::PostfixExpression> expression = newNode<ast::PostfixExpression>();
 
 		expression->m_token = m_currentToken;
 		expression->m_operator = m_currentToken.m_literal;
@@ -781,7 +950,7 @@ namespace parser
 
 	std::shared_ptr<ast::Expression> Parser::parseInfixExpression(std::shared_ptr<ast::Expression> p_leftExpression)
 	{
-		std::shared_ptr<ast::InfixExpression> expression(new ast::InfixExpression);
+		std::shared_ptr<ast::InfixExpression> expression = newNode<ast::InfixExpression>();
 
 		expression->m_token = m_currentToken;
 		expression->m_operator = m_currentToken.m_literal;
@@ -810,23 +979,23 @@ namespace parser
 
 	std::shared_ptr<ast::Expression> Parser::parseIntegerLiteral()
 	{
-		std::shared_ptr<ast::IntegerLiteral> expression(new ast::IntegerLiteral);
+		std::shared_ptr<ast::IntegerLiteral> expression = newNode<ast::IntegerLiteral>();
 		expression->m_token = m_currentToken;
-		expression->m_value = stoi(m_currentToken.m_literal);
+		expression->m_value = m_currentToken.m_integer;
 		return expression;
 	}
 
 	std::shared_ptr<ast::Expression> Parser::parseFloatLiteral()
 	{
-		std::shared_ptr<ast::FloatLiteral> expression(new ast::FloatLiteral);
+		std::shared_ptr<ast::FloatLiteral> expression = newNode<ast::FloatLiteral>();
 		expression->m_token = m_currentToken;
-		expression->m_value = stof(m_currentToken.m_literal);
+		expression->m_value = m_currentToken.m_float;
 		return expression;
 	}
 
 	std::shared_ptr<ast::Expression> Parser::parseBooleanLiteral()
 	{
-		std::shared_ptr<ast::BooleanLiteral> expression(new ast::BooleanLiteral);
+		std::shared_ptr<ast::BooleanLiteral> expression = newNode<ast::BooleanLiteral>();
 		expression->m_token = m_currentToken;
 		expression->m_value = currentTokenIs(token::TRUE_LITERAL);
 		return expression;
@@ -844,7 +1013,7 @@ namespace parser
 			m_errors.push_back(error.str());
 		}
 
-		std::shared_ptr<ast::CharacterLiteral> expression(new ast::CharacterLiteral);
+		std::shared_ptr<ast::CharacterLiteral> expression = newNode<ast::CharacterLiteral>();
 		expression->m_token = m_currentToken;
 		expression->m_value = m_currentToken.m_literal[0];
 		return expression;
@@ -852,7 +1021,7 @@ namespace parser
 
 	std::shared_ptr<ast::Expression> Parser::parseCollectionLiteral()
 	{
-		std::shared_ptr<ast::CollectionLiteral> expression(new ast::CollectionLiteral);
+		std::shared_ptr<ast::CollectionLiteral> expression = newNode<ast::CollectionLiteral>();
 		expression->m_token = m_currentToken;
 		parseLiterals(&expression->m_values, token::COMMA, token::RBRACKET);
 		return expression;
@@ -860,7 +1029,7 @@ namespace parser
 
 	std::shared_ptr<ast::Expression> Parser::parseDictionaryLiteral()
 	{
-		std::shared_ptr<ast::DictionaryLiteral> expression(new ast::DictionaryLiteral);
+		std::shared_ptr<ast::DictionaryLiteral> expression = newNode<ast::DictionaryLiteral>();
 		expression->m_token = m_currentToken;
 		parseKeyValuePairs(&expression->m_map, token::COMMA, token::RBRACE);
 		return expression;
@@ -868,13 +1037,13 @@ namespace parser
 
 	std::shared_ptr<ast::Expression> Parser::parseStringLiteral()
 	{
-		std::shared_ptr<ast::StringLiteral> stringLiteral(new ast::StringLiteral);
+		std::shared_ptr<ast::StringLiteral> stringLiteral = newNode<ast::StringLiteral>();
 		stringLiteral->m_token = m_currentToken;
-		stringLiteral->m_stringCollection = std::shared_ptr<ast::CollectionLiteral>(new ast::CollectionLiteral);
+		stringLiteral->m_stringCollection = newNode<ast::CollectionLiteral>();
 
 		for (int i = 0; i < m_currentToken.m_literal.size(); i++)
 		{
-			std::shared_ptr<ast::CharacterLiteral> expression(new ast::CharacterLiteral);
+			std::shared_ptr<ast::CharacterLiteral> expression = newNode<ast::CharacterLiteral>();
 
 			expression->m_token.m_type = token::CHARACTER_LITERAL;
 			expression->m_token.m_literal = m_currentToken.m_literal[i];
@@ -888,15 +1057,16 @@ namespace parser
 
 	std::shared_ptr<ast::Expression> Parser::parseIdentifier()
 	{
-		std::shared_ptr<ast::Identifier> expression(new ast::Identifier);
+		std::shared_ptr<ast::Identifier> expression = newNode<ast::Identifier>();
 		expression->m_token = m_currentToken;
 		expression->m_name = m_currentToken.m_literal;
+		expression->m_symbol = m_currentToken.m_symbol;
 		return expression;
 	}
 
 	std::shared_ptr<ast::Expression> Parser::parseCallExpression(std::shared_ptr<ast::Expression> p_leftExpression)
 	{
-		std::shared_ptr<ast::CallExpression> expression(new ast::CallExpression);
+		std::shared_ptr<ast::CallExpression> expression = newNode<ast::CallExpression>();
 		expression->m_token = m_currentToken;
 		expression->m_function = p_leftExpression;
 		parseLiterals(&expression->m_parameters, token::COMMA, token::RPARENTHESIS);
@@ -906,7 +1076,7 @@ namespace parser
 
 	std::shared_ptr<ast::Expression> Parser::parseIndexExpression(std::shared_ptr<ast::Expression> p_leftExpression)
 	{
-		std::shared_ptr<ast::IndexExpression> expression(new ast::IndexExpression);
+		std::shared_ptr<ast::IndexExpression> expression = newNode<ast::IndexExpression>();
 		expression->m_token = m_currentToken;
 		expression->m_collection = p_leftExpression;
 
@@ -921,28 +1091,13 @@ namespace parser
 		return expression;
 	}
 
-	void Parser::registerPrefixFunction(token::TokenType p_tokenType, PrefixParseFunction p_prefixParseFunction)
-	{
-		m_prefixParseFunctions[p_tokenType] = p_prefixParseFunction;
-	}
-
-	void Parser::registerPostfixFunction(token::TokenType p_tokenType, PostfixParseFunction p_postfixParseFunction)
-	{
-		m_postfixParseFunctions[p_tokenType] = p_postfixParseFunction;
-	}
-
-	void Parser::registerInfixFunction(token::TokenType p_tokenType, InfixParseFunction p_infixParseFunction)
-	{
-		m_infixParseFunctions[p_tokenType] = p_infixParseFunction;
-	}
-
 	void Parser::parseParameters(std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters)
 	{
 		while (!peekTokenIs(token::RPARENTHESIS))
 		{
 			nextToken();
 
-			std::shared_ptr<ast::DeclareVariableStatement> statement(new ast::DeclareVariableStatement);
+			std::shared_ptr<ast::DeclareVariableStatement> statement = newNode<ast::DeclareVariableStatement>();
 			statement->m_token = m_currentToken;
 
 			if (!expectPeek(token::IDENTIFIER))
@@ -953,6 +1108,7 @@ namespace parser
 
 			statement->m_name.m_token = m_currentToken;
 			statement->m_name.m_name = m_currentToken.m_literal;
+			statement->m_name.m_symbol = m_currentToken.m_symbol;
 			statement->m_value = NULL;
 
 			if (peekTokenIs(token::COMMA))
@@ -964,6 +1120,20 @@ namespace parser
 		}
 	}
 
+	void Parser::skipBlock()
+	{
+		int depth = 1;
+		while (depth > 0 && !peekTokenIs(token::END_OF_FILE))
+		{
+			nextToken();
+			if (currentTokenIs(token::LBRACE)) depth++;
+			else if (currentTokenIs(token::RBRACE)) depth--;
+		}
+
+		// An unclosed block ends at the end of the file, where the missing brace is reported
+		if (depth > 0) nextToken();
+	}
+
 	void Parser::parseLiterals(std::vector<std::shared_ptr<ast::Expression>>* p_destination, token::TokenType p_separator, token::TokenType p_ender)
 	{
 		while (!peekTokenIs(p_ender) && m_currentToken.m_type != token::END_OF_FILE)
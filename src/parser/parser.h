@@ -18,16 +18,25 @@ namespace parser
 		token::Token m_currentToken;
 		token::Token m_peekToken;
 
-		std::map<token::TokenType, PrefixParseFunction> m_prefixParseFunctions;
-		std::map<token::TokenType, PostfixParseFunction> m_postfixParseFunctions;
-		std::map<token::TokenType, InfixParseFunction> m_infixParseFunctions;
-
 		std::vector<std::string> m_errors;
 
-		Parser(lexer::Lexer p_lexer);
+		std::shared_ptr<ast::Arena> m_arena;    // Arena of the program being parsed
+
+		// Only brace-matches the bodies of functions declared at the top level of the program. Each is parsed from the
+		// source the first time it is needed, so its syntax errors are only reported then.
+		bool m_isLazy = false;
+
+		// Threads the top level statements of the program are parsed on. Only large programs are split between them.
+		int m_threadCount = 1;
+
+		// A pipelined parser runs its lexer on another thread, which lexes ahead while the parser builds the tree
+		Parser(lexer::Lexer p_lexer, bool p_isPipelined = false);
 		
 		// Parses the program described by the lexer and returns a parsed program
 		std::shared_ptr<ast::Program> ParseProgram();
+
+		// Parses a function body that starts at the current token, as the lexer of a skipped body is started
+		std::shared_ptr<ast::BlockStatement> ParseFunctionBody();
 	private:
 		typedef enum Precedence
 		{
@@ -45,33 +54,38 @@ namespace parser
 			MEMBER_ACCESS,  // dot operator
 		} Precedence;
 
-		const std::map<token::TokenType, Precedence> c_precedenceOfTokenType =
+		// How a token type is parsed at the start of an expression and after one
+		typedef struct ParseRule
 		{
-			{token::ASSIGN, ASSIGNMENT},
-			{token::PLUS_ASSIGN, ASSIGNMENT},
-			{token::MINUS_ASSIGN, ASSIGNMENT},
-			{token::ASTERIK_ASSIGN, ASSIGNMENT},
-			{token::SLASH_ASSIGN, ASSIGNMENT},
-			{token::PERCENT_ASSIGN, ASSIGNMENT},
-			{token::OR, LOGICAL_OR},
-			{token::AND, LOGICAL_AND},
-			{token::EQ, EQUALS},
-			{token::NEQ, EQUALS},
-			{token::LEQ, LESSGREATER},
-			{token::LCHEVRON, LESSGREATER},
-			{token::GEQ, LESSGREATER},
-			{token::RCHEVRON, LESSGREATER},
-			{token::PLUS, SUM},
-			{token::MINUS, SUM},
-			{token::ASTERIK, PRODUCT},
-			{token::SLASH, PRODUCT},
-			{token::PERCENT, PRODUCT},
-			{token::LPARENTHESIS, CALL},
-			{token::INCREMENT, CALL},
-			{token::DECREMENT, CALL},
-			{token::LBRACKET, INDEX},
-			{token::DOT, MEMBER_ACCESS},
-		};
+			PrefixParseFunction m_prefix;
+			InfixParseFunction m_infix;
+			PostfixParseFunction m_postfix;
+			Precedence m_precedence;
+		} ParseRule;
+
+		const ParseRule* m_parseRules; // Indexed by token type
+
+		std::shared_ptr<lexer::LexerThread> m_lexerThread; // Only when pipelined
+
+		int m_blockDepth = 0;                   // Blocks the current token is inside of
+		std::shared_ptr<std::string> m_source;  // Copy of the input shared by the skipped function bodies
+
+		// Programs shorter than this many bytes per chunk are parsed on one thread
+		static const int c_minimumChunkSize = 64 * 1024;
+
+		// Rules of every token type. They are built once and shared by every parser.
+		static const ParseRule* parseRules();
+		static std::vector<ParseRule> buildParseRules();
+
+		// Parses the top level statements that start before the given offset into the program
+		void parseStatements(ast::Program* p_program, int p_end);
+
+		// Splits the rest of the program into chunks of whole top level statements, parses each on one of the threads,
+		// and joins their statements in order. Returns NULL if a chunk has errors, to parse it all again in order.
+		std::shared_ptr<ast::Program> parseChunks();
+
+		// Where the chunks of the program start, found by following the braces and parentheses the tokens are in
+		std::vector<token::Location> findChunks(int p_chunkSize);
 
 		// Cycles through to the next token in the lexer
 		void nextToken();
@@ -146,17 +160,18 @@ namespace parser
 
 		// HELPERS
 
-		// Registers a prefix function into the parser
-		void registerPrefixFunction(token::TokenType p_tokenType, PrefixParseFunction p_prefixParseFunction);
-
-		// Registers a postfix function into the parser
-		void registerPostfixFunction(token::TokenType p_tokenType, PostfixParseFunction p_postfixParseFunction);
-		
-		// Registers an infix function into the parser
-		void registerInfixFunction(token::TokenType p_tokenType, InfixParseFunction p_infixParseFunction);
+		// Allocates a node from the arena of the program being parsed
+		template<typename T>
+		std::shared_ptr<T> newNode()
+		{
+			return ast::newNode<T>(m_arena);
+		}
 	
 		void parseParameters(std::vector<std::shared_ptr<ast::DeclareVariableStatement>> *p_parameters);
 
+		// Moves from the opening brace of a block to its closing brace without parsing what is in between
+		void skipBlock();
+
 		// Parses a list of literals, with given separator token and end token.
 		void parseLiterals(std::vector<std::shared_ptr<ast::Expression>>* p_destination, token::TokenType p_separator, token::TokenType p_ender);
 
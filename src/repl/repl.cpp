@@ -1,16 +1,21 @@
+#include <algorithm>
 #include <string>
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <thread>
 
+#include "cache.h"
+#include "checker.h"
+#include "optimizer.h"
 #include "parser.h"
+#include "resolver.h"
 #include "evaluator.h"
+#include "vm.h"
 
 namespace repl 
 {
 	const std::string c_prompt = ">> ";
 
-	int Start() 
+	int Start(bool p_useVirtualMachine, long long p_fuel, int p_timeout) 
 	{
 		bool isRunning = true;
 		std::shared_ptr<object::Environment> environment = std::make_shared<object::Environment>();
@@ -32,55 +37,132 @@ namespace repl
 			}
 			if (parser.m_errors.size() > 0) continue;
 
+			resolver::Resolver resolver;
+			resolver.ResolveProgram(program);
+
+			checker::Checker checker;
+			if (!checker.CheckProgram(program))
+			{
+				for (int i = 0; i < checker.m_errors.size(); i++)
+				{
+					std::cout << "Type error: " << checker.m_errors[i] << std::endl;
+				}
+				continue;
+			}
+
 #ifdef DEVELOPMENT_BUILD	
 			// Disable timeout in debug mode
+			evaluator::startBudget(p_fuel, 0);
 #else
-			evaluator::g_timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(1000);
+			evaluator::startBudget(p_fuel, p_timeout);
 #endif
-			std::shared_ptr<object::Object> output = evaluator::evaluate(program, environment);
+			std::shared_ptr<object::Object> output = p_useVirtualMachine
+				? vm::run(program, environment)
+				: evaluator::evaluate(program, environment);
 
 			if (output->Type() != object::NULL_TYPE)
 			{
 				std::cout << output->Inspect() << std::endl;
 			}
+			if (p_fuel != 0)
+			{
+				std::cout << "Fuel used: " << evaluator::fuelUsed() << std::endl;
+			}
 		}
 
 		return 0;
 	}
 
-	int Run(const char* p_fileName)
+	// Whether a lazy parse left the body of a top level function to be parsed when it is first called
+	bool hasSkippedBodies(ast::Program* p_program)
 	{
-		std::ifstream file(p_fileName, std::ios_base::in);
-		std::stringstream buffer;
-		std::string fileInput;
+		for (int i = 0; i < p_program->m_statements.size(); i++)
+		{
+			std::shared_ptr<ast::Statement> statement = p_program->m_statements[i];
+			if (statement->Type() == ast::DECLARE_FUNCTION_STATEMENT_NODE && std::static_pointer_cast<ast::DeclareFunctionStatement>(statement)->m_body->m_body == NULL)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
 
-		if (file.is_open()) {
-			buffer << file.rdbuf();
-			fileInput = buffer.str();
+	int Run(const char* p_fileName, bool p_useVirtualMachine, long long p_fuel, int p_timeout, bool p_useCache, bool p_isLazy, bool p_isPipelined, bool p_isParallel, bool p_isOptimized, bool p_isReporting)
+	{
+		// The file is lexed where it is mapped, without copying it into a string first
+		cache::MappedFile file(p_fileName);
+
+		if (file.IsOpen()) {
+			// An unchanged file is loaded from its cache instead of being lexed and parsed again. A cache written by a lazy
+			// parse is parsed again unless this one is lazy too, since the syntax errors of its skipped bodies are unknown.
+			std::shared_ptr<ast::Program> program = p_useCache ? cache::load(p_fileName, file.m_data, file.m_size) : NULL;
+			if (program != NULL && !p_isLazy && hasSkippedBodies(program.get())) program = NULL;
+			if (program == NULL)
+			{
+				lexer::Lexer lexer = lexer::Lexer(file.m_data, (int)file.m_size);
+				parser::Parser parser = parser::Parser(lexer, p_isPipelined);
+				parser.m_isLazy = p_isLazy;
+				if (p_isParallel) parser.m_threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+				program = parser.ParseProgram();
+
+				for (int i = 0; i < parser.m_errors.size(); i++)
+				{
+					std::cout << "Parser error: " << parser.m_errors[i] << std::endl;
+				}
+				if (parser.m_errors.size() > 0)
+				{
+					return -1;
+				}
+
+				if (p_useCache) cache::store(p_fileName, program.get(), file.m_data, file.m_size);
+			}
+			std::shared_ptr<object::Environment> environment = std::make_shared<object::Environment>();
 
-			lexer::Lexer lexer = lexer::Lexer(&fileInput);
-			parser::Parser parser = parser::Parser(lexer);
-			std::shared_ptr<ast::Program> program = parser.ParseProgram();
-			object::Environment environment;
+			resolver::Resolver resolver;
+			resolver.ResolveProgram(program);
 
-			for (int i = 0; i < parser.m_errors.size(); i++)
+			checker::Checker checker;
+			if (!checker.CheckProgram(program))
 			{
-				std::cout << "Parser error: " << parser.m_errors[i] << std::endl;
+				for (int i = 0; i < checker.m_errors.size(); i++)
+				{
+					std::cout << "Type error: " << checker.m_errors[i] << std::endl;
+				}
+				return -1;
 			}
-			if (parser.m_errors.size() > 0)
+
+			// Optimized after the cache is written, which keeps the program as it was parsed. Bodies parsed to be
+			// inlined are optimized like those parsed when they are called.
+			evaluator::g_isOptimizing = p_isOptimized;
+			evaluator::g_isReportingOptimizations = p_isReporting;
+			if (p_isOptimized)
 			{
-				file.close();
-				return -1;
+				optimizer::Optimizer optimizer;
+				optimizer.m_parseBody = [](ast::DeclareFunctionStatement* p_function)
+				{
+					return evaluator::parseFunctionBody(&p_function->m_name.m_name, &p_function->m_parameters, p_function->m_body.get()).empty();
+				};
+				optimizer.OptimizeProgram(program);
+
+				for (int i = 0; p_isReporting && i < optimizer.m_report.size(); i++)
+				{
+					std::cout << "Optimizer: " << optimizer.m_report[i] << std::endl;
+				}
 			}
 
-			std::shared_ptr<object::Object> output = evaluator::evaluate(program, std::make_shared<object::Environment>(environment));
+			evaluator::startBudget(p_fuel, p_timeout);
+			std::shared_ptr<object::Object> output = p_useVirtualMachine
+				? vm::run(program, environment)
+				: evaluator::evaluate(program, environment);
 
 			if (output->Type() == object::ERROR)
 			{
 				std::cout << output->Inspect() << std::endl;
 			}
-
-			file.close();
+			if (p_fuel != 0)
+			{
+				std::cout << "Fuel used: " << evaluator::fuelUsed() << std::endl;
+			}
 		}
 		else
 		{
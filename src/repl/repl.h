@@ -2,9 +2,19 @@
 
 namespace repl 
 {
-	// Starts an interactive terminal.
-	int Start();
+	// Starts an interactive terminal. Uses the bytecode virtual machine if requested.
+	// Each line gets its own budget of fuel and milliseconds, where zero means no limit.
+	int Start(bool p_useVirtualMachine = false, long long p_fuel = 0, int p_timeout = 1000);
 
-	// Runs a file.
-	int Run(const char* p_fileName);
+	// Runs a file. Uses the bytecode virtual machine if requested.
+	// The run is limited to a budget of fuel and milliseconds, where zero means no limit.
+	// The parsed program is cached, and later runs of the same source load the cache instead of parsing again.
+	// Every syntax and type error of the file is reported before it runs, unless the parse is lazy, in which case the
+	// bodies of functions declared at the top level are only parsed, and their errors reported, when first called.
+	// A pipelined parse lexes the file on another thread while it is parsed, and a parallel parse splits the top level
+	// statements of a large file between a thread for each core.
+	// Unless told otherwise, the program is optimized before it runs: constants folded, loop invariants hoisted, counted loops
+	// marked, dead code removed, common subexpressions shared and small functions inlined.
+	// A report of the optimizer prints each statement it removed and each call it inlined before the program runs.
+	int Run(const char* p_fileName, bool p_useVirtualMachine = false, long long p_fuel = 0, int p_timeout = 0, bool p_useCache = true, bool p_isLazy = false, bool p_isPipelined = false, bool p_isParallel = false, bool p_isOptimized = true, bool p_isReporting = false);
 }
\ No newline at end of file
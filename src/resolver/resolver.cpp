@@ -0,0 +1,372 @@
+#include "object.h"
+#include "resolver.h"
+
+namespace resolver
+{
+	Resolver::Resolver()
+	{
+	}
+
+	void Resolver::ResolveProgram(std::shared_ptr<ast::Program> p_program)
+	{
+		m_scopes.clear();
+
+		for (int i = 0; i < p_program->m_statements.size(); i++)
+		{
+			resolveStatement(p_program->m_statements[i]);
+		}
+	}
+
+	void Resolver::ResolveFunctionBody(std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters, std::shared_ptr<ast::BlockStatement> p_body)
+	{
+		m_scopes.clear();
+		resolveFunctionBody(p_parameters, p_body);
+	}
+
+	// STATEMENTS
+
+	void Resolver::resolveStatement(std::shared_ptr<ast::Statement> p_statement)
+	{
+		switch (p_statement->Type())
+		{
+		case ast::EXPRESSION_STATEMENT_NODE:
+			resolveExpression(std::static_pointer_cast<ast::ExpressionStatement>(p_statement)->m_expression);
+			break;
+		case ast::BLOCK_STATEMENT_NODE:
+			resolveBlock(std::static_pointer_cast<ast::BlockStatement>(p_statement));
+			break;
+		case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareVariableStatement> declaration = std::static_pointer_cast<ast::DeclareVariableStatement>(p_statement);
+			resolveDeclaration(&declaration->m_name, declaration->m_value);
+			break;
+		}
+		case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareCollectionStatement> declaration = std::static_pointer_cast<ast::DeclareCollectionStatement>(p_statement);
+			resolveDeclaration(&declaration->m_name, declaration->m_value);
+			break;
+		}
+		case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DeclareDictionaryStatement> declaration = std::static_pointer_cast<ast::DeclareDictionaryStatement>(p_statement);
+			resolveDeclaration(&declaration->m_name, declaration->m_value);
+			break;
+		}
+		case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+			resolveDeclareFunction(std::static_pointer_cast<ast::DeclareFunctionStatement>(p_statement));
+			break;
+		case ast::RETURN_STATEMENT_NODE:
+			resolveExpression(std::static_pointer_cast<ast::ReturnStatement>(p_statement)->m_returnValue);
+			break;
+		case ast::IF_STATEMENT_NODE:
+			resolveIfStatement(std::static_pointer_cast<ast::IfStatement>(p_statement));
+			break;
+		case ast::WHILE_STATEMENT_NODE:
+		{
+			// The condition is evaluated outside of the loop's environment
+			std::shared_ptr<ast::WhileStatement> whileStatement = std::static_pointer_cast<ast::WhileStatement>(p_statement);
+			resolveExpression(whileStatement->m_condition);
+			beginScope();
+			resolveBlock(whileStatement->m_consequence);
+			endScope();
+			break;
+		}
+		case ast::DO_WHILE_STATEMENT_NODE:
+		{
+			std::shared_ptr<ast::DoWhileStatement> doWhileStatement = std::static_pointer_cast<ast::DoWhileStatement>(p_statement);
+			beginScope();
+			resolveBlock(doWhileStatement->m_consequence);
+			endScope();
+			resolveExpression(doWhileStatement->m_condition);
+			break;
+		}
+		case ast::FOR_STATEMENT_NODE:
+			resolveForStatement(std::static_pointer_cast<ast::ForStatement>(p_statement));
+			break;
+		case ast::ITERATE_STATEMENT_NODE:
+			resolveIterateStatement(std::static_pointer_cast<ast::IterateStatement>(p_statement));
+			break;
+		default:
+			break;
+		}
+	}
+
+	void Resolver::resolveBlock(std::shared_ptr<ast::BlockStatement> p_block)
+	{
+		if (p_block == NULL) return;
+
+		if (!m_scopes.empty())
+		{
+			collectSlots(&p_block->m_statements);
+		}
+
+		for (int i = 0; i < p_block->m_statements.size(); i++)
+		{
+			resolveStatement(p_block->m_statements[i]);
+		}
+	}
+
+	void Resolver::resolveDeclaration(ast::Identifier* p_name, std::shared_ptr<ast::Expression> p_value)
+	{
+		resolveExpression(p_value);
+		declare(p_name);
+	}
+
+	void Resolver::resolveDeclareFunction(std::shared_ptr<ast::DeclareFunctionStatement> p_declareFunction)
+	{
+		declare(&p_declareFunction->m_name);
+		resolveFunctionBody(&p_declareFunction->m_parameters, p_declareFunction->m_body->m_body);
+	}
+
+	void Resolver::resolveFunctionBody(std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters, std::shared_ptr<ast::BlockStatement> p_body)
+	{
+		// Parameters take the first slots of the environment created for each call
+		beginScope(true);
+		for (int i = 0; i < p_parameters->size(); i++)
+		{
+			ast::Identifier* parameter = &(*p_parameters)[i]->m_name;
+			addSlot(&parameter->m_name);
+			declare(parameter);
+		}
+		resolveBlock(p_body);
+		endScope();
+	}
+
+	void Resolver::resolveIfStatement(std::shared_ptr<ast::IfStatement> p_ifStatement)
+	{
+		// An else clause creates its environment inside the one of the 'if' it belongs to
+		if (p_ifStatement->m_condition == NULL)
+		{
+			beginScope();
+			resolveBlock(p_ifStatement->m_consequence);
+			endScope();
+			return;
+		}
+
+		resolveExpression(p_ifStatement->m_condition);
+
+		beginScope();
+		resolveBlock(p_ifStatement->m_consequence);
+		endScope();
+
+		if (p_ifStatement->m_alternative != NULL)
+		{
+			beginScope();
+			resolveIfStatement(p_ifStatement->m_alternative);
+			endScope();
+		}
+	}
+
+	void Resolver::resolveForStatement(std::shared_ptr<ast::ForStatement> p_forStatement)
+	{
+		// One environment holds the initialization, and the body gets another one inside of it
+		beginScope();
+
+		std::vector<std::shared_ptr<ast::Statement>> header;
+		if (p_forStatement->m_initialization != NULL) header.push_back(p_forStatement->m_initialization);
+		if (p_forStatement->m_condition != NULL) header.push_back(p_forStatement->m_condition);
+		if (p_forStatement->m_updation != NULL) header.push_back(p_forStatement->m_updation);
+		collectSlots(&header);
+
+		if (p_forStatement->m_initialization != NULL) resolveStatement(p_forStatement->m_initialization);
+		if (p_forStatement->m_condition != NULL) resolveStatement(p_forStatement->m_condition);
+		if (p_forStatement->m_updation != NULL) resolveStatement(p_forStatement->m_updation);
+
+		beginScope();
+		resolveBlock(p_forStatement->m_consequence);
+		endScope();
+
+		endScope();
+	}
+
+	void Resolver::resolveIterateStatement(std::shared_ptr<ast::IterateStatement> p_iterateStatement)
+	{
+		resolveExpression(p_iterateStatement->m_collection);
+
+		// The loop variable shares its environment with the body
+		beginScope();
+		addSlot(&p_iterateStatement->m_var->m_name);
+		declare(p_iterateStatement->m_var.get());
+		resolveBlock(p_iterateStatement->m_consequence);
+		endScope();
+	}
+
+	// EXPRESSIONS
+
+	void Resolver::resolveExpression(std::shared_ptr<ast::Expression> p_expression)
+	{
+		if (p_expression == NULL) return;
+
+		switch (p_expression->Type())
+		{
+		case ast::IDENTIFIER_NODE:
+			resolveIdentifier(std::static_pointer_cast<ast::Identifier>(p_expression).get());
+			break;
+		case ast::COLLECTION_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::CollectionLiteral> collectionLiteral = std::static_pointer_cast<ast::CollectionLiteral>(p_expression);
+			for (int i = 0; i < collectionLiteral->m_values.size(); i++)
+			{
+				resolveExpression(collectionLiteral->m_values[i]);
+			}
+			break;
+		}
+		case ast::DICTIONARY_LITERAL_NODE:
+		{
+			std::shared_ptr<ast::DictionaryLiteral> dictionaryLiteral = std::static_pointer_cast<ast::DictionaryLiteral>(p_expression);
+			for (auto it = dictionaryLiteral->m_map.begin(); it != dictionaryLiteral->m_map.end(); it++)
+			{
+				resolveExpression(it->first);
+				resolveExpression(it->second);
+			}
+			break;
+		}
+		case ast::PREFIX_EXPRESSION_NODE:
+			resolveExpression(std::static_pointer_cast<ast::PrefixExpression>(p_expression)->m_rightExpression);
+			break;
+		case ast::POSTFIX_EXPRESSION_NODE:
+			resolveExpression(std::static_pointer_cast<ast::PostfixExpression>(p_expression)->m_leftExpression);
+			break;
+		case ast::INFIX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::InfixExpression> infixExpression = std::static_pointer_cast<ast::InfixExpression>(p_expression);
+			resolveExpression(infixExpression->m_leftExpression);
+
+			// Member names are not variables, so they are looked up in the table of members instead
+			if (infixExpression->m_operator != ".")
+			{
+				resolveExpression(infixExpression->m_rightExpression);
+			}
+			else if (infixExpression->m_rightExpression->Type() == ast::IDENTIFIER_NODE)
+			{
+				std::shared_ptr<ast::Identifier> name = std::static_pointer_cast<ast::Identifier>(infixExpression->m_rightExpression);
+				auto it = object::c_nameToMember.find(name->m_name);
+				if (it != object::c_nameToMember.end())
+				{
+					name->m_member = it->second;
+				}
+			}
+			break;
+		}
+		case ast::CALL_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::CallExpression> callExpression = std::static_pointer_cast<ast::CallExpression>(p_expression);
+			resolveExpression(callExpression->m_function);
+			for (int i = 0; i < callExpression->m_parameters.size(); i++)
+			{
+				resolveExpression(callExpression->m_parameters[i]);
+			}
+			break;
+		}
+		case ast::INDEX_EXPRESSION_NODE:
+		{
+			std::shared_ptr<ast::IndexExpression> indexExpression = std::static_pointer_cast<ast::IndexExpression>(p_expression);
+			resolveExpression(indexExpression->m_collection);
+			resolveExpression(indexExpression->m_index);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	void Resolver::resolveIdentifier(ast::Identifier* p_identifier)
+	{
+		p_identifier->m_depth = -1;
+		p_identifier->m_slot = -1;
+
+		// Within a function only names declared so far are visible, like in the evaluator.
+		// From inside a nested function, every name of the enclosing scopes is, since the call may come after the declaration.
+		bool isNested = false;
+		for (int i = m_scopes.size() - 1; i >= 0; i--)
+		{
+			Scope* scope = &m_scopes[i];
+			auto it = scope->m_slots.find(p_identifier->m_name);
+			if (it != scope->m_slots.end() && (isNested || scope->m_declared.count(p_identifier->m_name) > 0))
+			{
+				p_identifier->m_depth = m_scopes.size() - 1 - i;
+				p_identifier->m_slot = it->second;
+				return;
+			}
+
+			if (scope->m_isFunction)
+			{
+				isNested = true;
+			}
+		}
+	}
+
+	// HELPERS
+
+	void Resolver::beginScope(bool p_isFunction)
+	{
+		Scope scope;
+		scope.m_isFunction = p_isFunction;
+		m_scopes.push_back(scope);
+	}
+
+	void Resolver::endScope()
+	{
+		m_scopes.pop_back();
+	}
+
+	void Resolver::collectSlots(std::vector<std::shared_ptr<ast::Statement>>* p_statements)
+	{
+		for (int i = 0; i < p_statements->size(); i++)
+		{
+			std::shared_ptr<ast::Statement> statement = (*p_statements)[i];
+			switch (statement->Type())
+			{
+			case ast::DECLARE_VARIABLE_STATEMENT_NODE:
+				addSlot(&std::static_pointer_cast<ast::DeclareVariableStatement>(statement)->m_name.m_name);
+				break;
+			case ast::DECLARE_COLLECTION_STATEMENT_NODE:
+				addSlot(&std::static_pointer_cast<ast::DeclareCollectionStatement>(statement)->m_name.m_name);
+				break;
+			case ast::DECLARE_DICTIONARY_STATEMENT_NODE:
+				addSlot(&std::static_pointer_cast<ast::DeclareDictionaryStatement>(statement)->m_name.m_name);
+				break;
+			case ast::DECLARE_FUNCTION_STATEMENT_NODE:
+				addSlot(&std::static_pointer_cast<ast::DeclareFunctionStatement>(statement)->m_name.m_name);
+				break;
+			case ast::BLOCK_STATEMENT_NODE:
+				collectSlots(&std::static_pointer_cast<ast::BlockStatement>(statement)->m_statements);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	int Resolver::addSlot(std::string* p_name)
+	{
+		// Redeclaring a name reuses its slot, so the evaluator can report the redefinition
+		std::map<std::string, int>* slots = &m_scopes.back().m_slots;
+		auto it = slots->find(*p_name);
+		if (it != slots->end())
+		{
+			return it->second;
+		}
+
+		int slot = slots->size();
+		(*slots)[*p_name] = slot;
+		return slot;
+	}
+
+	void Resolver::declare(ast::Identifier* p_name)
+	{
+		// Globals stay in the environment's map so the REPL and the virtual machine can find them by name
+		if (m_scopes.empty())
+		{
+			p_name->m_depth = -1;
+			p_name->m_slot = -1;
+			return;
+		}
+
+		Scope* scope = &m_scopes.back();
+		p_name->m_depth = 0;
+		p_name->m_slot = scope->m_slots.at(p_name->m_name);
+		scope->m_declared.insert(p_name->m_name);
+	}
+}
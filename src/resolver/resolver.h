@@ -0,0 +1,61 @@
+#pragma once
+
+#include <map>
+#include <set>
+
+#include "ast.h"
+
+namespace resolver
+{
+	// Binds each identifier to the environment and slot that declares it, so the evaluator
+	// can index into an environment instead of looking the name up in each map on the way out.
+	// Global identifiers are left unresolved and keep being looked up by name.
+	class Resolver
+	{
+	public:
+		Resolver();
+
+		void ResolveProgram(std::shared_ptr<ast::Program> p_program);
+
+		// Resolves the body of a function declared at the top level of a program, once a lazy parser has parsed it
+		void ResolveFunctionBody(std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters, std::shared_ptr<ast::BlockStatement> p_body);
+	private:
+		// Mirrors one object::Environment created by the evaluator
+		typedef struct Scope
+		{
+			std::map<std::string, int> m_slots;    // Every name declared directly in the scope
+			std::set<std::string> m_declared;      // Names whose declaration has been resolved so far
+			bool m_isFunction;                     // Outermost scope of a function body
+		} Scope;
+
+		std::vector<Scope> m_scopes;               // Empty at the top level of the program
+
+		// STATEMENTS
+
+		void resolveStatement(std::shared_ptr<ast::Statement> p_statement);
+		void resolveBlock(std::shared_ptr<ast::BlockStatement> p_block);
+		void resolveDeclaration(ast::Identifier* p_name, std::shared_ptr<ast::Expression> p_value);
+		void resolveDeclareFunction(std::shared_ptr<ast::DeclareFunctionStatement> p_declareFunction);
+		void resolveFunctionBody(std::vector<std::shared_ptr<ast::DeclareVariableStatement>>* p_parameters, std::shared_ptr<ast::BlockStatement> p_body);
+		void resolveIfStatement(std::shared_ptr<ast::IfStatement> p_ifStatement);
+		void resolveForStatement(std::shared_ptr<ast::ForStatement> p_forStatement);
+		void resolveIterateStatement(std::shared_ptr<ast::IterateStatement> p_iterateStatement);
+
+		// EXPRESSIONS
+
+		void resolveExpression(std::shared_ptr<ast::Expression> p_expression);
+		void resolveIdentifier(ast::Identifier* p_identifier);
+
+		// HELPERS
+
+		void beginScope(bool p_isFunction = false);
+		void endScope();
+
+		// Gives a slot in the innermost scope to every name declared directly in these statements
+		void collectSlots(std::vector<std::shared_ptr<ast::Statement>>* p_statements);
+		int addSlot(std::string* p_name);
+
+		// Marks a name as declared in the innermost scope
+		void declare(ast::Identifier* p_name);
+	};
+}
@@ -1,14 +1,76 @@
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
 #include "token.h"
 
 namespace token 
 {
+	typedef struct Keyword
+	{
+		const char* m_name;
+		TokenType m_type;
+	} Keyword;
+
+	// Every keyword has its own entry at keywordHash of its name. Names that are not keywords either
+	// land on an empty entry or fail the one comparison with the keyword there.
+	const int c_keywordTableSize = 32;
+	const Keyword c_keywordTable[c_keywordTableSize] =
+	{
+		{NULL, IDENTIFIER},
+		{NULL, IDENTIFIER},
+		{"float", FLOAT_TYPE},
+		{NULL, IDENTIFIER},
+		{"false", FALSE_LITERAL},
+		{NULL, IDENTIFIER},
+		{"return", RETURN},
+		{"collection", COLLECTION_TYPE},
+		{NULL, IDENTIFIER},
+		{"integer", INTEGER_TYPE},
+		{"do", DO},
+		{"character", CHARACTER_TYPE},
+		{"break", BREAK},
+		{"continue", CONTINUE},
+		{"true", TRUE_LITERAL},
+		{"iterate", ITERATE},
+		{NULL, IDENTIFIER},
+		{NULL, IDENTIFIER},
+		{NULL, IDENTIFIER},
+		{NULL, IDENTIFIER},
+		{NULL, IDENTIFIER},
+		{"while", WHILE},
+		{"for", FOR},
+		{NULL, IDENTIFIER},
+		{NULL, IDENTIFIER},
+		{"string", STRING_TYPE},
+		{"boolean", BOOLEAN_TYPE},
+		{NULL, IDENTIFIER},
+		{NULL, IDENTIFIER},
+		{"if", IF},
+		{"dictionary", DICTIONARY_TYPE},
+		{"else", ELSE},
+	};
+
+	std::unordered_map<std::string, int> g_symbols;
+	std::deque<std::string> g_symbolNames;             // A deque, so names are not moved as it grows
+	std::mutex g_symbolMutex;                          // Lexers on other threads intern names too
+
+	static int keywordHash(const std::string* p_identifier)
+	{
+		unsigned char first = (*p_identifier)[0];
+		unsigned char last = (*p_identifier)[p_identifier->size() - 1];
+		return (first + 2 * last + 4 * p_identifier->size()) & (c_keywordTableSize - 1);
+	}
+
 	Token::Token()
+		: m_location{ -1, 0, 0 }, m_integer(0)
 	{
 		m_type = ILLEGAL;
 		m_literal = "ILLEGAL";
 	}
 
 	Token::Token(TokenType p_tokenType, std::string p_literal)
+		: m_location{ -1, 0, 0 }, m_integer(0)
 	{
 		m_type = p_tokenType;
 		m_literal = p_literal;
@@ -16,10 +78,34 @@ namespace token
 
 	TokenType lookupIdentifier(std::string* p_identifier)
 	{
-		if (c_keywordToTokenType.count(*p_identifier) > 0) 
+		if (p_identifier->empty()) return IDENTIFIER;
+
+		const Keyword* keyword = &c_keywordTable[keywordHash(p_identifier)];
+		if (keyword->m_name != NULL && *p_identifier == keyword->m_name) 
 		{
-			return c_keywordToTokenType.at(*p_identifier);
+			return keyword->m_type;
 		}
 		return IDENTIFIER;
 	}
+
+	int internIdentifier(std::string* p_identifier)
+	{
+		std::lock_guard<std::mutex> lock(g_symbolMutex);
+		auto it = g_symbols.find(*p_identifier);
+		if (it != g_symbols.end())
+		{
+			return it->second;
+		}
+
+		int symbol = g_symbolNames.size();
+		g_symbolNames.push_back(*p_identifier);
+		g_symbols.emplace(*p_identifier, symbol);
+		return symbol;
+	}
+
+	const std::string& identifierName(int p_symbol)
+	{
+		std::lock_guard<std::mutex> lock(g_symbolMutex);
+		return g_symbolNames[p_symbol];
+	}
 }
\ No newline at end of file
@@ -81,6 +81,8 @@ namespace token
 		// Loop controls
 		BREAK,
 		CONTINUE,
+
+		TOKEN_TYPE_COUNT, // Number of token types, for tables indexed by type
 	};
 
 	const std::map<TokenType, std::string> c_tokenTypeToString =
@@ -169,15 +171,41 @@ namespace token
 		{"continue", CONTINUE},
 	};
 
+	// Where a token starts in the source
+	typedef struct Location
+	{
+		int m_offset;
+		int m_line;                                 // Counted from 1
+		int m_column;                               // Counted from 1
+	} Location;
+
 	class Token 
 	{
 	public:
 		TokenType m_type;
 		std::string m_literal;
+		Location m_location;
+
+		// Value of a numeric literal, decoded by the lexer, or the interned name of an identifier
+		union
+		{
+			int m_integer;
+			float m_float;
+			int m_symbol;
+		};
 
 		Token();
 		Token(TokenType p_tokenType, std::string p_literal);
 	};
 
+	// Finds the keyword an identifier spells, or IDENTIFIER. Keywords are kept in a perfect hash table,
+	// so at most one keyword is compared.
 	TokenType lookupIdentifier(std::string *p_identifier);
+
+	// Interns an identifier into a small integer, so environments can compare names without comparing strings.
+	// The same name always gets the same symbol. Safe to call from several threads.
+	int internIdentifier(std::string* p_identifier);
+
+	// Name of an interned identifier
+	const std::string& identifierName(int p_symbol);
 }
\ No newline at end of file
@@ -0,0 +1,796 @@
+#include <sstream>
+
+#include "builtinFunctions.h"
+#include "compiler.h"
+#include "evaluator.h"
+#include "vm.h"
+
+namespace vm
+{
+	int g_maxCallDepth = 100000;
+
+	const std::map<compiler::OpCode, std::string> c_opCodeToOperator =
+	{
+		{compiler::OP_ADD, "+"},
+		{compiler::OP_SUBTRACT, "-"},
+		{compiler::OP_MULTIPLY, "*"},
+		{compiler::OP_DIVIDE, "/"},
+		{compiler::OP_MODULO, "%"},
+		{compiler::OP_LESS, "<"},
+		{compiler::OP_LESS_EQUAL, "<="},
+		{compiler::OP_GREATER, ">"},
+		{compiler::OP_GREATER_EQUAL, ">="},
+		{compiler::OP_EQUAL, "=="},
+		{compiler::OP_NOT_EQUAL, "!="},
+		{compiler::OP_AND, "&&"},
+		{compiler::OP_OR, "||"},
+	};
+
+	CompiledFunction::CompiledFunction(std::shared_ptr<compiler::Prototype> p_prototype, std::shared_ptr<object::Environment> p_environment)
+		: object::Function(p_prototype->m_functionType, p_prototype->m_declaration.get(), p_environment)
+		, m_prototype(p_prototype)
+	{
+	}
+
+	VirtualMachine::VirtualMachine(std::shared_ptr<object::Environment> p_environment)
+		: m_environment(p_environment)
+	{
+	}
+
+	std::shared_ptr<object::Object> VirtualMachine::Execute(std::shared_ptr<compiler::Prototype> p_program)
+	{
+		// A previous run can have ended on an error
+		evaluator::g_completion = evaluator::COMPLETION_NORMAL;
+		std::shared_ptr<object::Object> result = run(p_program.get()).Box();
+
+		// An error can leave frames behind
+		m_frames.clear();
+		m_registers.clear();
+		return result;
+	}
+
+	object::Value VirtualMachine::run(compiler::Prototype* p_program)
+	{
+		Frame program = { p_program, 0, 0, NULL, NULL, 0 };
+		m_frames.push_back(program);
+		m_registers.resize(p_program->m_registerCount);
+
+		compiler::Prototype* prototype = p_program;
+		object::Value* r = m_registers.data();
+		compiler::Instruction* instructions = prototype->m_instructions.data();
+		int position = 0;
+
+		while (true)
+		{
+			compiler::Instruction* instruction = &instructions[position++];
+
+			switch (instruction->m_opCode)
+			{
+			case compiler::OP_LOAD_CONSTANT:
+				r[instruction->m_a] = prototype->m_constants[instruction->m_b];
+				break;
+			case compiler::OP_LOAD_NULL:
+				r[instruction->m_a] = object::Value();
+				break;
+			case compiler::OP_MOVE:
+				r[instruction->m_a] = r[instruction->m_b];
+				break;
+
+			case compiler::OP_GET_GLOBAL:
+			{
+				int name = prototype->m_names[instruction->m_b];
+				std::shared_ptr<object::Object> value = m_environment->getIdentifier(name);
+				if (value == NULL)
+				{
+					const std::string& identifier = token::identifierName(name);
+					if (evaluator::c_builtins.find(identifier) == evaluator::c_builtins.end())
+					{
+						std::ostringstream error;
+						error << "'" << identifier << "' is not defined.";
+						return object::Value(evaluator::createError(error.str()));
+					}
+					value = evaluator::c_builtins.at(identifier);
+				}
+				r[instruction->m_a] = object::Value(value);
+				break;
+			}
+			case compiler::OP_GET_ASSIGNABLE_GLOBAL:
+			{
+				int name = prototype->m_names[instruction->m_b];
+				std::shared_ptr<object::Object> value = m_environment->getIdentifier(name);
+				if (value == NULL)
+				{
+					std::ostringstream error;
+					error << "'" << token::identifierName(name) << "' is not defined.";
+					return object::Value(evaluator::createError(error.str()));
+				}
+				r[instruction->m_a] = object::Value(value);
+				break;
+			}
+			case compiler::OP_SET_GLOBAL:
+				m_environment->reassignIdentifier(prototype->m_names[instruction->m_b], r[instruction->m_a].Box());
+				break;
+			case compiler::OP_DEFINE_GLOBAL:
+				m_environment->setIdentifier(prototype->m_names[instruction->m_b], r[instruction->m_a].Box());
+				break;
+			case compiler::OP_CHECK_REDEFINITION:
+			{
+				int name = prototype->m_names[instruction->m_b];
+				if (m_environment->getLocalIdentifier(name) != NULL)
+				{
+					std::ostringstream error;
+					error << "Redefinition of '" << token::identifierName(name) << "'.";
+					return object::Value(evaluator::createError(error.str()));
+				}
+				break;
+			}
+
+			case compiler::OP_CHECK_ASSIGNMENT:
+			{
+				object::Value* value = &r[instruction->m_a];
+				if (value->m_type == object::ERROR) return *value;
+
+				object::ObjectType savedType = r[instruction->m_b].m_type;
+				if (value->m_type != savedType)
+				{
+					std::ostringstream error;
+					error << "Cannot assign '" << token::identifierName(prototype->m_names[instruction->m_c]) << "' of type '"
+						<< object::c_objectTypeToString.at(savedType) << "' a value of type '"
+						<< object::c_objectTypeToString.at(value->m_type) << "'.";
+					return object::Value(evaluator::createError(error.str()));
+				}
+				break;
+			}
+			case compiler::OP_CHECK_DECLARATION:
+			{
+				object::Value result = checkDeclaration(&prototype->m_declarations[instruction->m_b], &r[instruction->m_a]);
+				if (result.m_type == object::ERROR) return result;
+				break;
+			}
+			case compiler::OP_ERROR:
+				return object::Value(evaluator::createError(prototype->m_strings[instruction->m_b]));
+
+			case compiler::OP_NEW_COLLECTION:
+				r[instruction->m_a] = object::Value(std::make_shared<object::Collection>());
+				break;
+			case compiler::OP_COLLECTION_PUSH:
+			{
+				object::Collection* collection = static_cast<object::Collection*>(r[instruction->m_a].m_object.get());
+				object::Value* item = &r[instruction->m_b];
+
+				if (collection->m_collectionType != object::NULL_TYPE && item->m_type != collection->m_collectionType)
+				{
+					std::ostringstream error;
+					error << "The collection " << prototype->m_literals[instruction->m_c]->String() << " must have uniform typing of elements.";
+					return object::Value(evaluator::createError(error.str()));
+				}
+
+				if (collection->m_collectionType == object::NULL_TYPE) collection->m_collectionType = item->m_type;
+				collection->m_values.push_back(item->Box());
+				break;
+			}
+			case compiler::OP_NEW_DICTIONARY:
+				r[instruction->m_a] = object::Value(std::make_shared<object::Dictionary>());
+				break;
+			case compiler::OP_DICTIONARY_CHECK_KEY:
+			{
+				object::Dictionary* dictionary = static_cast<object::Dictionary*>(r[instruction->m_a].m_object.get());
+				object::Value* key = &r[instruction->m_b];
+
+				if (key->m_type != object::INTEGER && key->m_type != object::FLOAT &&
+					key->m_type != object::BOOLEAN && key->m_type != object::CHARACTER)
+				{
+					std::ostringstream error;
+					error << "Invalid dictionary key type. " <<
+						object::c_objectTypeToString.at(key->m_type) << " is not a hashable type.";
+					return object::Value(evaluator::createError(error.str()));
+				}
+
+				if (dictionary->m_keyType != object::NULL_TYPE && key->m_type != dictionary->m_keyType)
+				{
+					return object::Value(evaluator::createError("Dictionary has mismatching key types."));
+				}
+
+				if (dictionary->m_keyType == object::NULL_TYPE) dictionary->m_keyType = key->m_type;
+				if (dictionary->m_map.find(key->Box()) != dictionary->m_map.end())
+				{
+					return object::Value(evaluator::createError("Dictionary initialized with duplicate key."));
+				}
+				break;
+			}
+			case compiler::OP_DICTIONARY_INSERT:
+			{
+				object::Dictionary* dictionary = static_cast<object::Dictionary*>(r[instruction->m_a].m_object.get());
+				object::Value* value = &r[instruction->m_c];
+
+				if (dictionary->m_valueType != object::NULL_TYPE && value->m_type != dictionary->m_valueType)
+				{
+					return object::Value(evaluator::createError("Dictionary has mismatching value types."));
+				}
+
+				if (dictionary->m_valueType == object::NULL_TYPE) dictionary->m_valueType = value->m_type;
+				dictionary->m_map.emplace(r[instruction->m_b].Box(), value->Box());
+				break;
+			}
+
+			case compiler::OP_ADD:
+			case compiler::OP_SUBTRACT:
+			case compiler::OP_MULTIPLY:
+			case compiler::OP_DIVIDE:
+			case compiler::OP_MODULO:
+			case compiler::OP_LESS:
+			case compiler::OP_LESS_EQUAL:
+			case compiler::OP_GREATER:
+			case compiler::OP_GREATER_EQUAL:
+			case compiler::OP_EQUAL:
+			case compiler::OP_NOT_EQUAL:
+			case compiler::OP_AND:
+			case compiler::OP_OR:
+			{
+				object::Value result = binaryOperation(instruction->m_opCode, &r[instruction->m_b], &r[instruction->m_c]);
+				if (result.m_type == object::ERROR) return result;
+				r[instruction->m_a] = result;
+				break;
+			}
+			case compiler::OP_UNSUPPORTED_INFIX:
+				return object::Value(evaluator::applyInfixOperator(r[instruction->m_b].Box(), &prototype->m_strings[instruction->m_a], r[instruction->m_c].Box()));
+			case compiler::OP_NOT:
+			{
+				object::Value* value = &r[instruction->m_b];
+				switch (value->m_type)
+				{
+				case object::INTEGER: r[instruction->m_a] = object::Value(value->m_integer == 0); break;
+				case object::FLOAT:   r[instruction->m_a] = object::Value(value->m_float == 0); break;
+				case object::BOOLEAN: r[instruction->m_a] = object::Value(!value->m_boolean); break;
+				default:
+					return object::Value(evaluator::evaluateBangOperatorExpression(value->Box()));
+				}
+				break;
+			}
+			case compiler::OP_NEGATE:
+			{
+				object::Value* value = &r[instruction->m_b];
+				switch (value->m_type)
+				{
+				case object::INTEGER: r[instruction->m_a] = object::Value(-value->m_integer); break;
+				case object::FLOAT:   r[instruction->m_a] = object::Value(-value->m_float); break;
+				default:
+					return object::Value(evaluator::evaluateMinusPrefixOperatorExpression(value->Box()));
+				}
+				break;
+			}
+			case compiler::OP_INCREMENT:
+			{
+				object::Value result = increment(&r[instruction->m_b], instruction->m_c);
+				if (result.m_type == object::ERROR) return result;
+				r[instruction->m_a] = result;
+				break;
+			}
+
+			case compiler::OP_GET_INDEX:
+			{
+				object::Value result = index(&r[instruction->m_b], &r[instruction->m_c]);
+				if (result.m_type == object::ERROR) return result;
+				r[instruction->m_a] = result;
+				break;
+			}
+			case compiler::OP_SET_INDEX:
+			{
+				object::Value* value = &r[instruction->m_a];
+				std::shared_ptr<object::Object> result;
+
+				switch (value->m_type)
+				{
+				case object::COLLECTION:
+					result = evaluator::collectionValueReassignment(std::static_pointer_cast<object::Collection>(value->m_object), r[instruction->m_b].Box(), r[instruction->m_c].Box());
+					break;
+				case object::DICTIONARY:
+					result = evaluator::dictionaryValueReassignment(std::static_pointer_cast<object::Dictionary>(value->m_object), r[instruction->m_b].Box(), r[instruction->m_c].Box());
+					break;
+				case object::STRING:
+					return object::Value(evaluator::createError("Strings are immutable."));
+				default:
+					return object::Value(evaluator::createError("This should be an unreachable piece of code."));
+				}
+
+				if (result->Type() == object::ERROR) return object::Value(result);
+				break;
+			}
+			case compiler::OP_STORE_INDEX:
+			{
+				object::Value* value = &r[instruction->m_a];
+				if (value->m_type == object::COLLECTION)
+				{
+					static_cast<object::Collection*>(value->m_object.get())->m_values[r[instruction->m_b].m_integer] = r[instruction->m_c].Box();
+				}
+				else if (value->m_type == object::DICTIONARY)
+				{
+					static_cast<object::Dictionary*>(value->m_object.get())->m_map[r[instruction->m_b].Box()] = r[instruction->m_c].Box();
+				}
+				break;
+			}
+			case compiler::OP_GET_MEMBER:
+			{
+				object::Value* value = &r[instruction->m_b];
+				ast::Identifier* name = prototype->m_members[instruction->m_c].get();
+
+				// Sizes are read straight into the register, without allocating an integer
+				int size = value->m_object != NULL ? value->m_object->FindSize(object::getMember(name)) : -1;
+				if (size >= 0)
+				{
+					r[instruction->m_a] = object::Value(size);
+					break;
+				}
+
+				std::shared_ptr<object::Object> result = value->Box()->Member(name);
+				if (result->Type() == object::ERROR) return object::Value(result);
+				r[instruction->m_a] = object::Value(result);
+				break;
+			}
+
+			case compiler::OP_FUNCTION:
+				r[instruction->m_a] = object::Value(std::make_shared<CompiledFunction>(prototype->m_prototypes[instruction->m_b], m_environment));
+				break;
+			case compiler::OP_CALL:
+			{
+				if (!evaluator::useFuel()) return object::Value(evaluator::budgetError());
+
+				compiler::CallSite* callSite = &prototype->m_callSites[instruction->m_c];
+				object::Value* function = &r[instruction->m_b];
+				CompiledFunction* compiledFunction = function->m_type == object::FUNCTION
+					? dynamic_cast<CompiledFunction*>(function->m_object.get())
+					: NULL;
+
+				if (compiledFunction == NULL)
+				{
+					object::Value result = call(callSite, function);
+					if (result.m_type == object::ERROR) return result;
+					r[instruction->m_a] = result;
+					break;
+				}
+
+				object::Value result = checkArguments(callSite, compiledFunction, function + 1);
+				if (result.m_type == object::ERROR) return result;
+
+				if (m_frames.size() > g_maxCallDepth)
+				{
+					std::ostringstream error;
+					error << "Exceeded the maximum call depth of " << g_maxCallDepth << ".";
+					return object::Value(evaluator::createError(error.str()));
+				}
+
+				// The callee's registers start after the caller's, with the arguments copied into the first ones
+				int base = m_frames.back().m_base + prototype->m_registerCount;
+				int arguments = m_frames.back().m_base + instruction->m_b + 1;
+				m_frames.back().m_position = position;
+				Frame frame = { compiledFunction->m_prototype.get(), 0, base, compiledFunction, callSite, instruction->m_a };
+				m_frames.push_back(frame);
+
+				prototype = frame.m_prototype;
+				m_registers.resize(base + prototype->m_registerCount);
+				for (int i = 0; i < callSite->m_argumentCount; i++)
+				{
+					m_registers[base + i] = m_registers[arguments + i];
+				}
+				r = m_registers.data() + base;
+				instructions = prototype->m_instructions.data();
+				position = 0;
+				break;
+			}
+
+			case compiler::OP_CALL_METHOD:
+			{
+				if (!evaluator::useFuel()) return object::Value(evaluator::budgetError());
+
+				object::Value result = callMethod(&prototype->m_callSites[instruction->m_c], &r[instruction->m_b]);
+				if (result.m_type == object::ERROR) return result;
+				r[instruction->m_a] = result;
+				break;
+			}
+
+			case compiler::OP_JUMP:
+				// Backward jumps close loops, so fuel is used there
+				if (instruction->m_b < position && !evaluator::useFuel()) return object::Value(evaluator::budgetError());
+				position = instruction->m_b;
+				break;
+			case compiler::OP_JUMP_IF_FALSE:
+			{
+				object::Value* condition = &r[instruction->m_a];
+				bool isTruthy;
+				switch (condition->m_type)
+				{
+				case object::BOOLEAN: isTruthy = condition->m_boolean; break;
+				case object::INTEGER: isTruthy = condition->m_integer != 0; break;
+				case object::FLOAT:   isTruthy = condition->m_float != 0; break;
+				default:
+					return object::Value(evaluator::isTruthy(condition->Box()));
+				}
+				if (!isTruthy) position = instruction->m_b;
+				break;
+			}
+			case compiler::OP_ITERATE_PREPARE:
+			{
+				object::Value iterable = r[instruction->m_b];
+
+				if (iterable.m_type == object::DICTIONARY)
+				{
+					// Iterates over the keys present when the loop starts
+					std::vector<std::shared_ptr<object::Object>> noArguments;
+					iterable = object::Value(evaluator::dictionaryKeys(&noArguments, iterable.m_object));
+				}
+				else if (iterable.m_type != object::COLLECTION && iterable.m_type != object::STRING)
+				{
+					std::ostringstream error;
+					error << "Expected to see a collection or dictionary to iterate over. Instead got a(n) '"
+						<< object::c_objectTypeToString.at(iterable.m_type) << "'.";
+					return object::Value(evaluator::createError(error.str()));
+				}
+
+				r[instruction->m_a] = iterable;
+				r[instruction->m_a + 1] = object::Value(0);
+				break;
+			}
+			case compiler::OP_ITERATE_NEXT:
+			{
+				object::Value* iterable = &r[instruction->m_b];
+				int* counter = &r[instruction->m_b + 1].m_integer;
+
+				if (iterable->m_type == object::COLLECTION)
+				{
+					object::Collection* collection = static_cast<object::Collection*>(iterable->m_object.get());
+					if (*counter >= collection->m_values.size())
+					{
+						position = instruction->m_c;
+						break;
+					}
+					r[instruction->m_a] = object::Value(collection->m_values[(*counter)++]);
+				}
+				else
+				{
+					object::String* string = static_cast<object::String*>(iterable->m_object.get());
+					if (*counter >= string->m_value.size())
+					{
+						position = instruction->m_c;
+						break;
+					}
+					r[instruction->m_a] = object::Value(string->m_value[(*counter)++]);
+				}
+				break;
+			}
+			case compiler::OP_RETURN:
+			{
+				object::Value output = r[instruction->m_a];
+				if (m_frames.size() == 1) return output;
+
+				Frame* frame = &m_frames.back();
+				object::Value result = checkReturn(frame->m_callSite, frame->m_function, &output);
+				if (result.m_type == object::ERROR) return result;
+
+				int resultRegister = frame->m_resultRegister;
+				m_registers.resize(frame->m_base);
+				m_frames.pop_back();
+
+				frame = &m_frames.back();
+				prototype = frame->m_prototype;
+				r = m_registers.data() + frame->m_base;
+				instructions = prototype->m_instructions.data();
+				position = frame->m_position;
+				r[resultRegister] = output;
+				break;
+			}
+			}
+		}
+	}
+
+	object::Value VirtualMachine::call(compiler::CallSite* p_callSite, object::Value* p_function)
+	{
+		object::Value* arguments = p_function + 1;
+		int argumentCount = p_callSite->m_argumentCount;
+
+		if (p_function->m_type == object::BUILTIN_FUNCTION)
+		{
+			object::Builtin* builtin = static_cast<object::Builtin*>(p_function->m_object.get());
+			std::vector<std::shared_ptr<object::Object>> boxedArguments;
+			for (int i = 0; i < argumentCount; i++)
+			{
+				boxedArguments.push_back(arguments[i].Box());
+			}
+			return object::Value(builtin->m_function(&boxedArguments, builtin->m_object));
+		}
+
+		if (p_function->m_type != object::FUNCTION)
+		{
+			std::ostringstream error;
+			error << "'" << p_callSite->m_expression->m_function->String() << "' is not a function.";
+			return object::Value(evaluator::createError(error.str()));
+		}
+
+		// Functions declared by the evaluator are run by the evaluator
+		object::Function* lotusFunction = static_cast<object::Function*>(p_function->m_object.get());
+		object::Value output = checkArguments(p_callSite, lotusFunction, arguments);
+		if (output.m_type == object::ERROR) return output;
+
+		std::vector<std::shared_ptr<object::Object>> boxedArguments;
+		for (int i = 0; i < argumentCount; i++)
+		{
+			boxedArguments.push_back(arguments[i].Box());
+		}
+
+		output = object::Value(evaluator::applyFunction(p_function->m_object, &boxedArguments));
+		if (evaluator::g_completion == evaluator::COMPLETION_BREAK) return object::Value(evaluator::createError("Attempted to break outside a loop."));
+		if (evaluator::g_completion == evaluator::COMPLETION_CONTINUE) return object::Value(evaluator::createError("Attempted to continue outside a loop."));
+
+		return checkReturn(p_callSite, lotusFunction, &output);
+	}
+
+	object::Value VirtualMachine::callMethod(compiler::CallSite* p_callSite, object::Value* p_object)
+	{
+		std::shared_ptr<object::Object> object = p_object->Box();
+		object::BuiltinFunctionPointer method = object->FindMethod(object::getMember(p_callSite->m_methodName.get()));
+
+		// Other members are called like any other value, which reports that they are not functions
+		if (method == NULL)
+		{
+			object::Value member = object::Value(object->Member(p_callSite->m_methodName.get()));
+			if (member.m_type == object::ERROR) return member;
+			*p_object = member;
+			return call(p_callSite, p_object);
+		}
+
+		std::vector<std::shared_ptr<object::Object>> boxedArguments;
+		for (int i = 0; i < p_callSite->m_argumentCount; i++)
+		{
+			boxedArguments.push_back(p_object[i + 1].Box());
+		}
+		return object::Value(method(&boxedArguments, object));
+	}
+
+	object::Value VirtualMachine::checkArguments(compiler::CallSite* p_callSite, object::Function* p_function, object::Value* p_arguments)
+	{
+		int argumentCount = p_callSite->m_argumentCount;
+		if (argumentCount != p_function->m_parameters.size())
+		{
+			std::ostringstream error;
+			error << "'" << p_function->m_functionName.String() << "' was supplied with "
+				<< argumentCount << " argument(s) instead of "
+				<< p_function->m_parameters.size() << ".";
+			return object::Value(evaluator::createError(error.str()));
+		}
+
+		for (int i = 0; i < argumentCount; i++)
+		{
+			if (p_arguments[i].m_type != object::c_nodeTypeToObjectType.at(p_function->m_parameters[i]->m_token.m_type))
+			{
+				std::ostringstream error;
+				error << "Parameter '" << p_function->m_parameters[i]->m_name.m_name << "' was supplied with a value of type '"
+					<< object::c_objectTypeToString.at(p_arguments[i].m_type) << "' instead of type '"
+					<< p_function->m_parameters[i]->m_token.m_literal << "' for the function call for '"
+					<< p_function->m_functionName.String() << "'.";
+				return object::Value(evaluator::createError(error.str()));
+			}
+		}
+
+		return object::Value();
+	}
+
+	object::Value VirtualMachine::checkReturn(compiler::CallSite* p_callSite, object::Function* p_function, object::Value* p_output)
+	{
+		if (p_output->m_type == object::ERROR) return *p_output;
+
+		if (p_output->m_type == object::NULL_TYPE)
+		{
+			std::ostringstream error;
+			error << "'" << p_function->m_functionName.String() << "' has no return value.";
+			return object::Value(evaluator::createError(error.str()));
+		}
+
+		if (p_output->m_type != p_function->m_functionType)
+		{
+			std::ostringstream error;
+			error << "'" << p_callSite->m_expression->String() << "\' produced a value of type '"
+				<< object::c_objectTypeToString.at(p_output->m_type) << "' instead of type '"
+				<< object::c_objectTypeToString.at(p_function->m_functionType) << "'.";
+			return object::Value(evaluator::createError(error.str()));
+		}
+
+		return *p_output;
+	}
+
+	object::Value VirtualMachine::binaryOperation(compiler::OpCode p_opCode, object::Value* p_leftValue, object::Value* p_rightValue)
+	{
+		object::ObjectType leftType = p_leftValue->m_type;
+		object::ObjectType rightType = p_rightValue->m_type;
+
+		if (leftType == object::INTEGER && rightType == object::INTEGER)
+		{
+			int left = p_leftValue->m_integer;
+			int right = p_rightValue->m_integer;
+
+			switch (p_opCode)
+			{
+			case compiler::OP_ADD:           return object::Value(left + right);
+			case compiler::OP_SUBTRACT:      return object::Value(left - right);
+			case compiler::OP_MULTIPLY:      return object::Value(left * right);
+			case compiler::OP_DIVIDE:
+				if (right == 0) return object::Value(evaluator::createError("Attempted division by zero."));
+				return object::Value(left / right);
+			case compiler::OP_MODULO:
+				if (right == 0) return object::Value(evaluator::createError("Attempted modulo by zero."));
+				return object::Value(left % right);
+			case compiler::OP_LESS:          return object::Value(left < right);
+			case compiler::OP_LESS_EQUAL:    return object::Value(left <= right);
+			case compiler::OP_GREATER:       return object::Value(left > right);
+			case compiler::OP_GREATER_EQUAL: return object::Value(left >= right);
+			case compiler::OP_EQUAL:         return object::Value(left == right);
+			case compiler::OP_NOT_EQUAL:     return object::Value(left != right);
+			default:                         break;
+			}
+		}
+		else if ((leftType == object::FLOAT || leftType == object::INTEGER) && (rightType == object::FLOAT || rightType == object::INTEGER))
+		{
+			// Integers are promoted to floats when mixed with them
+			float left = leftType == object::FLOAT ? p_leftValue->m_float : p_leftValue->m_integer;
+			float right = rightType == object::FLOAT ? p_rightValue->m_float : p_rightValue->m_integer;
+
+			switch (p_opCode)
+			{
+			case compiler::OP_ADD:           return object::Value(left + right);
+			case compiler::OP_SUBTRACT:      return object::Value(left - right);
+			case compiler::OP_MULTIPLY:      return object::Value(left * right);
+			case compiler::OP_DIVIDE:
+				if (right == 0) return object::Value(evaluator::createError("Attempted division by zero."));
+				return object::Value(left / right);
+			case compiler::OP_LESS:          return object::Value(left < right);
+			case compiler::OP_LESS_EQUAL:    return object::Value(left <= right);
+			case compiler::OP_GREATER:       return object::Value(left > right);
+			case compiler::OP_GREATER_EQUAL: return object::Value(left >= right);
+			case compiler::OP_EQUAL:         return object::Value(left == right);
+			case compiler::OP_NOT_EQUAL:     return object::Value(left != right);
+			default:                         break;
+			}
+		}
+		else if (leftType == object::BOOLEAN && rightType == object::BOOLEAN)
+		{
+			bool left = p_leftValue->m_boolean;
+			bool right = p_rightValue->m_boolean;
+
+			switch (p_opCode)
+			{
+			case compiler::OP_AND:           return object::Value(left && right);
+			case compiler::OP_OR:            return object::Value(left || right);
+			case compiler::OP_EQUAL:         return object::Value(left == right);
+			case compiler::OP_NOT_EQUAL:     return object::Value(left != right);
+			default:                         break;
+			}
+		}
+		else if (leftType == object::CHARACTER && rightType == object::CHARACTER)
+		{
+			switch (p_opCode)
+			{
+			case compiler::OP_EQUAL:         return object::Value(p_leftValue->m_character == p_rightValue->m_character);
+			case compiler::OP_NOT_EQUAL:     return object::Value(p_leftValue->m_character != p_rightValue->m_character);
+			default:                         break;
+			}
+		}
+
+		// Every other combination works on boxed values, or is an error
+		std::string infixOperator = c_opCodeToOperator.at(p_opCode);
+		return object::Value(evaluator::applyInfixOperator(p_leftValue->Box(), &infixOperator, p_rightValue->Box()));
+	}
+
+	object::Value VirtualMachine::increment(object::Value* p_value, int p_flags)
+	{
+		std::string incrementOperator = (p_flags & compiler::INCREMENT_DECREMENT) ? "--" : "++";
+		bool isPostfix = p_flags & compiler::INCREMENT_POSTFIX;
+
+		if (p_value->m_type != object::INTEGER)
+		{
+			std::ostringstream error;
+			if (isPostfix) error << object::c_objectTypeToString.at(p_value->m_type) << incrementOperator << "\' is not supported.";
+			else error << incrementOperator << object::c_objectTypeToString.at(p_value->m_type) << "\' is not supported.";
+			return object::Value(evaluator::createError(error.str()));
+		}
+
+		if (p_flags & compiler::INCREMENT_UNASSIGNABLE)
+		{
+			std::ostringstream error;
+			error << object::c_objectTypeToString.at(p_value->m_type) << " does not support "
+				<< (isPostfix ? "postfix" : "prefix") << " operator " << incrementOperator << ".";
+			return object::Value(evaluator::createError(error.str()));
+		}
+
+		return object::Value((p_flags & compiler::INCREMENT_DECREMENT) ? p_value->m_integer - 1 : p_value->m_integer + 1);
+	}
+
+	object::Value VirtualMachine::index(object::Value* p_value, object::Value* p_indexValue)
+	{
+		// Valid indices into collections and strings do not need to box the index
+		if (p_indexValue->m_type == object::INTEGER && p_indexValue->m_integer >= 0)
+		{
+			int index = p_indexValue->m_integer;
+
+			if (p_value->m_type == object::COLLECTION)
+			{
+				object::Collection* collection = static_cast<object::Collection*>(p_value->m_object.get());
+				if (index < collection->m_values.size()) return object::Value(collection->m_values[index]);
+			}
+			else if (p_value->m_type == object::STRING)
+			{
+				object::String* string = static_cast<object::String*>(p_value->m_object.get());
+				if (index < string->m_value.size()) return object::Value(string->m_value[index]);
+			}
+		}
+
+		return object::Value(evaluator::applyIndex(p_value->Box(), p_indexValue->Box()));
+	}
+
+	object::Value VirtualMachine::checkDeclaration(compiler::Declaration* p_declaration, object::Value* p_value)
+	{
+		if (p_value->m_type == object::ERROR) return *p_value;
+
+		if (p_value->m_type != p_declaration->m_type)
+		{
+			std::ostringstream error;
+			error << "'" << p_declaration->m_name
+				<< "' is defined as type '" << p_declaration->m_token.m_literal
+				<< "', not '" << (object::c_objectTypeToString.at(p_value->m_type)) << "'.";
+			return object::Value(evaluator::createError(error.str()));
+		}
+
+		if (p_value->m_type == object::COLLECTION)
+		{
+			object::Collection* collection = static_cast<object::Collection*>(p_value->m_object.get());
+
+			if (collection->m_collectionType != object::NULL_TYPE && collection->m_collectionType != p_declaration->m_keyType)
+			{
+				std::ostringstream error;
+				error << "'" << p_declaration->m_name
+					<< "' is a collection of '" << p_declaration->m_keyTypeToken.m_literal
+					<< "'s, but got a collection of type '" << object::c_objectTypeToString.at(collection->m_collectionType) << "'s.";
+				return object::Value(evaluator::createError(error.str()));
+			}
+
+			collection->m_collectionType = p_declaration->m_keyType;
+		}
+		else if (p_value->m_type == object::DICTIONARY)
+		{
+			object::Dictionary* dictionary = static_cast<object::Dictionary*>(p_value->m_object.get());
+
+			if (dictionary->m_keyType != object::NULL_TYPE &&
+				(dictionary->m_keyType != p_declaration->m_keyType || dictionary->m_valueType != p_declaration->m_valueType))
+			{
+				std::ostringstream error;
+				error << "'" << p_declaration->m_name
+					<< "' is a dictionary of <" << p_declaration->m_keyTypeToken.m_literal << ", " << p_declaration->m_valueTypeToken.m_literal
+					<< "> pairs, but got a dictionary of type <"
+					<< object::c_objectTypeToString.at(dictionary->m_keyType) << ", " << object::c_objectTypeToString.at(dictionary->m_valueType) << "> pairs.";
+				return object::Value(evaluator::createError(error.str()));
+			}
+
+			dictionary->m_keyType = p_declaration->m_keyType;
+			dictionary->m_valueType = p_declaration->m_valueType;
+		}
+
+		return object::Value();
+	}
+
+	void setMaxCallDepth(int p_maxCallDepth)
+	{
+		g_maxCallDepth = p_maxCallDepth;
+		evaluator::g_maxCallDepth = p_maxCallDepth;
+	}
+
+	std::shared_ptr<object::Object> run(std::shared_ptr<ast::Program> p_program, std::shared_ptr<object::Environment> p_environment)
+	{
+		compiler::Compiler compiler;
+		std::shared_ptr<compiler::Prototype> prototype = compiler.CompileProgram(p_program);
+
+		if (prototype == NULL)
+		{
+			return evaluator::evaluate(p_program, p_environment);
+		}
+
+		VirtualMachine virtualMachine(p_environment);
+		return virtualMachine.Execute(prototype);
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "ast.h"
+#include "bytecode.h"
+#include "object.h"
+
+namespace vm
+{
+	// Deepest a chain of compiled calls can go. Calls do not use the native stack, so this only bounds memory.
+	// Programs the compiler does not support, such as those with closures, are run by the evaluator instead, which
+	// still recurses on the native stack and also stops where it runs out.
+	extern int g_maxCallDepth;
+
+	// A function declared by compiled code. It can still be called by the evaluator through its body.
+	class CompiledFunction : public object::Function
+	{
+	public:
+		CompiledFunction(std::shared_ptr<compiler::Prototype> p_prototype, std::shared_ptr<object::Environment> p_environment);
+
+		std::shared_ptr<compiler::Prototype> m_prototype;
+	};
+
+	class VirtualMachine
+	{
+	public:
+		VirtualMachine(std::shared_ptr<object::Environment> p_environment);
+
+		// Runs a compiled program and returns the value of its last statement
+		std::shared_ptr<object::Object> Execute(std::shared_ptr<compiler::Prototype> p_program);
+	private:
+		// A call to a compiled function. Its registers are a window into the register stack.
+		typedef struct Frame
+		{
+			compiler::Prototype* m_prototype;
+			int m_position;                        // Instruction to resume at once the callee returns
+			int m_base;                            // First register
+			object::Function* m_function;          // NULL for the program
+			compiler::CallSite* m_callSite;
+			int m_resultRegister;                  // Register of the caller that receives the return value
+		} Frame;
+
+		std::shared_ptr<object::Environment> m_environment;
+		std::vector<object::Value> m_registers;
+		std::vector<Frame> m_frames;
+
+		// Runs a program. Calls to compiled functions push a frame instead of recursing, so the depth
+		// of Lotus calls is not limited by the native stack.
+		object::Value run(compiler::Prototype* p_program);
+
+		// Calls a builtin or a function declared by the evaluator with the arguments following it in the registers
+		object::Value call(compiler::CallSite* p_callSite, object::Value* p_function);
+
+		// Calls a member function of an object with the arguments following it in the registers
+		object::Value callMethod(compiler::CallSite* p_callSite, object::Value* p_object);
+
+		object::Value checkArguments(compiler::CallSite* p_callSite, object::Function* p_function, object::Value* p_arguments);
+		object::Value checkReturn(compiler::CallSite* p_callSite, object::Function* p_function, object::Value* p_output);
+
+		object::Value binaryOperation(compiler::OpCode p_opCode, object::Value* p_leftValue, object::Value* p_rightValue);
+		object::Value increment(object::Value* p_value, int p_flags);
+		object::Value index(object::Value* p_value, object::Value* p_indexValue);
+		object::Value checkDeclaration(compiler::Declaration* p_declaration, object::Value* p_value);
+	};
+
+	// Limits how deep calls can go on both the evaluator and the virtual machine
+	void setMaxCallDepth(int p_maxCallDepth);
+
+	// Compiles and runs a program, falling back to the evaluator for programs the compiler does not support
+	std::shared_ptr<object::Object> run(std::shared_ptr<ast::Program> p_program, std::shared_ptr<object::Environment> p_environment);
+}
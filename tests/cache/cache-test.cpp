@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "cache.h"
+#include "cache-test.h"
+#include "evaluator.h"
+#include "lexer.h"
+#include "parser.h"
+#include "repl.h"
+#include "resolver.h"
+
+TEST(CacheTest, RoundTrip)
+{
+	std::string tests[] =
+	{
+		"integer(integer n) fibonacci { if (n < 2) { return n; } return fibonacci(n - 1) + fibonacci(n - 2); } fibonacci(15);",
+		"collection<integer> myCollection = [5, 3, 7]; myCollection[1] += 6; myCollection.append(-2); myCollection;",
+		"dictionary<character, float> myDictionary = {'a': 1.5f, 'b': 2.25f}; myDictionary['c'] = 0.5f; myDictionary;",
+		"string myString = \"Hello, world.\"; integer count = 0; iterate(letter : myString) { if (letter == 'o') { count++; } } count;",
+		"integer total = 0; for (integer i = 0; i < 10; i++) { if (i % 2 == 0) { continue; } else if (i > 7) { break; } total += i; } total;",
+		"integer i = 0; do { i = i + 1; } while (i < 5); while (!(i == 0)) { --i; } boolean done = true && i == 0; done;",
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(std::string); i++)
+	{
+		std::shared_ptr<ast::Program> program = testCacheParse(&tests[i]);
+		std::string data = cache::serialize(program.get(), tests[i].data(), tests[i].size());
+
+		std::shared_ptr<ast::Program> loaded = cache::deserialize(data.data(), data.size(), tests[i].data(), tests[i].size());
+		ASSERT_NE(loaded, nullptr) << tests[i];
+		EXPECT_EQ(loaded->String(), program->String()) << tests[i];
+		EXPECT_EQ(cache::serialize(loaded.get(), tests[i].data(), tests[i].size()), data) << tests[i];
+		EXPECT_EQ(testCacheEvaluation(loaded)->Inspect(), testCacheEvaluation(program)->Inspect()) << tests[i];
+	}
+}
+
+TEST(CacheTest, LazyFunctionBodies)
+{
+	std::string input = "integer(integer n) fibonacci { if (n < 2) { return n; } return fibonacci(n - 1) + fibonacci(n - 2); } fibonacci(12);";
+	std::shared_ptr<ast::Program> program = testCacheParse(&input, true);
+	std::string data = cache::serialize(program.get(), input.data(), input.size());
+
+	// Skipped bodies stay skipped, and are parsed from the source the cache was loaded for
+	std::shared_ptr<ast::Program> loaded = cache::deserialize(data.data(), data.size(), input.data(), input.size());
+	ASSERT_NE(loaded, nullptr);
+	std::shared_ptr<ast::FunctionLiteral> function = std::static_pointer_cast<ast::DeclareFunctionStatement>(loaded->m_statements[0])->m_body;
+	EXPECT_TRUE(function->m_body == NULL);
+	EXPECT_EQ(testCacheEvaluation(loaded)->Inspect(), "144");
+	EXPECT_TRUE(function->m_body != NULL);
+}
+
+TEST(CacheTest, RejectsStaleOrDamagedCaches)
+{
+	std::string input = "integer(integer x) add { return x + 1; } collection<integer> values = [add(1), 2]; values;";
+	std::shared_ptr<ast::Program> program = testCacheParse(&input);
+	std::string data = cache::serialize(program.get(), input.data(), input.size());
+
+	// Written for a different source
+	std::string changedInput = input;
+	changedInput[changedInput.size() - 2] = 'z';
+	EXPECT_EQ(cache::deserialize(data.data(), data.size(), changedInput.data(), changedInput.size()), nullptr);
+
+	// Written by a different version
+	std::string otherVersion = data;
+	otherVersion[8]++;
+	EXPECT_EQ(cache::deserialize(otherVersion.data(), otherVersion.size(), input.data(), input.size()), nullptr);
+
+	// Cut short anywhere
+	for (size_t size = 0; size < data.size(); size++)
+	{
+		EXPECT_EQ(cache::deserialize(data.data(), size, input.data(), input.size()), nullptr) << size;
+	}
+
+	// Any byte of the nodes or strings changed
+	for (size_t i = 44; i < data.size(); i++)
+	{
+		std::string damaged = data;
+		damaged[i] ^= 0x10;
+		EXPECT_EQ(cache::deserialize(damaged.data(), damaged.size(), input.data(), input.size()), nullptr) << i;
+	}
+
+	// Damage that still matches its hash is caught by checking what was read
+	std::string damaged = data;
+	damaged[44] = 0x7f;
+	testSignCache(&damaged);
+	EXPECT_EQ(cache::deserialize(damaged.data(), damaged.size(), input.data(), input.size()), nullptr);
+
+	std::string changedOperator = data;
+	size_t plus = changedOperator.rfind("\x02+");
+	ASSERT_NE(plus, std::string::npos);
+	changedOperator[plus + 1] = '?';
+	testSignCache(&changedOperator);
+	EXPECT_EQ(cache::deserialize(changedOperator.data(), changedOperator.size(), input.data(), input.size()), nullptr);
+}
+
+TEST(CacheTest, DamagedCacheIsParsedAgain)
+{
+	std::string fileName = testing::TempDir() + "cache-damaged-test.lotus";
+	std::string input = "integer(integer n) triple { return n * 3; } integer total = 0; for (integer i = 0; i < 4; i++) { total += triple(i); } log(total);";
+	std::ofstream(fileName.c_str(), std::ios_base::binary) << input;
+	std::string cacheFile = cache::cachePath(fileName.c_str(), input.data(), input.size());
+
+	EXPECT_EQ(testCacheRun(fileName.c_str()), "18\n");
+
+	// Damage a byte of every node and string in the cache in turn, each run parsing the source and storing it again
+	std::ifstream file(cacheFile.c_str(), std::ios_base::binary);
+	std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+	ASSERT_GT(data.size(), 44);
+
+	for (size_t i = 44; i < data.size(); i += 7)
+	{
+		std::string damaged = data;
+		damaged[i] ^= 0x5a;
+		std::ofstream(cacheFile.c_str(), std::ios_base::binary | std::ios_base::trunc) << damaged;
+
+		EXPECT_EQ(testCacheRun(fileName.c_str()), "18\n") << i;
+		EXPECT_NE(cache::load(fileName.c_str(), input.data(), input.size()), nullptr) << i;
+	}
+
+	std::remove(cacheFile.c_str());
+	std::remove(fileName.c_str());
+}
+
+TEST(CacheTest, StoreAndLoad)
+{
+	std::string fileName = testing::TempDir() + "cache-test.lotus";
+	std::string input = "integer(integer n) square { return n * n; } square(12);";
+	std::shared_ptr<ast::Program> program = testCacheParse(&input);
+
+	EXPECT_EQ(cache::load(fileName.c_str(), input.data(), input.size()), nullptr);
+
+	cache::store(fileName.c_str(), program.get(), input.data(), input.size());
+	std::shared_ptr<ast::Program> loaded = cache::load(fileName.c_str(), input.data(), input.size());
+	ASSERT_NE(loaded, nullptr);
+	EXPECT_EQ(testCacheEvaluation(loaded)->Inspect(), "144");
+
+	std::string changedInput = "integer(integer n) square { return n * n; } square(13);";
+	EXPECT_EQ(cache::load(fileName.c_str(), changedInput.data(), changedInput.size()), nullptr);
+
+	std::remove(cache::cachePath(fileName.c_str(), input.data(), input.size()).c_str());
+}
+
+std::shared_ptr<ast::Program> testCacheParse(std::string* p_input, bool p_isLazy)
+{
+	lexer::Lexer lexer = lexer::Lexer(p_input);
+	parser::Parser parser = parser::Parser(lexer);
+	parser.m_isLazy = p_isLazy;
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+	EXPECT_EQ(parser.m_errors.size(), 0) << *p_input;
+	return program;
+}
+
+std::shared_ptr<object::Object> testCacheEvaluation(std::shared_ptr<ast::Program> p_program)
+{
+	resolver::Resolver resolver;
+	resolver.ResolveProgram(p_program);
+
+	return evaluator::evaluate(p_program, std::make_shared<object::Environment>());
+}
+
+void testSignCache(std::string* p_data)
+{
+	unsigned long long payloadHash = cache::hashBytes(p_data->data() + 44, p_data->size() - 44);
+	memcpy(&(*p_data)[28], &payloadHash, sizeof(payloadHash));
+}
+
+std::string testCacheRun(const char* p_fileName)
+{
+	std::ostringstream output;
+	std::streambuf* standardOutput = std::cout.rdbuf(output.rdbuf());
+	repl::Run(p_fileName);
+	std::cout.rdbuf(standardOutput);
+	return output.str();
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "ast.h"
+#include "object.h"
+
+// Lexes and parses a program, failing the test on parser errors. A lazy parse skips the top level function bodies.
+std::shared_ptr<ast::Program> testCacheParse(std::string* p_input, bool p_isLazy = false);
+
+// Resolves and evaluates a program in a new environment
+std::shared_ptr<object::Object> testCacheEvaluation(std::shared_ptr<ast::Program> p_program);
+
+// Fills in the hash of the nodes and strings of a cache, so that damage made on purpose gets past it
+void testSignCache(std::string* p_data);
+
+// Runs a file the way the interpreter does, using its cache, and returns what it printed
+std::string testCacheRun(const char* p_fileName);
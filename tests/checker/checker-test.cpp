@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include "checker-test.h"
+#include "lexer.h"
+#include "parser.h"
+#include "resolver.h"
+
+TEST(CheckerTest, TypeErrors)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		std::string expectedError;
+	} TestCase;
+
+	TestCase tests[] =
+	{
+		{"integer a = true;", "'a' is defined as type 'integer', not 'boolean'."},
+		{"integer a;", "'a' is defined as type 'integer', not 'null'."},
+		{"if (false) { float myFloat = 5; }", "'myFloat' is defined as type 'float', not 'integer'."},
+		{"integer() neverCalled { character c = 1 < 2; return 1; }", "'c' is defined as type 'character', not 'boolean'."},
+		{"collection<integer> myCollection = ['a'];", "'myCollection' is a collection of 'integer's, but got a collection of type 'character's."},
+		{"dictionary<character, integer> myDictionary = {1: 'a'};", "'myDictionary' is a dictionary of <character, integer> pairs, but got a dictionary of type <integer, character> pairs."},
+		{"integer myInt = 5; myInt = 6.5f;", "Cannot assign 'myInt' of type 'integer' a value of type 'float'."},
+		{"integer myInt = 5; myInt += 6.5f;", "Cannot assign 'myInt' of type 'integer' a value of type 'float'."},
+		{"iterate(letter : \"abc\") { integer myInt = letter; }", "'myInt' is defined as type 'integer', not 'character'."},
+		{"collection<float> myCollection = [1.5f]; integer myInt = myCollection[0];", "'myInt' is defined as type 'integer', not 'float'."},
+		{"integer(integer x) myFunction { return x; } myFunction();", "'myFunction' was supplied with 0 argument(s) instead of 1."},
+		{"integer(integer x) myFunction { return x; } myFunction('a');", "Parameter 'x' was supplied with a value of type 'character' instead of type 'integer' for the function call for 'myFunction'."},
+		{"float(integer x) myFunction { return x; }", "'myFunction' returns a value of type 'integer' instead of type 'float'."},
+		{"integer(integer x) myFunction { return x; } boolean myBoolean = myFunction(1);", "'myBoolean' is defined as type 'boolean', not 'integer'."},
+		{"integer(integer x) first { return x; } integer(float x) second { return 1; } first = second;", "Cannot assign 'first' a function with a different signature."},
+		{"integer() outer { integer() inner { return x; } integer x = 5; return inner(); } float y = outer();", "'y' is defined as type 'float', not 'integer'."},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		checker::Checker checker;
+		testChecker(&tests[i].input, &checker);
+
+		ASSERT_EQ(checker.m_errors.size(), 1) << tests[i].input;
+		EXPECT_EQ(checker.m_errors[0], tests[i].expectedError);
+	}
+}
+
+TEST(CheckerTest, WellTyped)
+{
+	std::string tests[] =
+	{
+		"integer myInt = 5; myInt = myInt * 2 + 1; myInt++;",
+		"collection<integer> myCollection = []; dictionary<character, integer> myDictionary = {};",
+		"integer(integer n) fibonacci { if (n < 2) { return n; } return fibonacci(n - 1) + fibonacci(n - 2); } fibonacci(10);",
+		"integer() getX { return x; } integer x = 5; getX();",
+		"integer x = 1; integer() outer { float x = 2.5f; return 1; }",
+		"iterate(letter : \"abc\") { character myCharacter = letter; }",
+		"integer myInt = undefinedFunction(1, 'a');",
+	};
+
+	// Types the checker cannot know are left to the evaluator
+	for (int i = 0; i < sizeof(tests) / sizeof(std::string); i++)
+	{
+		checker::Checker checker;
+		testChecker(&tests[i], &checker);
+
+		EXPECT_EQ(checker.m_errors.size(), 0) << tests[i];
+	}
+}
+
+TEST(CheckerTest, TypeCheckedNodes)
+{
+	std::string input =
+		"integer myInt = 5;"
+		"myInt = myInt + 1;"
+		"integer(integer x) myFunction { return x; }"
+		"myFunction(myInt);"
+		"integer(integer x) unknownReturn { return undefinedIdentifier; }"
+		"unknownReturn(undefinedIdentifier);"
+		"integer other = undefinedIdentifier;";
+
+	checker::Checker checker;
+	std::shared_ptr<ast::Program> program = testChecker(&input, &checker);
+	ASSERT_EQ(checker.m_errors.size(), 0);
+	ASSERT_EQ(program->m_statements.size(), 7);
+
+	EXPECT_TRUE(std::static_pointer_cast<ast::DeclareVariableStatement>(program->m_statements[0])->m_isTypeChecked);
+
+	std::shared_ptr<ast::ExpressionStatement> assignment = std::static_pointer_cast<ast::ExpressionStatement>(program->m_statements[1]);
+	EXPECT_TRUE(std::static_pointer_cast<ast::InfixExpression>(assignment->m_expression)->m_isTypeChecked);
+
+	EXPECT_TRUE(std::static_pointer_cast<ast::DeclareFunctionStatement>(program->m_statements[2])->m_isTypeChecked);
+
+	std::shared_ptr<ast::ExpressionStatement> call = std::static_pointer_cast<ast::ExpressionStatement>(program->m_statements[3]);
+	EXPECT_TRUE(std::static_pointer_cast<ast::CallExpression>(call->m_expression)->m_isTypeChecked);
+	EXPECT_EQ(call->m_expression->m_resolvedType, token::INTEGER_TYPE);
+
+	EXPECT_FALSE(std::static_pointer_cast<ast::DeclareFunctionStatement>(program->m_statements[4])->m_isTypeChecked);
+
+	std::shared_ptr<ast::ExpressionStatement> uncheckedCall = std::static_pointer_cast<ast::ExpressionStatement>(program->m_statements[5]);
+	EXPECT_FALSE(std::static_pointer_cast<ast::CallExpression>(uncheckedCall->m_expression)->m_isTypeChecked);
+
+	EXPECT_FALSE(std::static_pointer_cast<ast::DeclareVariableStatement>(program->m_statements[6])->m_isTypeChecked);
+}
+
+TEST(CheckerTest, ResolvedTypes)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		token::TokenType expectedType;
+	} TestCase;
+
+	TestCase tests[] =
+	{
+		{"1 + 2;", token::INTEGER_TYPE},
+		{"1 + 2.5f;", token::FLOAT_TYPE},
+		{"1 < 2;", token::BOOLEAN_TYPE},
+		{"!5;", token::BOOLEAN_TYPE},
+		{"'a' == 'b';", token::BOOLEAN_TYPE},
+		{"\"abc\"[0];", token::CHARACTER_TYPE},
+		{"[1, 2][0];", token::INTEGER_TYPE},
+		{"{'a': 1.5f}['a'];", token::FLOAT_TYPE},
+		{"[1, 'a'];", token::COLLECTION_TYPE},
+		{"'a' + 'b';", token::ILLEGAL},
+		{"undefinedIdentifier;", token::ILLEGAL},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		checker::Checker checker;
+		std::shared_ptr<ast::Program> program = testChecker(&tests[i].input, &checker);
+
+		std::shared_ptr<ast::ExpressionStatement> statement = std::static_pointer_cast<ast::ExpressionStatement>(program->m_statements[0]);
+		EXPECT_EQ(statement->m_expression->m_resolvedType, tests[i].expectedType) << tests[i].input;
+	}
+}
+
+std::shared_ptr<ast::Program> testChecker(std::string* p_input, checker::Checker* p_checker)
+{
+	lexer::Lexer lexer = lexer::Lexer(p_input);
+	parser::Parser parser = parser::Parser(lexer);
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+	EXPECT_EQ(parser.m_errors.size(), 0) << *p_input;
+
+	resolver::Resolver resolver;
+	resolver.ResolveProgram(program);
+
+	p_checker->CheckProgram(program);
+	return program;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "checker.h"
+
+// Lexes, parses and resolves a program, then runs the checker over it
+std::shared_ptr<ast::Program> testChecker(std::string* p_input, checker::Checker* p_checker);
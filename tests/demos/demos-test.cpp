@@ -2,10 +2,12 @@
 
 #include <gtest/gtest.h>
 
+#include "checker.h"
 #include "demos-test.h"
 #include "evaluator-test.h"
 #include "lexer.h"
 #include "parser.h"
+#include "resolver.h"
 
 TEST(DemosTest, Demos)
 {
@@ -61,6 +63,16 @@ std::shared_ptr<object::Object> testEvaluationFile(std::string* p_input)
 			return evaluator::createError("Parser errors found.");
 		}
 
+		resolver::Resolver resolver;
+		resolver.ResolveProgram(program);
+
+		checker::Checker checker;
+		if (!checker.CheckProgram(program))
+		{
+			file.close();
+			return evaluator::createError("Type errors found.");
+		}
+
 		std::cout.setstate(std::ios_base::failbit);
 		std::shared_ptr<object::Object> output = evaluator::evaluate(program, environment);
 		std::cout.clear();
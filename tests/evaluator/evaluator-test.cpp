@@ -3,6 +3,8 @@
 #include "evaluator-test.h"
 #include "lexer.h"
 #include "parser.h"
+#include "resolver.h"
+#include "vm-test.h"
 
 TEST(EvaluatorTest, IntegerExpression)
 {
@@ -34,6 +36,7 @@ TEST(EvaluatorTest, IntegerExpression)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		
 		ASSERT_EQ(evaluated->Type(), object::INTEGER);
 		std::shared_ptr<object::Integer> integer = std::static_pointer_cast<object::Integer>(evaluated);
@@ -69,6 +72,7 @@ TEST(EvaluatorTest, FloatExpression)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 
 		ASSERT_EQ(evaluated->Type(), object::FLOAT);
 		std::shared_ptr<object::Float> integer = std::static_pointer_cast<object::Float>(evaluated);
@@ -132,6 +136,7 @@ TEST(EvaluatorTest, BooleanExpression)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 
 		EXPECT_NO_FATAL_FAILURE(testBooleanObject(evaluated, tests[i].expectedValue));
 	}
@@ -154,6 +159,7 @@ TEST(EvaluatorTest, CharacterExpression)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 
 		EXPECT_NO_FATAL_FAILURE(testCharacterObject(evaluated, tests[i].expectedValue));
 	}
@@ -180,6 +186,7 @@ TEST(EvaluatorTest, CollectionExpression)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 
 		EXPECT_NO_FATAL_FAILURE(testCollectionObject(evaluated, &tests[i].expectedValue, tests[i].objectType));
 	}
@@ -206,6 +213,7 @@ TEST(EvaluatorTest, DictionaryExpression)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);;
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 
 		EXPECT_NO_FATAL_FAILURE(testDictionaryObject(evaluated, &tests[i].expectedValue, tests[i].expectedKeyType, tests[i].expectedValueType));
 	}
@@ -229,6 +237,7 @@ TEST(EvaluatorTest, StringExpression)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 
 		ASSERT_EQ(evaluated->Type(), object::STRING);
 		std::shared_ptr<object::String> string = std::static_pointer_cast<object::String>(evaluated);
@@ -256,6 +265,7 @@ TEST(EvaluatorTest, CollectionIndexing)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
@@ -278,6 +288,7 @@ TEST(EvaluatorTest, DictionaryIndexing)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
@@ -300,6 +311,7 @@ TEST(EvaluatorTest, StringIndexing)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
@@ -323,12 +335,16 @@ TEST(EvaluatorTest, ReturnStatement)
 		{"integer i = 0; while(true) { return i; i = i + 1; }", 0},
 		{"integer i = 0; do { return i; i = i + 1; } while(true);", 0},
 		{"integer i = 0; iterate(value : [1,2,3]) { return value; } ", 1},
+		{"integer() inner { while(true) { if (true) { return 7; } } return 0; } inner() + 1;", 8},
+		{"integer() inner { for(integer i = 0; i < 10; i++) { iterate(value : [1, 2]) { if (value == 2) { return i * 10 + value; } } } return 0; } inner(); 3;", 3},
+		{"integer(integer n) sum { integer total = 0; for(integer i = 0; i < n; i++) { if (i == 2) { continue; } total += i; } return total; } sum(5) + sum(3);", 9},
 		
 	};
 
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 
 		EXPECT_NO_FATAL_FAILURE(testIntegerObject(evaluated, tests[i].expectedValue));
 	}
@@ -356,6 +372,7 @@ TEST(EvaluatorTest, Declaration)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -388,6 +405,57 @@ TEST(EvaluatorTest, Function)
 	EXPECT_EQ(function->m_body->String(), "return (x + 2);\n");
 }
 
+TEST(EvaluatorTest, FunctionOutlivesProgram)
+{
+	// As in the REPL, the program declaring a function is released before the function is called
+	std::shared_ptr<object::Environment> environment(new object::Environment);
+	std::string declaration = "integer(integer x) myFunction { integer y = x * 2; return y + 2; }";
+	{
+		lexer::Lexer lexer = lexer::Lexer(&declaration);
+		parser::Parser parser = parser::Parser(lexer);
+		std::shared_ptr<ast::Program> program = parser.ParseProgram();
+		evaluator::evaluate(program, environment);
+	}
+
+	std::string call = "myFunction(5);";
+	lexer::Lexer lexer = lexer::Lexer(&call);
+	parser::Parser parser = parser::Parser(lexer);
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+
+	std::shared_ptr<object::Object> object = evaluator::evaluate(program, environment);
+	EXPECT_NO_FATAL_FAILURE(testLiteralObject(object, 12));
+}
+
+TEST(EvaluatorTest, LazyFunctionBodies)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		std::string expectedResult;
+	} TestCase;
+
+	TestCase tests[] =
+	{
+		{"integer(integer n) fibonacci { if (n < 2) { return n; } return fibonacci(n - 1) + fibonacci(n - 2); } fibonacci(15);", "610"},
+		{"integer() outer { integer x = 5; integer() inner { return x; } return inner(); } outer();", "5"},
+		{"integer total = 0; integer(integer n) add { total += n; return total; } add(3); add(4);", "7"},
+		{"integer(integer x) twice { integer y = x * 2; return y; } twice(2) + twice(3);", "10"},
+
+		// Type errors in a skipped body are found by the evaluator when it runs
+		{"integer(integer x) wrong { integer y = true; return x; } wrong(1);", "Evaluation Error: 'y' is defined as type 'integer', not 'boolean'."},
+
+		// Syntax errors in a skipped body are only reported once it is called
+		{"integer() broken { return 1 +; } 5;", "5"},
+		{"integer() broken\n{\n return (1;\n} broken();", "Evaluation Error: Syntax error in function 'broken' on line 2. Expected RPARENTHESIS. Got SEMICOLON instead."},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		std::shared_ptr<object::Object> object = testEvaluation(&tests[i].input, true);
+		EXPECT_EQ(object->Inspect(), tests[i].expectedResult) << tests[i].input;
+	}
+}
+
 TEST(EvaluatorTest, FunctionCall)
 {
 	typedef struct TestCase
@@ -405,6 +473,7 @@ TEST(EvaluatorTest, FunctionCall)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -429,6 +498,7 @@ TEST(EvaluatorTest, Reassignment)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -449,6 +519,7 @@ TEST(EvaluatorTest, CollectionReassignment)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -470,6 +541,7 @@ TEST(EvaluatorTest, DictionaryReassignment)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -501,6 +573,7 @@ TEST(EvaluatorTest, IfStatement)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -524,6 +597,7 @@ TEST(EvaluatorTest, WhileLoop)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -547,6 +621,7 @@ TEST(EvaluatorTest, DoWhileLoop)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -571,6 +646,7 @@ TEST(EvaluatorTest, ForLoop)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -596,6 +672,7 @@ TEST(EvaluatorTest, IterateLoop)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -618,6 +695,7 @@ TEST(EvaluatorTest, BuiltinFunctions)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -639,6 +717,7 @@ TEST(EvaluatorTest, StringMemberFunctions)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -672,6 +751,7 @@ TEST(EvaluatorTest, CollectionMemberFunctions)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testCollectionObject(evaluated, &tests[i].expectedValue, tests[i].objectType));
 	}
 }
@@ -712,6 +792,7 @@ TEST(EvaluatorTest, DictionaryMemberFunctions)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);;
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testDictionaryObject(evaluated, &tests[i].expectedValue, tests[i].expectedKeyType, tests[i].expectedValueType));
 	}
 }
@@ -731,12 +812,14 @@ TEST(EvaluatorTest, BreakStatement)
 		{"integer myInteger = 0; do { myInteger = myInteger + 1; break; } while(true); myInteger;", 1},
 		{"integer myInteger = 0; for(integer i = 0; i < 10; i = i + 1) { myInteger = myInteger + 1; break; } myInteger;", 1},
 		{"integer myInteger = 0; iterate(value : [1, 2, 3, 4]) { myInteger = myInteger + 1; if(value == 3) { break; } } myInteger;", 3},
+		{"integer myInteger = 0; iterate(outer : [1, 2, 3]) { while(true) { myInteger = myInteger + 1; break; } } myInteger;", 3},
 
 	};
 
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);;
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -762,6 +845,7 @@ TEST(EvaluatorTest, ContinueStatement)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);;
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -789,6 +873,7 @@ TEST(EvaluatorTest, OperatorAssignments)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);;
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
@@ -829,15 +914,153 @@ TEST(EvaluatorTest, IncrementDecrement)
 		{"collection<integer> b = [1, 2, 3]; ++b[1]; b[1];", 3},
 		{"integer a = 5; 5 + ++a + 5;", 16},
 		{"integer a = 23; (++a +7) * -3 - (100/3.0f);", (24 + 7) * -3 - (100 / 3.0f)}, // -126.333 
+		{"integer a = 5; integer b = a; a++; b;", 5}, // values are not shared between variables
+		{"integer a = 5; collection<integer> b = [a]; ++b[0]; a;", 5},
+		{"dictionary<character, integer> d = {'a': 1}; d['a']++; d['a'];", 2},
 	};
 
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);;
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
+		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
+	}
+}
+
+
+TEST(EvaluatorTest, ResolvedIdentifiers)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		std::any expectedValue;
+	} TestCase;
+
+	TestCase tests[] =
+	{
+		{"integer i = 0; integer total = 0; while (i < 3) { integer square = i * i; total += square; i++; } total;", 5},
+		{"integer i = 0; integer total = 0; do { integer square = i * i; total += square; i++; } while (i < 3); total;", 5},
+		{"integer total = 0; iterate(value : [1, 2, 3]) { integer doubled = value * 2; total += doubled; } total;", 12},
+		{"integer(integer n) sum { integer total = 0; for (integer i = 0; i <= n; i++) { integer next = total + i; total = next; } return total; } sum(4);", 10},
+		{"integer x = 1; integer() shadow { integer x = 2; if (true) { integer x = 3; } return x; } shadow();", 2},
+		{"integer(integer x) increment { x = x + 1; return x; } increment(1);", 2},
+		{"integer(integer n) classify { integer result = 0; if (n < 0) { result = 1; } else if (n == 0) { result = 2; } else { integer other = 3; result = other; } return result; } classify(5);", 3},
+		{"integer() outer { integer() inner { return y; } integer y = 4; return inner(); } outer();", 4},
+		{"integer y = 1; integer() outer { integer() inner { return y; } integer result = inner(); integer y = 4; return result; } outer();", 1},
+		{"integer() outer { integer(integer n) count { if (n == 0) { return 0; } return 1 + count(n - 1); } return count(5); } outer();", 5},
+
+		// A function declared in a loop keeps the variables of the iteration that declared it
+		{"integer() f { return -1; } integer total = 0; for (integer i = 0; i < 3; i++) { if (i > 0) { total = total * 100 + f(); } integer v = i * 10 + 5; integer() g { return v; } f = g; } total * 100 + f();", 51525},
+		{"integer() f { return -1; } integer i = 0; while (i < 3) { integer v = i; integer() g { return v; } if (i == 1) { f = g; } i++; } f();", 1},
+		{"integer() f { return -1; } integer i = 0; do { integer v = i; integer() g { return v; } if (i == 0) { f = g; } i++; } while (i < 3); f();", 0},
+		{"integer() f { return -1; } iterate(value : [4, 5, 6]) { integer v = value; integer() g { return v; } if (value == 5) { f = g; } } f();", 5},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 		EXPECT_NO_FATAL_FAILURE(testLiteralObject(evaluated, tests[i].expectedValue));
 	}
 }
 
+TEST(EvaluatorTest, SharedScalars)
+{
+	// Small integers and characters come from shared objects, which incrementing or reassigning one must not change
+	std::string input = "integer a = 3 + 4; integer b = a; a++; b += 1; collection<integer> c = [a, b, 7]; c[2]--; c;";
+	std::shared_ptr<object::Object> evaluated = testEvaluation(&input);
+	ASSERT_EQ(evaluated->Type(), object::COLLECTION);
+	EXPECT_EQ(evaluated->Inspect(), "[8, 8, 6]");
+	EXPECT_EQ(object::getInteger(7)->m_value, 7);
+
+	std::string sum = "300 + 400;";
+	EXPECT_EQ(testEvaluation(&sum), object::getInteger(700));
+	std::string character = "\"lotus\"[1];";
+	EXPECT_EQ(testEvaluation(&character), object::getCharacter('o'));
+
+	// Larger integers are allocated as before
+	std::string large = "500000 + 500000;";
+	std::shared_ptr<object::Object> first = testEvaluation(&large);
+	std::shared_ptr<object::Object> second = testEvaluation(&large);
+	EXPECT_NE(first, second);
+	EXPECT_EQ(first->Inspect(), "1000000");
+}
+
+TEST(EvaluatorTest, Budget)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		long long fuelLimit;
+		int timeout;
+		std::string expectedError;
+		long long expectedFuelUsed;
+	} TestCase;
+
+	TestCase tests[] =
+	{
+		{"while (true) { }", 100, 0, "Evaluation of the program ran out of fuel.", 100},
+		{"while (true) { }", 5000, 0, "Evaluation of the program ran out of fuel.", 5000},
+		{"while (true) { }", 0, 10, "Evaluation of the program timed out.", -1},
+		{"integer(integer n) forever { return forever(n + 1); } forever(0);", 2000, 0, "Evaluation of the program ran out of fuel.", 2000},
+		{"1 + 2;", 5, 0, "", 5},
+		{"1 + 2;", 4, 0, "Evaluation of the program ran out of fuel.", 4},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		evaluator::startBudget(tests[i].fuelLimit, tests[i].timeout);
+		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		long long fuelUsed = evaluator::fuelUsed();
+		evaluator::startBudget(0, 0);
+
+		if (tests[i].expectedError.empty())
+		{
+			EXPECT_NE(evaluated->Type(), object::ERROR) << tests[i].input;
+		}
+		else
+		{
+			ASSERT_EQ(evaluated->Type(), object::ERROR) << tests[i].input;
+			EXPECT_EQ(std::static_pointer_cast<object::Error>(evaluated)->m_errorMessage, tests[i].expectedError) << tests[i].input;
+		}
+		if (tests[i].expectedFuelUsed >= 0)
+		{
+			EXPECT_EQ(fuelUsed, tests[i].expectedFuelUsed) << tests[i].input;
+		}
+	}
+}
+
+TEST(EvaluatorTest, CallDepth)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		int maxCallDepth;
+		std::string expectedResult;
+	} TestCase;
+
+	TestCase tests[] =
+	{
+		{"integer(integer n) depth { if (n == 0) { return 0; } return depth(n - 1) + 1; } depth(1500);", 100000, "1500"},
+		{"integer(integer n) depth { if (n == 0) { return 0; } return depth(n - 1) + 1; } depth(99);", 100, "99"},
+		{"integer(integer n) depth { if (n == 0) { return 0; } return depth(n - 1) + 1; } depth(100);", 100, "Evaluation Error: Exceeded the maximum call depth of 100."},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		evaluator::g_maxCallDepth = tests[i].maxCallDepth;
+		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		evaluator::g_maxCallDepth = 100000;
+
+		EXPECT_EQ(evaluated->Inspect(), tests[i].expectedResult) << tests[i].input;
+	}
+
+	// Unbounded recursion stops where the native stack runs out instead of overflowing it
+	std::string input = "integer(integer n) forever { return forever(n + 1); } forever(0);";
+	std::shared_ptr<object::Object> evaluated = testEvaluation(&input);
+	ASSERT_EQ(evaluated->Type(), object::ERROR);
+	EXPECT_NE(std::static_pointer_cast<object::Error>(evaluated)->m_errorMessage.find("that the native stack can hold."), std::string::npos);
+}
 
 TEST(EvaluatorTest, Error)
 {
@@ -866,6 +1089,7 @@ TEST(EvaluatorTest, Error)
 		{"integer myInt = 5; myInt = 6.5f; myInt;", "Cannot assign 'myInt' of type 'integer' a value of type 'float'."},
 		{"integer myInt = 5; if ('a') { myInt = 6; } myInt;", "'a' is not a valid truthy value."},
 		{"integer myInt = 5; integer myInt = 6;", "Redefinition of 'myInt'."},
+		{"integer(integer x) myFunction { integer x = 2; return x; } myFunction(1);", "Redefinition of 'x'."},
 		{"[2, 3, 4, 5.5f];", "The collection [2, 3, 4, 5.5] must have uniform typing of elements."},
 		{"collection<integer> myCollection = [2, 3, 4, 5.5f];", "The collection [2, 3, 4, 5.5] must have uniform typing of elements."},
 		{"collection<integer> myCollection = ['a'];", "'myCollection' is a collection of 'integer's, but got a collection of type 'character's."},
@@ -904,19 +1128,24 @@ TEST(EvaluatorTest, Error)
 	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
 	{
 		std::shared_ptr<object::Object> evaluated = testEvaluation(&tests[i].input);
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i].input, false));
 
 		ASSERT_EQ(evaluated->Type(), object::ERROR);
 		EXPECT_EQ(std::static_pointer_cast<object::Error>(evaluated)->m_errorMessage, tests[i].expectedError);
 	}
 }
 
-std::shared_ptr<object::Object> testEvaluation(std::string* p_input)
+std::shared_ptr<object::Object> testEvaluation(std::string* p_input, bool p_isLazy)
 {
 	lexer::Lexer lexer = lexer::Lexer(p_input);
 	parser::Parser parser = parser::Parser(lexer);
+	parser.m_isLazy = p_isLazy;
 	std::shared_ptr<ast::Program> program = parser.ParseProgram();
 	std::shared_ptr<object::Environment> environment(new object::Environment());
 
+	resolver::Resolver resolver;
+	resolver.ResolveProgram(program);
+
 	std::cout.setstate(std::ios_base::failbit);
 	return evaluator::evaluate(program, environment);
 	std::cout.clear();
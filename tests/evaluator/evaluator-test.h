@@ -4,8 +4,8 @@
 
 #include "evaluator.h"
 
-// Lexes and parses through a program
-std::shared_ptr<object::Object> testEvaluation(std::string* p_input);
+// Lexes and parses through a program, skipping the bodies of top level functions if lazy
+std::shared_ptr<object::Object> testEvaluation(std::string* p_input, bool p_isLazy = false);
 
 // Checks type of object and defers it to proper testing function
 void testLiteralObject(std::shared_ptr<object::Object> p_object, std::any p_expectedValue);
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include "evaluator.h"
+#include "gc-test.h"
+#include "lexer.h"
+#include "parser.h"
+#include "resolver.h"
+
+TEST(GarbageCollectorTest, ReclaimsClosureCycles)
+{
+	std::string inputs[] =
+	{
+		"integer() outer { integer x = 5; integer() inner { return x; } return inner(); } for (integer i = 0; i < 100; i++) { outer(); }",
+		"integer(integer n) count { integer() step { return n; } if (n > 0) { return count(n - 1); } return step(); } count(50);",
+		"integer() outer { integer() first { return 1; } integer() second { return first() + 1; } return second(); } outer(); outer();",
+	};
+
+	for (int i = 0; i < sizeof(inputs) / sizeof(std::string); i++)
+	{
+		gc::collect();
+		long liveEnvironments = gc::g_statistics.m_liveEnvironments;
+		long liveObjects = gc::g_statistics.m_liveObjects;
+
+		std::shared_ptr<object::Environment> environment = std::make_shared<object::Environment>();
+		std::shared_ptr<object::Object> result = testCollectedEvaluation(&inputs[i], environment);
+		ASSERT_NE(result->Type(), object::ERROR) << inputs[i];
+
+		// Every environment of the program is part of a cycle through a function declared in it
+		result = NULL;
+		environment = NULL;
+		EXPECT_GT(gc::g_statistics.m_liveEnvironments, liveEnvironments) << inputs[i];
+
+		gc::collect();
+		EXPECT_EQ(gc::g_statistics.m_liveEnvironments, liveEnvironments) << inputs[i];
+		EXPECT_EQ(gc::g_statistics.m_liveObjects, liveObjects) << inputs[i];
+	}
+}
+
+TEST(GarbageCollectorTest, KeepsReachableEnvironments)
+{
+	typedef struct TestCase
+	{
+		std::string declarations;
+		std::string input;
+		int expectedValue;
+	} TestCase;
+
+	TestCase tests[] =
+	{
+		{"integer x = 5; integer() getX { return x; }", "getX();", 5},
+		{"integer() outer { integer x = 5; integer() inner { return x; } return inner(); }", "outer();", 5},
+		{"integer total = 0; integer(integer n) add { total += n; return total; } add(2);", "add(3);", 5},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		std::shared_ptr<object::Environment> environment = std::make_shared<object::Environment>();
+		ASSERT_NE(testCollectedEvaluation(&tests[i].declarations, environment)->Type(), object::ERROR) << tests[i].declarations;
+
+		// The global environment is held from outside the heap, so everything declared in it survives
+		gc::collect();
+
+		std::shared_ptr<object::Object> result = testCollectedEvaluation(&tests[i].input, environment);
+		ASSERT_EQ(result->Type(), object::INTEGER) << tests[i].input;
+		EXPECT_EQ(std::static_pointer_cast<object::Integer>(result)->m_value, tests[i].expectedValue) << tests[i].input;
+	}
+}
+
+TEST(GarbageCollectorTest, Statistics)
+{
+	long collections = gc::g_statistics.m_collections;
+	long environmentsFreed = gc::g_statistics.m_environmentsFreed;
+
+	// Enough calls to go past the collection threshold while the program runs
+	std::string input = "integer() outer { integer() inner { return 1; } return inner(); } integer total = 0; for (integer i = 0; i < 5000; i++) { total += outer(); } total;";
+	std::shared_ptr<object::Environment> environment = std::make_shared<object::Environment>();
+	std::shared_ptr<object::Object> result = testCollectedEvaluation(&input, environment);
+
+	ASSERT_EQ(result->Type(), object::INTEGER);
+	EXPECT_EQ(std::static_pointer_cast<object::Integer>(result)->m_value, 5000);
+	EXPECT_GT(gc::g_statistics.m_collections, collections);
+	EXPECT_GT(gc::g_statistics.m_environmentsFreed, environmentsFreed);
+	EXPECT_LT(gc::g_statistics.m_liveEnvironments, 5000);
+	EXPECT_GE(gc::g_statistics.m_maxPause, gc::g_statistics.m_lastPause);
+	EXPECT_GE(gc::g_statistics.m_totalPause, gc::g_statistics.m_maxPause);
+}
+
+TEST(GarbageCollectorTest, ClosureCyclesInLoopsStayBounded)
+{
+	// Each iteration leaves a function and the environment it was declared in holding each other
+	std::string inputs[] =
+	{
+		"for (integer i = 0; i < ITERATIONS; i++) { integer() get { return i; } get(); }",
+		"integer() make { integer x = 1; integer() get { return x; } return get(); } integer total = 0; for (integer i = 0; i < ITERATIONS; i++) { total += make(); }",
+		"integer i = 0; while (i < ITERATIONS) { collection<integer> values = [i]; integer() first { return values[0]; } i += 1 + first() - i; }",
+	};
+
+	for (int i = 0; i < sizeof(inputs) / sizeof(std::string); i++)
+	{
+		long maxLiveEnvironments[2];
+		int iterations[2] = { 2000, 20000 };
+		for (int j = 0; j < 2; j++)
+		{
+			std::string input = inputs[i];
+			input.replace(input.find("ITERATIONS"), 10, std::to_string(iterations[j]));
+
+			gc::collect();
+			long liveEnvironments = gc::g_statistics.m_liveEnvironments;
+			gc::g_statistics.m_maxLiveEnvironments = liveEnvironments;
+
+			std::shared_ptr<object::Environment> environment = std::make_shared<object::Environment>();
+			ASSERT_NE(testCollectedEvaluation(&input, environment)->Type(), object::ERROR) << input;
+			maxLiveEnvironments[j] = gc::g_statistics.m_maxLiveEnvironments - liveEnvironments;
+
+			environment = NULL;
+			gc::collect();
+			EXPECT_EQ(gc::g_statistics.m_liveEnvironments, liveEnvironments) << input;
+		}
+
+		// Collections keep the heap within twice the threshold, however many iterations run
+		EXPECT_LE(maxLiveEnvironments[1], 2 * gc::c_minimumThreshold) << inputs[i];
+		EXPECT_LE(maxLiveEnvironments[1], maxLiveEnvironments[0] + gc::c_minimumThreshold) << inputs[i];
+	}
+}
+
+std::shared_ptr<object::Object> testCollectedEvaluation(std::string* p_input, std::shared_ptr<object::Environment> p_environment)
+{
+	lexer::Lexer lexer = lexer::Lexer(p_input);
+	parser::Parser parser = parser::Parser(lexer);
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+	if (parser.m_errors.size() > 0) return evaluator::createError(parser.m_errors[0]);
+
+	resolver::Resolver resolver;
+	resolver.ResolveProgram(program);
+
+	return evaluator::evaluate(program, p_environment);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "gc.h"
+#include "object.h"
+
+// Lexes, parses and resolves a program, then evaluates it in the given environment
+std::shared_ptr<object::Object> testCollectedEvaluation(std::string* p_input, std::shared_ptr<object::Environment> p_environment);
@@ -374,4 +374,155 @@ TEST(LexerTest, NumericalValues)
         EXPECT_EQ(token.m_literal, tests[i].second)
             << "Test #" << i << '\n';
     }
-}
\ No newline at end of file
+}
+TEST(LexerTest, DecodedValuesAndLocations)
+{
+    std::string inputCode =
+        R"(integer a = 2147483647;
+  float b = 12.5f;
+2147483648
+)";
+
+    lexer::Lexer lexer(&inputCode);
+    std::vector<token::Token> tokens;
+    do
+    {
+        tokens.push_back(lexer.nextToken());
+    } while (tokens.back().m_type != token::END_OF_FILE);
+
+    ASSERT_EQ(tokens.size(), 12);
+
+    EXPECT_EQ(tokens[3].m_type, token::INTEGER_LITERAL);
+    EXPECT_EQ(tokens[3].m_integer, 2147483647);
+    EXPECT_EQ(tokens[8].m_type, token::FLOAT_LITERAL);
+    EXPECT_EQ(tokens[8].m_float, 12.5f);
+
+    // Too large for an integer
+    EXPECT_EQ(tokens[10].m_type, token::ILLEGAL_NUMERIC);
+
+    EXPECT_EQ(tokens[2].m_location.m_offset, 10);
+    EXPECT_EQ(tokens[2].m_location.m_line, 1);
+    EXPECT_EQ(tokens[2].m_location.m_column, 11);
+    EXPECT_EQ(tokens[5].m_location.m_offset, 26);
+    EXPECT_EQ(tokens[5].m_location.m_line, 2);
+    EXPECT_EQ(tokens[5].m_location.m_column, 3);
+    EXPECT_EQ(tokens[10].m_location.m_line, 3);
+    EXPECT_EQ(tokens[10].m_location.m_column, 1);
+}
+
+TEST(LexerTest, LongRuns)
+{
+    // Runs longer than the 16 characters scanned at once, and ones that end at the end of the input
+    std::string inputCode =
+        "                                        a_very_long_identifier_name_that_crosses_several_chunks\n"
+        "-> a comment that is long enough to be skipped in several chunks\n"
+        "-* a multi-line comment\n"
+        "   which ends on its second line *- \"a string with\nfour\nline\nbreaks\" 'c'\n"
+        "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\tlast";
+
+    lexer::Lexer lexer(&inputCode);
+    std::vector<token::Token> tokens;
+    do
+    {
+        tokens.push_back(lexer.nextToken());
+    } while (tokens.back().m_type != token::END_OF_FILE);
+
+    ASSERT_EQ(tokens.size(), 5);
+
+    EXPECT_EQ(tokens[0].m_type, token::IDENTIFIER);
+    EXPECT_EQ(tokens[0].m_literal, "a_very_long_identifier_name_that_crosses_several_chunks");
+    EXPECT_EQ(tokens[0].m_location.m_column, 41);
+
+    EXPECT_EQ(tokens[1].m_type, token::STRING_LITERAL);
+    EXPECT_EQ(tokens[1].m_literal, "a string with\nfour\nline\nbreaks");
+    EXPECT_EQ(tokens[1].m_location.m_line, 4);
+    EXPECT_EQ(tokens[1].m_location.m_column, 37);
+
+    EXPECT_EQ(tokens[2].m_type, token::CHARACTER_LITERAL);
+    EXPECT_EQ(tokens[2].m_literal, "c");
+    EXPECT_EQ(tokens[2].m_location.m_line, 7);
+
+    EXPECT_EQ(tokens[3].m_literal, "last");
+    EXPECT_EQ(tokens[3].m_location.m_line, 8);
+    EXPECT_EQ(tokens[3].m_location.m_column, 20);
+}
+
+TEST(LexerTest, KeywordsAndSymbols)
+{
+    for (auto it = token::c_keywordToTokenType.begin(); it != token::c_keywordToTokenType.end(); it++)
+    {
+        std::string keyword = it->first;
+        EXPECT_EQ(token::lookupIdentifier(&keyword), it->second) << keyword;
+
+        // Near misses land on the same entries of the keyword table as real keywords do
+        std::string nearMiss = keyword.substr(0, keyword.size() - 1) + "X";
+        EXPECT_EQ(token::lookupIdentifier(&nearMiss), token::IDENTIFIER) << nearMiss;
+    }
+
+    std::string inputCode = "someName other_name someName";
+    lexer::Lexer lexer(&inputCode);
+    token::Token first = lexer.nextToken();
+    token::Token second = lexer.nextToken();
+    token::Token third = lexer.nextToken();
+
+    EXPECT_EQ(first.m_symbol, third.m_symbol);
+    EXPECT_NE(first.m_symbol, second.m_symbol);
+    EXPECT_EQ(token::identifierName(first.m_symbol), "someName");
+    EXPECT_EQ(token::identifierName(second.m_symbol), "other_name");
+}
+
+TEST(LexerTest, LexerThread)
+{
+    // Many times the tokens the ring holds, so that the lexer thread has to wait for the parser
+    std::string inputCode;
+    for (int i = 0; i < 2000; i++)
+    {
+        inputCode += "integer(integer n) name { return n * 2.5f + 'c'; }\n";
+    }
+
+    lexer::Lexer lexer(&inputCode);
+    lexer::LexerThread lexerThread(lexer);
+    token::Token expected;
+    token::Token token;
+    do
+    {
+        lexer.nextToken(&expected);
+        lexerThread.nextToken(&token);
+
+        ASSERT_EQ(token.m_type, expected.m_type);
+        EXPECT_EQ(token.m_literal, expected.m_literal);
+        EXPECT_EQ(token.m_location.m_offset, expected.m_location.m_offset);
+        EXPECT_EQ(token.m_location.m_line, expected.m_location.m_line);
+        // The decoded value is only set for the tokens that carry one
+        if (expected.m_type == token::INTEGER_LITERAL || expected.m_type == token::FLOAT_LITERAL || expected.m_type == token::IDENTIFIER)
+        {
+            EXPECT_EQ(token.m_integer, expected.m_integer);
+        }
+    } while (expected.m_type != token::END_OF_FILE);
+
+    // The end of the file keeps being returned
+    lexerThread.nextToken(&token);
+    EXPECT_EQ(token.m_type, token::END_OF_FILE);
+
+    // A parser can stop taking tokens before the end
+    lexer::Lexer unfinished(&inputCode);
+    lexer::LexerThread abandoned(unfinished);
+    abandoned.nextToken(&token);
+    EXPECT_EQ(token.m_type, token::INTEGER_TYPE);
+}
+
+TEST(LexerTest, InputNotInString)
+{
+    // As a file mapped into memory, the input is not followed by a terminating character
+    const char inputCode[] = { 'f', 'i', 'v', 'e', ' ', '=', ' ', '5', ';', 'x', 'y', 'z' };
+    token::TokenType expectedTypes[] = { token::IDENTIFIER, token::ASSIGN, token::INTEGER_LITERAL, token::SEMICOLON, token::END_OF_FILE };
+
+    lexer::Lexer lexer(inputCode, 9);
+    token::Token token;
+    for (int i = 0; i < sizeof(expectedTypes) / sizeof(token::TokenType); i++)
+    {
+        lexer.nextToken(&token);
+        EXPECT_EQ(token.m_type, expectedTypes[i]);
+    }
+    EXPECT_EQ(token.m_location.m_offset, 9);
+}
@@ -0,0 +1,477 @@
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "evaluator.h"
+#include "lexer.h"
+#include "optimizer-test.h"
+#include "parser.h"
+#include "resolver.h"
+
+TEST(OptimizerTest, ConstantFolding)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		std::string expected;
+	} TestCase;
+
+	TestCase tests[] =
+	{
+		{"1 + 2 * 3;", "7;"},
+		{"10 / 3 - 10 % 3;", "2;"},
+		{"-5 + 2;", "-3;"},
+		{"1 + 2.5f;", "3.5;"},
+		{"7.5f / 2;", "3.75;"},
+		{"1 < 2 && 3 >= 4;", "false;"},
+		{"!0;", "true;"},
+		{"!(1 == 1);", "false;"},
+		{"'a' != 'b';", "true;"},
+		{"\"abc\".length;", "3;"},
+		{"[1 + 1, 2 * 2];", "[2, 4];"},
+		{"(1 + 2) * undefinedIdentifier;", "(3 * undefinedIdentifier);"},
+		// What would fail or overflow is left for the evaluator
+		{"5 / 0;", "(5 / 0);"},
+		{"5 % (1 - 1);", "(5 % 0);"},
+		{"2.5f / 0;", "(2.5 / 0);"},
+		{"5.5f % 2;", "(5.5 % 2);"},
+		{"true + 1;", "(true + 1);"},
+		{"'a' < 'b';", "('a' < 'b');"},
+		{"2147483647 + 1;", "(2147483647 + 1);"},
+		{"\"abc\".size;", "(\"abc\" . size);"},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		std::shared_ptr<ast::Program> program = testOptimizer(&tests[i].input);
+
+		ASSERT_EQ(program->m_statements.size(), 1) << tests[i].input;
+		EXPECT_EQ(program->m_statements[0]->String(), tests[i].expected) << tests[i].input;
+	}
+}
+
+TEST(OptimizerTest, ConstantPropagation)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		std::string expected;
+	} TestCase;
+
+	// The last statement of each program, once optimized
+	TestCase tests[] =
+	{
+		{"integer a = 2; integer b = a * 3; b + 1;", "7;"},
+		{"float half = 0.5f; half * 3;", "1.5;"},
+		{"boolean isOn = true; !isOn;", "false;"},
+		{"string s = \"abc\"; s.length + 1;", "4;"},
+		{"string s = \"abc\"; s;", "s;"},
+		{"integer a = 2; a = 3; a + 1;", "(a + 1);"},
+		{"integer a = 2; a++; a + 1;", "(a + 1);"},
+		{"integer a = 2; if (true) { a += 1; } a;", "a;"},
+		{"integer a = 2; if (true) { integer a = 5; a; } a;", "2;"},
+		{"integer a = 2; while (false) { integer a = 5; } a * a;", "4;"},
+		{"integer a = 1; integer a = 2; a;", "a;"},
+		{"integer a = true; a;", "a;"},
+		{"collection<integer> a = [1]; a;", "a;"},
+		{"integer(integer a) f { return a; } integer a = 2; a;", "2;"},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		std::shared_ptr<ast::Program> program = testOptimizer(&tests[i].input);
+
+		EXPECT_EQ(program->m_statements.back()->String(), tests[i].expected) << tests[i].input;
+	}
+}
+
+TEST(OptimizerTest, FunctionBodies)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		bool isLazy;
+		std::string expected;
+	} TestCase;
+
+	// What the first function of each program returns, once optimized. Each program calls it, so that it is not removed,
+	// and calls are not inlined, which would leave nothing to call it.
+	int inlineBudget = optimizer::g_inlineBudget;
+	optimizer::g_inlineBudget = 0;
+	TestCase tests[] =
+	{
+		{"integer x = 5; integer() getX { return x + 1; } getX();", false, "6"},
+		{"integer() getX { return x + 1; } integer x = 5; getX();", false, "(x + 1)"},
+		{"integer(integer x) getX { return x + 1; } integer x = 5; getX();", false, "(x + 1)"},
+		{"integer() getX { integer x = 5; return x + 1; } getX();", false, "6"},
+		{"integer() getX { integer() inner { return x; } integer x = 5; return x + 1; } getX();", false, "6"},
+		{"integer() getX { integer x = 5; x--; return x + 1; } getX();", false, "(x + 1)"},
+		{"integer() getX { integer x = 5; return x + 1; } getX();", true, "6"},
+		// A body left for the lazy parser could assign the global
+		{"integer x = 5; integer() getX { return x + 1; } integer() setX { x = 6; return 0; } getX();", true, "(x + 1)"},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		std::shared_ptr<ast::Program> program = testOptimizer(&tests[i].input, tests[i].isLazy);
+
+		std::shared_ptr<ast::DeclareFunctionStatement> function;
+		for (int j = 0; j < program->m_statements.size() && function == NULL; j++)
+		{
+			if (program->m_statements[j]->Type() == ast::DECLARE_FUNCTION_STATEMENT_NODE)
+			{
+				function = std::static_pointer_cast<ast::DeclareFunctionStatement>(program->m_statements[j]);
+			}
+		}
+		ASSERT_NE(function, nullptr) << tests[i].input;
+
+		// Lazily parsed bodies are parsed, resolved and optimized the way the evaluator does on their first call
+		if (function->m_body->m_body == NULL)
+		{
+			evaluator::g_isOptimizing = true;
+			std::string error = evaluator::parseFunctionBody(&function->m_name.m_name, &function->m_parameters, function->m_body.get());
+			evaluator::g_isOptimizing = false;
+			ASSERT_EQ(error, "") << tests[i].input;
+		}
+
+		std::shared_ptr<ast::BlockStatement> body = function->m_body->m_body;
+		std::shared_ptr<ast::ReturnStatement> returnStatement = std::static_pointer_cast<ast::ReturnStatement>(body->m_statements.back());
+		EXPECT_EQ(returnStatement->m_returnValue->String(), tests[i].expected) << tests[i].input;
+	}
+	optimizer::g_inlineBudget = inlineBudget;
+}
+
+TEST(OptimizerTest, LoopInvariants)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		std::string expected;
+	} TestCase;
+
+	// Each program, once optimized, with its statements separated by spaces
+	TestCase tests[] =
+	{
+		{"string s = \"ab\"; for (integer i = 0; i < s.length; i++) { log(i); } log(s);",
+			"string s = \"ab\"; for (integer i = 0; (i < 2); (i++);) { log(i); } log(s);"},
+		{"integer n = f(); integer t = 0; while (t < 100) { t += n * 2; }",
+			"integer n = f(); integer t = 0; integer $invariant1 = (n * 2); while ((t < 100)) { (t += $invariant1); }"},
+		{"integer n = f(); integer t = 0; do { t += n - 1; } while (t < n * 3);",
+			"integer n = f(); integer t = 0; integer $invariant1 = (n - 1); integer $invariant2 = (n * 3); do { (t += $invariant1); } while ((t < $invariant2));"},
+		{"integer n = f(); for (integer i = 0; i < n; i++) { for (integer j = 0; j < n * 4; j++) { log(j); } }",
+			"integer n = f(); integer $invariant1 = (n * 4); for (integer i = 0; (i < n); (i++);) { for (integer j = 0; (j < $invariant1); (j++);) { log(j); } }"},
+		// What changes in the loop, or could fail, stays in it
+		{"collection<integer> c = [1]; while (c.size < 5) { c.append(1); }",
+			"collection<integer> c = [1]; while (((c . size) < 5)) { (c . append)(1); }"},
+		{"integer n = f(); integer t = 0; while (t < n * 2) { log(t); t++; } n = 4;",
+			"integer n = f(); integer t = 0; while ((t < (n * 2))) { log(t); (t++); } (n = 4);"},
+		{"integer n = f(); integer t = 0; while (t < 10) { t += n / 0; t += n / 2; }",
+			"integer n = f(); integer t = 0; integer $invariant1 = (n / 2); while ((t < 10)) { (t += (n / 0)); (t += $invariant1); }"},
+		{"integer n = f(); for (integer i = 0; i < 10; i++) { log(i * n); }",
+			"integer n = f(); for (integer i = 0; (i < 10); (i++);) { log((i * n)); }"},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		EXPECT_EQ(testOptimizedProgram(&tests[i].input), tests[i].expected) << tests[i].input;
+	}
+}
+
+TEST(OptimizerTest, CountedLoops)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		bool expected;
+	} TestCase;
+
+	// Whether the last loop of each program is counted natively
+	TestCase tests[] =
+	{
+		{"integer n = f(); for (integer i = 0; i < n; i++) { log(i); }", true},
+		{"for (integer i = 10; i >= 0; i--) { log(i); }", true},
+		{"integer p = f(); for (integer j = p; j <= 100; j += p) { log(j); }", true},
+		{"for (integer i = 0; i < 10; ++i) { log(i); }", true},
+		{"for (integer i = 0; i < 10; i++) { i += 2; }", false},
+		{"for (float i = 0.0f; i < 10; i++) { log(i); }", false},
+		{"integer n = 1; for (integer i = 0; i < n; i++) { n++; }", false},
+		{"for (integer i = 0; i < 10; i *= 2) { log(i); }", false},
+		{"integer j = 0; for (integer i = 0; j < 10; i++) { j++; }", false},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		std::shared_ptr<ast::Program> program = testOptimizer(&tests[i].input);
+
+		ASSERT_EQ(program->m_statements.back()->Type(), ast::FOR_STATEMENT_NODE) << tests[i].input;
+		std::shared_ptr<ast::ForStatement> forStatement = std::static_pointer_cast<ast::ForStatement>(program->m_statements.back());
+		EXPECT_EQ(forStatement->m_isCounted, tests[i].expected) << tests[i].input;
+	}
+
+	// A counted loop ends where its counter would leave the range of an integer
+	std::string overflow = "for (integer i = 2147483640; i < 2147483647; i += 5) { log(i); }";
+	EXPECT_EQ(testOptimizedEvaluation(&overflow, true), "2147483640\n2147483645\nnull");
+}
+
+TEST(OptimizerTest, DeadCode)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		std::string expected;
+		int removed;
+	} TestCase;
+
+	// Each program once optimized, and the number of removals reported
+	TestCase tests[] =
+	{
+		{"integer() f { log(1); return 1; log(2); log(3); } log(f());", "integer() f { log(1); return 1; } log(f());", 1},
+		{"while (f()) { break; log(1); }", "while (f()) { break; }", 1},
+		{"if (false) { log(1); } log(2);", "log(2);", 1},
+		{"if (1 > 2) { log(1); } else { log(2); }", "if (false) { } else { log(2); }", 1},
+		{"if (true) { log(1); } else { log(2); }", "if (true) { log(1); }", 1},
+		{"while (2 < 1) { log(1); } log(2);", "log(2);", 1},
+		{"integer width = 4; integer height = 3; log(width * height);", "log(12);", 2},
+		{"integer count = 0; count++; count += 2; log(1);", "log(1);", 3},
+		{"integer(integer n) f { integer() g { return n; } return n; } log(f(1));", "integer(integer n) f { return n; } log(f(1));", 1},
+		// Values that can fail or do something else stay, and so do the variables they assign
+		{"integer a = f(); log(1);", "integer a = f(); log(1);", 0},
+		{"integer a = 1 / 0; log(1);", "integer a = (1 / 0); log(1);", 0},
+		{"integer a = true; log(1);", "integer a = true; log(1);", 0},
+		{"integer a = 1; a = f(); log(1);", "integer a = 1; (a = f()); log(1);", 0},
+		{"integer a = 1; integer a = 2; log(1);", "integer a = 1; integer a = 2; log(1);", 0},
+		{"integer a = 1; log(a++);", "integer a = 1; log((a++));", 0},
+		{"integer() f { a = 2; return 0; } integer a = 1; f();", "integer() f { (a = 2); return 0; } integer a = 1; f();", 0},
+		// The last statement gives the result of the program
+		{"integer x = 1; integer y = x;", "integer y = 1;", 1},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		std::vector<std::string> report;
+		EXPECT_EQ(testOptimizedProgram(&tests[i].input, &report), tests[i].expected) << tests[i].input;
+		EXPECT_EQ(report.size(), tests[i].removed) << tests[i].input;
+	}
+}
+
+TEST(OptimizerTest, CommonSubexpressions)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		std::string expected;
+	} TestCase;
+
+	// Each program, once optimized, with its statements separated by spaces
+	TestCase tests[] =
+	{
+		{"string s = f(); integer i = g(); log(s[i]); log(s[i] == s[i + 1]);",
+			"string s = f(); integer i = g(); character $value1 = (s[i]); log($value1); log(($value1 == (s[(i + 1)])));"},
+		{"string s = f(); log(s.length * 2); log(s.length * 2 + 1);",
+			"string s = f(); integer $value1 = ((s . length) * 2); log($value1); log(($value1 + 1));"},
+		{"integer(integer a, integer b) f { log(a * b); return a * b + 1; } log(f(2, 3));",
+			"integer(integer a, integer b) f { integer $value1 = (a * b); log($value1); return ($value1 + 1); } log(f(2, 3));"},
+		{"integer a = f(); integer b = g(); log(a * b); if (a * b > 2) { log(a * b); }",
+			"integer a = f(); integer b = g(); integer $value1 = (a * b); log($value1); if (($value1 > 2)) { log((a * b)); }"},
+		// A variable declared with the value holds it already
+		{"integer a = f(); integer b = g(); integer x = a * b + 1; log(a * b + 1); log(x);",
+			"integer a = f(); integer b = g(); integer x = ((a * b) + 1); log(x); log(x);"},
+		// Values that may have changed in between, or that would be computed before something that can fail, are computed again
+		{"integer a = f(); integer b = g(); log(a * b); a = 3; log(a * b);",
+			"integer a = f(); integer b = g(); log((a * b)); (a = 3); log((a * b));"},
+		{"integer a = f(); integer b = g(); log(a * b); h(); log(a * b);",
+			"integer a = f(); integer b = g(); log((a * b)); h(); log((a * b));"},
+		{"collection<integer> c = f(); integer n = c.size + 1; c.append(1); log(c.size + 1); log(n);",
+			"collection<integer> c = f(); integer n = ((c . size) + 1); (c . append)(1); log(((c . size) + 1)); log(n);"},
+		{"integer a = f(); integer b = g(); log(a / b, a * b); log(a * b);",
+			"integer a = f(); integer b = g(); log((a / b), (a * b)); log((a * b));"},
+		{"integer a = f(); integer b = g(); log(a * b); for (integer i = 0; i < 2; i++) { } log(a * b);",
+			"integer a = f(); integer b = g(); log((a * b)); for (integer i = 0; (i < 2); (i++);) { } log((a * b));"},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		EXPECT_EQ(testOptimizedProgram(&tests[i].input), tests[i].expected) << tests[i].input;
+	}
+}
+
+TEST(OptimizerTest, Inlining)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		std::string expected;
+		int inlined;
+	} TestCase;
+
+	// Each program once optimized, and the number of calls inlined
+	TestCase tests[] =
+	{
+		{"integer(integer n) square { return n * n; } log(square(3));", "log(9);", 1},
+		{"integer(integer n) square { return n * n; } integer x = f(); x = 2; log(square(x));", "integer x = f(); (x = 2); log((x * x));", 1},
+		{"boolean(integer x, integer lo, integer hi) within { return x >= lo && x <= hi; } integer x = f(); x++; log(within(x, 1, 9));", "integer x = f(); (x++); log(((x >= 1) && (x <= 9)));", 1},
+		{"integer(integer a, integer b) add { return a + b; } integer(integer a) twice { return add(a, a); } integer y = f(); y = 5; log(twice(y));", "integer y = f(); (y = 5); log((y + y));", 2},
+		{"character(string s, integer i) at { return s[i]; } string s = g(); s = \"ab\"; log(at(s, 1));", "string s = g(); (s = \"ab\"); log((s[1]));", 1},
+		{"integer(collection c) count { return c.size; } collection<integer> c = [1]; log(count(c));", "collection<integer> c = [1]; log((c . size));", 1},
+		// An argument evaluated more than once has to be cheap to repeat
+		{"integer(integer n) square { return n * n; } integer x = f(); x = 2; log(square(x + 1));", "integer(integer n) square { return (n * n); } integer x = f(); (x = 2); log(square((x + 1)));", 0},
+		{"integer(integer n) inc { return n + 1; } integer x = f(); x = 2; log(inc(x * 3));", "integer x = f(); (x = 2); log(((x * 3) + 1));", 1},
+		// What the call checks or could fail on is left for it
+		{"integer(integer n) inc { return n + 1; } log(inc(true));", "integer(integer n) inc { return (n + 1); } log(inc(true));", 0},
+		{"float(integer n) half { return n / 2; } log(half(3));", "float(integer n) half { return (n / 2); } log(half(3));", 0},
+		{"integer(integer n) inc { return n + 1; } log(inc(1 / 0));", "integer(integer n) inc { return (n + 1); } log(inc((1 / 0)));", 0},
+		{"integer(integer n) inc { return n + 1; } log(inc(f()));", "integer(integer n) inc { return (n + 1); } log(inc(f()));", 0},
+		// Functions that are recursive, assigned, redeclared, or do more than return a value
+		{"integer(integer n) f { return f(n - 1); } log(f(3));", "integer(integer n) f { return f((n - 1)); } log(f(3));", 0},
+		{"integer(integer n) inc { return n + 1; } integer(integer n) dec { return n - 1; } inc = dec; log(inc(3));", "integer(integer n) inc { return (n + 1); } integer(integer n) dec { return (n - 1); } (inc = dec); log(inc(3));", 0},
+		{"integer(integer n) inc { log(n); return n + 1; } log(inc(3));", "integer(integer n) inc { log(n); return (n + 1); } log(inc(3));", 0},
+		{"integer(integer n) inc { return n + 1; } integer(integer n) inc { return n + 2; } log(inc(3));", "integer(integer n) inc { return (n + 1); } integer(integer n) inc { return (n + 2); } log(inc(3));", 0},
+		// A global the function reads must not be hidden where it is called
+		{"integer g = f(); g = 1; integer(integer n) add { return n + g; } integer() h { integer g = 5; return add(g); } log(h());", "integer g = f(); (g = 1); integer(integer n) add { return (n + g); } integer() h { integer g = 5; return add(g); } log(h());", 0},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		std::vector<std::string> report;
+		EXPECT_EQ(testOptimizedProgram(&tests[i].input, &report), tests[i].expected) << tests[i].input;
+
+		int inlined = 0;
+		for (int j = 0; j < report.size(); j++)
+		{
+			if (report[j].find("inlined") != std::string::npos) inlined++;
+		}
+		EXPECT_EQ(inlined, tests[i].inlined) << tests[i].input;
+	}
+
+	// A budget smaller than the value leaves the call
+	int inlineBudget = optimizer::g_inlineBudget;
+	optimizer::g_inlineBudget = 2;
+	std::string input = "integer(integer n) square { return n * n; } log(square(3));";
+	EXPECT_EQ(testOptimizedProgram(&input), "integer(integer n) square { return (n * n); } log(square(3));");
+	optimizer::g_inlineBudget = inlineBudget;
+}
+
+TEST(OptimizerTest, SameResults)
+{
+	std::string tests[] =
+	{
+		"integer a = 6; integer b = a * 7; log(b / 2 + a % 4);",
+		"integer total = 0; for (integer i = 0; i < 10; i++) { integer step = 2; total += step * i; } log(total);",
+		"string s = \"lotus\"; log(s.length * 2); log(s);",
+		"float f = 1.5f; log(f * 2 + 1);",
+		"log(5 / 0);",
+		"log(5 % (2 - 2));",
+		"log(true + 1);",
+		"log(2147483647 + 1);",
+		"integer a = true; log(a);",
+		"integer a = 1; integer a = 2; log(a);",
+		"integer() getX { return x; } integer x = 5; log(getX());",
+		"integer() getX { return x; } log(getX()); integer x = 5;",
+		"integer x = 5; integer() setX { x = 6; return x; } setX(); log(x + 1);",
+		"integer x = 1; if (x == 1) { integer x = 2; log(x); } else { log(x); } log(x);",
+		"collection<integer> c = [1 + 1, 2 * 2]; c.append(3 - 3); log(c);",
+		// Loops, whose invariants are computed before them and whose counters may be counted natively
+		"integer total = 0; for (integer i = 0; i < 10; i++) { if (i == 3) { continue; } if (i == 7) { break; } total += i; } log(total);",
+		"integer() first { for (integer i = 2; i < 10; i++) { if (i % 3 == 0) { return i; } } return 0; } log(first());",
+		"for (integer i = 5; i > 0; i--) { log(i); }",
+		"integer n = 30; integer p = 3; for (integer j = p * p; j <= n; j += p) { log(j); }",
+		"integer n = 20; integer count = 0; for (integer p = 2; p < n; p++) { for (integer j = p + p; j < n * 2; j += p) { count += n - p; } } log(count);",
+		"collection<integer> c = [1]; while (c.size < 5) { c.append(c.size * 2); } log(c);",
+		"integer n = 3; integer() grow { n++; return n; } integer t = 0; while (t < n * 4) { t += grow(); } log(t); log(n);",
+		"string s = \"lotus\"; integer t = 0; do { t += s.length * 2; } while (t < 40); log(t);",
+		"integer n = 3; for (integer i = 0; i < 3; i++) { integer() get { return i * n; } log(get()); }",
+		"for (integer i = 0; i < 3; i++) { integer x = i / 0; }",
+		"integer(integer n) count { integer total = 0; for (integer p = 2; p < n; p++) { if (p > 3) { for (integer j = p; j < n * 2; j += p) { total += n - p; } } } return total; } log(count(20));",
+		"integer(integer n) count { integer total = 0; integer k = n + 1; while (total < 50) { if (total > 10) { total += k * 2; } else { total += k - n; } } return total; } log(count(4));",
+		"for (integer i = 0; i < \"a\"; i++) { log(i); }",
+		// Dead code
+		"integer() f { integer unused = 5; unused++; return 1; log(2); } log(f());",
+		"integer total = 0; for (integer i = 0; i < 5; i++) { integer skipped = i * 2; if (i == 3) { break; total += 100; } total += i; } log(total);",
+		"integer a = 1; if (a > 2) { log(1); } else { log(2); } if (a == 1) { log(3); } else { log(4); }",
+		"integer x = 1; integer() f { x = 2; return x; } log(f()); log(x);",
+		"integer() f { a = 2; return 0; } integer a = 1; log(f()); integer b = 3;",
+		"integer a = 1; integer a = 2; log(0);",
+		"integer a = 1 / 0; log(0);",
+		"integer x = 1;",
+		// Common subexpressions
+		"string s = \"racecar\"; integer n = s.length; for (integer i = 0; i < n; i++) { if (s[i] == s[n - i - 1] && s[i] != 'x') { log(s[i]); } log(s[n - i - 1]); }",
+		"collection<integer> c = [1, 2, 3]; integer a = c[0] * c[0] + c[1]; c.append(4); integer b = c[0] * c[0] + c.size; c[0] = 5; log(c[0] * c[0] + c.size); log(a + b);",
+		"integer(string s, integer i) f { log(s[i]); log(s[i] == s[i + 1]); return s.length - i; } log(f(\"abba\", 1)); log(f(\"ab\", 1));",
+		"integer g = 1; integer() bump { g++; return g; } integer k = g * 3 + 1; log(bump() + (g * 3 + 1)); log(g * 3 + 1); log(k);",
+		"integer(integer a, integer b) f { integer x = a * b + 1; a++; integer y = a * b + 1; integer z = a * b + 1; return x + y + z; } log(f(2, 3));",
+		"integer z = 0; string s = \"a\"; log(s[z], s[z] == s[z + 1]);",
+		// Inlining
+		"integer(integer n) square { return n * n; } integer total = 0; for (integer i = 0; i < 10; i++) { total += square(i); } log(total);",
+		"boolean(integer x, integer lo, integer hi) within { return x >= lo && x <= hi; } for (integer i = 0; i < 6; i++) { log(within(i, 2, 4)); }",
+		"character(string s, integer i) at { return s[i]; } string s = \"lotus\"; log(at(s, 1)); log(at(s, 9));",
+		"integer(integer n) inc { return n + 1; } integer(integer n) dec { return n - 1; } integer() swap { inc = dec; return 0; } log(inc(5)); swap(); log(inc(5));",
+		"integer(integer n) inc { return n + 1; } integer() h { return inc(true); } log(h());",
+		"float(integer n) half { return n / 2; } integer() h { return half(3); } log(h());",
+		"integer g = 1; integer(integer n) add { return n + g; } integer() h { integer g = 5; return add(g); } log(h()); g = 2; log(add(1));",
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(std::string); i++)
+	{
+		EXPECT_EQ(testOptimizedEvaluation(&tests[i], true), testOptimizedEvaluation(&tests[i], false)) << tests[i];
+		EXPECT_EQ(testOptimizedEvaluation(&tests[i], true, true), testOptimizedEvaluation(&tests[i], false)) << tests[i];
+	}
+}
+
+std::shared_ptr<ast::Program> testOptimizer(std::string* p_input, bool p_isLazy, std::vector<std::string>* p_report)
+{
+	lexer::Lexer lexer = lexer::Lexer(p_input);
+	parser::Parser parser = parser::Parser(lexer);
+	parser.m_isLazy = p_isLazy;
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+	EXPECT_EQ(parser.m_errors.size(), 0) << *p_input;
+
+	resolver::Resolver resolver;
+	resolver.ResolveProgram(program);
+
+	optimizer::Optimizer optimizer;
+	optimizer.OptimizeProgram(program);
+	if (p_report != NULL) *p_report = optimizer.m_report;
+	return program;
+}
+
+std::string testOptimizedProgram(std::string* p_input, std::vector<std::string>* p_report)
+{
+	std::string output = testOptimizer(p_input, false, p_report)->String();
+	for (int i = 0; i < output.size(); i++)
+	{
+		if (output[i] == '\n') output[i] = ' ';
+	}
+	if (!output.empty() && output.back() == ' ') output.pop_back();
+	return output;
+}
+
+std::string testOptimizedEvaluation(std::string* p_input, bool p_isOptimized, bool p_isLazy)
+{
+	lexer::Lexer lexer = lexer::Lexer(p_input);
+	parser::Parser parser = parser::Parser(lexer);
+	parser.m_isLazy = p_isLazy;
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+
+	resolver::Resolver resolver;
+	resolver.ResolveProgram(program);
+
+	// Skipped bodies that calls are inlined from are parsed as the interpreter does
+	evaluator::g_isOptimizing = p_isOptimized;
+	if (p_isOptimized)
+	{
+		optimizer::Optimizer optimizer;
+		optimizer.m_parseBody = [](ast::DeclareFunctionStatement* p_function)
+		{
+			return evaluator::parseFunctionBody(&p_function->m_name.m_name, &p_function->m_parameters, p_function->m_body.get()).empty();
+		};
+		optimizer.OptimizeProgram(program);
+	}
+
+	std::ostringstream output;
+	std::streambuf* standardOutput = std::cout.rdbuf(output.rdbuf());
+	std::shared_ptr<object::Object> result = evaluator::evaluate(program, std::make_shared<object::Environment>());
+	evaluator::g_isOptimizing = false;
+	std::cout.rdbuf(standardOutput);
+
+	output << result->Inspect();
+	return output.str();
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "optimizer.h"
+
+// Lexes, parses and resolves a program, skipping the bodies of top level functions if lazy, then optimizes it
+std::shared_ptr<ast::Program> testOptimizer(std::string* p_input, bool p_isLazy = false, std::vector<std::string>* p_report = NULL);
+
+// Optimizes a program and returns it on one line, with its statements separated by spaces
+std::string testOptimizedProgram(std::string* p_input, std::vector<std::string>* p_report = NULL);
+
+// Evaluates a program, optimized or not, and returns what it printed followed by its result
+std::string testOptimizedEvaluation(std::string* p_input, bool p_isOptimized, bool p_isLazy = false);
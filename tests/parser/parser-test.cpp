@@ -1063,6 +1063,113 @@ return 5.1;
 	EXPECT_EQ(program->String(), expectedString);
 }
 
+TEST(ParserTest, LazyFunctionBodies)
+{
+	std::string input = R"(
+integer(integer n) outer {
+	integer() inner { return { 1: 2 }[1]; }
+	return n + inner();
+}
+if (true) { integer() nested { return 3; } }
+integer() unclosed { return 4; )";
+
+	lexer::Lexer lexer(&input);
+	parser::Parser parser(lexer);
+	parser.m_isLazy = true;
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+
+	// Only the missing brace at the end of the file is found without parsing the bodies
+	ASSERT_EQ(parser.m_errors.size(), 1);
+	EXPECT_EQ(parser.m_errors[0], "Expected RBRACE. Got END_OF_FILE instead.");
+	ASSERT_EQ(program->m_statements.size(), 2);
+
+	// A top level body is skipped, past its nested braces
+	ASSERT_EQ(program->m_statements[0]->Type(), ast::DECLARE_FUNCTION_STATEMENT_NODE);
+	std::shared_ptr<ast::FunctionLiteral> outer = std::static_pointer_cast<ast::DeclareFunctionStatement>(program->m_statements[0])->m_body;
+	EXPECT_TRUE(outer->m_body == NULL);
+	ASSERT_TRUE(outer->m_source != NULL);
+	EXPECT_EQ(outer->m_token.m_location.m_line, 2);
+	EXPECT_EQ(outer->m_token.m_location.m_column, 26);
+
+	// Functions declared inside of a block are parsed with it
+	ASSERT_EQ(program->m_statements[1]->Type(), ast::IF_STATEMENT_NODE);
+	std::shared_ptr<ast::BlockStatement> consequence = std::static_pointer_cast<ast::IfStatement>(program->m_statements[1])->m_consequence;
+	ASSERT_EQ(consequence->m_statements.size(), 1);
+	EXPECT_TRUE(std::static_pointer_cast<ast::DeclareFunctionStatement>(consequence->m_statements[0])->m_body->m_body != NULL);
+
+	// The skipped body parses from its opening brace as it would have in place
+	parser::Parser bodyParser(lexer::Lexer(outer->m_source.get(), outer->m_token.m_location));
+	std::shared_ptr<ast::BlockStatement> body = bodyParser.ParseFunctionBody();
+	ASSERT_NO_FATAL_FAILURE(checkParserErrors(&bodyParser));
+	ASSERT_EQ(body->m_statements.size(), 2);
+	EXPECT_EQ(body->m_statements[0]->Type(), ast::DECLARE_FUNCTION_STATEMENT_NODE);
+	EXPECT_EQ(body->m_statements[1]->Type(), ast::RETURN_STATEMENT_NODE);
+	EXPECT_EQ(std::static_pointer_cast<ast::ReturnStatement>(body->m_statements[1])->m_token.m_location.m_line, 4);
+}
+
+
+TEST(ParserTest, PipelinedLexer)
+{
+	std::string input;
+	for (int i = 0; i < 500; i++)
+	{
+		input += "integer(integer n) twice { if (n > 0) { return n * 2; } return [1, 2][0]; } twice(3) + 'a';\n";
+	}
+	input += "integer missing = ;";
+
+	lexer::Lexer lexer(&input);
+	parser::Parser parser(lexer);
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+
+	parser::Parser pipelinedParser(lexer, true);
+	std::shared_ptr<ast::Program> pipelinedProgram = pipelinedParser.ParseProgram();
+
+	EXPECT_EQ(pipelinedProgram->String(), program->String());
+	EXPECT_EQ(pipelinedParser.m_errors, parser.m_errors);
+	EXPECT_FALSE(pipelinedParser.m_errors.empty());
+}
+
+TEST(ParserTest, ParallelParse)
+{
+	// Large enough to be split into a few chunks, with statements that continue after a closing brace
+	std::string input;
+	for (int i = 0; i < 3000; i++)
+	{
+		input += "integer(integer n) twice { if (n > 0) { return n * 2; } return 0; } twice(3) + {1: 2}[1];\n";
+		input += "if (true) { twice(1); } else { twice(2); } do { twice(4); } while (false); integer x = [1][0];\n";
+	}
+
+	for (int isLazy = 0; isLazy < 2; isLazy++)
+	{
+		lexer::Lexer lexer(&input);
+		parser::Parser parser(lexer);
+		parser.m_isLazy = isLazy;
+		std::shared_ptr<ast::Program> program = parser.ParseProgram();
+		ASSERT_EQ(parser.m_errors.size(), 0);
+
+		parser::Parser parallelParser(lexer);
+		parallelParser.m_isLazy = isLazy;
+		parallelParser.m_threadCount = 4;
+		std::shared_ptr<ast::Program> parallelProgram = parallelParser.ParseProgram();
+
+		EXPECT_EQ(parallelParser.m_errors.size(), 0);
+		EXPECT_EQ(parallelProgram->m_statements.size(), program->m_statements.size());
+		EXPECT_EQ(parallelProgram->String(), program->String());
+	}
+
+	// Errors are the same as those of parsing in order
+	std::string brokenInput = input + "integer y = ;\n" + input + "twice(1;\n" + input;
+	lexer::Lexer brokenLexer(&brokenInput);
+	parser::Parser parser(brokenLexer);
+	parser.ParseProgram();
+
+	parser::Parser parallelParser(brokenLexer);
+	parallelParser.m_threadCount = 4;
+	parallelParser.ParseProgram();
+
+	EXPECT_FALSE(parallelParser.m_errors.empty());
+	EXPECT_EQ(parallelParser.m_errors, parser.m_errors);
+}
 
 TEST(ParserTest, CallExpression)
 {
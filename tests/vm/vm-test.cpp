@@ -0,0 +1,239 @@
+#include <gtest/gtest.h>
+
+#include "evaluator.h"
+#include "evaluator-test.h"
+#include "lexer.h"
+#include "parser.h"
+#include "resolver.h"
+#include "vm-test.h"
+
+TEST(VirtualMachineTest, SameAsEvaluator)
+{
+	std::string tests[] =
+	{
+		"(24+7) * -3 - (100/3);",
+		"(24+7) * -3 - (100/3.0f);",
+		"1 < 2 == true != false;",
+		"!true == !!false;",
+		"'a' < 'b';",
+		"true && false || true;",
+		"[1, 2, 3][1];",
+		"{1: 'a', 2: 'b'}[2];",
+		"\"Hello\"[1];",
+		"\"Hello\" + \", world.\";",
+		"[1, 2] + [3, 4];",
+		"integer myInt = 5; integer() integerFunction { integer myInt = 6; myInt = 7; return 5; } integerFunction(); myInt;",
+		"integer(integer x, integer y) add { return x + y; } add(add(1, 2), 3);",
+		"integer(integer n) fibonacci { if (n < 2) { return n; } return fibonacci(n - 1) + fibonacci(n - 2); } fibonacci(15);",
+		"integer(integer n) sum { integer total = 0; for (integer i = 0; i <= n; i++) { total += i; } return total; } sum(100);",
+		"integer(integer n) firstOver { for (integer i = 0; i < 100; i = i + 1) { if (i > n) { return i; } } return -1; } firstOver(7);",
+		"collection<integer> myCollection = [5, 3, 7]; myCollection[1] = 6; myCollection;",
+		"dictionary<integer, character> myDictionary = {5: 'a', 3: 'c', 7: 'c'}; myDictionary[6] = 'c'; myDictionary;",
+		"integer myInt = 5; if (false) { myInt = 6; } else if(true) { myInt = 7; } else { myInt = 8; } myInt;",
+		"integer myInt = 5; if (-1.2f) { myInt = 6; } myInt;",
+		"integer i = 0; integer myInt = 5; while( i < 5 ) { i = i + 1; myInt = myInt + 1; } myInt;",
+		"integer i = 0; integer myInt = 5; do { i = i + 1; myInt = myInt + 1; } while( i > 5 ); myInt;",
+		"integer myInt = 0; for(integer i = 0; i < 5; i = i + 1) { integer myInteger = i + 1; myInt = myInt + myInteger; } myInt;",
+		"integer myInt = 5; for(; myInt < 10; myInt = myInt + 1) { myInt = myInt + 1; } myInt;",
+		"integer myInt = 0; dictionary<character, integer> myDictionary = {'a': 0, 'b': 1, 'c': 2}; iterate(key : myDictionary) { myInt = myInt + myDictionary[key]; } myInt;",
+		"integer myInt = 0; iterate(letter : \"Hello, world.\") { myInt++; } myInt;",
+		"integer myInteger = 0; iterate(value : [1, 2, 3, 4]) { myInteger = myInteger + 1; if(value == 3) { break; } } myInteger;",
+		"integer myInteger = 0; for(integer i = 0; i < 10; i = i + 1) { if(i / 2 == 2) { continue; } myInteger = myInteger + 1; } myInteger;",
+		"integer myInteger = 0; integer i = 0; do { i = i + 1; if(i > 5) { continue; } myInteger = myInteger + 1; } while(i < 10); myInteger;",
+		"collection<integer> myCollection = [1, 2, 3, 4]; myCollection[3] += 5; myCollection[3];",
+		"float myFloat = 12.5f; myFloat += 5; myFloat;",
+		"integer a = 23; (a++ +7) * -3 - (100/3.0f);",
+		"integer a = 5; --a + 5; a;",
+		"collection<integer> b = [1, 2, 3]; ++b[1]; b;",
+		"integer a = 5; integer b = a; a++; b;",
+		"dictionary<character, integer> d = {'a': 1}; d['a']++; d;",
+		"1.5f * 2 + 3 / 2.0f - 1;",
+		"2.5f % 2;",
+		"collection<integer> myCollection = [2, 3, 4]; myCollection.append(1); myCollection.pop(0); myCollection;",
+		"dictionary<character, integer> myDictionary = {'a': 0, 'b': 1}; myDictionary.values();",
+		"\"Hello\".length + [1, 2, 3].size + {1: 'a'}.size;",
+
+		// Errors
+		"5 + true;",
+		"undefinedIdentifier;",
+		"integer a = true;",
+		"float(integer x) integerFunction { return x; } integerFunction();",
+		"float(integer x) integerFunction { return x; } integerFunction(6);",
+		"integer(integer x) integerFunction { return x; } integerFunction(true);",
+		"integer(integer x) integerFunction { x; } integerFunction(6);",
+		"integer myInt = 5; myInt = 6.5f; myInt;",
+		"integer myInt = 5; if ('a') { myInt = 6; } myInt;",
+		"integer myInt = 5; integer myInt = 6;",
+		"collection<integer> myCollection = [2, 3, 4, 5.5f];",
+		"collection<integer> myCollection = ['a'];",
+		"{1: 2, 2: 3, 3: 4}['a'];",
+		"{1: 2, 1: 3};",
+		"{[1]: 2};",
+		"[1, 2, 3][3];",
+		"[1, 2, 3][-1];",
+		"5[0];",
+		"\"abc\"[0] = 'd';",
+		"integer() myFunc { break; } while(true) { myFunc(); }",
+		"continue;",
+		"integer myInteger = 12; myInteger += 'a';",
+		"5 += 3;",
+		"5 % 0;",
+		"5++;",
+		"true++;",
+		"++'a';",
+		"5(1);",
+		"iterate(value : 5) { }",
+		"collection<integer> myCollection = [2, 3, 4]; myCollection.append('a');",
+		"[1, 2, 3].length;",
+		"\"Hello\".size;",
+		"collection<integer> myCollection = [1, 2]; myCollection.size();",
+		"integer myInt = 5; myInt.append(1);",
+		"dictionary<integer, integer> myDictionary = {1: 2}; myDictionary.append(1);",
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(std::string); i++)
+	{
+		EXPECT_NO_FATAL_FAILURE(testSameAsEvaluator(&tests[i]));
+	}
+}
+
+TEST(VirtualMachineTest, CompilerSupport)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		bool isSupported;
+	} TestCase;
+
+	TestCase tests[] =
+	{
+		{"integer(integer n) fibonacci { if (n < 2) { return n; } return fibonacci(n - 1) + fibonacci(n - 2); } fibonacci(15);", true},
+		{"integer x = 5; integer() getX { return x; } getX();", true},
+		{"integer() outer { integer x = 5; integer() inner { return x; } return inner(); } outer();", false},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		std::shared_ptr<compiler::Prototype> prototype = testCompilation(&tests[i].input);
+		EXPECT_EQ(prototype != NULL, tests[i].isSupported) << tests[i].input;
+	}
+}
+
+TEST(VirtualMachineTest, Fallback)
+{
+	std::string input = "integer() outer { integer x = 5; integer() inner { return x; } return inner(); } outer();";
+	std::shared_ptr<object::Object> result = testVirtualMachine(&input);
+
+	ASSERT_EQ(result->Type(), object::INTEGER);
+	EXPECT_EQ(std::static_pointer_cast<object::Integer>(result)->m_value, 5);
+}
+
+TEST(VirtualMachineTest, Budget)
+{
+	std::string input = "integer i = 0; while (true) { i++; }";
+
+	evaluator::startBudget(1000, 0);
+	std::shared_ptr<object::Object> result = testVirtualMachine(&input);
+	long long fuelUsed = evaluator::fuelUsed();
+	evaluator::startBudget(0, 0);
+
+	// Only backward jumps and calls use fuel on the virtual machine
+	ASSERT_EQ(result->Type(), object::ERROR);
+	EXPECT_EQ(std::static_pointer_cast<object::Error>(result)->m_errorMessage, "Evaluation of the program ran out of fuel.");
+	EXPECT_EQ(fuelUsed, 1000);
+}
+
+TEST(VirtualMachineTest, CallDepth)
+{
+	typedef struct TestCase
+	{
+		std::string input;
+		int maxCallDepth;
+		std::string expectedResult;
+	} TestCase;
+
+	TestCase tests[] =
+	{
+		// Far deeper than the evaluator can go on the native stack
+		{"integer(integer n) depth { if (n == 0) { return 0; } return depth(n - 1) + 1; } depth(50000);", 100000, "50000"},
+		{"integer(integer n) depth { if (n == 0) { return 0; } return depth(n - 1) + 1; } depth(99);", 100, "99"},
+		{"integer(integer n) depth { if (n == 0) { return 0; } return depth(n - 1) + 1; } depth(100);", 100, "Evaluation Error: Exceeded the maximum call depth of 100."},
+		{"integer(integer n) forever { return forever(n + 1); } forever(0);", 100, "Evaluation Error: Exceeded the maximum call depth of 100."},
+		{"integer(integer n) depth { if (n == 0) { return 0; } return depth(n - 1) + 1; } integer() twice { return depth(60) + depth(60); } twice();", 100, "120"},
+	};
+
+	for (int i = 0; i < sizeof(tests) / sizeof(TestCase); i++)
+	{
+		vm::g_maxCallDepth = tests[i].maxCallDepth;
+		std::shared_ptr<object::Object> result = testVirtualMachine(&tests[i].input);
+		vm::g_maxCallDepth = 100000;
+
+		EXPECT_EQ(result->Inspect(), tests[i].expectedResult) << tests[i].input;
+	}
+}
+
+TEST(VirtualMachineTest, DeepRecursion)
+{
+	std::string input = "integer(integer n) forever { return forever(n + 1); } forever(0);";
+
+	// The evaluator stops where the native stack runs out, well before the virtual machine's limit
+	vm::setMaxCallDepth(1000000);
+	std::shared_ptr<object::Object> evaluated = testEvaluation(&input);
+	std::shared_ptr<object::Object> result = testVirtualMachine(&input);
+	vm::setMaxCallDepth(100000);
+
+	ASSERT_EQ(evaluated->Type(), object::ERROR);
+	EXPECT_NE(evaluated->Inspect().find("that the native stack can hold."), std::string::npos);
+	EXPECT_EQ(result->Inspect(), "Evaluation Error: Exceeded the maximum call depth of 1000000.");
+}
+
+std::shared_ptr<compiler::Prototype> testCompilation(std::string* p_input)
+{
+	lexer::Lexer lexer = lexer::Lexer(p_input);
+	parser::Parser parser = parser::Parser(lexer);
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+
+	compiler::Compiler compiler;
+	return compiler.CompileProgram(program);
+}
+
+std::shared_ptr<object::Object> testVirtualMachine(std::string* p_input)
+{
+	lexer::Lexer lexer = lexer::Lexer(p_input);
+	parser::Parser parser = parser::Parser(lexer);
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+	std::shared_ptr<object::Environment> environment(new object::Environment());
+
+	resolver::Resolver resolver;
+	resolver.ResolveProgram(program);
+
+	return vm::run(program, environment);
+}
+
+void testSameAsEvaluator(std::string* p_input, bool p_mustCompile)
+{
+	lexer::Lexer lexer = lexer::Lexer(p_input);
+	parser::Parser parser = parser::Parser(lexer);
+	std::shared_ptr<ast::Program> program = parser.ParseProgram();
+	if (p_mustCompile) ASSERT_EQ(parser.m_errors.size(), 0) << *p_input;
+
+	resolver::Resolver resolver;
+	resolver.ResolveProgram(program);
+
+	// A program the compiler does not support is run by the evaluator under --vm, so there is nothing to compare
+	compiler::Compiler compiler;
+	std::shared_ptr<compiler::Prototype> prototype = compiler.CompileProgram(program);
+	if (p_mustCompile) ASSERT_NE(prototype, nullptr) << *p_input;
+	if (prototype == nullptr) return;
+
+	// Both stop at the same call depth, so that running out of it fails the same way
+	std::shared_ptr<object::Object> expected = evaluator::evaluate(program, std::make_shared<object::Environment>());
+	int maxCallDepth = vm::g_maxCallDepth;
+	vm::g_maxCallDepth = evaluator::g_maxCallDepth;
+	vm::VirtualMachine virtualMachine(std::make_shared<object::Environment>());
+	std::shared_ptr<object::Object> result = virtualMachine.Execute(prototype);
+	vm::g_maxCallDepth = maxCallDepth;
+
+	ASSERT_EQ(result->Type(), expected->Type()) << *p_input;
+	EXPECT_EQ(result->Inspect(), expected->Inspect()) << *p_input;
+}
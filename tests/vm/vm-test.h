@@ -0,0 +1,14 @@
+#pragma once
+
+#include "compiler.h"
+#include "vm.h"
+
+// Lexes, parses and compiles a program. Returns NULL if the compiler does not support it.
+std::shared_ptr<compiler::Prototype> testCompilation(std::string* p_input);
+
+// Lexes and parses through a program and runs it on the virtual machine
+std::shared_ptr<object::Object> testVirtualMachine(std::string* p_input);
+
+// Runs a program on both the evaluator and the virtual machine and checks that they agree. Unless p_mustCompile, a
+// program the compiler does not support is skipped, since --vm runs it on the evaluator.
+void testSameAsEvaluator(std::string* p_input, bool p_mustCompile = true);